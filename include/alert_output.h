@@ -0,0 +1,68 @@
+/**
+ * @file alert_output.h
+ * @brief Outputs and timing used by Watchlist
+ *
+ * The watchlist only needs a clock, a way to wake whatever runs
+ * service(), the alert pin and the display banner, so it talks to this
+ * interface instead of FreeRTOS, GPIO and the display. The firmware uses
+ * ArduinoAlertOutput; host tests drive the watchlist from a simulated
+ * sweep with their own output.
+ */
+
+#ifndef ALERT_OUTPUT_H
+#define ALERT_OUTPUT_H
+
+#include <stdint.h>
+
+class AlertOutput {
+public:
+    virtual ~AlertOutput() {}
+
+    /**
+     * @brief Free-running microsecond clock
+     */
+    virtual int64_t nowUs() = 0;
+
+    /**
+     * @brief Have Watchlist::service() run as soon as possible
+     *
+     * Called from the sweep with a new alert pending; must not block.
+     */
+    virtual void wake() = 0;
+
+    /**
+     * @brief Drive the alert pin (LED/buzzer)
+     *
+     * The fast path: the latency bound is measured to this call.
+     */
+    virtual void setPin(bool on) = 0;
+
+    /**
+     * @brief Get the banner for a watchlist entry ready ahead of time
+     */
+    virtual void prepareBanner(int entry, float freq) = 0;
+
+    /**
+     * @brief Put an entry's banner on screen
+     *
+     * Must not wait for a display refresh in progress; a banner that
+     * cannot go out at once goes out with that refresh.
+     */
+    virtual void showBanner(int entry) = 0;
+
+    /**
+     * @brief Take the banner off the screen
+     */
+    virtual void clearBanner() = 0;
+
+    /**
+     * @brief Report a raised alert once its outputs are set
+     * @param freq Frequency in MHz
+     * @param rssi Level that triggered it in dBm
+     * @param pinUs Detection-to-pin latency
+     * @param bannerUs Detection-to-banner latency
+     */
+    virtual void alerted(float freq, int8_t rssi, uint32_t pinUs, uint32_t bannerUs) = 0;
+};
+
+#endif // ALERT_OUTPUT_H
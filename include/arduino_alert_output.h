@@ -0,0 +1,46 @@
+/**
+ * @file arduino_alert_output.h
+ * @brief AlertOutput on the alert GPIO, the OLED and a FreeRTOS task
+ */
+
+#ifndef ARDUINO_ALERT_OUTPUT_H
+#define ARDUINO_ALERT_OUTPUT_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "alert_output.h"
+#include "display_ui.h"
+#include "watchlist.h"
+
+class ArduinoAlertOutput : public AlertOutput {
+public:
+    ArduinoAlertOutput();
+
+    /**
+     * @brief Set up the alert pin and start the alert task
+     * @param watchlist Watchlist the task services; begin() it first
+     * @param ui Display used for the banner, may be nullptr
+     */
+    void begin(Watchlist* watchlist, DisplayUI* ui);
+
+    int64_t nowUs() override;
+    void wake() override;
+    void setPin(bool on) override;
+    void prepareBanner(int entry, float freq) override;
+    void showBanner(int entry) override;
+    void clearBanner() override;
+    void alerted(float freq, int8_t rssi, uint32_t pinUs, uint32_t bannerUs) override;
+
+private:
+    Watchlist* watchlist;
+    DisplayUI* ui;
+    TaskHandle_t task;
+    uint8_t overlays[WATCHLIST_MAX][ALERT_OVERLAY_BYTES];   // Pre-rendered banners
+
+    /**
+     * @brief Alert task body
+     */
+    static void alertTask(void* arg);
+};
+
+#endif // ARDUINO_ALERT_OUTPUT_H
@@ -0,0 +1,189 @@
+/**
+ * @file band_analyzer.h
+ * @brief Per-band detection state: floors, history, clustering, classification
+ *
+ * Holds everything derived from a band's sweep rows: adaptive thresholds,
+ * noise floors, max-hold and the variance window, and turns each new row
+ * into clustered, classified emitters. RFScanner feeds it live rows; the
+ * host replay tool (tools/spurscan.cpp) feeds it logged ones, so both run
+ * the same detection.
+ *
+ * Host-compilable: no Arduino calls.
+ */
+
+#ifndef BAND_ANALYZER_H
+#define BAND_ANALYZER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sweep_kernels.h"
+#include "emitter_cluster.h"
+
+// Padded row length shared by both bands (the 900MHz plan is the larger)
+#define SWEEP_ROW_MAX SWEEP_ROW_STRIDE(CHANNELS_900)
+
+class SpurMask;
+
+class BandAnalyzer {
+public:
+    BandAnalyzer();
+
+    /**
+     * @brief Set the band's channel plan and reset all state
+     * @param band Band (0=900MHz, 1=2.4GHz), a classifier feature
+     * @param channels Channel count, at most SWEEP_ROW_MAX
+     * @param startMHz Frequency of channel 0
+     * @param stepMHz Channel spacing
+     */
+    void begin(uint8_t band, int channels, float startMHz, float stepMHz);
+
+    /**
+     * @brief Forget all history; floors restart at the fixed threshold
+     */
+    void reset();
+
+    /**
+     * @brief Store one channel's measurement for the row being swept
+     * @param peakDbm Row value
+     * @param meanDbm Mean over the channel's samples
+     * @param occupancy Share of samples above threshold (%)
+     */
+    void setSample(int channel, int8_t peakDbm, int8_t meanDbm, uint8_t occupancy) {
+        row[channel] = peakDbm;
+        mean[channel] = meanDbm;
+        occupancies[channel] = occupancy;
+    }
+
+    /**
+     * @brief Note board activity during one channel's sample
+     * @param activity SPUR_* activity bits, see spur_mask.h
+     */
+    void markActivity(int channel, uint8_t activity) {
+        this->activity[channel] |= activity;
+    }
+
+    /**
+     * @brief Threshold the row being swept is compared against, in dBm
+     */
+    int8_t getThreshold(int channel) const {
+        return threshold[channel];
+    }
+
+    /**
+     * @brief Set the band's spur mask, learned from and applied to each row
+     * @param mask Spur mask, may be nullptr
+     */
+    void setSpurMask(SpurMask* mask);
+
+    /**
+     * @brief Run the row kernels and group the hits into emitters
+     * @param out Emitters found
+     * @param maxOut Capacity of out
+     * @return Number of emitters written
+     */
+    int detect(EmitterCluster* out, int maxOut);
+
+    /**
+     * @brief Modulation of an emitter from detect()
+     *
+     * Wideband emitters by spectral shape, narrow ones by the decision
+     * table on their peak channel.
+     */
+    ModulationType classify(const EmitterCluster& cluster) const;
+
+    /**
+     * @brief Fill a channel's classifier feature vector
+     * @param features CLASSIFIER_FEATURES values
+     */
+    void features(int channel, int16_t* features) const;
+
+    /**
+     * @brief Get the last completed row, one int8 dBm value per channel
+     */
+    const int8_t* getRow() const;
+
+    /**
+     * @brief Get the last row's hits, nonzero above threshold
+     */
+    const uint8_t* getHits() const;
+    
+    /**
+     * @brief Get the max-hold row since the last reset
+     */
+    const int8_t* getMaxHold() const;
+
+    /**
+     * @brief Restart max-hold
+     */
+    void resetMaxHold();
+
+    /**
+     * @brief Get the noise floors, NOISE_FLOOR_FRAC_BITS fixed point
+     */
+    const int16_t* getNoiseFloors() const;
+
+    /**
+     * @brief Restore saved noise floors
+     * @param count Number of channels to copy
+     */
+    void setNoiseFloors(const int16_t* floors, int count);
+
+    /**
+     * @brief Get a channel's RSSI variance over the last SWEEP_HISTORY rows
+     * @return Variance in dB^2
+     */
+    uint16_t getVariance(int channel) const;
+
+    /**
+     * @brief Get a channel's share of samples above threshold in the last row
+     * @return Occupancy in percent
+     */
+    uint8_t getOccupancy(int channel) const;
+
+    /**
+     * @brief Get a channel's mean level in the last row
+     * @return Mean in dBm
+     */
+    int8_t getMean(int channel) const;
+
+    /**
+     * @brief Get a channel's centre frequency in MHz
+     */
+    float getFrequency(int channel) const;
+
+    /**
+     * @brief Get the channel count set by begin()
+     */
+    int getChannelCount() const;
+
+private:
+    alignas(SWEEP_ROW_ALIGN) int8_t row[SWEEP_ROW_MAX];
+    alignas(SWEEP_ROW_ALIGN) int8_t maxHold[SWEEP_ROW_MAX];
+    alignas(SWEEP_ROW_ALIGN) int8_t threshold[SWEEP_ROW_MAX];
+    alignas(SWEEP_ROW_ALIGN) uint8_t hits[SWEEP_ROW_MAX];
+    uint8_t activity[SWEEP_ROW_MAX];       // SPUR_* bits of the row being swept
+    uint8_t masked[SWEEP_ROW_MAX];         // Spur-raised thresholds, then floor skips
+    int8_t mean[SWEEP_ROW_MAX];            // dBm, histogram mean
+    uint8_t occupancies[SWEEP_ROW_MAX];    // % of samples above threshold
+    int16_t noiseFloor[SWEEP_ROW_MAX];     // dBm, NOISE_FLOOR_FRAC_BITS fraction
+    int8_t history[SWEEP_HISTORY][SWEEP_ROW_MAX];
+    int16_t historySum[SWEEP_ROW_MAX];
+    int32_t historySumSq[SWEEP_ROW_MAX];
+    uint16_t variance[SWEEP_ROW_MAX];      // dB^2
+    int historyNext;
+    int historyCount;
+    SpurMask* spurs;
+
+    uint8_t band;
+    int channels;
+    float startMHz;
+    float stepMHz;
+
+    /**
+     * @brief Threshold, floor, max-hold and history kernels over the row
+     * @return Number of channels above threshold
+     */
+    int processRow();
+};
+
+#endif // BAND_ANALYZER_H
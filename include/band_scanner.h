@@ -0,0 +1,212 @@
+/**
+ * @file band_scanner.h
+ * @brief Per-radio sweep primitives specialised at compile time
+ *
+ * BandScanner<RadioTraits, Plan> tunes, settles and reads one radio over
+ * one channel plan. Everything that differs between chips is a static
+ * member of the traits struct, so each instantiation compiles to its own
+ * straight-line code with no band or chip checks per sample:
+ *
+ *   Radio                       driver class
+ *   Commands                    frame builders (radio_commands.h)
+ *   SETTLE_US                   RSSI settling time after entering receive
+ *   SPECTRAL_SCAN               chip has the histogram scan (spectral_scan.h)
+ *   BANDWIDTH_COUNT             receive bandwidths the chip offers...
+ *   bandwidthKHz(i)             ...in ascending order
+ *   frequencyWord(MHz)          RF frequency register value
+ *   tune(radio, word)           write the frequency register from standby
+ *   readRssi(radio)             instantaneous RSSI in dBm
+ *   calibrate(radio, lo, hi)    one-off calibration for a frequency span
+ *   delayUs(us)                 wait, yielding whole ticks
+ *   nowUs()                     free-running microsecond clock
+ *   transfer(radio, cmds, n)    send frames back to back, BUSY-gated
+ *
+ * listen(), readRssi(), standby() and measure() go through the pre-built
+ * step frames; tune() and readRssi() in the traits are the driver path,
+ * kept for calibration, the spectral scan and timeSteps().
+ *
+ * A plan provides CHANNELS and frequency(channel). Supporting another
+ * radio (an LR1121 covering both bands, say) takes one traits struct;
+ * the chips on this board are in radio_chips.h (constants and frames)
+ * and radio_traits.h (driver and bus).
+ *
+ * Host-compilable: no Arduino or RadioLib calls outside the traits.
+ */
+
+#ifndef BAND_SCANNER_H
+#define BAND_SCANNER_H
+
+#include <stdint.h>
+#include <math.h>
+#include "config.h"
+#include "radio_commands.h"
+
+// 900MHz sweep plan
+struct Plan900 {
+    static const int CHANNELS = CHANNELS_900;
+    static float frequency(int channel) { return FREQ_900_START + channel * FREQ_900_STEP; }
+};
+
+// 2.4GHz sweep plan
+struct Plan2400 {
+    static const int CHANNELS = CHANNELS_2400;
+    static float frequency(int channel) { return FREQ_2400_START + channel * FREQ_2400_STEP; }
+};
+
+template <typename Traits, typename Plan>
+class BandScanner {
+public:
+    typedef Traits RadioTraits;
+    typedef typename Traits::Radio Radio;
+    static const int CHANNELS = Plan::CHANNELS;
+
+    BandScanner() {
+        radio = nullptr;
+        for (int ch = 0; ch < Plan::CHANNELS; ch++) {
+            words[ch] = Traits::frequencyWord(Plan::frequency(ch));
+        }
+        Traits::Commands::buildStep(step, words[0]);
+    }
+
+    /**
+     * @brief Attach a started radio and calibrate it for the plan's span
+     * @return false if the calibration failed
+     */
+    bool begin(Radio* started) {
+        radio = started;
+        return Traits::calibrate(*radio, Plan::frequency(0), Plan::frequency(Plan::CHANNELS - 1));
+    }
+
+    /**
+     * @brief Get the attached radio, or nullptr before begin()
+     */
+    Radio* getRadio() const {
+        return radio;
+    }
+
+    /**
+     * @brief Get a channel's centre frequency in MHz
+     */
+    static float frequency(int channel) {
+        return Plan::frequency(channel);
+    }
+
+    /**
+     * @brief Snap a bandwidth to the nearest one the chip supports
+     * @param requestedKHz Wanted receive bandwidth
+     * @return Supported bandwidth in kHz
+     */
+    static float bandwidthKHz(float requestedKHz) {
+        float best = Traits::bandwidthKHz(0);
+        for (int i = 1; i < Traits::BANDWIDTH_COUNT; i++) {
+            float bw = Traits::bandwidthKHz(i);
+            if (fabsf(bw - requestedKHz) < fabsf(best - requestedKHz)) best = bw;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Tune from standby, start receiving and let the RSSI settle
+     * @return false if the radio stopped answering; a rejected frequency
+     *         shows up as readRssi() failing instead
+     */
+    bool listen(float freq) {
+        return listenWord(Traits::frequencyWord(freq));
+    }
+
+    /**
+     * @brief Read the instantaneous RSSI while receiving
+     * @return dBm, or -120 if the radio is not receiving
+     */
+    float readRssi() {
+        float rssi = -120;
+        RadioCommand* read = &step.commands[RADIO_STEP_READ_RSSI];
+        if (!Traits::transfer(*radio, read, 1) || !Traits::Commands::parseRssi(*read, rssi)) {
+            return -120;
+        }
+        return rssi;
+    }
+
+    /**
+     * @brief Return to standby
+     */
+    void standby() {
+        Traits::transfer(*radio, &step.commands[RADIO_STEP_STANDBY], 1);
+    }
+
+    /**
+     * @brief Measure one channel of the plan and return to standby
+     * @return dBm, or -120 if the radio rejected the frequency
+     */
+    float measure(int channel) {
+        float rssi = -120;
+        if (listenWord(words[channel])) {
+            // Read and standby in one go
+            RadioCommand* read = &step.commands[RADIO_STEP_READ_RSSI];
+            if (!Traits::transfer(*radio, read, 2) || !Traits::Commands::parseRssi(*read, rssi)) {
+                rssi = -120;
+            }
+        } else {
+            standby();
+        }
+        return rssi;
+    }
+
+    /**
+     * @brief Time the SPI side of sweep steps, settling excluded
+     *
+     * Steps through the first channels of the plan twice: through the
+     * driver calls the sweep used to make, then through the step frames.
+     * Leaves the radio in standby.
+     * @param steps Channels per path
+     * @param driverUs Mean SPI time per step through the driver
+     * @param framesUs Mean SPI time per step through the frames
+     */
+    void timeSteps(int steps, uint32_t& driverUs, uint32_t& framesUs) {
+        if (steps > Plan::CHANNELS) steps = Plan::CHANNELS;
+        uint32_t driverTotal = 0;
+        uint32_t framesTotal = 0;
+
+        for (int ch = 0; ch < steps; ch++) {
+            uint32_t start = Traits::nowUs();
+            Traits::tune(*radio, words[ch]);
+            radio->startReceive();
+            driverTotal += Traits::nowUs() - start;
+            Traits::delayUs(Traits::SETTLE_US);
+
+            start = Traits::nowUs();
+            Traits::readRssi(*radio);
+            radio->standby();
+            driverTotal += Traits::nowUs() - start;
+        }
+
+        for (int ch = 0; ch < steps; ch++) {
+            uint32_t start = Traits::nowUs();
+            Traits::Commands::setFrequency(step, words[ch]);
+            Traits::transfer(*radio, &step.commands[RADIO_STEP_TUNE], 2);
+            framesTotal += Traits::nowUs() - start;
+            Traits::delayUs(Traits::SETTLE_US);
+
+            start = Traits::nowUs();
+            Traits::transfer(*radio, &step.commands[RADIO_STEP_READ_RSSI], 2);
+            framesTotal += Traits::nowUs() - start;
+        }
+
+        driverUs = steps > 0 ? driverTotal / steps : 0;
+        framesUs = steps > 0 ? framesTotal / steps : 0;
+    }
+
+private:
+    Radio* radio;
+    uint32_t words[Plan::CHANNELS];    // Register value per channel
+    RadioStep step;                    // Frames of the current step
+
+    bool listenWord(uint32_t word) {
+        Traits::Commands::setFrequency(step, word);
+        if (!Traits::transfer(*radio, &step.commands[RADIO_STEP_TUNE], 2)) return false;
+        Traits::delayUs(Traits::SETTLE_US);
+        return true;
+    }
+};
+
+#endif // BAND_SCANNER_H
@@ -0,0 +1,54 @@
+/**
+ * @file burst_analysis.h
+ * @brief Burst-timing analysis of zero-span RSSI captures
+ *
+ * Turns a fixed-rate RSSI capture on one frequency into burst length,
+ * duty cycle and an inter-burst interval histogram, and matches the
+ * packet period against known control-link and video cadences.
+ */
+
+#ifndef BURST_ANALYSIS_H
+#define BURST_ANALYSIS_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Log-spaced interval histogram: 4 bins per octave from 0.5 ms
+#define BURST_HIST_BINS 32
+#define BURST_HIST_MIN_MS 0.5f
+#define BURST_HIST_BINS_PER_OCTAVE 4
+
+// Intervals kept for period matching
+#define BURST_MAX_INTERVALS 256
+
+struct BurstProfile {
+    uint16_t burstCount;           // Bursts found in the capture
+    float meanBurstMs;             // Average burst length
+    float dutyCycle;               // Fraction of time inside bursts (0-1)
+    float periodMs;                // Packet period (0 if none found)
+    float rateHz;                  // 1000 / periodMs
+    bool hopping;                  // Bursts skip most periods (FHSS)
+    int8_t noiseDbm;               // Capture noise level
+    int8_t peakDbm;                // Strongest sample
+    uint16_t intervalHistogram[BURST_HIST_BINS];
+    const char* protocol;          // Best fingerprint, or "Unknown"
+    ModulationType modType;        // Modulation implied by the fingerprint
+};
+
+/**
+ * @brief Analyse a zero-span capture
+ * @param samples RSSI samples in dBm
+ * @param count Number of samples
+ * @param sampleRateHz Capture rate
+ * @param band Band (0=900MHz, 1=2.4GHz), restricts fingerprints
+ * @param out Result
+ */
+void analyzeBursts(const int8_t* samples, int count, uint32_t sampleRateHz,
+                   uint8_t band, BurstProfile& out);
+
+/**
+ * @brief Lower edge of an interval histogram bin in ms
+ */
+float burstHistogramBinMs(int bin);
+
+#endif // BURST_ANALYSIS_H
@@ -0,0 +1,42 @@
+/**
+ * @file classifier.h
+ * @brief Emitter classifier evaluated from a generated decision table
+ *
+ * The decision tree is trained offline by tools/train_classifier.py from
+ * labelled feature captures and compiled in as constexpr integer tables
+ * (classifier_model.h). Evaluation is a walk of at most one node per tree
+ * level: integer compares only, no allocation.
+ */
+
+#ifndef CLASSIFIER_H
+#define CLASSIFIER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Feature vector layout; tools/train_classifier.py uses the same order
+enum ClassifierFeature {
+    FEAT_BAND = 0,                 // 0 = 900MHz, 1 = 2.4GHz
+    FEAT_FREQ,                     // Channel frequency in 100 kHz units
+    FEAT_RSSI,                     // Sweep level in dBm
+    FEAT_MARGIN,                   // dB above the channel's noise floor
+    FEAT_VARIANCE,                 // dB^2 over the last SWEEP_HISTORY sweeps
+    FEAT_OCCUPANCY,                // Samples above threshold (%)
+    FEAT_WIDTH,                    // Contiguous occupied width in 100 kHz units
+    FEAT_PRESENCE,                 // Recent sweeps above threshold (hop-rate proxy)
+    CLASSIFIER_FEATURES
+};
+
+/**
+ * @brief Classify one channel from its feature vector
+ * @param features CLASSIFIER_FEATURES values in ClassifierFeature order
+ * @return Modulation predicted by the trained table
+ */
+ModulationType classifyEmitter(const int16_t* features);
+
+/**
+ * @brief Short column name of a feature, as used in training data
+ */
+const char* classifierFeatureName(int feature);
+
+#endif // CLASSIFIER_H
@@ -0,0 +1,46 @@
+/**
+ * @file classifier_model.h
+ * @brief Emitter classifier decision tree (generated, do not edit)
+ *
+ * Generated by tools/train_classifier.py from: classifier_seed.csv
+ * 45 nodes, depth 8. Retrain instead of editing by hand.
+ */
+
+#ifndef CLASSIFIER_MODEL_H
+#define CLASSIFIER_MODEL_H
+
+#include <stdint.h>
+
+#define CLASSIFIER_MODEL_FEATURES 8
+#define CLASSIFIER_NODE_COUNT 45
+#define CLASSIFIER_LEAF 0xFF
+
+// Feature tested at each node, CLASSIFIER_LEAF at a leaf
+static constexpr uint8_t classifierFeature[CLASSIFIER_NODE_COUNT] = {
+    1, 1, 255, 255, 4, 6, 1, 255, 2, 1, 2, 3, 255, 255, 0, 255, 255, 255, 0,
+    255, 1, 255, 255, 1, 255, 255, 1, 255, 6, 1, 4, 0, 2, 255, 255, 255, 6,
+    1, 255, 255, 255, 255, 1, 255, 255
+};
+
+// Go left if feature <= threshold; the ModulationType at a leaf
+static constexpr int16_t classifierThreshold[CLASSIFIER_NODE_COUNT] = {
+    8705, 8672, 1, 3, 56, 65, 9015, 1, -50, 24830, -56, 10, 2, 2, 0, 3, 2, 0,
+    0, 3, 24845, 5, 0, 24815, 6, 0, 9015, 1, 65, 24835, 77, 0, -58, 2, 3, 4,
+    7, 9277, 4, 1, 4, 0, 24850, 6, 0
+};
+
+// Child when the test holds
+static constexpr uint8_t classifierLeft[CLASSIFIER_NODE_COUNT] = {
+    1, 2, 255, 255, 5, 6, 7, 255, 9, 10, 11, 12, 255, 255, 15, 255, 255, 255,
+    19, 255, 21, 255, 255, 24, 255, 255, 27, 255, 29, 30, 31, 32, 33, 255,
+    255, 255, 37, 38, 255, 255, 255, 255, 43, 255, 255
+};
+
+// Child when it does not
+static constexpr uint8_t classifierRight[CLASSIFIER_NODE_COUNT] = {
+    4, 3, 255, 255, 26, 23, 8, 255, 18, 17, 14, 13, 255, 255, 16, 255, 255,
+    255, 20, 255, 22, 255, 255, 25, 255, 255, 28, 255, 42, 41, 36, 35, 34,
+    255, 255, 255, 40, 39, 255, 255, 255, 255, 44, 255, 255
+};
+
+#endif // CLASSIFIER_MODEL_H
@@ -19,18 +19,67 @@
 
 // RF Scanning configuration
 #define SCAN_INTERVAL_MS 50          // Time between frequency scans
+
+// Background scanning (runs whatever the screen shows)
+#define SCAN_WEIGHT_900 1            // Sweeps of each band per rotation cycle
+#define SCAN_WEIGHT_2400 1
+#define SCAN_TASK_PRIORITY 2         // Above the Arduino loop task (1)
+#define SCAN_TASK_CORE 0             // The Arduino loop runs on core 1
+#define SCAN_TASK_STACK 8192
+#define SWEEP_RATE_WINDOW_MS 5000    // Window for the per-band sweep rate
 #define RSSI_THRESHOLD -100          // Minimum RSSI to consider a signal detected
 #define SIGNAL_HOLD_TIME_MS 3000     // How long to hold a detected signal
+#define NOISE_FLOOR_MARGIN_DB 10     // Detect this far above the channel floor
+#define NOISE_FLOOR_RISE_SHIFT 5     // Floor rises by 1/32 of the gap per sweep
+#define NOISE_FLOOR_FALL_SHIFT 2     // ...and falls by 1/4 of it
+#define SWEEP_HISTORY 8              // Sweeps kept for per-channel variance
+
+// Self-interference spur masking (spur_mask.h)
+#define SPUR_NARROW_DB 6             // A spur stands this far above both neighbours
+#define SPUR_MARGIN_DB 6             // Masked channels still detect this far above the spur
+#define SPUR_CALIBRATE_ROWS 64       // Sweeps per band taken by "spur calibrate"
+#define SPUR_PERSIST_PERCENT 80      // Calibration: in this share of sweeps makes a spur
+#define SPUR_LEARN_ROWS 256          // Background learner window, sweeps per band
+#define SPUR_ACTIVE_MIN 16           // Samples during board activity a window needs
+#define SPUR_ACTIVE_PERCENT 50       // Ours if seen this often during activity...
+#define SPUR_QUIET_PERCENT 5         // ...and at most this often without it
+#define CLASSIFIER_LOG_FEATURES 0    // Print [FEAT] training rows for each hit
+
+// Wideband emitter clustering
+#define CLUSTER_MAX 24               // Emitters kept per sweep row
+#define CLUSTER_MAX_GAP 1            // Below-threshold channels bridged inside one emitter
+#define CLUSTER_WIDE_MIN_MHZ 4.0f    // Narrower emitters keep the classifier's result
+#define CLUSTER_OFDM_MIN_MHZ 10.0f   // Wide, flat emitters from here up are OFDM
+#define CLUSTER_DSSS_ROLLOFF_DB 6    // Peak this far over the mean marks a DSSS sinc
 
 // 900MHz band configuration (SX1262 - LoRa module on T-Beam S3)
 #define FREQ_900_START 860.0         // Start frequency in MHz
 #define FREQ_900_END 930.0           // End frequency in MHz
 #define FREQ_900_STEP 0.5            // Step size in MHz
+#define CHANNELS_900 141             // (END - START) / STEP + 1
+#define SCAN_BANDWIDTH_900_KHZ 125.0 // SX1262 receive bandwidth, shared with the mesh
+#define RSSI_SETTLE_US_SX126X 2000   // RSSI settling after entering receive
+
+// 900MHz hardware spectral scan (SX1262 RSSI histogram)
+#define SPECTRAL_SCAN_900 1          // 0 = one software RSSI read per channel
+#define SPECTRAL_SAMPLES 256         // RSSI samples per channel
+#define SPECTRAL_SAMPLE_US 8         // Chip time per sample (8.2 us interval)
+#define SPECTRAL_TIMEOUT_MS 20       // Abandon a channel scan after this long
+#define SPECTRAL_BIN0_DBM -11        // Level of histogram bin 0 (approximate)
+#define SPECTRAL_BIN_DB 4            // Histogram bin width
 
 // 2.4GHz band configuration (SX1280 - if connected)
 #define FREQ_2400_START 2400.0       // Start frequency in MHz
 #define FREQ_2400_END 2500.0         // End frequency in MHz
 #define FREQ_2400_STEP 1.0           // Step size in MHz
+#define CHANNELS_2400 101            // (END - START) / STEP + 1
+#define SCAN_BANDWIDTH_2400_KHZ 1625.0 // SX1280 receive bandwidth
+#define RSSI_SETTLE_US_SX128X 2000
+
+// Radio command frames (radio_commands.h)
+#define RADIO_SPI_HZ 2000000         // Radio SPI clock, as the driver runs it
+#define RADIO_BUSY_TIMEOUT_US 5000   // Give up on a frame if BUSY stays high this long
+#define SPI_BENCH_STEPS 32           // Channels timed per path by the "spi" command
 
 // Common drone control frequencies (MHz)
 // 900MHz band drones
@@ -61,7 +110,11 @@ enum MenuState {
     MENU_SCAN_2400,
     MENU_DETECTED,
     MENU_SETTINGS,
-    MENU_INFO
+    MENU_INFO,
+    MENU_BURST,
+    MENU_STATS,
+    MENU_TRACK,
+    MENU_SURVEY
 };
 
 // Signal detection result structure
@@ -70,11 +123,137 @@ struct DetectedSignal {
     float rssi;               // Signal strength in dBm
     ModulationType modType;   // Detected modulation type
     uint32_t timestamp;       // Detection timestamp
+    uint32_t holdUntil;       // millis() when the hold runs out
     bool active;              // Is signal currently active
     uint8_t band;             // 0 = 900MHz, 1 = 2.4GHz
+    float latitude;           // Observer position at detection (degrees)
+    float longitude;
+    bool hasPosition;         // Latitude/longitude are valid
+    bool modFromBurst;        // modType came from a burst-timing capture
+    uint8_t occupancy;        // Share of samples above threshold (%)
+    float bandwidth;          // Occupied bandwidth in MHz (0 = unknown)
+    int64_t utcUs;            // UTC of the peak sample, us since 1970 (0 = no GPS time)
 };
 
 // Maximum number of signals to track
 #define MAX_DETECTED_SIGNALS 10
 
+// Boot
+#define SPLASH_TIME_MS 1500              // Splash stays up this long, without blocking
+#define RADIO_PROBE_TIMEOUT_MS 20        // Wait for BUSY to drop after reset
+#define BOOT_TASK_STACK 4096             // Stack for each hardware bring-up task
+
+// Warm restart and duty-cycled sleep
+#define WARM_RTC_BYTES 1024              // RTC slow memory reserved for the snapshot
+#define WARM_NVS_NAMESPACE "spur"        // Used when the snapshot exceeds WARM_RTC_BYTES
+#define WARM_NVS_KEY "warm"
+#define DUTY_CYCLE_SLEEP_MS 0            // Deep sleep between awake periods (0 = always on)
+#define DUTY_CYCLE_AWAKE_MS 10000        // Minimum time awake after each wake
+
+// Watchlist alerts
+#ifndef ALERT_PIN
+#define ALERT_PIN -1                     // GPIO driven high while alerting (LED/buzzer), -1 = none
+#endif
+#define WATCHLIST_MAX 8                  // Watchlisted frequencies
+#define WATCH_HYSTERESIS_DB 6            // Alert holds until this far below threshold...
+#define WATCH_HOLD_MS 2000               // ...for this long...
+#define WATCH_HOLD_REVISITS 2            // ...and at least this many revisits of the channel
+#define WATCH_LATENCY_BUDGET_US 2000     // Detection-to-GPIO bound; slower alerts are counted
+#define ALERT_TASK_PRIORITY 5            // Above the Arduino loop task (1)
+#define ALERT_TASK_STACK 4096
+#define ALERT_OVERLAY_HEIGHT 12          // Pre-rendered banner at the bottom of the screen
+
+// Zero-span burst capture
+#define BURST_SAMPLE_RATE_HZ 4000        // RSSI samples per second
+#define BURST_CAPTURE_SAMPLES 4096       // ~1 s at the rate above
+#define BURST_TIMER_NUM 0                // Hardware timer pacing the samples
+
+// Lock-on tracking of one emitter
+#define LOCK_SLOT_MS 200                 // Radio time per lock-on slot...
+#define LOCK_SLOTS_PER_SWEEP 4           // ...this many per background sweep
+#define LOCK_DWELL_READS 16              // RSSI reads per dwell; the dwell reports their peak
+#define LOCK_GAP_MS 2                    // Pause after a lock-on slot for acquireRadios()
+#define LOCK_HOP_MAX 8                   // Hop set size learned for FHSS targets
+#define LOCK_HOP_SPAN_MHZ 10.0f          // Hops are learned within this of the target
+#define LOCK_FOLLOW_MHZ 1.0f             // Other targets follow re-detections this close
+#define LOCK_POINT_MS 50                 // Sparkline point period; dwells in it are maxed
+#define LOCK_SPARK_POINTS 64             // Sparkline length
+#define LOCK_TREND_POINTS 60             // Trend fitted over the last this many points
+#define LOCK_TREND_MIN_POINTS 10         // Trend unknown until this many points
+#define LOCK_TREND_DB_PER_S 1.0f         // Slope above this is approaching/receding
+
+// Site survey accumulators
+#define SURVEY_BUCKET_MS 60000           // First time-bucket length; doubles each time buckets fill
+#define SURVEY_BUCKETS 512               // Time buckets kept in PSRAM (0 = totals only)
+#define SURVEY_BUSY_PERCENT 20           // Channels this occupied are busy for planning
+
+// Button timing
+#define LONG_PRESS_MS 700                // Hold this long for a long press
+#define LOCK_PRESS_MS 2000               // Hold this long on a Detected row to lock on
+
+// GPS configuration
+#define GPS_BAUD 9600                    // L76K default rate
+#define GPS_FIX_TIMEOUT_MS 5000          // Fix considered lost after this
+#define GPS_NMEA_MAX_DELAY_MS 900        // A time sentence names the PPS edge this recent
+#define GPS_TASK_PRIORITY 3              // Above the loop (1) and scan task (2)
+#define GPS_TASK_STACK 4096
+#define GPS_TASK_PERIOD_MS 10            // UART poll period; bounds the sentence timestamp error
+
+// GPS-disciplined sweep timing (needs GPS_PPS_PIN)
+#define SYNC_ENABLED 1                   // Start sweeps on shared UTC slots once locked
+#define SYNC_SLOT_MS 500                 // Slot N starts N * this after 1970-01-01
+#define SYNC_DWELL_US 3000               // Channel k is sampled at slot start + k * this
+#define SYNC_LEAD_US 2000                // Scan task wakes this long before a slot
+#define SYNC_LATE_US 200                 // Samples starting later than this are counted late
+#define SYNC_LOCK_PPS 3                  // Consistent PPS edges before sweeps align
+#define SYNC_PPS_TOLERANCE_US 500        // Edge may be this far off 1 s per second
+#define SYNC_HOLDOVER_MS 10000           // Lock kept this long after the last edge
+#define SYNC_DRIFT_SHIFT 3               // Drift estimate moves 1/8 toward each measurement
+
+// Emitter localisation (log-distance path-loss model)
+#define PATH_LOSS_EXPONENT 2.7f          // 2 = free space, 3-4 = cluttered
+#define LOCATOR_RSSI_SIGMA_DB 6.0f       // Shadowing noise per observation
+#define LOCATOR_MAX_EMITTERS 6           // Emitters located at once
+#define LOCATOR_GRID_SIZE 20             // Grid cells per side
+#define LOCATOR_GRID_SPAN_M 1000.0f      // Grid side, centred on first fix
+#define LOCATOR_FORGETTING 0.998f        // Per-observation evidence decay
+#define LOCATOR_MIN_RANGE_M 5.0f         // Model floor near the emitter
+#define LOCATOR_MIN_OBSERVATIONS 8       // Before an estimate is shown
+#define LOCATOR_MAX_SIGMA_M 100.0f       // Max position spread to show
+#define LOCATOR_TRACK_TIMEOUT_MS 600000  // Forget emitters unseen this long
+
+// Mesh alert sharing (SX1262 time-shared with the 900MHz sweep)
+#define MESH_ENABLED 1                   // Set to 0 to keep the SX1262 scan-only
+#define MESH_FREQ 906.875                // Mesh channel in MHz
+#define MESH_SPREADING_FACTOR 7          // Short packets keep TX windows brief
+#define MESH_SWEEPS_PER_WINDOW 2         // Sweep slots between mesh windows
+#define MESH_WINDOW_MS 150               // Fixed length of every TX/RX window
+#define MESH_DUTY_CYCLE_PERMILLE 10      // Airtime budget (10 = 1%)
+#define MESH_AIRTIME_BURST_MS 1000       // Maximum saved-up airtime credit
+#define MESH_MAX_REPORTS 8               // Reports per packet / pending table
+#define MESH_BATCH_SIZE 4                // Send once this many are pending
+#define MESH_BATCH_MAX_AGE_MS 2000       // ...or once the oldest is this old
+#define MESH_REPORT_HOLDOFF_MS 10000     // Don't resend an emitter sooner
+#define MESH_SENT_HISTORY 16             // Recently sent emitters remembered
+#define MESH_REMOTE_HOLD_MS 30000        // How long remote reports are kept
+#define MESH_TX_SLOTS 4                  // Transmit offsets a node picks from each window
+#define MESH_TX_SLOT_MS 4                // Spacing of the offsets, longer than a CAD
+#define MESH_RETRY_MS 1500               // First resend of an unacknowledged batch
+#define MAX_REMOTE_REPORTS 16            // Remote reports tracked
+
+// Flash logging configuration (LittleFS on the 16MB flash)
+#define LOG_DIR "/logs"                  // Directory holding rotated log files
+#define LOG_PAGE_SIZE 4096               // RAM page size, written as one append
+#define LOG_PAGE_COUNT 4                 // RAM pages buffered ahead of the flash
+#define LOG_FILE_MAX_BYTES (256 * 1024)  // Rotate to a new file past this size
+#define LOG_MAX_FILES 12                 // Oldest files are deleted beyond this
+#define LOG_MIN_FLUSH_INTERVAL_MS 2000   // At most one page write per interval
+#define LOG_MAX_PAGE_AGE_MS 60000        // Seal a partly filled page after this
+#define LOG_SWEEP_DECIMATION 20          // Log every Nth sweep row (0 = off)
+
+// Serial telemetry for the host aggregation daemon (tools/spurd.cpp)
+#define TELEMETRY_ENABLED 1              // $SWP per sweep, $DET per refreshed detection
+#define TELEMETRY_LINE_MAX 128           // Longest sentence including "$", "*HH\r\n"
+#define SERIAL_COMMAND_MAX 32            // Longest serial command line, e.g. "survey watch"
+
 #endif // CONFIG_H
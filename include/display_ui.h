@@ -14,6 +14,15 @@
 #include <Adafruit_SSD1306.h>
 #include "config.h"
 #include "rf_scanner.h"
+#include "emitter_locator.h"
+#include "burst_analysis.h"
+#include "lock_on.h"
+#include "survey.h"
+
+// Pre-rendered alert banner: full width, ALERT_OVERLAY_HEIGHT rows
+#define ALERT_OVERLAY_BYTES (SCREEN_WIDTH / 8 * ALERT_OVERLAY_HEIGHT)
+
+class Watchlist;
 
 class DisplayUI {
 public:
@@ -37,10 +46,60 @@ public:
     void showSplash();
     
     /**
-     * @brief Handle button press for menu navigation
+     * @brief Turn the panel off before deep sleep
+     */
+    void sleep();
+    
+    /**
+     * @brief Draw an alert banner over the current screen and push it now
+     *
+     * Safe to call from another task, and never waits for the display:
+     * if a frame is being sent, the banner goes out with its remaining
+     * pages instead. The banner stays on every frame until clearAlert().
+     * @param overlay Banner from renderAlert()
+     */
+    void showAlert(const uint8_t* overlay);
+    
+    /**
+     * @brief Remove the alert banner
+     */
+    void clearAlert();
+    
+    /**
+     * @brief Pre-render an alert banner for a frequency
+     * @param overlay Output, ALERT_OVERLAY_BYTES
+     * @param freq Frequency in MHz
+     */
+    static void renderAlert(uint8_t* overlay, float freq);
+    
+    /**
+     * @brief Count of flush starts and ends; odd while a flush is running
+     *
+     * The I2C traffic of a flush can show up as spurs in the sweep; the
+     * scanner tags samples that overlap one (spur_mask.h).
+     */
+    uint32_t getFlushCount();
+    
+    /**
+     * @brief Set the watchlist whose alert latency is shown in stats
+     */
+    void setWatchlist(Watchlist* watchlist);
+    
+    /**
+     * @brief Handle a short button press for menu navigation
      */
     void handleButton();
     
+    /**
+     * @brief Handle a long button press (select / start burst capture)
+     */
+    void handleLongPress();
+    
+    /**
+     * @brief Handle a very long press (lock on to the selected signal)
+     */
+    void handleLockPress();
+    
     /**
      * @brief Get current menu state
      * @return Current MenuState
@@ -67,33 +126,160 @@ public:
      * @brief Select current menu item
      */
     void selectMenu();
+    
+    /**
+     * @brief Set the locator used for bearing/distance on the Detected screen
+     * @param locator Emitter locator, may be nullptr
+     */
+    void setLocator(EmitterLocator* locator);
+    
+    /**
+     * @brief Set the tracker shown on the tracking screen
+     */
+    void setLockOn(LockOnTracker* tracker);
+    
+    /**
+     * @brief Set the survey shown on the survey screen
+     */
+    void setSurvey(Survey* siteSurvey);
+    
+    /**
+     * @brief Take a pending burst-capture request from the Detected screen
+     * @param band Band of the selected signal
+     * @param freq Frequency of the selected signal in MHz
+     * @return true if a capture was requested since the last call
+     */
+    bool takeBurstRequest(uint8_t& band, float& freq);
+    
+    /**
+     * @brief Show the result of a burst capture
+     * @param profile Analysis result
+     * @param overruns Sample ticks missed during the capture, -1 if it failed
+     */
+    void setBurstProfile(const BurstProfile& profile, int overruns);
+    
+    /**
+     * @brief Take a pending lock-on request from the Detected screen
+     * @param band Band of the selected signal
+     * @param freq Frequency of the selected signal in MHz
+     * @param mod Modulation of the selected signal
+     * @return true if lock-on was requested since the last call
+     */
+    bool takeLockRequest(uint8_t& band, float& freq, ModulationType& mod);
+    
+    /**
+     * @brief Take a pending request to leave lock-on
+     * @return true if the tracking screen was left since the last call
+     */
+    bool takeLockRelease();
+    
+    /**
+     * @brief Take a pending start, stop or reset from the survey screen
+     * @return SURVEY_CTL_NONE if nothing was asked since the last call
+     */
+    SurveyControl takeSurveyControl();
 
 private:
     Adafruit_SSD1306* display;
+    EmitterLocator* locator;
+    Watchlist* watchlist;
+    LockOnTracker* lockOn;
+    Survey* survey;
+    SemaphoreHandle_t lock;            // Frame buffer and I2C, shared with the alert task
+    volatile bool ready;
+    const uint8_t* volatile alertOverlay;
+    volatile bool alertDirty;          // Banner changed and not sent yet
+    volatile uint32_t flushCount;
     MenuState currentState;
     int selectedItem;
+    int selectedRow;
+    int detectedRows;
+    ScanSnapshot view;                 // Scanner state shown by the current frame
     uint32_t lastButtonPress;
     
+    // Burst capture state
+    bool burstRequested;
+    bool burstReady;
+    uint8_t burstBand;
+    float burstFreq;
+    int burstOverruns;
+    BurstProfile burstProfile;
+    
+    // Lock-on requests, taken by the loop
+    bool lockRequested;
+    bool lockReleased;
+    
+    // Survey screen
+    SurveyControl surveyControl;       // Taken by the loop
+    uint8_t surveyBand;
+    SurveyView surveyView;             // Survey state shown by the current frame
+    
     /**
-     * @brief Draw main menu screen
+     * @brief Push the frame buffer to the panel, counting the flush
+     *
+     * Sent a page at a time; a banner raised in between is drawn into
+     * the pages still to go.
      */
-    void drawMainMenu();
+    void flush();
+    
+    /**
+     * @brief Send one 8-row page of the frame buffer
+     */
+    void sendPage(int page);
+    
+    /**
+     * @brief Draw the current banner into the frame buffer, marking it sent
+     */
+    void drawPendingAlert();
+    
+    /**
+     * @brief Send a pending banner's pages only; call with the lock held
+     */
+    void pushAlert();
+    
+    /**
+     * @brief Release the display, sending a banner raised too late for
+     *        the frame that held it
+     */
+    void unlock();
     
     /**
-     * @brief Draw 900MHz scanning screen
+     * @brief Draw main menu screen
      */
-    void drawScan900(RFScanner* scanner);
+    void drawMainMenu();
     
     /**
-     * @brief Draw 2.4GHz scanning screen
+     * @brief Draw a band's scanning screen
+     * @param band Band (0=900MHz, 1=2.4GHz)
      */
-    void drawScan2400(RFScanner* scanner);
+    void drawScan(RFScanner* scanner, uint8_t band);
     
     /**
      * @brief Draw detected signals list
      */
     void drawDetected(RFScanner* scanner);
     
+    /**
+     * @brief Draw burst-timing capture result
+     */
+    void drawBurst();
+    
+    /**
+     * @brief Draw the lock-on tracking screen: level, trend and sparkline
+     */
+    void drawTrack();
+    
+    /**
+     * @brief Draw the site survey screen: max-hold, mean and occupancy
+     */
+    void drawSurvey(RFScanner* scanner);
+    
+    /**
+     * @brief Find the index of the nth active signal in the current view
+     * @return Index, or -1 if there are fewer active signals
+     */
+    int activeSignalIndex(int n);
+    
     /**
      * @brief Draw settings screen
      */
@@ -104,6 +290,11 @@ private:
      */
     void drawInfo();
     
+    /**
+     * @brief Draw boot and sweep statistics
+     */
+    void drawStats(RFScanner* scanner);
+    
     /**
      * @brief Draw status bar at top
      */
@@ -112,7 +303,7 @@ private:
     /**
      * @brief Draw signal strength indicator
      */
-    void drawSignalBars(int x, int y, float rssi);
+    void drawSignalBars(int x, int y, float rssi, uint16_t color = SSD1306_WHITE);
     
     /**
      * @brief Convert modulation type to string
@@ -0,0 +1,59 @@
+/**
+ * @file emitter_cluster.h
+ * @brief Groups the hits of one sweep row into emitters
+ *
+ * A wideband link (Wi-Fi, DSSS or OFDM video) lights up many adjacent
+ * channels at once. Runs of hits, allowing gaps of up to
+ * CLUSTER_MAX_GAP channels, are joined into one emitter with a centre
+ * frequency, an occupied bandwidth and a peak/mean level, so the tracker
+ * holds one entry per transmitter instead of one per channel.
+ */
+
+#ifndef EMITTER_CLUSTER_H
+#define EMITTER_CLUSTER_H
+
+#include <stdint.h>
+#include "config.h"
+
+struct EmitterCluster {
+    int firstChannel;              // First hit channel
+    int lastChannel;               // Last hit channel
+    int peakChannel;               // Strongest channel
+    float centerMHz;               // Centre frequency
+    float bandwidthMHz;            // Occupied bandwidth
+    int8_t peakDbm;
+    int8_t meanDbm;                // Mean over the hit channels
+};
+
+/**
+ * @brief Find the emitters in a thresholded row
+ *
+ * Narrow emitters are centred by parabolic interpolation around the peak
+ * channel; wideband ones on the middle of their occupied span, which
+ * stays put while the peak wanders across a flat top.
+ * @param row Sweep row in dBm
+ * @param hits Nonzero where the row is above threshold
+ * @param n Channel count
+ * @param startMHz Frequency of channel 0
+ * @param stepMHz Channel spacing
+ * @param out Emitters found
+ * @param maxOut Capacity of out; the weakest are dropped beyond it
+ * @return Number of emitters written
+ */
+int clusterRow(const int8_t* row, const uint8_t* hits, int n, float startMHz, float stepMHz,
+               EmitterCluster* out, int maxOut);
+
+/**
+ * @brief Check if a cluster is wide enough to be classified by its shape
+ */
+bool isWidebandCluster(const EmitterCluster& cluster);
+
+/**
+ * @brief Modulation implied by a wideband cluster's width and shape
+ *
+ * Flat-topped spectra are OFDM; narrower ones, and wide ones that roll
+ * off from a central peak like a DSSS sinc, are DSSS.
+ */
+ModulationType classifyWideband(const EmitterCluster& cluster);
+
+#endif // EMITTER_CLUSTER_H
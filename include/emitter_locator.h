@@ -0,0 +1,100 @@
+/**
+ * @file emitter_locator.h
+ * @brief Incremental emitter position estimates from GPS-tagged RSSI
+ *
+ * Each emitter gets a grid-based (point-mass) Bayesian filter over its
+ * east/north position with a log-distance path-loss model. The unknown
+ * transmit power is solved in closed form per cell from a running mean
+ * and residual, so memory per emitter and work per observation are both
+ * fixed by the grid size. Positions are kept in a local east/north frame
+ * in metres around the first fix.
+ */
+
+#ifndef EMITTER_LOCATOR_H
+#define EMITTER_LOCATOR_H
+
+#include <stdint.h>
+#include "config.h"
+
+#define LOCATOR_CELLS (LOCATOR_GRID_SIZE * LOCATOR_GRID_SIZE)
+
+class EmitterLocator {
+public:
+    EmitterLocator();
+
+    /**
+     * @brief Record the operator's current position
+     */
+    void setObserver(float latitude, float longitude);
+
+    /**
+     * @brief Feed one GPS-tagged detection into its emitter's filter
+     * @param now Timestamp used to age out unused emitters
+     */
+    void addObservation(const DetectedSignal& sig, uint32_t now);
+
+    /**
+     * @brief Get bearing and distance from the observer to an emitter
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param freq Emitter frequency in MHz
+     * @param bearingDeg True bearing, 0-360 degrees clockwise from north
+     * @param distanceM Distance in metres
+     * @return false if no converged estimate exists for the emitter
+     */
+    bool getEstimate(uint8_t band, float freq, float& bearingDeg, float& distanceM);
+
+    /**
+     * @brief Forget all emitters
+     */
+    void clear();
+
+private:
+    struct Cell {
+        float mean;            // Decayed mean of rssi + path loss (= P0)
+        float residual;        // Decayed sum of squared residuals
+    };
+
+    struct Track {
+        Cell cells[LOCATOR_CELLS];
+        float weightSum;       // Decayed observation count
+        float originX;         // South-west corner of the grid (m)
+        float originY;
+        float bestResidual;    // Smallest residual over the grid
+        float frequency;       // MHz
+        uint8_t band;
+        uint16_t observations;
+        uint32_t lastUpdate;
+        bool active;
+    };
+
+    Track tracks[LOCATOR_MAX_EMITTERS];
+
+    bool hasOrigin;
+    double originLat;
+    double originLon;
+    float metresPerDegLon;
+    float observerX;
+    float observerY;
+
+    /**
+     * @brief Project a position into the local east/north frame
+     */
+    void project(float latitude, float longitude, float& x, float& y);
+
+    /**
+     * @brief Find the track for an emitter, or start one
+     */
+    Track* findTrack(uint8_t band, float freq, uint32_t now, bool create);
+
+    /**
+     * @brief Centre a new track's grid on the first observation
+     */
+    void initTrack(Track& t, float x, float y);
+
+    /**
+     * @brief Fold one observation into every cell
+     */
+    void update(Track& t, float x, float y, float rssi);
+};
+
+#endif // EMITTER_LOCATOR_H
@@ -0,0 +1,197 @@
+/**
+ * @file flash_logger.h
+ * @brief Batched, wear-aware flash logger for detections and sweep rows
+ *
+ * Records are collected into RAM pages and written to flash as whole
+ * CRC-protected blocks, one page per flush, at a bounded rate. Log files
+ * rotate at a fixed size so a torn write can only ever cost the last block.
+ *
+ * The filesystem is reached through LogStorage and times are passed in, so
+ * the logger and its power-loss recovery also run in host tests.
+ */
+
+#ifndef FLASH_LOGGER_H
+#define FLASH_LOGGER_H
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "log_storage.h"
+
+// Block header written in front of every flushed page
+#define LOG_BLOCK_MAGIC 0x474C5053   // "SPLG"
+
+// Record types stored inside a block
+enum LogRecordType {
+    LOG_REC_DETECTION = 1,
+    LOG_REC_SWEEP_ROW = 2
+};
+
+struct __attribute__((packed)) LogBlockHeader {
+    uint32_t magic;            // LOG_BLOCK_MAGIC
+    uint32_t sequence;         // Monotonic block counter across files
+    uint16_t payloadLength;    // Bytes of records following the header
+    uint16_t recordCount;      // Number of records in the payload
+    uint32_t crc;              // CRC-32 of sequence..recordCount, then the payload
+};
+
+struct __attribute__((packed)) LogDetectionRecord {
+    uint32_t timestamp;        // millis() of the detection
+    float frequency;           // MHz
+    float rssi;                // dBm
+    uint8_t band;              // 0 = 900MHz, 1 = 2.4GHz
+    uint8_t modType;           // ModulationType
+};
+
+struct __attribute__((packed)) LogSweepRowHeader {
+    uint32_t timestamp;        // millis() at the end of the sweep
+    uint8_t band;              // 0 = 900MHz, 1 = 2.4GHz
+    uint8_t channelCount;      // Number of int8 dBm cells that follow
+};
+
+class FlashLogger {
+public:
+    FlashLogger();
+
+    /**
+     * @brief Mount the storage and recover the last log file
+     *
+     * The first flush after boot always opens a new file.
+     * @return true if logging is available
+     */
+    bool begin(LogStorage* storage);
+
+    /**
+     * @brief Queue a detection record (never blocks)
+     * @return false if the record was dropped because all pages are full
+     */
+    bool logDetection(const DetectedSignal& sig, uint32_t nowMs);
+
+    /**
+     * @brief Queue a sweep row record (never blocks)
+     * @return false if the record was dropped because all pages are full
+     */
+    bool logSweepRow(uint8_t band, const int8_t* row, int count, uint32_t nowMs);
+
+    /**
+     * @brief Write at most one sealed page to flash if the rate budget allows
+     *
+     * Call between sweeps.
+     */
+    void service(uint32_t nowMs);
+
+    /**
+     * @brief Seal and write every buffered page immediately
+     *
+     * Ignores the rate limit; use before a controlled reboot or sleep.
+     */
+    void flush(uint32_t nowMs);
+
+    /**
+     * @brief Check if logging is available
+     */
+    bool isAvailable();
+
+    /**
+     * @brief Number of records dropped because the RAM pages were full
+     */
+    uint32_t getDroppedRecords();
+
+    /**
+     * @brief Number of blocks written since boot
+     */
+    uint32_t getBlocksWritten();
+
+    /**
+     * @brief Index of the newest log file found at boot, or being written
+     */
+    uint32_t getFileIndex();
+
+    /**
+     * @brief Sequence number the next sealed block will carry
+     */
+    uint32_t getNextSequence();
+
+    /**
+     * @brief Valid blocks in the file the sequence was recovered from
+     */
+    uint32_t getRecoveredBlocks();
+
+    /**
+     * @brief Bytes after the last valid block of that file, ignored as torn
+     */
+    uint32_t getTornBytes();
+
+    /**
+     * @brief CRC-32 (IEEE 802.3) over a buffer
+     */
+    static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+    /**
+     * @brief CRC of a block: the header fields after the magic, then the payload
+     */
+    static uint32_t blockCrc(const LogBlockHeader& hdr, const uint8_t* payload);
+
+private:
+    struct Page {
+        uint8_t data[LOG_PAGE_SIZE];
+        uint16_t used;             // Bytes used, including the header
+        uint16_t records;
+        uint32_t openedAt;         // Time of the first record (ms)
+        bool sealed;
+    };
+
+    Page pages[LOG_PAGE_COUNT];
+    int fillPage;                  // Page currently receiving records
+    int flushPage;                 // Oldest sealed page waiting for flash
+
+    LogStorage* storage;
+    LogStorageFile* logFile;
+    uint32_t fileIndex;
+    uint32_t sequence;
+    uint32_t lastFlushTime;
+    uint32_t droppedRecords;
+    uint32_t blocksWritten;
+    uint32_t recoveredBlocks;
+    uint32_t tornBytes;
+    bool available;
+
+    /**
+     * @brief Reserve space for a record in the fill page
+     * @return Pointer to the record payload, or nullptr if dropped
+     */
+    uint8_t* reserve(uint8_t type, uint16_t len, uint32_t nowMs);
+
+    /**
+     * @brief Finish the fill page's header and hand it to the flusher
+     */
+    void sealFillPage();
+
+    /**
+     * @brief Write the oldest sealed page to the current log file
+     */
+    bool writePage(uint32_t nowMs);
+
+    /**
+     * @brief Open the next log file and delete ones beyond LOG_MAX_FILES
+     */
+    bool rotate();
+
+    /**
+     * @brief Find the last valid block after a reset and continue its sequence
+     */
+    void recover();
+
+    /**
+     * @brief Walk one log file block by block
+     * @return Number of valid blocks; sequence is advanced past the last one
+     */
+    uint32_t scanFile(uint32_t index, size_t* validBytes, size_t* fileSize);
+
+    /**
+     * @brief Build the path of a numbered log file
+     */
+    static void filePath(uint32_t index, char* out, size_t len);
+};
+
+#endif // FLASH_LOGGER_H
@@ -0,0 +1,88 @@
+/**
+ * @file gps_receiver.h
+ * @brief GPS receiver for tagging detections with the operator's position
+ *
+ * The NMEA stream is parsed by its own task, not the Arduino loop, so a
+ * loop busy for a second (a burst capture, a flash write) neither delays
+ * the position nor stamps a time sentence late. With GPS_PPS_PIN wired,
+ * each PPS edge is also timestamped and paired with the RMC sentence for
+ * that second to discipline a SweepClock; pairing by arrival time only
+ * works if sentences are seen as they arrive. The pairing rules live in
+ * PpsPairer, which the host tests drive directly.
+ */
+
+#ifndef GPS_RECEIVER_H
+#define GPS_RECEIVER_H
+
+#include <Arduino.h>
+#include <TinyGPSPlus.h>
+#include "config.h"
+#include "pps_pairer.h"
+#include "seqlock.h"
+#include "sweep_clock.h"
+
+// Position as of the last sentence the GPS task parsed
+struct GpsFix {
+    float latitude;                // Degrees
+    float longitude;
+    uint8_t satellites;
+    bool valid;                    // A location has been received
+    uint32_t fixMs;                // millis() of the last location
+};
+
+class GpsReceiver {
+public:
+    GpsReceiver();
+
+    /**
+     * @brief Open the GPS UART, attach the PPS interrupt and start the GPS task
+     * @param clock Clock to discipline from PPS, may be nullptr
+     * @return true if the UART was opened
+     */
+    bool begin(SweepClock* clock);
+
+    /**
+     * @brief Get the latest position
+     * @param fix One consistent copy of the position
+     * @return true if it is valid and younger than GPS_FIX_TIMEOUT_MS
+     */
+    bool getFix(GpsFix& fix);
+
+    /**
+     * @brief Get number of satellites in use
+     */
+    uint8_t getSatellites();
+
+private:
+    TinyGPSPlus gps;               // GPS task only
+    PpsPairer pairer;              // GPS task only
+    SeqLock<GpsFix> published;     // Written by the GPS task, read by the loop
+    TaskHandle_t task;
+
+    // Written by the PPS interrupt; count is bumped after the time
+    static volatile int64_t pulseUs;
+    static volatile uint32_t pulseCount;
+
+    /**
+     * @brief PPS rising edge interrupt
+     */
+    static void IRAM_ATTR onPps();
+
+    /**
+     * @brief Parse the NMEA stream every GPS_TASK_PERIOD_MS
+     */
+    static void gpsTask(void* arg);
+
+    /**
+     * @brief Feed pending NMEA characters to the parser, publish the
+     * position and pair the latest PPS edge (GPS task)
+     */
+    void poll();
+
+    /**
+     * @brief Hand the pairer the latest edge once an RMC sentence completes
+     */
+    void pairPulse();
+};
+
+#endif // GPS_RECEIVER_H
@@ -0,0 +1,24 @@
+/**
+ * @file littlefs_log_storage.h
+ * @brief LogStorage on the ESP32's LittleFS partition
+ */
+
+#ifndef LITTLEFS_LOG_STORAGE_H
+#define LITTLEFS_LOG_STORAGE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "log_storage.h"
+
+class LittleFsLogStorage : public LogStorage {
+public:
+    bool mount() override;
+    bool exists(const char* path) override;
+    bool mkdir(const char* path) override;
+    bool remove(const char* path) override;
+    LogStorageFile* open(const char* path, bool append) override;
+    void close(LogStorageFile* file) override;
+    bool listDir(const char* path, LogDirVisitor visit, void* ctx) override;
+};
+
+#endif // LITTLEFS_LOG_STORAGE_H
@@ -0,0 +1,126 @@
+/**
+ * @file lock_on.h
+ * @brief Lock-on tracking of one emitter at a high revisit rate
+ *
+ * While locked on, the scan task spends most slots dwelling on the
+ * target's frequency (or, for a frequency hopper, on the hop set learned
+ * from the background sweeps) instead of sweeping the whole band. Each
+ * dwell reports the peak of a few RSSI reads; dwells are folded into a
+ * sparkline of LOCK_POINT_MS points, and a least-squares fit over the
+ * recent points gives the trend used for direction-finding on foot.
+ *
+ * Only the scan task calls the mutating methods; start() and stop() come
+ * from the loop with the radios acquired. Readers take getView().
+ *
+ * Host-compilable: no Arduino calls, times are passed in.
+ */
+
+#ifndef LOCK_ON_H
+#define LOCK_ON_H
+
+#include <stdint.h>
+#include "config.h"
+#include "seqlock.h"
+
+// Direction of the recent RSSI slope
+enum LockTrend {
+    LOCK_TREND_UNKNOWN = 0,        // Too few points yet
+    LOCK_TREND_STEADY,
+    LOCK_TREND_APPROACHING,        // Getting stronger
+    LOCK_TREND_RECEDING            // Getting weaker
+};
+
+// Tracker state as of the last closed sparkline point
+struct LockOnView {
+    bool active;
+    uint8_t band;                  // 0 = 900MHz, 1 = 2.4GHz
+    uint8_t modType;               // ModulationType of the target
+    uint8_t hopCount;              // Frequencies dwelt on
+    float frequency;               // Target (first hop) in MHz
+    int8_t spark[LOCK_SPARK_POINTS];           // dBm, ring buffer...
+    uint32_t sparkMs[LOCK_SPARK_POINTS];       // ...and when each point closed
+    uint8_t sparkNext;             // Next slot to write
+    uint8_t sparkCount;
+    int8_t lastDbm;                // Newest point
+    float trendDbPerS;             // Fitted slope
+    uint8_t trend;                 // LockTrend
+    uint16_t revisitHz;            // Dwells per second over the last second
+    uint16_t maxGapMs;             // Longest wait between dwells over the last second
+    uint32_t dwells;               // Since start()
+};
+
+class LockOnTracker {
+public:
+    LockOnTracker();
+
+    /**
+     * @brief Lock on to an emitter and forget the previous one
+     * @param modType Target modulation; MOD_FHSS targets learn a hop set
+     */
+    void start(uint8_t band, float freq, uint8_t modType, uint32_t nowMs);
+
+    /**
+     * @brief Stop tracking; the scan task returns to full sweeps
+     */
+    void stop();
+
+    /**
+     * @brief Check if a target is locked
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Band of the target
+     */
+    uint8_t getBand() const;
+
+    /**
+     * @brief Frequency for the next dwell, cycling through the hop set
+     */
+    float nextFrequency();
+
+    /**
+     * @brief Add one dwell's reading
+     * @param peakDbm Peak of the dwell's RSSI reads
+     * @param nowMs When the dwell ended
+     */
+    void addDwell(int8_t peakDbm, uint32_t nowMs);
+
+    /**
+     * @brief Feed a detection from a background sweep
+     *
+     * Hopper targets add nearby hops of the same kind to the hop set;
+     * other targets follow their own re-detection as it drifts.
+     */
+    void learn(uint8_t band, float freq, uint8_t modType);
+
+    /**
+     * @brief Copy out the latest published state
+     */
+    void getView(LockOnView& out) const;
+
+private:
+    LockOnView state;                  // Written by the scan task only
+    SeqLock<LockOnView> published;
+    float hops[LOCK_HOP_MAX];
+    int hopNext;
+    int8_t pointPeak;                  // Peak of the open sparkline point
+    uint32_t pointStartMs;
+    uint32_t lastDwellMs;
+    uint32_t rateStartMs;              // Revisit rate window
+    uint32_t rateDwells;
+    uint32_t rateMaxGapMs;
+
+    /**
+     * @brief Close the open point, refit the trend and publish
+     */
+    void closePoint(uint32_t nowMs);
+
+    /**
+     * @brief Least-squares slope of the newest LOCK_TREND_POINTS points
+     * @return dB per second
+     */
+    float fitTrend() const;
+};
+
+#endif // LOCK_ON_H
@@ -0,0 +1,91 @@
+/**
+ * @file log_storage.h
+ * @brief Filesystem interface used by FlashLogger
+ *
+ * FlashLogger only needs append, sequential read, remove and a directory
+ * listing, so it talks to this small interface instead of LittleFS. The
+ * firmware uses LittleFsLogStorage; host tests use StdioLogStorage on a
+ * temporary directory, optionally wrapped to cut writes mid-block.
+ */
+
+#ifndef LOG_STORAGE_H
+#define LOG_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class LogStorageFile {
+public:
+    virtual ~LogStorageFile() {}
+
+    /**
+     * @brief Read up to len bytes from the current position
+     * @return Bytes read
+     */
+    virtual size_t read(uint8_t* data, size_t len) = 0;
+
+    /**
+     * @brief Append len bytes
+     * @return Bytes written; less than len on a full or failing device
+     */
+    virtual size_t write(const uint8_t* data, size_t len) = 0;
+
+    /**
+     * @brief Push buffered writes to the device
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @brief Current file size in bytes
+     */
+    virtual size_t size() = 0;
+};
+
+/**
+ * @brief Called once per entry by LogStorage::listDir()
+ */
+typedef void (*LogDirVisitor)(const char* name, void* ctx);
+
+class LogStorage {
+public:
+    virtual ~LogStorage() {}
+
+    /**
+     * @brief Mount the filesystem, formatting it if it cannot be mounted
+     */
+    virtual bool mount() = 0;
+
+    /**
+     * @brief Check if a path exists
+     */
+    virtual bool exists(const char* path) = 0;
+
+    /**
+     * @brief Create a directory
+     */
+    virtual bool mkdir(const char* path) = 0;
+
+    /**
+     * @brief Delete a file
+     */
+    virtual bool remove(const char* path) = 0;
+
+    /**
+     * @brief Open a file for reading, or for appending (created if missing)
+     * @return Open file, or nullptr; release with close()
+     */
+    virtual LogStorageFile* open(const char* path, bool append) = 0;
+
+    /**
+     * @brief Close and release a file returned by open()
+     */
+    virtual void close(LogStorageFile* file) = 0;
+
+    /**
+     * @brief Call visit with the name (without directory) of every entry
+     * @return false if the directory cannot be opened
+     */
+    virtual bool listDir(const char* path, LogDirVisitor visit, void* ctx) = 0;
+};
+
+#endif // LOG_STORAGE_H
@@ -0,0 +1,228 @@
+/**
+ * @file mesh_link.h
+ * @brief Compact detection-report exchange between units over LoRa
+ *
+ * Reports are batched and deduplicated locally, then sent in short
+ * windows on the SX1262 under an airtime duty-cycle budget. Reports
+ * heard from other units are kept in a small remote table.
+ *
+ * Units that sweep in step open their windows together, so nobody sends
+ * at the start of one: each window a node picks one of MESH_TX_SLOTS
+ * offsets and checks the channel before sending. A unit that hears a
+ * batch acknowledges it in its next packet, or in a header-only one. A
+ * batch stays queued and is resent, backing off, until some unit
+ * acknowledges it.
+ *
+ * The radio and clock are reached through MeshTransport, so several links
+ * can be run against a simulated shared channel on the host.
+ */
+
+#ifndef MESH_LINK_H
+#define MESH_LINK_H
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "mesh_transport.h"
+
+#define MESH_PACKET_MAGIC 0xD7
+#define MESH_PACKET_VERSION 2
+
+struct __attribute__((packed)) MeshPacketHeader {
+    uint8_t magic;             // MESH_PACKET_MAGIC
+    uint8_t version;           // MESH_PACKET_VERSION
+    uint16_t nodeId;           // Sender, from the low MAC bytes
+    uint8_t sequence;          // Per-sender packet counter
+    uint8_t count;             // Number of MeshReportEntry that follow
+    uint16_t ackNode;          // Sender of the batch acknowledged, 0 = none
+    uint8_t ackSequence;       // Its packet sequence
+};
+
+struct __attribute__((packed)) MeshReportEntry {
+    uint16_t freqCode;         // Frequency in 100kHz units
+    int8_t rssi;               // dBm
+    uint8_t flags;             // Bit 7 = band, bits 0-3 = ModulationType
+};
+
+#define MESH_MAX_PACKET_LEN (sizeof(MeshPacketHeader) + MESH_MAX_REPORTS * sizeof(MeshReportEntry))
+
+// Detection reported by another unit
+struct RemoteReport {
+    uint16_t nodeId;
+    float frequency;           // MHz
+    int8_t rssi;               // dBm as seen by the remote unit
+    uint8_t band;              // 0 = 900MHz, 1 = 2.4GHz
+    ModulationType modType;
+    uint32_t timestamp;        // Local time when received (ms)
+    bool active;
+};
+
+// Called for every report decoded from another unit
+typedef void (*RemoteReportHandler)(const RemoteReport& report);
+
+class MeshLink {
+public:
+    MeshLink();
+
+    /**
+     * @brief Attach to the radio used for mesh windows
+     * @param transport Radio and clock, may be nullptr
+     * @return true if the mesh is usable
+     */
+    bool begin(MeshTransport* transport);
+
+    /**
+     * @brief Set the function told about each report heard, may be nullptr
+     */
+    void setReportHandler(RemoteReportHandler handler);
+
+    /**
+     * @brief Queue a local detection for the next report packet
+     *
+     * Reports for the same emitter are merged; emitters sent recently
+     * are skipped until MESH_REPORT_HOLDOFF_MS has passed.
+     */
+    void queueReport(const DetectedSignal& sig);
+
+    /**
+     * @brief Use the radio for one fixed-length TX/RX window
+     *
+     * Transmits a batch if one is due and the airtime budget allows,
+     * and listens for the rest of the window. Always takes
+     * MESH_WINDOW_MS so sweep revisit time stays predictable.
+     * @return Time the window ended (ms)
+     */
+    uint32_t runWindow();
+
+    /**
+     * @brief Get the remote reports table
+     */
+    RemoteReport* getRemoteReports();
+
+    /**
+     * @brief Get this unit's node ID
+     */
+    uint16_t getNodeId();
+
+    /**
+     * @brief Check if the mesh is usable
+     */
+    bool isAvailable();
+
+    uint32_t getPacketsSent();
+    uint32_t getPacketsReceived();
+
+    /**
+     * @brief Header-only packets sent to acknowledge a batch
+     */
+    uint32_t getAcksSent();
+
+    /**
+     * @brief Reports queued or sent but not yet acknowledged
+     */
+    int getPendingCount();
+
+    /**
+     * @brief Total time on air of the packets sent, in microseconds
+     */
+    uint64_t getAirtimeUs();
+
+private:
+    struct PendingReport {
+        MeshReportEntry entry;
+        uint32_t queuedAt;
+    };
+
+    struct SentReport {
+        uint16_t freqCode;
+        uint8_t band;
+        uint32_t sentAt;
+    };
+
+    MeshTransport* radio;
+    bool available;
+    uint16_t nodeId;
+    uint8_t sequence;
+
+    PendingReport pending[MESH_MAX_REPORTS];
+    int pendingCount;
+    int inFlight;                  // Leading pending reports sent, unacknowledged
+    uint8_t inFlightSequence;      // Packet that carried them
+    int attempts;                  // Times they have been sent
+    uint32_t retryAt;              // When to resend them (ms)
+    uint32_t slotRandom;           // Picks each window's transmit offset
+
+    bool ackPending;               // A batch heard that we have not acknowledged
+    uint16_t ackNode;
+    uint8_t ackSequence;
+    SentReport sent[MESH_SENT_HISTORY];
+    int sentNext;
+
+    RemoteReport remote[MAX_REMOTE_REPORTS];
+    RemoteReportHandler reportHandler;
+
+    uint32_t airtimeCreditUs;
+    uint32_t lastCreditUpdate;
+    uint32_t packetsSent;
+    uint32_t packetsReceived;
+    uint32_t acksSent;
+    uint64_t airtimeUs;
+
+    /**
+     * @brief Accrue airtime credit for the time since the last call
+     */
+    void updateCredit();
+
+    /**
+     * @brief Check if a batch should go out in this window
+     */
+    bool batchDue();
+
+    /**
+     * @brief Check if an emitter was sent within the holdoff period
+     */
+    bool recentlySent(uint16_t freqCode, uint8_t band);
+
+    /**
+     * @brief Pick a transmit offset within the window (ms)
+     */
+    uint32_t txOffset();
+
+    /**
+     * @brief Send the pending batch if due, else an acknowledgement if owed
+     */
+    bool transmitNext(uint32_t deadline);
+
+    /**
+     * @brief Encode and transmit the first count pending reports
+     *
+     * Carries any owed acknowledgement. Sends nothing if the budget or the
+     * window is too short, or if the channel is busy.
+     */
+    bool sendPacket(int count, uint32_t deadline);
+
+    /**
+     * @brief Drop the reports of an acknowledged batch
+     */
+    void confirmBatch();
+
+    /**
+     * @brief Listen until the deadline, handling any packets received
+     *
+     * Sends at a fresh offset at the start of the window, and after each
+     * packet heard, whenever a batch is due or an acknowledgement is owed.
+     */
+    void listen(uint32_t deadline);
+
+    /**
+     * @brief Decode a received packet into the remote table
+     */
+    void handlePacket(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Expire old remote reports
+     */
+    void cleanupRemote();
+};
+
+#endif // MESH_LINK_H
@@ -0,0 +1,82 @@
+/**
+ * @file mesh_transport.h
+ * @brief Packet radio interface used by MeshLink
+ *
+ * MeshLink only needs to tune, send, poll for received packets and keep
+ * time, so it talks to this interface instead of RadioLib. The firmware
+ * uses RadioLibMeshTransport on the shared SX1262; host tests use
+ * SimMeshTransport, where several virtual nodes share one simulated channel.
+ */
+
+#ifndef MESH_TRANSPORT_H
+#define MESH_TRANSPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MeshTransport {
+public:
+    virtual ~MeshTransport() {}
+
+    /**
+     * @brief Apply the modem settings mesh packets use
+     */
+    virtual bool configure() = 0;
+
+    /**
+     * @brief Identifier other nodes see as the sender
+     */
+    virtual uint16_t getNodeId() = 0;
+
+    /**
+     * @brief Tune to a channel in MHz
+     */
+    virtual bool setFrequency(float freq) = 0;
+
+    /**
+     * @brief Time on air of a packet in microseconds
+     */
+    virtual uint32_t getTimeOnAir(size_t len) = 0;
+
+    /**
+     * @brief Send a packet, returning once it has left the antenna
+     */
+    virtual bool transmit(const uint8_t* data, size_t len) = 0;
+
+    /**
+     * @brief Check for a packet already on the air on the current channel
+     *
+     * Interrupts any receive in progress; call startReceive() after.
+     */
+    virtual bool isChannelBusy() = 0;
+
+    /**
+     * @brief Start listening on the current channel
+     */
+    virtual bool startReceive() = 0;
+
+    /**
+     * @brief Fetch a packet received since the last call
+     *
+     * Keeps receiving afterwards.
+     * @return Packet length, or 0 if nothing arrived
+     */
+    virtual size_t readPacket(uint8_t* data, size_t maxLen) = 0;
+
+    /**
+     * @brief Stop receiving and idle the radio
+     */
+    virtual void standby() = 0;
+
+    /**
+     * @brief Current time in milliseconds
+     */
+    virtual uint32_t nowMs() = 0;
+
+    /**
+     * @brief Wait, letting the radio keep receiving
+     */
+    virtual void idle(uint32_t ms) = 0;
+};
+
+#endif // MESH_TRANSPORT_H
@@ -0,0 +1,73 @@
+/**
+ * @file pps_pairer.h
+ * @brief Pairs GPS PPS edges with the RMC sentence naming their second
+ *
+ * The GPS task feeds it every NMEA character as it is read from the UART.
+ * When an RMC sentence for a whole UTC second completes, the task hands
+ * it the latest PPS edge, and the pair goes to the SweepClock if:
+ * - the edge has not been paired already (the sentence for second N
+ *   follows the edge that starts it, and one edge names one second);
+ * - the edge is at most GPS_NMEA_MAX_DELAY_MS old, so a sentence is never
+ *   paired with an edge from a second the PPS line has since missed.
+ *
+ * Only RMC is parsed, as it alone carries both the date and the time.
+ * Sentences with a bad checksum, a void fix or a fractional second are
+ * ignored.
+ *
+ * Host-compilable: no Arduino calls, times are passed in.
+ */
+
+#ifndef PPS_PAIRER_H
+#define PPS_PAIRER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sweep_clock.h"
+
+// Longest NMEA sentence from '$' to the checksum, per NMEA 0183
+#define NMEA_SENTENCE_MAX 82
+
+class PpsPairer {
+public:
+    PpsPairer();
+
+    /**
+     * @brief Set the clock to discipline, may be nullptr
+     */
+    void begin(SweepClock* clock);
+
+    /**
+     * @brief Feed one NMEA character
+     * @return true if it completed an RMC sentence naming a whole second
+     */
+    bool encode(char c);
+
+    /**
+     * @brief UTC second named by the last sentence encode() accepted
+     * @return Seconds since 1970
+     */
+    int64_t getUtcSecond() const;
+
+    /**
+     * @brief Hand the clock the latest PPS edge if the last sentence names it
+     * @param count PPS edges seen since boot
+     * @param edgeUs Local time of the latest edge
+     * @param nowUs Current local time
+     * @return true if the edge was paired
+     */
+    bool pairPulse(uint32_t count, int64_t edgeUs, int64_t nowUs);
+
+private:
+    SweepClock* clock;
+    char sentence[NMEA_SENTENCE_MAX + 1];
+    int length;                    // -1 until the next '$'
+    int64_t utcSecond;
+    uint32_t pairedPulse;          // Count of the last edge paired
+
+    /**
+     * @brief Check and parse a complete sentence into utcSecond
+     */
+    bool parseRmc();
+};
+
+#endif // PPS_PAIRER_H
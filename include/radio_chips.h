@@ -0,0 +1,59 @@
+/**
+ * @file radio_chips.h
+ * @brief Chip constants shared by the BandScanner traits
+ *
+ * What a BandScanner needs to know about a chip that does not involve
+ * talking to it: its command frames, settling time, bandwidths and
+ * frequency register scaling. The board's traits in radio_traits.h add
+ * the driver and SPI on top; host tests add a simulated radio instead,
+ * so both run the same frames and frequency words.
+ *
+ * Host-compilable: no Arduino or RadioLib calls.
+ */
+
+#ifndef RADIO_CHIPS_H
+#define RADIO_CHIPS_H
+
+#include <stdint.h>
+#include "config.h"
+#include "radio_commands.h"
+
+// Semtech SX126x (SX1262, 150-960 MHz)
+struct SX126xChip {
+    typedef SX126xCommands Commands;
+    static const uint32_t SETTLE_US = RSSI_SETTLE_US_SX126X;
+    static const bool SPECTRAL_SCAN = true;
+    static const int BANDWIDTH_COUNT = 10;
+
+    static float bandwidthKHz(int i) {
+        static const float bandwidths[BANDWIDTH_COUNT] = {
+            7.8f, 10.4f, 15.6f, 20.8f, 31.25f, 41.7f, 62.5f, 125.0f, 250.0f, 500.0f
+        };
+        return bandwidths[i];
+    }
+
+    // 32 MHz crystal: f * 2^25 / 32e6
+    static constexpr uint32_t frequencyWord(double freqMHz) {
+        return (uint32_t)(freqMHz * (1UL << 25) / 32.0 + 0.5);
+    }
+};
+
+// Semtech SX128x (SX1280, 2.4 GHz)
+struct SX128xChip {
+    typedef SX128xCommands Commands;
+    static const uint32_t SETTLE_US = RSSI_SETTLE_US_SX128X;
+    static const bool SPECTRAL_SCAN = false;
+    static const int BANDWIDTH_COUNT = 4;
+
+    static float bandwidthKHz(int i) {
+        static const float bandwidths[BANDWIDTH_COUNT] = { 203.125f, 406.25f, 812.5f, 1625.0f };
+        return bandwidths[i];
+    }
+
+    // 52 MHz crystal: f * 2^18 / 52e6
+    static constexpr uint32_t frequencyWord(double freqMHz) {
+        return (uint32_t)(freqMHz * (1UL << 18) / 52.0 + 0.5);
+    }
+};
+
+#endif // RADIO_CHIPS_H
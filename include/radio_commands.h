@@ -0,0 +1,103 @@
+/**
+ * @file radio_commands.h
+ * @brief Pre-built SPI command frames for a retune-and-sample step
+ *
+ * A sweep step through the driver is several separate calls, each its own
+ * SPI transaction with its own BUSY wait, and startReceive() also rewrites
+ * IRQ and buffer setup that never changes during a sweep. Here the step is
+ * four raw frames built once per scanner:
+ *
+ *   tune        SetRfFrequency, patched per channel
+ *   receive     SetRx, continuous
+ *   read RSSI   GetRssiInst
+ *   standby     SetStandby (RC)
+ *
+ * The frames are clocked out back to back by the radio traits, each once
+ * BUSY drops. Only the frequency word changes between channels.
+ *
+ * Host-compilable: no Arduino or RadioLib calls.
+ */
+
+#ifndef RADIO_COMMANDS_H
+#define RADIO_COMMANDS_H
+
+#include <stdint.h>
+
+// SX126x opcodes (SX1261/2 datasheet, section 13)
+#define SX126X_OP_SET_STANDBY 0x80
+#define SX126X_OP_SET_RX 0x82
+#define SX126X_OP_SET_RF_FREQUENCY 0x86
+#define SX126X_OP_GET_RSSI_INST 0x15
+
+// SX128x opcodes (SX1280/1 datasheet, section 11)
+#define SX128X_OP_SET_STANDBY 0x80
+#define SX128X_OP_SET_RX 0x82
+#define SX128X_OP_SET_RF_FREQUENCY 0x86
+#define SX128X_OP_GET_RSSI_INST 0x1F
+
+// Longest frame: SX126x SetRfFrequency, opcode and 4 bytes
+#define RADIO_COMMAND_MAX 5
+
+// One SPI frame and what came back while it was clocked out
+struct RadioCommand {
+    uint8_t bytes[RADIO_COMMAND_MAX];
+    uint8_t reply[RADIO_COMMAND_MAX];
+    uint8_t length;
+};
+
+// Frames of a retune-and-sample step, in the order they are sent
+enum RadioStepCommand {
+    RADIO_STEP_TUNE = 0,
+    RADIO_STEP_RECEIVE,
+    RADIO_STEP_READ_RSSI,
+    RADIO_STEP_STANDBY,
+    RADIO_STEP_COMMANDS
+};
+
+struct RadioStep {
+    RadioCommand commands[RADIO_STEP_COMMANDS];
+};
+
+// Semtech SX126x frames
+struct SX126xCommands {
+    /**
+     * @brief Build all frames of a step
+     * @param word Frequency register value for the tune frame
+     */
+    static void buildStep(RadioStep& step, uint32_t word);
+
+    /**
+     * @brief Point the tune frame at another frequency
+     */
+    static void setFrequency(RadioStep& step, uint32_t word);
+
+    /**
+     * @brief Decode a sent read-RSSI frame
+     * @param dbm Instantaneous RSSI
+     * @return false if the chip was not receiving, e.g. it rejected the tune
+     */
+    static bool parseRssi(const RadioCommand& read, float& dbm);
+};
+
+// Semtech SX128x frames
+struct SX128xCommands {
+    /**
+     * @brief Build all frames of a step
+     * @param word Frequency register value for the tune frame
+     */
+    static void buildStep(RadioStep& step, uint32_t word);
+
+    /**
+     * @brief Point the tune frame at another frequency
+     */
+    static void setFrequency(RadioStep& step, uint32_t word);
+
+    /**
+     * @brief Decode a sent read-RSSI frame
+     * @param dbm Instantaneous RSSI
+     * @return false if the chip was not receiving, e.g. it rejected the tune
+     */
+    static bool parseRssi(const RadioCommand& read, float& dbm);
+};
+
+#endif // RADIO_COMMANDS_H
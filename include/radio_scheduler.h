@@ -0,0 +1,70 @@
+/**
+ * @file radio_scheduler.h
+ * @brief Time-slot plan sharing the SX1262 between sweeps and the mesh
+ *
+ * A frame is MESH_SWEEPS_PER_WINDOW sweep slots followed by one fixed
+ * MESH_WINDOW_MS mesh window, so the band revisit time only depends on
+ * the sweep time and never on mesh traffic.
+ */
+
+#ifndef RADIO_SCHEDULER_H
+#define RADIO_SCHEDULER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "mesh_link.h"
+
+// What the radio should do in the next slot
+enum RadioSlot {
+    SLOT_SWEEP = 0,
+    SLOT_MESH
+};
+
+class RadioScheduler {
+public:
+    RadioScheduler();
+
+    /**
+     * @brief Attach the mesh link that mesh windows are given to
+     * @param nowMs Start of the first frame
+     */
+    void begin(MeshLink* mesh, uint32_t nowMs);
+
+    /**
+     * @brief Get the kind of the next slot
+     */
+    RadioSlot nextSlot();
+
+    /**
+     * @brief Mark a sweep slot as finished (whether or not a sweep ran)
+     */
+    void slotCompleted();
+
+    /**
+     * @brief Run the mesh window and start a new frame
+     */
+    void runMeshWindow();
+
+    /**
+     * @brief Duration of the last complete frame in ms
+     */
+    uint32_t getFrameMs();
+
+    /**
+     * @brief Sweep slots run since the last mesh window
+     */
+    int getSlotsInFrame();
+
+    /**
+     * @brief Resume mid-frame, e.g. after a warm restart
+     */
+    void setSlotsInFrame(int slots);
+
+private:
+    MeshLink* mesh;
+    int slotsInFrame;
+    uint32_t frameStart;
+    uint32_t frameMs;
+};
+
+#endif // RADIO_SCHEDULER_H
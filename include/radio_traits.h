@@ -0,0 +1,117 @@
+/**
+ * @file radio_traits.h
+ * @brief BandScanner traits for the radios on the T-Beam S3
+ *
+ * Retuning writes the frequency register directly. The driver's
+ * setFrequency() also reruns image calibration on the SX126x, which
+ * costs milliseconds per channel; calibrate() covers the whole plan once
+ * instead.
+ *
+ * Sweep steps skip the driver altogether: the pre-built frames of
+ * radio_commands.h go out back to back in one SPI transaction.
+ *
+ * Chip constants (frames, settling, bandwidths, frequency words) are in
+ * radio_chips.h; these traits add the driver and the bus.
+ */
+
+#ifndef RADIO_TRAITS_H
+#define RADIO_TRAITS_H
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <SPI.h>
+#include "config.h"
+#include "radio_chips.h"
+#include "band_scanner.h"
+
+// Waiting and raw SPI shared by every chip on this board
+struct ArduinoRadioTraits {
+    static void delayUs(uint32_t us) {
+        // Whole ticks go to other tasks; only the remainder busy-waits
+        if (us >= 1000) vTaskDelay(pdMS_TO_TICKS(us / 1000));
+        delayMicroseconds(us % 1000);
+    }
+
+    static uint32_t nowUs() {
+        return micros();
+    }
+
+    // Clock out frames under one bus claim, each once BUSY is low; the
+    // chip holds BUSY while it carries out the previous frame
+    template <typename Radio>
+    static bool transfer(Radio& radio, RadioCommand* commands, int count) {
+        Module* mod = radio.getMod();
+        uint32_t cs = mod->getCs();
+        uint32_t busy = mod->getGpio();
+
+        bool ok = true;
+        SPI.beginTransaction(SPISettings(RADIO_SPI_HZ, MSBFIRST, SPI_MODE0));
+        for (int i = 0; i < count && ok; i++) {
+            uint32_t start = micros();
+            while (digitalRead(busy) == HIGH) {
+                if (micros() - start > RADIO_BUSY_TIMEOUT_US) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (!ok) break;
+
+            digitalWrite(cs, LOW);
+            SPI.transferBytes(commands[i].bytes, commands[i].reply, commands[i].length);
+            digitalWrite(cs, HIGH);
+        }
+        SPI.endTransaction();
+        return ok;
+    }
+};
+
+// SX1262 on the 900MHz plan
+struct SX126xTraits : ArduinoRadioTraits, SX126xChip {
+    typedef SX1262 Radio;
+
+    static bool tune(Radio& radio, uint32_t word) {
+        uint8_t data[4] = { (uint8_t)(word >> 24), (uint8_t)(word >> 16),
+                            (uint8_t)(word >> 8), (uint8_t)word };
+        return radio.getMod()->SPIwriteStream(RADIOLIB_SX126X_CMD_SET_RF_FREQUENCY,
+                                              data, 4) == RADIOLIB_ERR_NONE;
+    }
+
+    static float readRssi(Radio& radio) {
+        return radio.getRSSI(false);  // GetRssiInst, not the last packet
+    }
+
+    // Image rejection over the span, in 4 MHz units
+    static bool calibrate(Radio& radio, float loMHz, float hiMHz) {
+        uint8_t data[2] = { (uint8_t)(loMHz / 4), (uint8_t)ceilf(hiMHz / 4) };
+        return radio.getMod()->SPIwriteStream(RADIOLIB_SX126X_CMD_CALIBRATE_IMAGE,
+                                              data, 2) == RADIOLIB_ERR_NONE;
+    }
+};
+
+// SX1280 on the 2.4GHz plan
+struct SX128xTraits : ArduinoRadioTraits, SX128xChip {
+    typedef SX1280 Radio;
+
+    static bool tune(Radio& radio, uint32_t word) {
+        uint8_t data[3] = { (uint8_t)(word >> 16), (uint8_t)(word >> 8), (uint8_t)word };
+        return radio.getMod()->SPIwriteStream(RADIOLIB_SX128X_CMD_SET_RF_FREQUENCY,
+                                              data, 3) == RADIOLIB_ERR_NONE;
+    }
+
+    // GetRssiInst; the driver's getRSSI() reports the last packet
+    static float readRssi(Radio& radio) {
+        uint8_t raw = 0;
+        radio.getMod()->SPIreadStream(RADIOLIB_SX128X_CMD_GET_RSSI_INST, &raw, 1);
+        return -(float)raw / 2;
+    }
+
+    // No image calibration on the SX128x
+    static bool calibrate(Radio&, float, float) {
+        return true;
+    }
+};
+
+typedef BandScanner<SX126xTraits, Plan900> Scanner900;
+typedef BandScanner<SX128xTraits, Plan2400> Scanner2400;
+
+#endif // RADIO_TRAITS_H
@@ -0,0 +1,43 @@
+/**
+ * @file radiolib_mesh_transport.h
+ * @brief MeshTransport on the SX1262 shared with the 900MHz sweep
+ */
+
+#ifndef RADIOLIB_MESH_TRANSPORT_H
+#define RADIOLIB_MESH_TRANSPORT_H
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include "config.h"
+#include "mesh_transport.h"
+
+class RadioLibMeshTransport : public MeshTransport {
+public:
+    RadioLibMeshTransport();
+
+    /**
+     * @brief Attach the radio owned by RFScanner
+     * @param radio May be nullptr, which leaves the mesh unusable
+     */
+    void setRadio(SX1262* radio);
+
+    bool configure() override;
+    uint16_t getNodeId() override;
+    bool setFrequency(float freq) override;
+    uint32_t getTimeOnAir(size_t len) override;
+    bool transmit(const uint8_t* data, size_t len) override;
+    bool isChannelBusy() override;
+    bool startReceive() override;
+    size_t readPacket(uint8_t* data, size_t maxLen) override;
+    void standby() override;
+    uint32_t nowMs() override;
+    void idle(uint32_t ms) override;
+
+private:
+    SX1262* radio;
+
+    static volatile bool packetFlag;
+    static void IRAM_ATTR onDio1();
+};
+
+#endif // RADIOLIB_MESH_TRANSPORT_H
@@ -2,7 +2,9 @@
  * @file rf_scanner.h
  * @brief RF Scanner module for drone frequency detection
  * 
- * Uses RadioLib to scan 900MHz (SX1262) and 2.4GHz (SX1280) bands
+ * Uses RadioLib to scan 900MHz (SX1262) and 2.4GHz (SX1280) bands. The
+ * per-chip measurement loops are BandScanner specialisations
+ * (radio_traits.h); everything after a row is measured is band-agnostic.
  */
 
 #ifndef RF_SCANNER_H
@@ -11,6 +13,36 @@
 #include <Arduino.h>
 #include <RadioLib.h>
 #include "config.h"
+#include "sweep_kernels.h"
+#include "band_analyzer.h"
+#include "spur_mask.h"
+#include "seqlock.h"
+#include "spectral_scan.h"
+#include "sweep_clock.h"
+#include "radio_traits.h"
+
+struct WarmSnapshot;
+class Watchlist;
+class DisplayUI;
+
+// Operator position stamped onto detections, published by the loop
+struct ObserverPosition {
+    float latitude;                // Degrees
+    float longitude;
+    bool valid;
+};
+
+// Scanner state as of the end of one sweep; readers get a consistent copy
+struct ScanSnapshot {
+    uint32_t version;              // Publishes since boot
+    uint32_t timestamp;            // millis() when published
+    uint8_t band;                  // Band of the sweep that produced it
+    uint32_t sweeps[2];            // Completed sweeps per band
+    int signalCount;
+    DetectedSignal signals[MAX_DETECTED_SIGNALS];
+    int8_t rows[2][SWEEP_ROW_MAX]; // Last completed row per band
+    int64_t rowUtcUs[2];           // UTC of channel 0 of each row (0 = not aligned)
+};
 
 class RFScanner {
 public:
@@ -23,25 +55,142 @@ public:
     bool begin();
     
     /**
-     * @brief Scan 900MHz band for signals
+     * @brief Initialize the SX1262 (900MHz) radio only
+     *
+     * begin900() and begin2400() may run in separate tasks at the same
+     * time once SPI.begin() has been called.
+     * @return true if the radio is ready
+     */
+    bool begin900();
+    
+    /**
+     * @brief Initialize the SX1280 (2.4GHz) radio only
+     * @return true if the radio is ready
+     */
+    bool begin2400();
+    
+    /**
+     * @brief Get a band's measured sweep rate
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @return Sweeps per second over the last SWEEP_RATE_WINDOW_MS
+     */
+    float getSweepRate(uint8_t band);
+    
+    /**
+     * @brief Get time from power-on to the end of the first sweep
+     * @return Milliseconds since boot, or 0 if no sweep has completed
+     */
+    uint32_t getFirstSweepMs();
+    
+    /**
+     * @brief Copy noise floors, sweep counters and signals into a snapshot
+     */
+    void exportState(WarmSnapshot& snap);
+    
+    /**
+     * @brief Restore state from a snapshot taken before sleep or reboot
+     *
+     * Each signal keeps the hold time it had left, less the time spent
+     * asleep, counted from now; those with none left are dropped.
+     * @param snap Validated snapshot
+     * @param elapsedMs Time between the snapshot and now
+     */
+    void importState(const WarmSnapshot& snap, uint32_t elapsedMs);
+    
+    /**
+     * @brief Put both radios into their lowest-power sleep mode
+     */
+    void sleep();
+    
+    /**
+     * @brief Check every sweep sample against a watchlist as it is measured
+     * @param watchlist Watchlist, or nullptr to stop checking
+     */
+    void setWatchlist(Watchlist* watchlist);
+    
+    /**
+     * @brief Tag samples taken during display flushes for the spur learner
+     * @param ui Display, or nullptr to stop tagging
+     */
+    void setDisplay(DisplayUI* ui);
+    
+    /**
+     * @brief Rebuild both bands' always-on spur entries from the next sweeps
+     * @param rows Sweeps per band
+     */
+    void calibrateSpurs(int rows);
+    
+    /**
+     * @brief Forget both bands' spur masks
+     */
+    void clearSpurs();
+    
+    /**
+     * @brief Get a band's spur mask; read it with the radios acquired
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     */
+    const SpurMask& getSpurMask(uint8_t band);
+    
+    /**
+     * @brief Sweep a band for signals
+     * @param band Band (0=900MHz, 1=2.4GHz)
      * @return Number of signals detected
      */
-    int scan900MHz();
+    int scan(uint8_t band);
     
     /**
-     * @brief Scan 2.4GHz band for signals
+     * @brief Sweep a band on the shared UTC timeline
+     *
+     * Channel k is sampled at startUtcUs + k * SYNC_DWELL_US, so every
+     * locked unit measures the same channel at the same moment.
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param startUtcUs Slot start, us since 1970
      * @return Number of signals detected
      */
-    int scan2400MHz();
+    int scanAt(uint8_t band, int64_t startUtcUs);
+    
+    /**
+     * @brief Set the clock aligned sweeps are paced by
+     */
+    void setClock(SweepClock* clock);
+    
+    /**
+     * @brief Get number of aligned samples that missed their dwell
+     *
+     * Late: started more than SYNC_LATE_US after the dwell began, or still
+     * running when it ended. Detections peaking on one carry no UTC stamp.
+     */
+    uint32_t getLateSamples();
     
     /**
      * @brief Get detected signals array
+     *
+     * Live tracker state, only safe to use from the task that sweeps;
+     * everything else should read getSnapshot().
      * @return Pointer to detected signals array
      */
     DetectedSignal* getDetectedSignals();
     
+    /**
+     * @brief Copy the latest published sweep and tracker state
+     *
+     * Never blocks the scanner and never returns a half-updated copy;
+     * safe from any task.
+     * @param out Snapshot to fill
+     * @return Version of the copied snapshot
+     */
+    uint32_t getSnapshot(ScanSnapshot& out);
+    
+    /**
+     * @brief Version of the latest snapshot, to skip copies when unchanged
+     */
+    uint32_t getSnapshotVersion();
+    
     /**
      * @brief Get number of currently detected signals
+     *
+     * Live tracker state like getDetectedSignals(); other tasks should
+     * use the snapshot's signalCount.
      * @return Number of active signals
      */
     int getSignalCount();
@@ -70,28 +219,226 @@ public:
     float getCurrentFrequency();
     
     /**
-     * @brief Analyze modulation type of detected signal
-     * @param freq Frequency to analyze
+     * @brief Classify the emitter on a channel of the last sweep
+     *
+     * Uses the trained decision table (classifier.h) on statistics the
+     * sweep already has; takes no extra measurements.
      * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param channel Channel index
      * @return Detected modulation type
      */
-    ModulationType analyzeModulation(float freq, uint8_t band);
+    ModulationType analyzeModulation(uint8_t band, int channel);
+    
+    /**
+     * @brief Get the RSSI row recorded by the last completed sweep
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @return Pointer to one int8 dBm value per channel
+     */
+    const int8_t* getSweepRow(uint8_t band);
+    
+    /**
+     * @brief Get which channels of the last completed sweep were above threshold
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @return Pointer to one flag per channel, nonzero above threshold
+     */
+    const uint8_t* getHitRow(uint8_t band);
+    
+    /**
+     * @brief Get number of channels in a band's sweep row
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @return Channel count
+     */
+    int getChannelCount(uint8_t band);
+    
+    /**
+     * @brief Get number of completed sweeps of a band
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @return Sweep counter
+     */
+    uint32_t getSweepCount(uint8_t band);
+    
+    /**
+     * @brief Get the max-hold row since the last reset
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     */
+    const int8_t* getMaxHoldRow(uint8_t band);
+    
+    /**
+     * @brief Restart max-hold on both bands
+     */
+    void resetMaxHold();
+    
+    /**
+     * @brief Get a channel's tracked noise floor
+     * @return Noise floor in dBm
+     */
+    float getNoiseFloor(uint8_t band, int channel);
+    
+    /**
+     * @brief Replace a band's noise floors, e.g. with ones planned from a survey
+     * @param floors One per channel, NOISE_FLOOR_FRAC_BITS fixed point
+     */
+    void setNoiseFloors(uint8_t band, const int16_t* floors);
+    
+    /**
+     * @brief Get a channel's RSSI variance over the last SWEEP_HISTORY sweeps
+     * @return Variance in dB^2
+     */
+    uint16_t getChannelVariance(uint8_t band, int channel);
+    
+    /**
+     * @brief Get the share of a channel's last samples above its threshold
+     *
+     * From the hardware histogram on the SX1262; a single read (0 or 100)
+     * elsewhere.
+     * @return Occupancy in percent
+     */
+    uint8_t getChannelOccupancy(uint8_t band, int channel);
+    
+    /**
+     * @brief Get a channel's mean level over its last samples
+     * @return Mean in dBm
+     */
+    int8_t getChannelMean(uint8_t band, int channel);
+    
+    /**
+     * @brief Check if the 900MHz sweep uses the hardware spectral scan
+     */
+    bool isSpectralScanActive();
+    
+    /**
+     * @brief Get a channel's centre frequency
+     * @return Frequency in MHz
+     */
+    float getChannelFrequency(uint8_t band, int channel);
+    
+    /**
+     * @brief Get the SX1262 for time-shared use between sweeps
+     * @return Radio, or nullptr if the SX1262 is not available
+     */
+    SX1262* getRadio900();
+    
+    /**
+     * @brief Set the position stamped onto new detections
+     * @param latitude Degrees
+     * @param longitude Degrees
+     * @param valid false when there is no GPS fix
+     */
+    void setPosition(float latitude, float longitude, bool valid);
+    
+    /**
+     * @brief Park a radio on one frequency and sample RSSI at a fixed rate
+     *
+     * Sampling is paced by a hardware timer. If an RSSI read overruns a
+     * tick, the reading is repeated for the missed ticks so the time base
+     * stays exact.
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param freq Frequency in MHz
+     * @param samples Output buffer of int8 dBm values
+     * @param count Number of samples to take
+     * @param sampleRateHz Sample rate
+     * @return Number of ticks that overran, or -1 on failure
+     */
+    int captureZeroSpan(uint8_t band, float freq, int8_t* samples, int count, uint32_t sampleRateHz);
+    
+    /**
+     * @brief Tune to one frequency, take a few RSSI reads back to back
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param freq Frequency in MHz
+     * @param reads Number of reads
+     * @param peakDbm Strongest read, as a sweep row value
+     * @return false if the radio is unavailable or rejected the frequency
+     */
+    bool dwell(uint8_t band, float freq, int reads, int8_t& peakDbm);
+    
+    /**
+     * @brief Time the SPI side of sweep steps, driver calls against frames
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param driverUs Mean SPI time per step through the driver
+     * @param framesUs Mean SPI time per step through the pre-built frames
+     * @return false if the radio is unavailable
+     */
+    bool timeSpiSteps(uint8_t band, uint32_t& driverUs, uint32_t& framesUs);
+    
+    /**
+     * @brief Override a detected signal's modulation with a burst-timing result
+     *
+     * Later sweeps keep this modulation instead of their own estimate.
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param freq Frequency in MHz
+     * @param mod Modulation from the burst fingerprint
+     */
+    void setSignalModulation(uint8_t band, float freq, ModulationType mod);
+    
 
 private:
     SX1262* radio900;           // 900MHz LoRa radio
     SX1280* radio2400;          // 2.4GHz radio (optional)
+    Scanner900 scanner900;
+    Scanner2400 scanner2400;
+    SpectralRadio* spectralRadio;  // Set once the scan patch is loaded
+    SpectralScan spectral;
+    SweepClock* clock;
+    uint32_t lateSamples;
     
     DetectedSignal signals[MAX_DETECTED_SIGNALS];
     int signalCount;
     float currentFreq;
     
-    bool sx1262Available;
-    bool sx1280Available;
+    // Per-band sweep row and the analytics derived from it
+    struct BandState {
+        BandAnalyzer analyzer;
+        SpurMask spurs;                    // The board's own spurs, fed by analyzer
+        int spurCount;                     // Masked channels when last logged
+        bool spurCalibrating;
+        int64_t rowUtcUs;                  // UTC of channel 0, 0 if not aligned
+        bool late[SWEEP_ROW_MAX];          // Aligned sample missed its dwell
+        uint32_t sweeps;
+        uint32_t rateWindowStart;          // millis() the rate window opened
+        uint32_t rateWindowSweeps;
+        float sweepRate;                   // Sweeps per second
+    };
+    
+    BandState bands[2];
+    
+    SeqLock<ObserverPosition> position;  // Set from the loop, read by the scan task
+    
+    volatile bool sx1262Available;  // Set by boot tasks, read by the loop
+    volatile bool sx1280Available;
+    uint32_t firstSweepMs;
+    Watchlist* watchlist;
+    DisplayUI* display;
+    
+    SeqLock<ScanSnapshot> published;
+    ScanSnapshot staging;          // Built here, then published
+    
+    /**
+     * @brief Publish the tracker and sweep rows after a change
+     *
+     * Single writer: only ever called from whichever task currently owns
+     * the radios.
+     * @param band Band the change came from
+     */
+    void publish(uint8_t band);
     
     /**
-     * @brief Add or update a detected signal
+     * @brief Reset a radio and read its status byte to see if it is fitted
+     *
+     * Much faster than letting the driver's begin() time out on a missing
+     * module.
+     * @param statusShift Position of the 3-bit chip mode in the status byte
+     * @return true if the chip answered in a valid mode
      */
-    void addSignal(float freq, float rssi, ModulationType mod, uint8_t band);
+    static bool probeRadio(Module& mod, int statusShift);
+    
+    /**
+     * @brief Add or update a detected emitter
+     *
+     * Matches an existing entry within 1 MHz or whose occupied band
+     * overlaps this one.
+     */
+    void addSignal(float freq, float bandwidth, float rssi, uint8_t occupancy,
+                   ModulationType mod, uint8_t band, int64_t utcUs);
     
     /**
      * @brief Remove stale signals that are no longer active
@@ -99,9 +446,42 @@ private:
     void cleanupSignals();
     
     /**
-     * @brief Measure RSSI at specific frequency
+     * @brief Measure a full band row, then detect on it
+     * @param startUtcUs Aligned slot start, or 0 to sweep at once
+     * @return Number of emitters found
+     */
+    int sweepBand(uint8_t band, int64_t startUtcUs);
+    
+    /**
+     * @brief Log a band's spur mask when it changes or calibration ends
+     */
+    void logSpurs(uint8_t band);
+    
+    /**
+     * @brief Measure every channel of a band into its row
+     *
+     * Instantiated once per radio, so the loop carries no band checks.
+     * @param startLocalUs Local time channel 0 is due, when aligned
+     */
+    template <typename Scanner>
+    void measureRow(Scanner& scanner, uint8_t band, bool aligned, int64_t startLocalUs);
+    
+    /**
+     * @brief Zero-span capture loop for one radio, see captureZeroSpan()
+     */
+    template <typename Scanner>
+    int zeroSpan(Scanner& scanner, float freq, int8_t* samples, int count, uint32_t sampleRateHz);
+    
+    /**
+     * @brief Dwell loop for one radio, see dwell()
+     */
+    template <typename Scanner>
+    bool dwellPeak(Scanner& scanner, float freq, int reads, int8_t& peakDbm);
+    
+    /**
+     * @brief Clamp a dBm reading into a sweep row cell
      */
-    float measureRSSI(float freq, uint8_t band);
+    static int8_t toRowValue(float rssi);
 };
 
 #endif // RF_SCANNER_H
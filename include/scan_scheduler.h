@@ -0,0 +1,123 @@
+/**
+ * @file scan_scheduler.h
+ * @brief Background scan task that owns the radios
+ *
+ * Sweeps run continuously in their own task, rotating through the bands
+ * by SCAN_WEIGHT_900 / SCAN_WEIGHT_2400, with mesh windows slotted in by
+ * the RadioScheduler. What the screen shows has no effect on coverage.
+ * Anything else that needs a radio (burst capture, mesh setup, sleep)
+ * borrows both radios with acquireRadios() between slots.
+ *
+ * Once the GPS sweep clock is locked, sweeps instead start on shared UTC
+ * slot boundaries every SYNC_SLOT_MS, with the band picked from the slot
+ * number, so all locked units sweep the same band in the same order at
+ * the same time.
+ *
+ * While a LockOnTracker has a target, LOCK_SLOTS_PER_SWEEP slots of
+ * LOCK_SLOT_MS dwelling on it run between background sweeps, and sweeps
+ * run unaligned.
+ */
+
+#ifndef SCAN_SCHEDULER_H
+#define SCAN_SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "rf_scanner.h"
+#include "radio_scheduler.h"
+#include "flash_logger.h"
+#include "sweep_clock.h"
+#include "lock_on.h"
+
+/**
+ * @brief Called in the scan task after every sweep
+ * @param band Band swept (0=900MHz, 1=2.4GHz)
+ * @param sweepStart millis() when the sweep started
+ * @param detected Emitters found
+ */
+typedef void (*SweepHandler)(uint8_t band, uint32_t sweepStart, int detected);
+
+class ScanScheduler {
+public:
+    ScanScheduler();
+
+    /**
+     * @brief Start the scan task
+     * @param scanner Scanner to sweep with
+     * @param scheduler Slot plan for mesh windows
+     * @param logger Logger serviced between slots, may be nullptr
+     * @param handler Called after every sweep, may be nullptr
+     */
+    void begin(RFScanner* scanner, RadioScheduler* scheduler,
+               FlashLogger* logger, SweepHandler handler);
+
+    /**
+     * @brief Align sweeps to a disciplined clock whenever it is locked
+     * @param clock Clock, or nullptr to always sweep back to back
+     */
+    void setClock(SweepClock* clock);
+
+    /**
+     * @brief Give most radio time to a tracker's target while it has one
+     * @param tracker Tracker, or nullptr to always sweep
+     */
+    void setLockOn(LockOnTracker* tracker);
+
+    /**
+     * @brief Wait for the current slot to end and keep the radios
+     */
+    void acquireRadios();
+
+    /**
+     * @brief Hand the radios back to the scan task
+     */
+    void releaseRadios();
+
+private:
+    RFScanner* scanner;
+    RadioScheduler* scheduler;
+    FlashLogger* logger;
+    SweepHandler handler;
+    SweepClock* clock;
+    LockOnTracker* lockOn;
+    SemaphoreHandle_t radioLock;   // Held by the scan task for each slot
+    int rotationPos;
+    int lockSlots;                 // Lock-on slots since the last sweep
+
+    /**
+     * @brief Next band in the weighted rotation that has a radio
+     * @return Band, or -1 if neither radio is available
+     */
+    int nextBand();
+
+    /**
+     * @brief Band every locked unit sweeps in a UTC slot
+     * @return Band, or -1 if neither radio is available
+     */
+    int slotBand(int64_t slotUtcUs);
+
+    /**
+     * @brief Sleep until just before the next UTC slot if the clock is locked
+     * @return Slot start in UTC us, or 0 to sweep unaligned
+     */
+    int64_t waitForSlot();
+
+    /**
+     * @brief Run one sweep, lock-on or mesh slot
+     * @param slotUtcUs Aligned slot start, or 0
+     * @return true if the slot dwelt on the lock-on target
+     */
+    bool runSlot(int64_t slotUtcUs);
+
+    /**
+     * @brief Dwell on the lock-on target for LOCK_SLOT_MS
+     */
+    void runLockSlot();
+
+    /**
+     * @brief Scan task body
+     */
+    static void scanTask(void* arg);
+};
+
+#endif // SCAN_SCHEDULER_H
@@ -0,0 +1,77 @@
+/**
+ * @file seqlock.h
+ * @brief Single-writer, multi-reader publication of a value (seqlock latch)
+ *
+ * The writer keeps two copies and bumps a sequence counter before
+ * updating each one; readers always copy whichever copy is not being
+ * written and retry only if the writer moved on during their copy. The
+ * writer never blocks, readers never see a torn value, and a reader that
+ * preempts the writer mid-update still finishes without spinning.
+ *
+ * T must be trivially copyable. Only one task may call publish().
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+template <typename T>
+class SeqLock {
+public:
+    SeqLock() : sequence(0) {
+        memset(copies, 0, sizeof(copies));
+    }
+
+    /**
+     * @brief Publish a new value (single writer only)
+     */
+    void publish(const T& value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+
+        // Odd: readers use copies[1] while copies[0] is rewritten
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        memcpy(&copies[0], &value, sizeof(T));
+
+        // Even: readers use copies[0] while copies[1] catches up
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        sequence.store(seq + 2, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        memcpy(&copies[1], &value, sizeof(T));
+
+        // copies[1] must be complete before the next publish's odd store
+        // sends readers to it
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy out the latest complete value
+     * @return Number of publishes the value reflects
+     */
+    uint32_t read(T& out) const {
+        for (;;) {
+            uint32_t seq = sequence.load(std::memory_order_acquire);
+            memcpy(&out, &copies[seq & 1], sizeof(T));
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sequence.load(std::memory_order_relaxed) == seq) {
+                return seq / 2;
+            }
+        }
+    }
+
+    /**
+     * @brief Number of publishes so far, without copying
+     */
+    uint32_t getVersion() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    std::atomic<uint32_t> sequence;
+    T copies[2];
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,155 @@
+/**
+ * @file sim_mesh_medium.h
+ * @brief In-memory shared LoRa channel for running several MeshLinks on a host
+ *
+ * Each virtual node runs on its own thread with its own SimMeshTransport.
+ * Time is virtual and advances in lockstep: a node waiting in idle() only
+ * resumes once every other node has reached the same time, so packet
+ * overlaps are decided purely by virtual time and runs are repeatable.
+ *
+ * A packet reaches a node that was receiving on the same channel for its
+ * whole time on air. Channel activity detection sees a packet from its
+ * first instant and takes no time. Packets that overlap on the same channel collide and
+ * are lost at every receiver; there is no capture effect.
+ */
+
+#ifndef SIM_MESH_MEDIUM_H
+#define SIM_MESH_MEDIUM_H
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "mesh_transport.h"
+
+class SimMeshMedium {
+public:
+    SimMeshMedium();
+
+    /**
+     * @brief Add a node at the current virtual time
+     * @return Node index for the other calls
+     */
+    int join();
+
+    /**
+     * @brief Remove a node so the others no longer wait for it
+     */
+    void leave(int node);
+
+    /**
+     * @brief Virtual time of a node in ms
+     */
+    uint32_t now(int node);
+
+    /**
+     * @brief Advance a node's clock and wait for the others to catch up
+     */
+    void advance(int node, uint32_t ms);
+
+    /**
+     * @brief Put a packet on the air starting at the node's current time
+     */
+    void transmit(int node, float freq, const uint8_t* data, size_t len, uint32_t airMs);
+
+    /**
+     * @brief Check if another node's packet is on the air at the node's time
+     */
+    bool busy(int node, float freq);
+
+    /**
+     * @brief Start receiving on a channel
+     */
+    void startReceive(int node, float freq);
+
+    /**
+     * @brief Stop receiving
+     */
+    void standby(int node);
+
+    /**
+     * @brief Fetch the next packet that finished arriving at the node
+     * @return Packet length, or 0 if nothing arrived
+     */
+    size_t poll(int node, uint8_t* data, size_t maxLen);
+
+    /**
+     * @brief Number of packets put on the air
+     */
+    uint32_t getTransmissions();
+
+    /**
+     * @brief Number of packets lost to an overlapping transmission
+     */
+    uint32_t getCollisions();
+
+    /**
+     * @brief Number of packets handed to a receiver
+     */
+    uint32_t getDeliveries();
+
+private:
+    struct Node {
+        uint32_t time;
+        bool active;
+        bool receiving;
+        float freq;
+        uint32_t rxSince;          // Start of the current receive
+        uint32_t delivered;        // Packets ending up to here were handled
+    };
+
+    struct Packet {
+        int from;
+        float freq;
+        uint32_t start;
+        uint32_t end;
+        bool collided;
+        std::vector<uint8_t> data;
+    };
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<Node> nodes;
+    std::vector<Packet> air;
+    uint32_t transmissions;
+    uint32_t collisions;
+    uint32_t deliveries;
+
+    /**
+     * @brief Check if every other active node has reached a time
+     */
+    bool othersReached(int node, uint32_t time);
+};
+
+class SimMeshTransport : public MeshTransport {
+public:
+    /**
+     * @brief Join a medium as a node with the given ID
+     */
+    SimMeshTransport(SimMeshMedium* medium, uint16_t nodeId);
+
+    /**
+     * @brief Leave the medium; call when the node's thread finishes
+     */
+    void leave();
+
+    bool configure() override;
+    uint16_t getNodeId() override;
+    bool setFrequency(float freq) override;
+    uint32_t getTimeOnAir(size_t len) override;
+    bool transmit(const uint8_t* data, size_t len) override;
+    bool isChannelBusy() override;
+    bool startReceive() override;
+    size_t readPacket(uint8_t* data, size_t maxLen) override;
+    void standby() override;
+    uint32_t nowMs() override;
+    void idle(uint32_t ms) override;
+
+private:
+    SimMeshMedium* medium;
+    int node;
+    uint16_t nodeId;
+    float freq;
+};
+
+#endif // SIM_MESH_MEDIUM_H
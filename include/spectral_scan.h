@@ -0,0 +1,156 @@
+/**
+ * @file spectral_scan.h
+ * @brief Hardware spectral scan: per-channel RSSI histograms from the radio
+ *
+ * The SX126x can sample RSSI on its own and bin the results into a
+ * histogram while the CPU sleeps. SpectralScan runs one such scan per
+ * channel (start, wait, poll, collect) and reduces the histogram to peak,
+ * mean and occupancy. The radio is reached through SpectralRadio so the
+ * state machine has no Arduino or RadioLib dependency and can be driven
+ * by a mock radio on the host.
+ */
+
+#ifndef SPECTRAL_SCAN_H
+#define SPECTRAL_SCAN_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Histogram size returned by the SX126x scan patch
+#define SPECTRAL_BINS 33
+
+// Summary of one channel's histogram
+struct SpectralStats {
+    int8_t peakDbm;                // Strongest occupied bin
+    int8_t meanDbm;                // Sample-weighted mean level
+    uint8_t occupancy;             // Samples above threshold (%)
+    uint16_t samples;              // Samples in the histogram
+};
+
+enum SpectralState {
+    SPECTRAL_IDLE,                 // No scan running
+    SPECTRAL_SCANNING,             // Radio is collecting samples
+    SPECTRAL_READY,                // Histogram waiting to be collected
+    SPECTRAL_TIMEOUT               // Scan never completed; radio stopped
+};
+
+/**
+ * @brief Radio operations the spectral scan needs
+ */
+class SpectralRadio {
+public:
+    virtual ~SpectralRadio() {}
+
+    /**
+     * @brief Tune and start a hardware scan
+     * @return true if the scan started
+     */
+    virtual bool start(float freq, uint16_t samples) = 0;
+
+    /**
+     * @brief Check whether the running scan has completed
+     */
+    virtual bool finished() = 0;
+
+    /**
+     * @brief Read the completed histogram
+     * @param bins SPECTRAL_BINS counts, strongest level first
+     */
+    virtual bool readHistogram(uint16_t* bins) = 0;
+
+    /**
+     * @brief Abort a scan and leave the radio in standby
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Yield the CPU for about this long
+     */
+    virtual void sleepUs(uint32_t us) = 0;
+
+    /**
+     * @brief Free-running microsecond clock
+     */
+    virtual uint32_t nowUs() = 0;
+};
+
+class SpectralScan {
+public:
+    SpectralScan();
+
+    /**
+     * @brief Attach a radio and set the per-channel scan length
+     * @param radio Radio backend
+     * @param samples RSSI samples per channel
+     * @param sampleUs Hardware time per sample, sets the first wait
+     * @param timeoutUs Give up on a scan after this long
+     */
+    void begin(SpectralRadio* radio, uint16_t samples, uint32_t sampleUs, uint32_t timeoutUs);
+
+    /**
+     * @brief Start scanning a channel
+     * @return false if a scan is already running or the radio refused
+     */
+    bool start(float freq);
+
+    /**
+     * @brief Advance a running scan
+     * @return SPECTRAL_READY once the histogram can be collected,
+     *         SPECTRAL_TIMEOUT if the scan was abandoned
+     */
+    SpectralState poll();
+
+    /**
+     * @brief Read and reduce a ready histogram, returning to idle
+     * @param threshold Occupancy threshold in dBm
+     * @param out Result
+     * @return false if no histogram was ready or the read failed
+     */
+    bool collect(int8_t threshold, SpectralStats& out);
+
+    /**
+     * @brief Scan one channel start to finish, sleeping while the radio works
+     * @return false on timeout or radio error
+     */
+    bool measure(float freq, int8_t threshold, SpectralStats& out);
+
+    /**
+     * @brief Current state
+     */
+    SpectralState getState();
+
+    /**
+     * @brief Scans collected since begin()
+     */
+    uint32_t getScanCount();
+
+    /**
+     * @brief Scans abandoned since begin()
+     */
+    uint32_t getTimeoutCount();
+
+private:
+    SpectralRadio* radio;
+    SpectralState state;
+    uint16_t samples;
+    uint32_t expectedUs;
+    uint32_t timeoutUs;
+    uint32_t startUs;
+    uint32_t scanCount;
+    uint32_t timeoutCount;
+};
+
+/**
+ * @brief Reduce a scan histogram
+ * @param bins SPECTRAL_BINS counts, strongest level first
+ * @param threshold Occupancy threshold in dBm
+ * @param out Result; peak and mean are -128 for an empty histogram
+ */
+void reduceSpectralHistogram(const uint16_t* bins, int8_t threshold, SpectralStats& out);
+
+/**
+ * @brief Approximate level of a histogram bin in dBm
+ */
+int spectralBinDbm(int bin);
+
+#endif // SPECTRAL_SCAN_H
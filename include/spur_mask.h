@@ -0,0 +1,141 @@
+/**
+ * @file spur_mask.h
+ * @brief Learned mask of the board's own narrowband spurs
+ *
+ * The S3's clocks and the display's I2C traffic put narrow lines into
+ * both bands. Steady ones never become their channel's noise floor (hits
+ * don't lift floors), so without a mask they are permanent detections.
+ *
+ * Two ways in:
+ * - calibrate() watches the next rows and masks channels with a narrow
+ *   peak in at least SPUR_PERSIST_PERCENT of them (SPUR_ALWAYS).
+ * - The background learner compares every channel's narrow peaks in
+ *   samples taken during board activity (a display flush) with those
+ *   taken without. Peaks that follow the activity are ours; an outside
+ *   emitter doesn't know when the display flushes. Each SPUR_LEARN_ROWS
+ *   window sets or clears the channel's activity bit.
+ *
+ * Each bit keeps the spur's mean peak as it was learned. A masked
+ * channel's threshold is raised SPUR_MARGIN_DB above the levels that
+ * apply: the SPUR_ALWAYS level always, an activity level only for samples
+ * taken during that activity. A real emitter on the same channel still
+ * shows above the spur.
+ *
+ * BandAnalyzer calls learn() and apply() from the scan task; calibrate()
+ * and clear() come from the loop with the radios acquired.
+ *
+ * Host-compilable: no Arduino calls.
+ */
+
+#ifndef SPUR_MASK_H
+#define SPUR_MASK_H
+
+#include <stdint.h>
+#include "config.h"
+#include "band_analyzer.h"
+
+// Mask and activity bits; a sample's activity bits say what the board was
+// doing while it was taken
+#define SPUR_ALWAYS 0x01           // Spur present whatever the board does
+#define SPUR_DISPLAY 0x02          // Display flush in progress
+
+class SpurMask {
+public:
+    SpurMask();
+
+    /**
+     * @brief Forget the mask and everything learned
+     */
+    void clear();
+
+    /**
+     * @brief Rebuild the SPUR_ALWAYS entries from the next rows
+     * @param rows Rows to watch
+     */
+    void calibrate(int rows);
+
+    /**
+     * @brief Check if a calibration is still collecting rows
+     */
+    bool isCalibrating() const;
+
+    /**
+     * @brief Count one row's narrow peaks
+     * @param row Sweep row in dBm
+     * @param threshold Thresholds from the noise floors, before apply()
+     * @param activity Activity bits per channel
+     */
+    void learn(const int8_t* row, const int8_t* threshold, const uint8_t* activity, int channels);
+
+    /**
+     * @brief Raise thresholds on masked channels
+     * @param threshold Thresholds to raise in place
+     * @param activity Activity bits per channel
+     * @param masked Output, nonzero where a spur raised the threshold
+     * @return Number of channels raised
+     */
+    int apply(int8_t* threshold, const uint8_t* activity, uint8_t* masked, int channels) const;
+
+    /**
+     * @brief Mask bits of a channel, 0 if it is clear
+     */
+    uint8_t getFlags(int channel) const;
+
+    /**
+     * @brief Spur level of a masked channel in dBm, the highest of its bits
+     */
+    int8_t getLevel(int channel) const;
+
+    /**
+     * @brief Number of masked channels
+     */
+    int getCount() const;
+
+private:
+    int8_t level[SWEEP_ROW_MAX];           // dBm, highest of the set bits' levels
+    int8_t alwaysLevel[SWEEP_ROW_MAX];     // dBm, mean narrow peak at calibration
+    int8_t displayLevel[SWEEP_ROW_MAX];    // dBm, mean narrow peak during flushes
+    uint8_t flags[SWEEP_ROW_MAX];          // SPUR_* bits
+    int count;
+
+    // Background learner window
+    uint16_t activeSamples[SWEEP_ROW_MAX];
+    uint16_t activeHits[SWEEP_ROW_MAX];
+    int32_t activeSum[SWEEP_ROW_MAX];      // dBm of the active hits
+    uint16_t quietSamples[SWEEP_ROW_MAX];
+    uint16_t quietHits[SWEEP_ROW_MAX];
+    int learnRows;
+
+    // Calibration
+    uint16_t calibrateHits[SWEEP_ROW_MAX];
+    int32_t calibrateSum[SWEEP_ROW_MAX];
+    int calibrateRows;                     // Rows taken so far
+    int calibrateTarget;                   // 0 = not calibrating
+
+    /**
+     * @brief Set or clear activity bits from a full learner window
+     */
+    void closeWindow(int channels);
+
+    /**
+     * @brief Set SPUR_ALWAYS entries from a finished calibration
+     */
+    void finishCalibration(int channels);
+
+    /**
+     * @brief Recompute a channel's level from the bits still set
+     */
+    void updateLevel(int channel);
+
+    /**
+     * @brief Recount the masked channels
+     */
+    void recount(int channels);
+
+    /**
+     * @brief Check for a peak standing SPUR_NARROW_DB over its neighbours
+     */
+    static bool isNarrowPeak(const int8_t* row, const int8_t* threshold, int channel, int channels);
+};
+
+#endif // SPUR_MASK_H
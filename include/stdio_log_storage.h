@@ -0,0 +1,40 @@
+/**
+ * @file stdio_log_storage.h
+ * @brief LogStorage on a host directory, for tests and tools
+ *
+ * Paths given to the interface are taken relative to a root directory,
+ * so "/logs/00001.bin" lands in "<root>/logs/00001.bin".
+ */
+
+#ifndef STDIO_LOG_STORAGE_H
+#define STDIO_LOG_STORAGE_H
+
+#include "log_storage.h"
+
+#define STDIO_LOG_PATH_MAX 256
+
+class StdioLogStorage : public LogStorage {
+public:
+    /**
+     * @brief Create storage rooted at an existing host directory
+     */
+    explicit StdioLogStorage(const char* root);
+
+    bool mount() override;
+    bool exists(const char* path) override;
+    bool mkdir(const char* path) override;
+    bool remove(const char* path) override;
+    LogStorageFile* open(const char* path, bool append) override;
+    void close(LogStorageFile* file) override;
+    bool listDir(const char* path, LogDirVisitor visit, void* ctx) override;
+
+private:
+    char root[STDIO_LOG_PATH_MAX];
+
+    /**
+     * @brief Join the root and a storage path into a host path
+     */
+    void hostPath(const char* path, char* out, size_t len);
+};
+
+#endif // STDIO_LOG_STORAGE_H
@@ -0,0 +1,196 @@
+/**
+ * @file survey.h
+ * @brief Long-running site survey: per-channel max, min, mean and occupancy
+ *
+ * While running, every sweep row of both bands is added to integer
+ * accumulators with the sweep_kernels.h row kernels, so a sample costs
+ * the same after ten hours as after ten seconds. Occupancy counts sweeps
+ * in which the channel was above its detection threshold.
+ *
+ * Optionally the survey is also kept as a time series in a caller-given
+ * buffer (PSRAM on the unit): one bucket of max, mean and occupancy per
+ * channel every SURVEY_BUCKET_MS. When the buffer fills, neighbouring
+ * buckets are merged in pairs and the bucket length doubles, so the whole
+ * survey always fits at the best resolution the buffer allows. Each bucket
+ * keeps its sweep count per band, and merges weight the means and
+ * occupancy by it, so a short bucket closed by stop() counts for only the
+ * sweeps it holds.
+ *
+ * Only the scan task calls addRow(); start(), stop() and reset() come from
+ * the loop with the radios acquired, as do bucket reads. Readers take
+ * getView().
+ *
+ * Host-compilable: no Arduino calls, times are passed in.
+ */
+
+#ifndef SURVEY_H
+#define SURVEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "sweep_kernels.h"
+#include "band_analyzer.h"
+#include "seqlock.h"
+
+// Bytes per time bucket: max, mean and occupancy for every channel of both
+// bands, then each band's sweep count
+#define SURVEY_BUCKET_BYTES (3 * (CHANNELS_900 + CHANNELS_2400) + 2 * sizeof(uint32_t))
+
+// Survey controls from the UI or serial
+enum SurveyControl {
+    SURVEY_CTL_NONE = 0,
+    SURVEY_CTL_START,
+    SURVEY_CTL_STOP,
+    SURVEY_CTL_RESET
+};
+
+// One band's survey traces
+struct SurveyTrace {
+    int8_t maxHold[SWEEP_ROW_MAX];         // dBm
+    int8_t minHold[SWEEP_ROW_MAX];         // dBm
+    int16_t meanQ[SWEEP_ROW_MAX];          // dBm, NOISE_FLOOR_FRAC_BITS fraction
+    uint8_t occupancy[SWEEP_ROW_MAX];      // % of sweeps above threshold
+    uint32_t sweeps;
+};
+
+// Survey state as of the last row added
+struct SurveyView {
+    bool running;
+    uint32_t elapsedMs;            // Time spent running since reset()
+    uint16_t bucketCount;          // Closed time buckets
+    uint16_t bucketCapacity;
+    uint32_t bucketMs;             // Current bucket length
+    SurveyTrace bands[2];
+};
+
+class Survey {
+public:
+    Survey();
+
+    /**
+     * @brief Give the survey its time-bucket buffer and reset it
+     * @param buckets Buffer, or nullptr to keep totals only
+     * @param bytes Buffer size; whole SURVEY_BUCKET_BYTES buckets are used
+     */
+    void begin(uint8_t* buckets, size_t bytes);
+
+    /**
+     * @brief Start or resume accumulating
+     */
+    void start(uint32_t nowMs);
+
+    /**
+     * @brief Pause; the totals and buckets are kept
+     */
+    void stop(uint32_t nowMs);
+
+    /**
+     * @brief Clear all totals and buckets; a running survey keeps running
+     */
+    void reset(uint32_t nowMs);
+
+    /**
+     * @brief Check if rows are being accumulated
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Add one sweep row (scan task only)
+     * @param row Sweep row in dBm
+     * @param hits Nonzero where the row was above the detection threshold
+     */
+    void addRow(uint8_t band, const int8_t* row, const uint8_t* hits, uint32_t nowMs);
+
+    /**
+     * @brief Copy out the latest published traces
+     */
+    void getView(SurveyView& out) const;
+
+    /**
+     * @brief Copy one closed time bucket of one band
+     * @param index Bucket, 0 = oldest
+     * @param maxOut, meanOut dBm per channel
+     * @param occupancyOut % per channel
+     * @return false if there is no such bucket
+     *
+     * A band with no sweeps in the bucket reads max and mean -128 and
+     * occupancy 0.
+     */
+    bool getBucket(int index, uint8_t band, int8_t* maxOut, int8_t* meanOut,
+                   uint8_t* occupancyOut) const;
+
+    /**
+     * @brief Noise floors to seed detection with, from a survey trace
+     *
+     * Quiet channels use their mean; busy ones (SURVEY_BUSY_PERCENT) their
+     * min-hold, the closest the survey got to the noise under the traffic.
+     * @param floors Output, NOISE_FLOOR_FRAC_BITS fixed point
+     */
+    static void planFloors(const SurveyTrace& trace, int channels, int16_t* floors);
+
+    /**
+     * @brief Busiest channels of a trace, one per run of busy channels
+     * @param out Channel indices, busiest first
+     * @param maxOut Capacity of out
+     * @return Number written
+     */
+    static int busyChannels(const SurveyTrace& trace, int channels, int* out, int maxOut);
+
+private:
+    // Running totals per band
+    struct Totals {
+        alignas(SWEEP_ROW_ALIGN) int8_t maxHold[SWEEP_ROW_MAX];
+        alignas(SWEEP_ROW_ALIGN) int8_t minHold[SWEEP_ROW_MAX];
+        int32_t sum[SWEEP_ROW_MAX];
+        uint32_t above[SWEEP_ROW_MAX];
+        uint32_t sweeps;
+    };
+
+    Totals totals[2];
+    Totals bucket[2];              // The open time bucket
+    SurveyView state;              // Written by the scan task only
+    SeqLock<SurveyView> published;
+
+    uint8_t* buckets;
+    int bucketCapacity;
+    int bucketCount;
+    uint32_t bucketMs;
+    uint32_t bucketStartMs;
+    uint32_t runStartMs;           // When the current run started
+    uint32_t runMs;                // Completed runs since reset()
+    bool running;
+
+    /**
+     * @brief Clear a set of totals
+     */
+    static void clearTotals(Totals& t);
+
+    /**
+     * @brief Write the open bucket to the buffer, merging pairs if it is full
+     */
+    void closeBucket(uint32_t nowMs);
+
+    /**
+     * @brief Start of one band's part of a bucket in the buffer
+     */
+    uint8_t* bucketBand(int index, uint8_t band) const;
+
+    /**
+     * @brief Sweeps one band's part of a bucket covers
+     */
+    uint32_t bucketSweeps(int index, uint8_t band) const;
+    void setBucketSweeps(int index, uint8_t band, uint32_t sweeps);
+
+    /**
+     * @brief Refresh one band's published traces from its totals
+     */
+    void updateTrace(uint8_t band);
+
+    /**
+     * @brief Fill in the run time and bucket fields and publish
+     */
+    void publish(uint32_t nowMs);
+};
+
+#endif // SURVEY_H
@@ -0,0 +1,85 @@
+/**
+ * @file sweep_clock.h
+ * @brief Microsecond UTC clock disciplined by the GPS PPS pulse
+ *
+ * Each PPS edge is timestamped against esp_timer in an interrupt, then
+ * paired with the NMEA sentence naming that second. The pairs give the
+ * offset from the local timer to UTC and the local crystal's rate error,
+ * so any local time can be converted to UTC (and back) to within a few
+ * microseconds between pulses. Once SYNC_LOCK_PPS consecutive pulses
+ * agree, units share one timeline and can start their sweeps on the same
+ * slot boundaries.
+ *
+ * Host-compilable: no Arduino or ESP-IDF calls, times are passed in.
+ */
+
+#ifndef SWEEP_CLOCK_H
+#define SWEEP_CLOCK_H
+
+#include <stdint.h>
+#include "config.h"
+#include "seqlock.h"
+
+// Clock model as of the last PPS edge
+struct SweepClockFix {
+    int64_t ppsLocalUs;            // esp_timer time of the edge
+    int64_t ppsUtcUs;              // UTC of the edge, us since 1970
+    int32_t driftPpb;              // Local timer rate error, + = runs fast
+    uint32_t goodPulses;           // Consecutive edges consistent with UTC
+};
+
+class SweepClock {
+public:
+    SweepClock();
+
+    /**
+     * @brief Add a PPS edge and the UTC second it marks (single writer)
+     * @param ppsLocalUs esp_timer time captured at the edge
+     * @param utcSecond Seconds since 1970 from the NMEA sentence
+     */
+    void discipline(int64_t ppsLocalUs, int64_t utcSecond);
+
+    /**
+     * @brief Check if the clock can be used for aligned sweeps
+     *
+     * Needs SYNC_LOCK_PPS consistent edges, the last within
+     * SYNC_HOLDOVER_MS.
+     * @param nowLocalUs Current esp_timer time
+     */
+    bool isLocked(int64_t nowLocalUs) const;
+
+    /**
+     * @brief Convert a local timer value to UTC
+     * @param utcUs UTC in us since 1970
+     * @return false if the clock is not locked at localUs
+     */
+    bool toUtc(int64_t localUs, int64_t& utcUs) const;
+
+    /**
+     * @brief Convert a UTC time to the local timer value it occurs at
+     * @return false if the clock is not locked
+     */
+    bool toLocal(int64_t utcUs, int64_t& localUs) const;
+
+    /**
+     * @brief Get the estimated local timer rate error
+     * @return Parts per billion, positive when the timer runs fast
+     */
+    int32_t getDriftPpb() const;
+
+    /**
+     * @brief Number of PPS edges paired with a UTC second since boot
+     */
+    uint32_t getPulseCount() const;
+
+private:
+    SeqLock<SweepClockFix> published;
+    SweepClockFix fix;             // Writer's copy
+
+    /**
+     * @brief Lock test on one consistent copy of the model
+     */
+    static bool locked(const SweepClockFix& f, int64_t nowLocalUs);
+};
+
+#endif // SWEEP_CLOCK_H
@@ -0,0 +1,94 @@
+/**
+ * @file sweep_kernels.h
+ * @brief Whole-row analytics kernels over int8 dBm sweep rows
+ *
+ * Every kernel works on a full channel row at once. On the ESP32-S3 the
+ * element-wise max/min/compare kernels use the PIE 128-bit vector
+ * instructions; everywhere else (and for the remaining kernels) plain
+ * loops are written so the compiler can auto-vectorise them. Both paths
+ * are integer-only and produce bit-identical results.
+ *
+ * Rows passed to the PIE kernels must be 16-byte aligned; any length is
+ * accepted, the tail is handled by the scalar loop. The scalar versions
+ * of the vectorised kernels are always built, so tests and benchmarks can
+ * run both paths on the same rows.
+ */
+
+#ifndef SWEEP_KERNELS_H
+#define SWEEP_KERNELS_H
+
+#include <stdint.h>
+
+// Alignment and padded length of sweep row buffers
+#define SWEEP_ROW_ALIGN 16
+#define SWEEP_ROW_STRIDE(n) (((n) + SWEEP_ROW_ALIGN - 1) & ~(SWEEP_ROW_ALIGN - 1))
+
+// Noise floors are kept in fixed point with this many fractional bits
+#define NOISE_FLOOR_FRAC_BITS 4
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(SWEEP_KERNELS_SCALAR)
+#define SWEEP_KERNELS_PIE 1
+#else
+#define SWEEP_KERNELS_PIE 0
+#endif
+
+/**
+ * @brief hold[i] = max(hold[i], row[i])
+ */
+void sweepMaxHold(int8_t* hold, const int8_t* row, int n);
+
+/**
+ * @brief hold[i] = min(hold[i], row[i])
+ */
+void sweepMinHold(int8_t* hold, const int8_t* row, int n);
+
+/**
+ * @brief Asymmetric exponential noise-floor tracking
+ *
+ * floor += (row - floor) >> shift, with riseShift used when the row is
+ * above the floor (slow, so signals don't lift it) and fallShift when it
+ * is below (fast). A floor below the row rises by at least one LSB, so
+ * it never stalls short of the row when the shifted gap truncates to 0.
+ * Channels flagged in hits are skipped so a steady emitter never becomes
+ * its own floor. Floors are in dBm with NOISE_FLOOR_FRAC_BITS fractional
+ * bits.
+ */
+void sweepNoiseFloorUpdate(int16_t* floorQ, const int8_t* row, const uint8_t* hits, int n, int riseShift, int fallShift);
+
+/**
+ * @brief Per-channel detection threshold: max(minimum, floor + margin)
+ */
+void sweepThresholdRow(int8_t* threshold, const int16_t* floorQ, int n, int8_t margin, int8_t minimum);
+
+/**
+ * @brief hits[i] = row[i] > threshold[i] ? 0xFF : 0
+ * @return Number of hits
+ */
+int sweepCompare(uint8_t* hits, const int8_t* row, const int8_t* threshold, int n);
+
+/**
+ * @brief Slide a row into running history sums
+ * @param evicted Row leaving the history window, or nullptr while filling
+ */
+void sweepHistoryUpdate(int16_t* sum, int32_t* sumSq, const int8_t* row, const int8_t* evicted, int n);
+
+/**
+ * @brief Add a row to long-running totals: sum += row, above += hit
+ */
+void sweepAccumulate(int32_t* sum, uint32_t* above, const int8_t* row, const uint8_t* hits, int n);
+
+/**
+ * @brief Variance of each channel over the history window in dB^2
+ */
+void sweepVariance(uint16_t* variance, const int16_t* sum, const int32_t* sumSq, int n, int count);
+
+/**
+ * @brief Portable sweepMaxHold(), sweepMinHold() and sweepCompare()
+ *
+ * The kernels above fall back to these when SWEEP_KERNELS_PIE is 0.
+ */
+void sweepMaxHoldScalar(int8_t* hold, const int8_t* row, int n);
+void sweepMinHoldScalar(int8_t* hold, const int8_t* row, int n);
+int sweepCompareScalar(uint8_t* hits, const int8_t* row, const int8_t* threshold, int n);
+
+#endif // SWEEP_KERNELS_H
@@ -0,0 +1,96 @@
+/**
+ * @file warm_state.h
+ * @brief Scanner state snapshot kept across deep sleep and reboots
+ *
+ * Before deep sleep or a controlled reboot the per-channel noise floors,
+ * the detected-signal table and the radio scheduler position are packed
+ * into a small versioned, CRC-checked snapshot. It lives in RTC slow
+ * memory, which survives both, unless it is too large for the reserved
+ * region, in which case it goes to NVS. On boot a valid snapshot is
+ * restored once and then discarded.
+ */
+
+#ifndef WARM_STATE_H
+#define WARM_STATE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "rf_scanner.h"
+#include "radio_scheduler.h"
+
+#define WARM_MAGIC 0x4D524157      // "WARM" little-endian
+#define WARM_VERSION 2
+
+// WarmSignal flag bits
+#define WARM_SIG_BAND_2400 0x01
+#define WARM_SIG_HAS_POSITION 0x02
+#define WARM_SIG_MOD_FROM_BURST 0x04
+
+struct __attribute__((packed)) WarmSignal {
+    float frequency;               // MHz
+    float latitude;
+    float longitude;
+    uint32_t holdMs;               // Hold time left, at save
+    int8_t rssi;                   // dBm
+    uint8_t modType;               // ModulationType
+    uint8_t flags;                 // WARM_SIG_* bits
+};
+
+struct __attribute__((packed)) WarmSnapshot {
+    uint32_t magic;                // WARM_MAGIC
+    uint16_t version;              // WARM_VERSION
+    uint16_t length;               // sizeof(WarmSnapshot)
+    uint32_t crc;                  // CRC-32 of everything after this field
+    uint32_t sleepMs;              // Expected time until the next boot
+    uint32_t sweeps[2];            // Sweep counters per band
+    uint8_t schedulerSlots;        // Sweep slots since the last mesh window
+    uint8_t signalCount;
+    int16_t noiseFloor900[CHANNELS_900];    // dBm, NOISE_FLOOR_FRAC_BITS fraction
+    int16_t noiseFloor2400[CHANNELS_2400];
+    WarmSignal signals[MAX_DETECTED_SIGNALS];
+};
+
+class WarmState {
+public:
+    WarmState();
+
+    /**
+     * @brief Attach the state owners and save on controlled reboots
+     * @param scanner Scanner whose floors and signals are kept
+     * @param scheduler Scheduler whose slot position is kept
+     */
+    void begin(RFScanner* scanner, RadioScheduler* scheduler);
+
+    /**
+     * @brief Restore a snapshot left by the previous run, if any
+     *
+     * The snapshot is discarded whether or not it was valid, so it is
+     * never applied twice.
+     * @return true if state was restored
+     */
+    bool restore();
+
+    /**
+     * @brief Write a snapshot of the current state
+     * @param sleepMs Time until the next boot (0 for a reboot), used to
+     *                age the restored signals
+     * @return true if the snapshot was stored
+     */
+    bool save(uint32_t sleepMs);
+
+private:
+    RFScanner* scanner;
+    RadioScheduler* scheduler;
+
+    /**
+     * @brief Check magic, version, length and CRC
+     */
+    static bool isValid(const WarmSnapshot& snap);
+
+    /**
+     * @brief CRC over the part of the snapshot after the crc field
+     */
+    static uint32_t snapshotCrc(const WarmSnapshot& snap);
+};
+
+#endif // WARM_STATE_H
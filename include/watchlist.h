@@ -0,0 +1,143 @@
+/**
+ * @file watchlist.h
+ * @brief Low-latency alerts for watchlisted frequencies
+ *
+ * Every RSSI sample taken by a sweep is checked against the watchlist as
+ * soon as it is measured. A hit wakes a high-priority alert task, which
+ * drives the alert GPIO and then asks for a pre-rendered banner, without
+ * waiting for the sweep to finish. The pin goes up for every pending hit
+ * before any banner is touched, and banners never wait for the display.
+ * Detection-to-GPIO and detection-to-banner latencies are measured for
+ * every alert.
+ *
+ * The sweep and the alert task may run on different cores. Each entry's
+ * alerting bit and a count of the samples that held it share one atomic
+ * word: the sweep raises and holds an alert by compare-and-swap, and the
+ * alert task clears an expired one only if no sample held it since it
+ * looked. A raised alert's detection time is handed over through the
+ * pending flag.
+ *
+ * Host-compilable: the clock, task and outputs are behind AlertOutput.
+ */
+
+#ifndef WATCHLIST_H
+#define WATCHLIST_H
+
+#include <stdint.h>
+#include <atomic>
+#include "config.h"
+#include "alert_output.h"
+#include "band_analyzer.h"
+
+// Expiry is checked at least this often while nothing new arrives
+#define WATCH_POLL_MS 100
+
+class Watchlist {
+public:
+    Watchlist();
+
+    /**
+     * @brief Load the DRONE_FREQ_* entries
+     * @param output Clock, alert task and outputs
+     */
+    void begin(AlertOutput* output);
+
+    /**
+     * @brief Add a frequency to the watchlist
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param freq Frequency in MHz, snapped to the nearest sweep channel
+     * @return false if the list is full or the frequency is out of band
+     */
+    bool add(uint8_t band, float freq);
+
+    /**
+     * @brief Check one sweep sample; called from the sweep loop
+     * @param band Band (0=900MHz, 1=2.4GHz)
+     * @param channel Channel index within the band
+     * @param rssi Measured level in dBm
+     * @param threshold Channel's detection threshold in dBm
+     */
+    inline void onSample(uint8_t band, int channel, int8_t rssi, int8_t threshold) {
+        int e = channelEntry[band][channel];
+        if (e >= 0) checkSample(e, rssi, threshold);
+    }
+
+    /**
+     * @brief Raise pending alerts and clear expired ones
+     *
+     * Run by the alert task on wake(), and at least every WATCH_POLL_MS.
+     * An alert clears after WATCH_HOLD_MS below the hysteresis band, or
+     * WATCH_HOLD_REVISITS revisits of its channel if that is longer, as
+     * while lock-on stretches the time between sweeps; it never clears
+     * before the channel has been looked at again.
+     */
+    void service();
+
+    /**
+     * @brief Number of watchlisted frequencies
+     */
+    int getCount();
+
+    /**
+     * @brief Check if any watchlisted frequency is alerting
+     */
+    bool isAlerting();
+
+    /**
+     * @brief Number of alerts raised since boot
+     */
+    uint32_t getAlertCount();
+
+    /**
+     * @brief Detection-to-GPIO latency of the last alert in us
+     */
+    uint32_t getLastAlertUs();
+
+    /**
+     * @brief Worst detection-to-GPIO latency since boot in us
+     */
+    uint32_t getMaxAlertUs();
+
+    /**
+     * @brief Detection-to-banner latency of the last alert in us
+     */
+    uint32_t getLastOverlayUs();
+
+    /**
+     * @brief Alerts slower than WATCH_LATENCY_BUDGET_US
+     */
+    uint32_t getLatencyMisses();
+
+private:
+    struct Entry {
+        float frequency;               // Channel centre in MHz
+        uint8_t band;
+        std::atomic<uint32_t> state;   // WATCH_ALERTING + WATCH_HELD per holding sample
+        std::atomic<bool> pending;     // Raised by the sweep, taken by the alert task
+        std::atomic<int8_t> rssi;
+        int64_t detectedUs;            // Written before pending is set
+        std::atomic<uint32_t> lastAboveMs; // Last sample inside the hysteresis band
+        std::atomic<uint32_t> lastSampleMs;
+        std::atomic<uint32_t> revisitMs;   // Between the last two samples
+    };
+
+    Entry entries[WATCHLIST_MAX];
+    int entryCount;
+    int8_t channelEntry[2][SWEEP_ROW_MAX];     // Entry per channel, -1 if none
+
+    AlertOutput* output;
+
+    volatile uint32_t alertCount;
+    volatile uint32_t lastAlertUs;
+    volatile uint32_t maxAlertUs;
+    volatile uint32_t lastOverlayUs;
+    volatile uint32_t latencyMisses;
+
+    /**
+     * @brief Apply trigger and hysteresis to a watchlisted sample
+     */
+    void checkSample(int e, int8_t rssi, int8_t threshold);
+
+};
+
+#endif // WATCHLIST_H
@@ -0,0 +1,71 @@
+/**
+ * @file arduino_alert_output.cpp
+ * @brief AlertOutput on the ESP32
+ */
+
+#include "arduino_alert_output.h"
+
+ArduinoAlertOutput::ArduinoAlertOutput() {
+    watchlist = nullptr;
+    ui = nullptr;
+    task = nullptr;
+}
+
+void ArduinoAlertOutput::begin(Watchlist* list, DisplayUI* display) {
+    watchlist = list;
+    ui = display;
+
+#if ALERT_PIN >= 0
+    pinMode(ALERT_PIN, OUTPUT);
+    digitalWrite(ALERT_PIN, LOW);
+#endif
+
+    // Higher priority than the loop, so a hit preempts the rest of the sweep
+    xTaskCreate(alertTask, "alert", ALERT_TASK_STACK, this, ALERT_TASK_PRIORITY, &task);
+}
+
+void ArduinoAlertOutput::alertTask(void* arg) {
+    ArduinoAlertOutput* self = (ArduinoAlertOutput*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WATCH_POLL_MS));
+        self->watchlist->service();
+    }
+}
+
+int64_t ArduinoAlertOutput::nowUs() {
+    return esp_timer_get_time();
+}
+
+void ArduinoAlertOutput::wake() {
+    if (task != nullptr) xTaskNotifyGive(task);
+}
+
+void ArduinoAlertOutput::setPin(bool on) {
+#if ALERT_PIN >= 0
+    digitalWrite(ALERT_PIN, on ? HIGH : LOW);
+#endif
+}
+
+void ArduinoAlertOutput::prepareBanner(int entry, float freq) {
+    DisplayUI::renderAlert(overlays[entry], freq);
+}
+
+void ArduinoAlertOutput::showBanner(int entry) {
+    if (ui != nullptr) ui->showAlert(overlays[entry]);
+}
+
+void ArduinoAlertOutput::clearBanner() {
+    if (ui != nullptr) ui->clearAlert();
+}
+
+void ArduinoAlertOutput::alerted(float freq, int8_t rssi, uint32_t pinUs, uint32_t bannerUs) {
+    Serial.print("[WATCH] Alert ");
+    Serial.print(freq, 1);
+    Serial.print(" MHz ");
+    Serial.print(rssi);
+    Serial.print(" dBm, ");
+    Serial.print(pinUs);
+    Serial.print(" us to GPIO, ");
+    Serial.print(bannerUs);
+    Serial.println(" us to display");
+}
@@ -0,0 +1,178 @@
+/**
+ * @file band_analyzer.cpp
+ * @brief Per-band detection state implementation
+ */
+
+#include "band_analyzer.h"
+#include "classifier.h"
+#include "spur_mask.h"
+#include <math.h>
+#include <string.h>
+
+BandAnalyzer::BandAnalyzer() {
+    band = 0;
+    channels = 0;
+    startMHz = 0;
+    stepMHz = 0;
+    spurs = nullptr;
+    reset();
+}
+
+void BandAnalyzer::begin(uint8_t bandIndex, int channelCount, float start, float step) {
+    band = bandIndex;
+    channels = channelCount;
+    startMHz = start;
+    stepMHz = step;
+    reset();
+}
+
+void BandAnalyzer::reset() {
+    // Floors start where the fixed threshold sits; they fall quickly to
+    // the real noise level and rise only slowly
+    memset(row, -128, sizeof(row));
+    memset(maxHold, -128, sizeof(maxHold));
+    memset(threshold, RSSI_THRESHOLD, sizeof(threshold));
+    memset(hits, 0, sizeof(hits));
+    memset(activity, 0, sizeof(activity));
+    memset(masked, 0, sizeof(masked));
+    memset(mean, -128, sizeof(mean));
+    memset(occupancies, 0, sizeof(occupancies));
+    memset(history, 0, sizeof(history));
+    memset(historySum, 0, sizeof(historySum));
+    memset(historySumSq, 0, sizeof(historySumSq));
+    memset(variance, 0, sizeof(variance));
+    for (int i = 0; i < SWEEP_ROW_MAX; i++) {
+        noiseFloor[i] = (RSSI_THRESHOLD - NOISE_FLOOR_MARGIN_DB) * (1 << NOISE_FLOOR_FRAC_BITS);
+    }
+    historyNext = 0;
+    historyCount = 0;
+}
+
+int BandAnalyzer::processRow() {
+    int n = channels;
+
+    // Compare against thresholds from the floors before this row
+    sweepThresholdRow(threshold, noiseFloor, n, NOISE_FLOOR_MARGIN_DB, RSSI_THRESHOLD);
+
+    // The learner sees the floors' thresholds; the mask then lifts them
+    // over our own spurs
+    int raised = 0;
+    if (spurs != nullptr) {
+        spurs->learn(row, threshold, activity, n);
+        raised = spurs->apply(threshold, activity, masked, n);
+    }
+    memset(activity, 0, n);
+
+    int count = sweepCompare(hits, row, threshold, n);
+
+    // A masked spur must not lift its floor either
+    const uint8_t* floorSkip = hits;
+    if (raised > 0) {
+        for (int i = 0; i < n; i++) masked[i] |= hits[i];
+        floorSkip = masked;
+    }
+    sweepNoiseFloorUpdate(noiseFloor, row, floorSkip, n,
+                          NOISE_FLOOR_RISE_SHIFT, NOISE_FLOOR_FALL_SHIFT);
+    sweepMaxHold(maxHold, row, n);
+
+    // Slide the row into the variance window
+    int8_t* slot = history[historyNext];
+    const int8_t* evicted = historyCount == SWEEP_HISTORY ? slot : nullptr;
+    sweepHistoryUpdate(historySum, historySumSq, row, evicted, n);
+    memcpy(slot, row, n);
+    historyNext = (historyNext + 1) % SWEEP_HISTORY;
+    if (historyCount < SWEEP_HISTORY) historyCount++;
+    sweepVariance(variance, historySum, historySumSq, n, historyCount);
+
+    return count;
+}
+
+int BandAnalyzer::detect(EmitterCluster* out, int maxOut) {
+    if (processRow() == 0) return 0;
+
+    // One emitter per transmitter, not per channel it covers
+    return clusterRow(row, hits, channels, startMHz, stepMHz, out, maxOut);
+}
+
+void BandAnalyzer::setSpurMask(SpurMask* mask) {
+    spurs = mask;
+}
+
+ModulationType BandAnalyzer::classify(const EmitterCluster& cluster) const {
+    if (isWidebandCluster(cluster)) return classifyWideband(cluster);
+
+    int16_t f[CLASSIFIER_FEATURES];
+    features(cluster.peakChannel, f);
+    return classifyEmitter(f);
+}
+
+void BandAnalyzer::features(int channel, int16_t* out) const {
+    int n = channels;
+    int step100k = (int)lroundf(stepMHz * 10);
+
+    // Width of the run of hits this channel sits in
+    int lo = channel;
+    int hi = channel;
+    while (lo > 0 && hits[lo - 1]) lo--;
+    while (hi < n - 1 && hits[hi + 1]) hi++;
+
+    // Recent sweeps above the current threshold; hoppers come and go
+    int presence = 0;
+    for (int k = 0; k < historyCount; k++) {
+        if (history[k][channel] > threshold[channel]) presence++;
+    }
+
+    int floor = noiseFloor[channel] >> NOISE_FLOOR_FRAC_BITS;
+    out[FEAT_BAND] = band;
+    out[FEAT_FREQ] = (int16_t)lroundf(getFrequency(channel) * 10);
+    out[FEAT_RSSI] = row[channel];
+    out[FEAT_MARGIN] = row[channel] - floor;
+    out[FEAT_VARIANCE] = variance[channel] > INT16_MAX ? INT16_MAX : variance[channel];
+    out[FEAT_OCCUPANCY] = occupancies[channel];
+    out[FEAT_WIDTH] = (hi - lo + 1) * step100k;
+    out[FEAT_PRESENCE] = presence;
+}
+
+const int8_t* BandAnalyzer::getRow() const {
+    return row;
+}
+
+const uint8_t* BandAnalyzer::getHits() const {
+    return hits;
+}
+
+const int8_t* BandAnalyzer::getMaxHold() const {
+    return maxHold;
+}
+
+void BandAnalyzer::resetMaxHold() {
+    memset(maxHold, -128, sizeof(maxHold));
+}
+
+const int16_t* BandAnalyzer::getNoiseFloors() const {
+    return noiseFloor;
+}
+
+void BandAnalyzer::setNoiseFloors(const int16_t* floors, int count) {
+    memcpy(noiseFloor, floors, count * sizeof(int16_t));
+}
+
+uint16_t BandAnalyzer::getVariance(int channel) const {
+    return variance[channel];
+}
+
+uint8_t BandAnalyzer::getOccupancy(int channel) const {
+    return occupancies[channel];
+}
+
+int8_t BandAnalyzer::getMean(int channel) const {
+    return mean[channel];
+}
+
+float BandAnalyzer::getFrequency(int channel) const {
+    return startMHz + channel * stepMHz;
+}
+
+int BandAnalyzer::getChannelCount() const {
+    return channels;
+}
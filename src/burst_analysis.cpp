@@ -0,0 +1,197 @@
+/**
+ * @file burst_analysis.cpp
+ * @brief Burst-timing analysis implementation
+ */
+
+#include "burst_analysis.h"
+#include <math.h>
+#include <string.h>
+
+// Bursts must rise this far above the noise level
+#define BURST_MIN_CONTRAST_DB 6
+#define BURST_RELEASE_DB 3
+
+// Share of intervals a candidate period must explain, and how close the
+// fitted period must land to the nominal one
+#define BURST_MIN_FIT 0.8f
+#define BURST_PERIOD_TOLERANCE 0.015f
+
+// Band mask bits for fingerprints
+#define FP_900 0x01
+#define FP_2400 0x02
+
+struct BurstFingerprint {
+    const char* name;
+    float periodMs;
+    uint8_t bands;
+    float minDuty;
+    float maxDuty;
+    ModulationType modType;
+};
+
+// Known packet/frame cadences; matched largest period first
+static const BurstFingerprint fingerprints[] = {
+    { "Video 25fps",     40.000f, FP_2400,          0.3f, 1.0f, MOD_OFDM },
+    { "Video 30fps",     33.333f, FP_2400,          0.3f, 1.0f, MOD_OFDM },
+    { "ELRS/CRSF 50Hz",  20.000f, FP_900 | FP_2400, 0.0f, 0.5f, MOD_LORA },
+    { "Video 50fps",     20.000f, FP_2400,          0.3f, 1.0f, MOD_OFDM },
+    { "Video 60fps",     16.667f, FP_2400,          0.3f, 1.0f, MOD_OFDM },
+    { "ELRS 100Hz",      10.000f, FP_900,           0.0f, 0.5f, MOD_LORA },
+    { "FrSky ACCST",      9.000f, FP_2400,          0.0f, 0.5f, MOD_FSK },
+    { "Crossfire 150Hz",  6.667f, FP_900,           0.0f, 0.5f, MOD_FSK },
+    { "ELRS 150Hz",       6.667f, FP_2400,          0.0f, 0.5f, MOD_LORA },
+    { "ELRS 200Hz",       5.000f, FP_900,           0.0f, 0.5f, MOD_LORA },
+    { "ELRS 250Hz",       4.000f, FP_2400,          0.0f, 0.5f, MOD_LORA },
+    { "ELRS 500Hz",       2.000f, FP_2400,          0.0f, 0.5f, MOD_GFSK },
+};
+
+#define FINGERPRINT_COUNT (sizeof(fingerprints) / sizeof(fingerprints[0]))
+
+float burstHistogramBinMs(int bin) {
+    return BURST_HIST_MIN_MS * powf(2.0f, (float)bin / BURST_HIST_BINS_PER_OCTAVE);
+}
+
+static int histogramBin(float ms) {
+    if (ms <= BURST_HIST_MIN_MS) return 0;
+    int bin = (int)(log2f(ms / BURST_HIST_MIN_MS) * BURST_HIST_BINS_PER_OCTAVE);
+    if (bin >= BURST_HIST_BINS) bin = BURST_HIST_BINS - 1;
+    return bin;
+}
+
+// Fraction of intervals that are a whole number of periods; also returns
+// the least-squares period over the intervals that fit
+static float periodFit(const float* intervals, int count, float period, float tolMs,
+                       float& refined, float& meanMultiple) {
+    int fits = 0;
+    float sumInterval = 0;
+    float sumMultiple = 0;
+
+    for (int i = 0; i < count; i++) {
+        float k = roundf(intervals[i] / period);
+        if (k < 1) continue;
+        float tol = tolMs > 0.04f * period ? tolMs : 0.04f * period;
+        if (fabsf(intervals[i] - k * period) <= tol) {
+            fits++;
+            sumInterval += intervals[i];
+            sumMultiple += k;
+        }
+    }
+
+    refined = sumMultiple > 0 ? sumInterval / sumMultiple : period;
+    meanMultiple = fits > 0 ? sumMultiple / fits : 0;
+    return count > 0 ? (float)fits / count : 0;
+}
+
+void analyzeBursts(const int8_t* samples, int count, uint32_t sampleRateHz,
+                   uint8_t band, BurstProfile& out) {
+    memset(&out, 0, sizeof(out));
+    out.protocol = "Unknown";
+    out.modType = MOD_UNKNOWN;
+    if (count <= 0 || sampleRateHz == 0) return;
+
+    float msPerSample = 1000.0f / sampleRateHz;
+
+    // Noise = 20th percentile, via a histogram over the int8 range
+    uint16_t levels[256];
+    memset(levels, 0, sizeof(levels));
+    int8_t peak = -128;
+    for (int i = 0; i < count; i++) {
+        levels[samples[i] + 128]++;
+        if (samples[i] > peak) peak = samples[i];
+    }
+    int target = count / 5;
+    int seen = 0;
+    int noise = -128;
+    for (int v = 0; v < 256; v++) {
+        seen += levels[v];
+        if (seen > target) {
+            noise = v - 128;
+            break;
+        }
+    }
+    out.noiseDbm = (int8_t)noise;
+    out.peakDbm = peak;
+
+    if (peak - noise < BURST_MIN_CONTRAST_DB) return;
+
+    int rise = noise + (peak - noise) / 2;
+    if (rise < noise + BURST_MIN_CONTRAST_DB) rise = noise + BURST_MIN_CONTRAST_DB;
+    int release = rise - BURST_RELEASE_DB;
+
+    // Find bursts with hysteresis; keep start-to-start intervals
+    float intervals[BURST_MAX_INTERVALS];
+    int intervalCount = 0;
+    int burstSamples = 0;
+    int lastStart = -1;
+    int start = 0;
+    bool inBurst = false;
+
+    for (int i = 0; i < count; i++) {
+        if (!inBurst && samples[i] >= rise) {
+            inBurst = true;
+            start = i;
+            if (lastStart >= 0 && intervalCount < BURST_MAX_INTERVALS) {
+                float ms = (start - lastStart) * msPerSample;
+                intervals[intervalCount++] = ms;
+                out.intervalHistogram[histogramBin(ms)]++;
+            }
+            lastStart = start;
+        } else if (inBurst && samples[i] < release) {
+            inBurst = false;
+            burstSamples += i - start;
+            out.burstCount++;
+        }
+    }
+    if (inBurst) {
+        burstSamples += count - start;
+        out.burstCount++;
+    }
+
+    out.dutyCycle = (float)burstSamples / count;
+    out.meanBurstMs = out.burstCount > 0 ? burstSamples * msPerSample / out.burstCount : 0;
+    if (intervalCount == 0) return;
+
+    // Pick the largest known period that explains most intervals. A
+    // hopper only lands on this channel every few periods, so intervals
+    // are whole multiples of the period rather than equal to it.
+    float tolMs = 1.5f * msPerSample;
+    uint8_t bandMask = band == 0 ? FP_900 : FP_2400;
+
+    for (unsigned f = 0; f < FINGERPRINT_COUNT; f++) {
+        const BurstFingerprint& fp = fingerprints[f];
+        if (!(fp.bands & bandMask)) continue;
+        if (out.dutyCycle < fp.minDuty || out.dutyCycle > fp.maxDuty) continue;
+
+        float refined, meanMultiple;
+        float fit = periodFit(intervals, intervalCount, fp.periodMs, tolMs, refined, meanMultiple);
+        if (fit >= BURST_MIN_FIT &&
+            fabsf(refined - fp.periodMs) <= BURST_PERIOD_TOLERANCE * fp.periodMs) {
+            out.periodMs = refined;
+            out.protocol = fp.name;
+            out.hopping = meanMultiple > 1.5f;
+            out.modType = out.hopping ? MOD_FHSS : fp.modType;
+            break;
+        }
+    }
+
+    // Unknown cadence: report the most common interval
+    if (out.periodMs == 0) {
+        int mode = 0;
+        for (int b = 1; b < BURST_HIST_BINS; b++) {
+            if (out.intervalHistogram[b] > out.intervalHistogram[mode]) mode = b;
+        }
+        float lo = burstHistogramBinMs(mode);
+        float hi = burstHistogramBinMs(mode + 1);
+        float sum = 0;
+        int n = 0;
+        for (int i = 0; i < intervalCount; i++) {
+            if (intervals[i] >= lo && intervals[i] < hi) {
+                sum += intervals[i];
+                n++;
+            }
+        }
+        out.periodMs = n > 0 ? sum / n : 0;
+    }
+
+    out.rateHz = out.periodMs > 0 ? 1000.0f / out.periodMs : 0;
+}
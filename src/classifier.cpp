@@ -0,0 +1,33 @@
+/**
+ * @file classifier.cpp
+ * @brief Decision-table evaluation for the emitter classifier
+ */
+
+#include "classifier.h"
+#include "classifier_model.h"
+
+static_assert(CLASSIFIER_MODEL_FEATURES == CLASSIFIER_FEATURES,
+              "classifier_model.h was trained on a different feature layout");
+
+static const char* const featureNames[CLASSIFIER_FEATURES] = {
+    "band", "freq", "rssi", "margin", "variance", "occupancy", "width", "presence"
+};
+
+ModulationType classifyEmitter(const int16_t* features) {
+    uint8_t node = 0;
+
+    // Children always follow their parent, so this walk ends at a leaf
+    while (classifierFeature[node] != CLASSIFIER_LEAF) {
+        if (features[classifierFeature[node]] <= classifierThreshold[node]) {
+            node = classifierLeft[node];
+        } else {
+            node = classifierRight[node];
+        }
+    }
+    return (ModulationType)classifierThreshold[node];
+}
+
+const char* classifierFeatureName(int feature) {
+    if (feature < 0 || feature >= CLASSIFIER_FEATURES) return "?";
+    return featureNames[feature];
+}
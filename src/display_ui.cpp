@@ -4,17 +4,51 @@
  */
 
 #include "display_ui.h"
+#include "watchlist.h"
+
+// Main menu size, and how many items fit below the status bar
+#define MENU_ITEM_COUNT 7
+#define MENU_VISIBLE_ITEMS 5
+
+// Panel RAM is written in 8-row pages; the alert banner is the last ones
+#define DISPLAY_PAGES (SCREEN_HEIGHT / 8)
+#define ALERT_FIRST_PAGE ((SCREEN_HEIGHT - ALERT_OVERLAY_HEIGHT) / 8)
+#define DISPLAY_I2C_CHUNK 32           // Data bytes per I2C write
 
 DisplayUI::DisplayUI() {
     display = nullptr;
+    locator = nullptr;
+    watchlist = nullptr;
+    lockOn = nullptr;
+    survey = nullptr;
+    lock = nullptr;
+    ready = false;
+    alertOverlay = nullptr;
+    alertDirty = false;
+    flushCount = 0;
     currentState = MENU_MAIN;
     selectedItem = 0;
+    selectedRow = 0;
+    detectedRows = 0;
+    memset(&view, 0, sizeof(view));
     lastButtonPress = 0;
+    burstRequested = false;
+    burstReady = false;
+    burstBand = 0;
+    burstFreq = 0;
+    burstOverruns = 0;
+    lockRequested = false;
+    lockReleased = false;
+    surveyControl = SURVEY_CTL_NONE;
+    surveyBand = 0;
+    memset(&surveyView, 0, sizeof(surveyView));
 }
 
 bool DisplayUI::begin() {
     Serial.println("[UI] Initializing display...");
     
+    lock = xSemaphoreCreateMutex();
+    
     // Initialize I2C for display
     Wire.begin(OLED_SDA, OLED_SCL);
     
@@ -30,10 +64,12 @@ bool DisplayUI::begin() {
     display->setTextSize(1);
     
     Serial.println("[UI] Display initialized successfully");
+    ready = true;
     return true;
 }
 
 void DisplayUI::showSplash() {
+    xSemaphoreTake(lock, portMAX_DELAY);
     display->clearDisplay();
     
     // Draw border
@@ -54,10 +90,114 @@ void DisplayUI::showSplash() {
     display->print("v");
     display->print(FIRMWARE_VERSION);
     
-    display->display();
+    flush();
+    unlock();
+}
+
+void DisplayUI::sleep() {
+    if (display != nullptr) {
+        display->ssd1306_command(SSD1306_DISPLAYOFF);
+    }
+}
+
+void DisplayUI::showAlert(const uint8_t* overlay) {
+    alertOverlay = overlay;
+    alertDirty = true;
+    if (!ready) return;
+    
+    // Never wait behind a frame: whoever holds the display sends the
+    // banner between the pages of its flush, or as it lets go
+    if (xSemaphoreTake(lock, 0) == pdTRUE) {
+        pushAlert();
+        xSemaphoreGive(lock);
+    }
+}
+
+void DisplayUI::clearAlert() {
+    alertOverlay = nullptr;
+}
+
+void DisplayUI::renderAlert(uint8_t* overlay, float freq) {
+    GFXcanvas1 canvas(SCREEN_WIDTH, ALERT_OVERLAY_HEIGHT);
+    canvas.fillRect(0, 0, SCREEN_WIDTH, ALERT_OVERLAY_HEIGHT, 1);
+    canvas.setTextSize(1);
+    canvas.setTextColor(0);
+    canvas.setCursor(4, 2);
+    canvas.print("! WATCH ");
+    canvas.print(freq, 1);
+    canvas.print(" MHz !");
+    memcpy(overlay, canvas.getBuffer(), ALERT_OVERLAY_BYTES);
+}
+
+void DisplayUI::flush() {
+    flushCount++;
+    for (int page = 0; page < DISPLAY_PAGES; page++) {
+        if (alertDirty) drawPendingAlert();
+        sendPage(page);
+    }
+    flushCount++;
+}
+
+void DisplayUI::sendPage(int page) {
+    display->ssd1306_command(SSD1306_PAGEADDR);
+    display->ssd1306_command(page);
+    display->ssd1306_command(page);
+    display->ssd1306_command(SSD1306_COLUMNADDR);
+    display->ssd1306_command(0);
+    display->ssd1306_command(SCREEN_WIDTH - 1);
+    
+    const uint8_t* data = display->getBuffer() + page * SCREEN_WIDTH;
+    for (int i = 0; i < SCREEN_WIDTH; i += DISPLAY_I2C_CHUNK) {
+        Wire.beginTransmission(SCREEN_ADDRESS);
+        Wire.write((uint8_t)0x40);     // Co = 0, D/C = 1: data follows
+        Wire.write(data + i, DISPLAY_I2C_CHUNK);
+        Wire.endTransmission();
+    }
+}
+
+void DisplayUI::drawPendingAlert() {
+    alertDirty = false;
+    const uint8_t* overlay = alertOverlay;
+    if (overlay != nullptr) {
+        display->drawBitmap(0, SCREEN_HEIGHT - ALERT_OVERLAY_HEIGHT, overlay,
+                            SCREEN_WIDTH, ALERT_OVERLAY_HEIGHT, SSD1306_WHITE, SSD1306_BLACK);
+    }
+}
+
+void DisplayUI::pushAlert() {
+    if (!alertDirty) return;
+    drawPendingAlert();
+    flushCount++;
+    for (int page = ALERT_FIRST_PAGE; page < DISPLAY_PAGES; page++) {
+        sendPage(page);
+    }
+    flushCount++;
+}
+
+void DisplayUI::unlock() {
+    xSemaphoreGive(lock);
+    
+    // A banner raised after the last page went out; the alert task found
+    // the display busy and left it to us, unless it has got in since
+    if (alertDirty && xSemaphoreTake(lock, 0) == pdTRUE) {
+        pushAlert();
+        xSemaphoreGive(lock);
+    }
+}
+
+uint32_t DisplayUI::getFlushCount() {
+    return flushCount;
+}
+
+void DisplayUI::setWatchlist(Watchlist* list) {
+    watchlist = list;
 }
 
 void DisplayUI::update(RFScanner* scanner) {
+    // One consistent copy of the tracker for the whole frame
+    scanner->getSnapshot(view);
+    
+    xSemaphoreTake(lock, portMAX_DELAY);
     display->clearDisplay();
     
     // Draw status bar at top
@@ -69,10 +209,10 @@ void DisplayUI::update(RFScanner* scanner) {
             drawMainMenu();
             break;
         case MENU_SCAN_900:
-            drawScan900(scanner);
+            drawScan(scanner, 0);
             break;
         case MENU_SCAN_2400:
-            drawScan2400(scanner);
+            drawScan(scanner, 1);
             break;
         case MENU_DETECTED:
             drawDetected(scanner);
@@ -83,9 +223,29 @@ void DisplayUI::update(RFScanner* scanner) {
         case MENU_INFO:
             drawInfo();
             break;
+        case MENU_BURST:
+            drawBurst();
+            break;
+        case MENU_STATS:
+            drawStats(scanner);
+            break;
+        case MENU_TRACK:
+            drawTrack();
+            break;
+        case MENU_SURVEY:
+            drawSurvey(scanner);
+            break;
+    }
+    
+    // An active watchlist alert covers the bottom of every screen
+    const uint8_t* overlay = alertOverlay;
+    if (overlay != nullptr) {
+        display->drawBitmap(0, SCREEN_HEIGHT - ALERT_OVERLAY_HEIGHT, overlay,
+                            SCREEN_WIDTH, ALERT_OVERLAY_HEIGHT, SSD1306_WHITE, SSD1306_BLACK);
     }
     
-    display->display();
+    flush();
+    unlock();
 }
 
 void DisplayUI::drawStatusBar() {
@@ -126,6 +286,18 @@ void DisplayUI::drawStatusBar() {
         case MENU_INFO:
             display->print("INFO");
             break;
+        case MENU_BURST:
+            display->print("BRST");
+            break;
+        case MENU_STATS:
+            display->print("STAT");
+            break;
+        case MENU_TRACK:
+            display->print("LOCK");
+            break;
+        case MENU_SURVEY:
+            display->print("SURV");
+            break;
     }
 }
 
@@ -137,15 +309,19 @@ void DisplayUI::drawMainMenu() {
         "Scan 2.4GHz",
         "Detected",
         "Settings",
-        "Info"
+        "Info",
+        "Stats",
+        "Survey"
     };
     
-    int numItems = 5;
     int startY = 14;
     int itemHeight = 10;
     
-    for (int i = 0; i < numItems; i++) {
-        drawMenuItem(startY + (i * itemHeight), menuItems[i], i == selectedItem);
+    // Scroll once the selection moves past the last visible item
+    int first = selectedItem >= MENU_VISIBLE_ITEMS ? selectedItem - MENU_VISIBLE_ITEMS + 1 : 0;
+    
+    for (int i = first; i < MENU_ITEM_COUNT && i < first + MENU_VISIBLE_ITEMS; i++) {
+        drawMenuItem(startY + ((i - first) * itemHeight), menuItems[i], i == selectedItem);
     }
 }
 
@@ -168,10 +344,10 @@ void DisplayUI::drawMenuItem(int y, const char* text, bool selected) {
     display->setTextColor(SSD1306_WHITE);
 }
 
-void DisplayUI::drawScan900(RFScanner* scanner) {
+void DisplayUI::drawScan(RFScanner* scanner, uint8_t band) {
     display->setTextSize(1);
     display->setCursor(2, 14);
-    display->print("Scanning 900MHz Band");
+    display->print(band == 0 ? "Scanning 900MHz Band" : "Scanning 2.4GHz Band");
     
     // Show current frequency
     display->setCursor(2, 26);
@@ -179,51 +355,34 @@ void DisplayUI::drawScan900(RFScanner* scanner) {
     display->print(scanner->getCurrentFrequency(), 1);
     display->print(" MHz");
     
-    // Draw scan progress bar
-    float progress = (scanner->getCurrentFrequency() - FREQ_900_START) / 
-                     (FREQ_900_END - FREQ_900_START) * 100;
-    drawProgressBar(2, 38, 124, 8, (int)progress);
+    // Draw scan progress bar; the other band's sweep shows as empty or full
+    float start = scanner->getChannelFrequency(band, 0);
+    float end = scanner->getChannelFrequency(band, scanner->getChannelCount(band) - 1);
+    float progress = (scanner->getCurrentFrequency() - start) / (end - start) * 100;
+    drawProgressBar(2, 38, 124, 8, (int)constrain(progress, 0.0f, 100.0f));
     
     // Show detected count
     display->setCursor(2, 52);
     display->print("Detected: ");
-    display->print(scanner->getSignalCount());
+    display->print(view.signalCount);
     display->print(" signals");
     
     // Indicate if radio available
-    if (!scanner->is900MHzAvailable()) {
+    bool available = band == 0 ? scanner->is900MHzAvailable() : scanner->is2400MHzAvailable();
+    if (!available) {
         display->setCursor(2, 56);
-        display->print("Radio unavailable!");
+        display->print(band == 0 ? "Radio unavailable!" : "2.4GHz not connected");
     }
 }
 
-void DisplayUI::drawScan2400(RFScanner* scanner) {
-    display->setTextSize(1);
-    display->setCursor(2, 14);
-    display->print("Scanning 2.4GHz Band");
-    
-    // Show current frequency
-    display->setCursor(2, 26);
-    display->print("Freq: ");
-    display->print(scanner->getCurrentFrequency(), 1);
-    display->print(" MHz");
-    
-    // Draw scan progress bar
-    float progress = (scanner->getCurrentFrequency() - FREQ_2400_START) / 
-                     (FREQ_2400_END - FREQ_2400_START) * 100;
-    drawProgressBar(2, 38, 124, 8, (int)progress);
-    
-    // Show detected count
-    display->setCursor(2, 52);
-    display->print("Detected: ");
-    display->print(scanner->getSignalCount());
-    display->print(" signals");
-    
-    // Indicate if radio available
-    if (!scanner->is2400MHzAvailable()) {
-        display->setCursor(2, 56);
-        display->print("2.4GHz not connected");
+int DisplayUI::activeSignalIndex(int n) {
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (view.signals[i].active) {
+            if (n == 0) return i;
+            n--;
+        }
     }
+    return -1;
 }
 
 void DisplayUI::drawDetected(RFScanner* scanner) {
@@ -231,32 +390,71 @@ void DisplayUI::drawDetected(RFScanner* scanner) {
     display->setCursor(2, 14);
     display->print("Detected Signals:");
     
-    DetectedSignal* signals = scanner->getDetectedSignals();
     int count = 0;
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (view.signals[i].active) count++;
+    }
+    detectedRows = count;
+    
+    // Signals may have expired since the selection moved
+    if (selectedRow >= count) selectedRow = count > 0 ? count - 1 : 0;
+    
+    // Scroll so the selected row is always one of the 4 shown
+    int first = selectedRow > 3 ? selectedRow - 3 : 0;
     int y = 24;
     
-    for (int i = 0; i < MAX_DETECTED_SIGNALS && count < 4; i++) {
-        if (signals[i].active) {
-            display->setCursor(2, y);
-            
-            // Frequency
-            display->print(signals[i].frequency, 1);
-            display->print("M ");
+    // Alternate the last column between modulation and bearing/distance
+    bool showLocation = (millis() / 2000) % 2 == 1;
+    
+    for (int row = first; row < count && row < first + 4; row++) {
+        const DetectedSignal& sig = view.signals[activeSignalIndex(row)];
+        bool selected = row == selectedRow;
+        
+        if (selected) {
+            display->fillRect(0, y - 1, SCREEN_WIDTH, 9, SSD1306_WHITE);
+            display->setTextColor(SSD1306_BLACK);
+        }
+        display->setCursor(2, y);
+        
+        // Frequency
+        display->print(sig.frequency, 1);
+        display->print("M ");
+        
+        float bearing, distance;
+        if (showLocation && locator != nullptr &&
+            locator->getEstimate(sig.band, sig.frequency, bearing, distance)) {
+            // RSSI, then bearing/distance e.g. "045/320m"
+            display->print((int)sig.rssi);
+            display->print(" ");
             
+            char locStr[12];
+            if (distance < 1000) {
+                snprintf(locStr, sizeof(locStr), "%03d/%dm", (int)bearing, (int)distance);
+            } else {
+                snprintf(locStr, sizeof(locStr), "%03d/%.1fk", (int)bearing, distance / 1000);
+            }
+            display->print(locStr);
+        } else {
             // RSSI
-            display->print((int)signals[i].rssi);
-            display->print("dB ");
+            display->print((int)sig.rssi);
             
-            // Modulation (abbreviated)
-            const char* modStr = modTypeToString(signals[i].modType);
-            display->print(modStr);
-            
-            // Draw signal bars
-            drawSignalBars(115, y, signals[i].rssi);
-            
-            y += 10;
-            count++;
+            // Modulation (abbreviated); wideband emitters add their width
+            const char* modStr = modTypeToString(sig.modType);
+            if (sig.bandwidth >= CLUSTER_WIDE_MIN_MHZ) {
+                display->print(" ");
+                display->print(modStr);
+                display->print((int)(sig.bandwidth + 0.5f));
+            } else {
+                display->print("dB ");
+                display->print(modStr);
+            }
         }
+        
+        // Draw signal bars
+        drawSignalBars(115, y, sig.rssi, selected ? SSD1306_BLACK : SSD1306_WHITE);
+        display->setTextColor(SSD1306_WHITE);
+        
+        y += 10;
     }
     
     if (count == 0) {
@@ -265,6 +463,199 @@ void DisplayUI::drawDetected(RFScanner* scanner) {
     }
 }
 
+void DisplayUI::drawBurst() {
+    display->setTextSize(1);
+    display->setCursor(2, 14);
+    display->print(burstFreq, 1);
+    display->print("M ");
+    
+    if (!burstReady) {
+        display->print("capturing");
+        display->setCursor(2, 28);
+        display->print("Hold still...");
+        return;
+    }
+    if (burstOverruns < 0) {
+        display->print("failed");
+        display->setCursor(2, 28);
+        display->print("Radio unavailable");
+        return;
+    }
+    
+    display->print(burstProfile.protocol);
+    
+    // Rate and duty cycle
+    char line[24];
+    display->setCursor(2, 24);
+    snprintf(line, sizeof(line), "%.1fHz duty %d%%",
+             burstProfile.rateHz, (int)(burstProfile.dutyCycle * 100));
+    display->print(line);
+    
+    // Burst length, burst count and missed sample ticks
+    display->setCursor(2, 34);
+    snprintf(line, sizeof(line), "%.1fms x%d ovr %d",
+             burstProfile.meanBurstMs, burstProfile.burstCount, burstOverruns);
+    display->print(line);
+    
+    // Inter-burst interval histogram, 0.5 ms on the left, log-spaced
+    uint16_t peak = 1;
+    for (int b = 0; b < BURST_HIST_BINS; b++) {
+        if (burstProfile.intervalHistogram[b] > peak) peak = burstProfile.intervalHistogram[b];
+    }
+    int barWidth = SCREEN_WIDTH / BURST_HIST_BINS;
+    for (int b = 0; b < BURST_HIST_BINS; b++) {
+        int h = burstProfile.intervalHistogram[b] * 18 / peak;
+        if (h > 0) {
+            display->fillRect(b * barWidth, SCREEN_HEIGHT - h, barWidth - 1, h, SSD1306_WHITE);
+        }
+    }
+    display->drawLine(0, SCREEN_HEIGHT - 1, SCREEN_WIDTH, SCREEN_HEIGHT - 1, SSD1306_WHITE);
+}
+
+void DisplayUI::drawTrack() {
+    display->setTextSize(1);
+    if (lockOn == nullptr) return;
+    
+    LockOnView track;
+    lockOn->getView(track);
+    
+    display->setCursor(2, 14);
+    display->print(track.frequency, 1);
+    display->print("M ");
+    display->print(modTypeToString((ModulationType)track.modType));
+    if (track.hopCount > 1) {
+        display->print(" x");
+        display->print(track.hopCount);
+    }
+    
+    if (!track.active || track.sparkCount == 0) {
+        display->setCursor(2, 28);
+        display->print("Locking on...");
+        return;
+    }
+    
+    // Level and which way it is heading
+    char line[24];
+    const char* trend = "...";
+    switch (track.trend) {
+        case LOCK_TREND_STEADY:      trend = "STEADY"; break;
+        case LOCK_TREND_APPROACHING: trend = "CLOSER"; break;
+        case LOCK_TREND_RECEDING:    trend = "FURTHER"; break;
+        default: break;
+    }
+    display->setCursor(2, 24);
+    snprintf(line, sizeof(line), "%ddB %s %+.1f", track.lastDbm, trend, track.trendDbPerS);
+    display->print(line);
+    
+    // Revisit rate and the longest wait (a background sweep)
+    display->setCursor(2, 34);
+    snprintf(line, sizeof(line), "%dHz gap %dms", track.revisitHz, track.maxGapMs);
+    display->print(line);
+    
+    // Sparkline, oldest on the left, scaled to the points shown (10 dB minimum)
+    int n = track.sparkCount;
+    int oldest = (track.sparkNext + LOCK_SPARK_POINTS - n) % LOCK_SPARK_POINTS;
+    int lo = 127;
+    int hi = -128;
+    for (int k = 0; k < n; k++) {
+        int v = track.spark[(oldest + k) % LOCK_SPARK_POINTS];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+    }
+    if (hi - lo < 10) lo = hi - 10;
+    
+    const int top = 44;
+    const int height = SCREEN_HEIGHT - top;
+    int step = SCREEN_WIDTH / LOCK_SPARK_POINTS;
+    int prevY = -1;
+    for (int k = 0; k < n; k++) {
+        int v = track.spark[(oldest + k) % LOCK_SPARK_POINTS];
+        int y = SCREEN_HEIGHT - 1 - (v - lo) * (height - 1) / (hi - lo);
+        int x = k * step;
+        if (prevY >= 0) {
+            display->drawLine(x - step, prevY, x, y, SSD1306_WHITE);
+        } else {
+            display->drawPixel(x, y, SSD1306_WHITE);
+        }
+        prevY = y;
+    }
+}
+
+void DisplayUI::drawSurvey(RFScanner* scanner) {
+    display->setTextSize(1);
+    if (survey == nullptr) return;
+    
+    survey->getView(surveyView);
+    const SurveyTrace& trace = surveyView.bands[surveyBand];
+    
+    // Band, state and running time
+    char line[24];
+    unsigned long elapsed = surveyView.elapsedMs / 1000;
+    display->setCursor(2, 14);
+    snprintf(line, sizeof(line), "%s %s %02lu:%02lu:%02lu", surveyBand == 0 ? "900M" : "2.4G",
+             surveyView.running ? "RUN" : "STOP", elapsed / 3600, (elapsed % 3600) / 60, elapsed % 60);
+    display->print(line);
+    
+    if (trace.sweeps == 0) {
+        display->setCursor(2, 32);
+        display->print(surveyView.running ? "Waiting for sweep" : "Hold to start");
+        return;
+    }
+    
+    // One column per pixel; where channels outnumber pixels, the column
+    // shows the strongest of its channels
+    int n = scanner->getChannelCount(surveyBand);
+    int colMax[SCREEN_WIDTH];
+    int colMean[SCREEN_WIDTH];
+    int colOcc[SCREEN_WIDTH];
+    int lo = 127;
+    int hi = -128;
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        int first = x * n / SCREEN_WIDTH;
+        int last = (x + 1) * n / SCREEN_WIDTH;
+        if (last <= first) last = first + 1;
+        colMax[x] = -128;
+        colMean[x] = -128;
+        colOcc[x] = 0;
+        for (int ch = first; ch < last && ch < n; ch++) {
+            int mean = trace.meanQ[ch] >> NOISE_FLOOR_FRAC_BITS;
+            if (trace.maxHold[ch] > colMax[x]) colMax[x] = trace.maxHold[ch];
+            if (mean > colMean[x]) colMean[x] = mean;
+            if (trace.occupancy[ch] > colOcc[x]) colOcc[x] = trace.occupancy[ch];
+        }
+        if (colMean[x] < lo) lo = colMean[x];
+        if (colMax[x] > hi) hi = colMax[x];
+    }
+    if (hi - lo < 20) lo = hi - 20;
+    
+    // Max-hold as a line, mean as dots under it (20 dB minimum span)
+    const int top = 24;
+    const int bottom = SCREEN_HEIGHT - 7;
+    const int height = bottom - top;
+    int prevY = -1;
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        int y = bottom - (colMax[x] - lo) * height / (hi - lo);
+        if (prevY >= 0) {
+            display->drawLine(x - 1, prevY, x, y, SSD1306_WHITE);
+        } else {
+            display->drawPixel(x, y, SSD1306_WHITE);
+        }
+        prevY = y;
+        
+        if (x % 2 == 0) {
+            display->drawPixel(x, bottom - (colMean[x] - lo) * height / (hi - lo), SSD1306_WHITE);
+        }
+    }
+    
+    // Occupancy strip along the bottom, full height at 100%
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        int h = (colOcc[x] * 5 + 99) / 100;
+        if (h > 0) {
+            display->drawFastVLine(x, SCREEN_HEIGHT - h, h, SSD1306_WHITE);
+        }
+    }
+}
+
 void DisplayUI::drawSettings() {
     display->setTextSize(1);
     display->setCursor(2, 14);
@@ -302,6 +693,44 @@ void DisplayUI::drawInfo() {
     display->print("RadioLib RF Scanner");
 }
 
+void DisplayUI::drawStats(RFScanner* scanner) {
+    char line[24];
+    display->setTextSize(1);
+    
+    display->setCursor(2, 14);
+    display->print("Boot->sweep: ");
+    if (scanner->getFirstSweepMs() > 0) {
+        display->print(scanner->getFirstSweepMs());
+        display->print("ms");
+    } else {
+        display->print("--");
+    }
+    
+    display->setCursor(2, 24);
+    snprintf(line, sizeof(line), "Sweep/s %.1f / %.1f",
+             scanner->getSweepRate(0), scanner->getSweepRate(1));
+    display->print(line);
+    
+    display->setCursor(2, 34);
+    display->print("Radios: 900 ");
+    display->print(scanner->is900MHzAvailable() ? "OK" : "--");
+    display->print(" 2.4 ");
+    display->print(scanner->is2400MHzAvailable() ? "OK" : "--");
+    
+    // Watchlist detection-to-GPIO latency, last/worst
+    if (watchlist != nullptr) {
+        display->setCursor(2, 44);
+        snprintf(line, sizeof(line), "Alert %lu/%luus",
+                 (unsigned long)watchlist->getLastAlertUs(), (unsigned long)watchlist->getMaxAlertUs());
+        display->print(line);
+        
+        display->setCursor(2, 54);
+        snprintf(line, sizeof(line), "Alerts %lu late %lu",
+                 (unsigned long)watchlist->getAlertCount(), (unsigned long)watchlist->getLatencyMisses());
+        display->print(line);
+    }
+}
+
 void DisplayUI::drawProgressBar(int x, int y, int width, int height, int progress) {
     // Draw border
     display->drawRect(x, y, width, height, SSD1306_WHITE);
@@ -313,7 +742,7 @@ void DisplayUI::drawProgressBar(int x, int y, int width, int height, int progres
     }
 }
 
-void DisplayUI::drawSignalBars(int x, int y, float rssi) {
+void DisplayUI::drawSignalBars(int x, int y, float rssi, uint16_t color) {
     // Draw 4 signal bars based on RSSI
     // -120 to -100 = 1 bar, -100 to -80 = 2 bars, -80 to -60 = 3 bars, > -60 = 4 bars
     
@@ -325,9 +754,9 @@ void DisplayUI::drawSignalBars(int x, int y, float rssi) {
     for (int i = 0; i < 4; i++) {
         int barHeight = 2 + (i * 2);
         if (i < bars) {
-            display->fillRect(x + (i * 3), y + (6 - barHeight), 2, barHeight, SSD1306_WHITE);
+            display->fillRect(x + (i * 3), y + (6 - barHeight), 2, barHeight, color);
         } else {
-            display->drawRect(x + (i * 3), y + (6 - barHeight), 2, barHeight, SSD1306_WHITE);
+            display->drawRect(x + (i * 3), y + (6 - barHeight), 2, barHeight, color);
         }
     }
 }
@@ -350,24 +779,148 @@ void DisplayUI::handleButton() {
     lastButtonPress = millis();
     
     if (currentState == MENU_MAIN) {
-        selectMenu();
+        nextMenu();
+    } else if (currentState == MENU_DETECTED && selectedRow + 1 < detectedRows) {
+        // Step through the detected signals, then back to the menu
+        selectedRow++;
+    } else if (currentState == MENU_BURST) {
+        currentState = MENU_DETECTED;
+    } else if (currentState == MENU_TRACK) {
+        // Back to full sweeps
+        lockReleased = true;
+        currentState = MENU_DETECTED;
+    } else if (currentState == MENU_SURVEY && surveyBand == 0) {
+        // Show the other band, then back to the menu
+        surveyBand = 1;
     } else {
         // Return to main menu
         currentState = MENU_MAIN;
     }
 }
 
+void DisplayUI::handleLongPress() {
+    if (millis() - lastButtonPress < 200) return;
+    lastButtonPress = millis();
+    
+    switch (currentState) {
+        case MENU_MAIN:
+            selectMenu();
+            break;
+        case MENU_DETECTED:
+            // Capture the selected signal
+            if (detectedRows > 0) {
+                burstFreq = 0;
+                burstRequested = true;
+                burstReady = false;
+                currentState = MENU_BURST;
+            }
+            break;
+        case MENU_BURST:
+            // Capture the same frequency again
+            burstRequested = true;
+            burstReady = false;
+            break;
+        case MENU_SURVEY:
+            if (survey != nullptr) {
+                surveyControl = survey->isRunning() ? SURVEY_CTL_STOP : SURVEY_CTL_START;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void DisplayUI::handleLockPress() {
+    // Anywhere else it is just a long press
+    bool lockable = currentState == MENU_DETECTED && detectedRows > 0;
+    if (!lockable && currentState != MENU_SURVEY) {
+        handleLongPress();
+        return;
+    }
+    
+    if (millis() - lastButtonPress < 200) return;
+    lastButtonPress = millis();
+    
+    if (currentState == MENU_SURVEY) {
+        // Start the survey over
+        surveyControl = SURVEY_CTL_RESET;
+        return;
+    }
+    
+    lockRequested = true;
+    currentState = MENU_TRACK;
+}
+
+bool DisplayUI::takeLockRequest(uint8_t& band, float& freq, ModulationType& mod) {
+    if (!lockRequested) return false;
+    lockRequested = false;
+    
+    // Resolve against the snapshot the user was looking at
+    int idx = activeSignalIndex(selectedRow);
+    if (idx < 0) {
+        // The signal expired before tracking could start
+        currentState = MENU_DETECTED;
+        return false;
+    }
+    
+    band = view.signals[idx].band;
+    freq = view.signals[idx].frequency;
+    mod = view.signals[idx].modType;
+    return true;
+}
+
+bool DisplayUI::takeLockRelease() {
+    if (!lockReleased) return false;
+    lockReleased = false;
+    return true;
+}
+
+SurveyControl DisplayUI::takeSurveyControl() {
+    SurveyControl control = surveyControl;
+    surveyControl = SURVEY_CTL_NONE;
+    return control;
+}
+
+bool DisplayUI::takeBurstRequest(uint8_t& band, float& freq) {
+    if (!burstRequested) return false;
+    burstRequested = false;
+    
+    // A new capture from the Detected screen; repeats keep their frequency
+    if (burstFreq == 0) {
+        // Resolve against the snapshot the user was looking at
+        int idx = activeSignalIndex(selectedRow);
+        if (idx < 0) {
+            // The signal expired before the capture could start
+            currentState = MENU_DETECTED;
+            return false;
+        }
+        
+        burstBand = view.signals[idx].band;
+        burstFreq = view.signals[idx].frequency;
+    }
+    
+    band = burstBand;
+    freq = burstFreq;
+    return true;
+}
+
+void DisplayUI::setBurstProfile(const BurstProfile& profile, int overruns) {
+    burstProfile = profile;
+    burstOverruns = overruns;
+    burstReady = true;
+}
+
 void DisplayUI::nextMenu() {
     if (currentState == MENU_MAIN) {
         selectedItem++;
-        if (selectedItem > 4) selectedItem = 0;
+        if (selectedItem >= MENU_ITEM_COUNT) selectedItem = 0;
     }
 }
 
 void DisplayUI::prevMenu() {
     if (currentState == MENU_MAIN) {
         selectedItem--;
-        if (selectedItem < 0) selectedItem = 4;
+        if (selectedItem < 0) selectedItem = MENU_ITEM_COUNT - 1;
     }
 }
 
@@ -381,6 +934,7 @@ void DisplayUI::selectMenu() {
             break;
         case 2:
             currentState = MENU_DETECTED;
+            selectedRow = 0;
             break;
         case 3:
             currentState = MENU_SETTINGS;
@@ -388,6 +942,13 @@ void DisplayUI::selectMenu() {
         case 4:
             currentState = MENU_INFO;
             break;
+        case 5:
+            currentState = MENU_STATS;
+            break;
+        case 6:
+            currentState = MENU_SURVEY;
+            surveyBand = 0;
+            break;
     }
 }
 
@@ -398,3 +959,15 @@ MenuState DisplayUI::getMenuState() {
 void DisplayUI::setMenuState(MenuState state) {
     currentState = state;
 }
+
+void DisplayUI::setLocator(EmitterLocator* emitterLocator) {
+    locator = emitterLocator;
+}
+
+void DisplayUI::setLockOn(LockOnTracker* tracker) {
+    lockOn = tracker;
+}
+
+void DisplayUI::setSurvey(Survey* siteSurvey) {
+    survey = siteSurvey;
+}
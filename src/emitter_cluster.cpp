@@ -0,0 +1,102 @@
+/**
+ * @file emitter_cluster.cpp
+ * @brief Sweep-row emitter clustering implementation
+ */
+
+#include "emitter_cluster.h"
+
+// Peak channel offset from the parabola through it and its neighbours
+static float peakOffset(const int8_t* row, int n, int peak) {
+    if (peak == 0 || peak == n - 1) return 0;
+
+    int left = row[peak - 1];
+    int centre = row[peak];
+    int right = row[peak + 1];
+    int curve = left - 2 * centre + right;
+    if (curve >= 0) return 0;  // Flat or not a maximum
+
+    float offset = 0.5f * (left - right) / curve;
+    if (offset > 0.5f) offset = 0.5f;
+    if (offset < -0.5f) offset = -0.5f;
+    return offset;
+}
+
+static void buildCluster(const int8_t* row, const uint8_t* hits, int n, int first, int last,
+                         float startMHz, float stepMHz, EmitterCluster& c) {
+    int peak = first;
+    int sum = 0;
+    int count = 0;
+    for (int ch = first; ch <= last; ch++) {
+        if (!hits[ch]) continue;  // Bridged gap
+        if (row[ch] > row[peak]) peak = ch;
+        sum += row[ch];
+        count++;
+    }
+
+    c.firstChannel = first;
+    c.lastChannel = last;
+    c.peakChannel = peak;
+    c.peakDbm = row[peak];
+    c.meanDbm = (int8_t)(sum / count);
+    c.bandwidthMHz = (last - first + 1) * stepMHz;
+
+    if (isWidebandCluster(c)) {
+        c.centerMHz = startMHz + (first + last) * 0.5f * stepMHz;
+    } else {
+        c.centerMHz = startMHz + (peak + peakOffset(row, n, peak)) * stepMHz;
+    }
+}
+
+int clusterRow(const int8_t* row, const uint8_t* hits, int n, float startMHz, float stepMHz,
+               EmitterCluster* out, int maxOut) {
+    int count = 0;
+    int ch = 0;
+
+    while (ch < n) {
+        if (!hits[ch]) {
+            ch++;
+            continue;
+        }
+
+        // Extend the run across gaps of up to CLUSTER_MAX_GAP channels
+        int first = ch;
+        int last = ch;
+        int gap = 0;
+        for (int i = ch + 1; i < n; i++) {
+            if (hits[i]) {
+                last = i;
+                gap = 0;
+            } else if (++gap > CLUSTER_MAX_GAP) {
+                break;
+            }
+        }
+        ch = last + 1;
+
+        EmitterCluster c;
+        buildCluster(row, hits, n, first, last, startMHz, stepMHz, c);
+
+        if (count < maxOut) {
+            out[count++] = c;
+            continue;
+        }
+
+        // Full: keep the strongest
+        int weakest = 0;
+        for (int i = 1; i < count; i++) {
+            if (out[i].peakDbm < out[weakest].peakDbm) weakest = i;
+        }
+        if (c.peakDbm > out[weakest].peakDbm) out[weakest] = c;
+    }
+
+    return count;
+}
+
+bool isWidebandCluster(const EmitterCluster& cluster) {
+    return cluster.bandwidthMHz >= CLUSTER_WIDE_MIN_MHZ;
+}
+
+ModulationType classifyWideband(const EmitterCluster& cluster) {
+    if (cluster.bandwidthMHz < CLUSTER_OFDM_MIN_MHZ) return MOD_DSSS;
+    if (cluster.peakDbm - cluster.meanDbm >= CLUSTER_DSSS_ROLLOFF_DB) return MOD_DSSS;
+    return MOD_OFDM;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file emitter_locator.cpp
+ * @brief Incremental emitter localisation implementation
+ */
+
+#include "emitter_locator.h"
+#include <math.h>
+
+#define DEG_TO_RADIANS 0.017453292519943295
+#define METRES_PER_DEG_LAT 110540.0f
+
+EmitterLocator::EmitterLocator() {
+    hasOrigin = false;
+    originLat = 0;
+    originLon = 0;
+    metresPerDegLon = 0;
+    observerX = 0;
+    observerY = 0;
+    clear();
+}
+
+void EmitterLocator::clear() {
+    for (int i = 0; i < LOCATOR_MAX_EMITTERS; i++) {
+        tracks[i].active = false;
+    }
+}
+
+void EmitterLocator::project(float latitude, float longitude, float& x, float& y) {
+    if (!hasOrigin) {
+        originLat = latitude;
+        originLon = longitude;
+        metresPerDegLon = 111320.0f * cos(originLat * DEG_TO_RADIANS);
+        hasOrigin = true;
+    }
+    x = (float)((longitude - originLon) * metresPerDegLon);
+    y = (float)((latitude - originLat) * METRES_PER_DEG_LAT);
+}
+
+void EmitterLocator::setObserver(float latitude, float longitude) {
+    project(latitude, longitude, observerX, observerY);
+}
+
+EmitterLocator::Track* EmitterLocator::findTrack(uint8_t band, float freq, uint32_t now, bool create) {
+    for (int i = 0; i < LOCATOR_MAX_EMITTERS; i++) {
+        if (tracks[i].active && tracks[i].band == band &&
+            fabsf(tracks[i].frequency - freq) < 1.0f) {
+            return &tracks[i];
+        }
+    }
+    if (!create) return nullptr;
+
+    // Reuse a free or timed-out slot, else the least recently updated one
+    int slot = 0;
+    for (int i = 0; i < LOCATOR_MAX_EMITTERS; i++) {
+        if (!tracks[i].active || now - tracks[i].lastUpdate > LOCATOR_TRACK_TIMEOUT_MS) {
+            slot = i;
+            break;
+        }
+        if (tracks[i].lastUpdate < tracks[slot].lastUpdate) slot = i;
+    }
+
+    Track& t = tracks[slot];
+    t.frequency = freq;
+    t.band = band;
+    t.observations = 0;
+    t.active = true;
+    return &t;
+}
+
+void EmitterLocator::initTrack(Track& t, float x, float y) {
+    // Nothing is known about direction yet: centre the grid on the observer
+    for (int i = 0; i < LOCATOR_CELLS; i++) {
+        t.cells[i].mean = 0;
+        t.cells[i].residual = 0;
+    }
+    t.weightSum = 0;
+    t.originX = x - LOCATOR_GRID_SPAN_M / 2;
+    t.originY = y - LOCATOR_GRID_SPAN_M / 2;
+    t.bestResidual = 0;
+}
+
+void EmitterLocator::update(Track& t, float x, float y, float rssi) {
+    const float cellSize = LOCATOR_GRID_SPAN_M / LOCATOR_GRID_SIZE;
+    const float minD2 = LOCATOR_MIN_RANGE_M * LOCATOR_MIN_RANGE_M;
+
+    float prevWeight = t.weightSum;
+    float weight = prevWeight * LOCATOR_FORGETTING + 1.0f;
+    float best = INFINITY;
+
+    for (int row = 0; row < LOCATOR_GRID_SIZE; row++) {
+        float dy = t.originY + (row + 0.5f) * cellSize - y;
+        for (int col = 0; col < LOCATOR_GRID_SIZE; col++) {
+            float dx = t.originX + (col + 0.5f) * cellSize - x;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < minD2) d2 = minD2;
+
+            // rssi = P0 - 10 n log10(d): track the implied P0 for this cell
+            // with a decayed Welford update, so the best-fit P0 and its
+            // residual never need the observation history
+            float v = rssi + PATH_LOSS_EXPONENT * 5.0f * log10f(d2);
+            Cell& c = t.cells[row * LOCATOR_GRID_SIZE + col];
+            float delta = v - c.mean;
+            c.mean += delta / weight;
+            c.residual = LOCATOR_FORGETTING * (c.residual + delta * delta * prevWeight / weight);
+
+            if (c.residual < best) best = c.residual;
+        }
+    }
+
+    t.weightSum = weight;
+    t.bestResidual = best;
+}
+
+void EmitterLocator::addObservation(const DetectedSignal& sig, uint32_t now) {
+    if (!sig.hasPosition) return;
+
+    float x, y;
+    project(sig.latitude, sig.longitude, x, y);
+
+    Track* t = findTrack(sig.band, sig.frequency, now, true);
+    if (t->observations == 0) {
+        initTrack(*t, x, y);
+    }
+    update(*t, x, y, sig.rssi);
+
+    if (t->observations < UINT16_MAX) t->observations++;
+    t->lastUpdate = now;
+}
+
+bool EmitterLocator::getEstimate(uint8_t band, float freq, float& bearingDeg, float& distanceM) {
+    Track* t = findTrack(band, freq, 0, false);
+    if (t == nullptr || t->observations < LOCATOR_MIN_OBSERVATIONS) return false;
+
+    // Posterior mean and spread over the grid
+    const float cellSize = LOCATOR_GRID_SPAN_M / LOCATOR_GRID_SIZE;
+    const float scale = 1.0f / (2.0f * LOCATOR_RSSI_SIGMA_DB * LOCATOR_RSSI_SIGMA_DB);
+    float total = 0;
+    float mx = 0;
+    float my = 0;
+    float mxx = 0;
+
+    for (int i = 0; i < LOCATOR_CELLS; i++) {
+        float w = expf(-(t->cells[i].residual - t->bestResidual) * scale);
+        float cx = t->originX + (i % LOCATOR_GRID_SIZE + 0.5f) * cellSize;
+        float cy = t->originY + (i / LOCATOR_GRID_SIZE + 0.5f) * cellSize;
+        total += w;
+        mx += w * cx;
+        my += w * cy;
+        mxx += w * (cx * cx + cy * cy);
+    }
+    mx /= total;
+    my /= total;
+
+    float spread2 = mxx / total - (mx * mx + my * my);
+    if (spread2 > LOCATOR_MAX_SIGMA_M * LOCATOR_MAX_SIGMA_M) return false;
+
+    float dx = mx - observerX;
+    float dy = my - observerY;
+    distanceM = sqrtf(dx * dx + dy * dy);
+    bearingDeg = atan2f(dx, dy) / (float)DEG_TO_RADIANS;
+    if (bearingDeg < 0) bearingDeg += 360.0f;
+    return true;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file flash_logger.cpp
+ * @brief Batched, wear-aware flash logger implementation
+ */
+
+#include "flash_logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+// Each record is prefixed with a type byte and a length byte
+#define LOG_RECORD_PREFIX 2
+
+// Range of numbered files found in the log directory
+struct LogDirScan {
+    uint32_t newest;
+    uint32_t oldest;
+    bool found;
+};
+
+static void scanLogEntry(const char* name, void* ctx) {
+    LogDirScan* scan = (LogDirScan*)ctx;
+    uint32_t index = strtoul(name, nullptr, 10);
+    if (index > scan->newest) scan->newest = index;
+    if (index < scan->oldest) scan->oldest = index;
+    scan->found = true;
+}
+
+FlashLogger::FlashLogger() {
+    fillPage = 0;
+    flushPage = 0;
+    storage = nullptr;
+    logFile = nullptr;
+    fileIndex = 0;
+    sequence = 0;
+    lastFlushTime = 0;
+    droppedRecords = 0;
+    blocksWritten = 0;
+    recoveredBlocks = 0;
+    tornBytes = 0;
+    available = false;
+
+    for (int i = 0; i < LOG_PAGE_COUNT; i++) {
+        pages[i].used = sizeof(LogBlockHeader);
+        pages[i].records = 0;
+        pages[i].openedAt = 0;
+        pages[i].sealed = false;
+    }
+}
+
+bool FlashLogger::begin(LogStorage* storage) {
+    this->storage = storage;
+    if (!storage->mount()) return false;
+
+    if (!storage->exists(LOG_DIR)) {
+        storage->mkdir(LOG_DIR);
+    }
+
+    // Never append behind a possibly torn block: the first flush after
+    // boot always opens a new file
+    recover();
+    available = true;
+    return true;
+}
+
+void FlashLogger::recover() {
+    LogDirScan scan;
+    scan.newest = 0;
+    scan.oldest = UINT32_MAX;
+    scan.found = false;
+
+    if (!storage->listDir(LOG_DIR, scanLogEntry, &scan) || !scan.found) return;
+
+    uint32_t newest = scan.newest;
+    uint32_t oldest = scan.oldest;
+    fileIndex = newest;
+
+    // The newest file can be empty or torn at its first block if power
+    // failed right after it was opened; keep walking back until a valid
+    // block says where the sequence left off
+    size_t validBytes = 0;
+    size_t fileSize = 0;
+    uint32_t validBlocks = 0;
+    uint32_t index = newest;
+
+    while (true) {
+        validBlocks = scanFile(index, &validBytes, &fileSize);
+        if (validBlocks > 0 || index == oldest) break;
+        index--;
+    }
+
+    recoveredBlocks = validBlocks;
+    tornBytes = (uint32_t)(fileSize - validBytes);
+
+    // Drop files that fell out of the retention window while we were off
+    char path[32];
+    for (uint32_t i = oldest; i + LOG_MAX_FILES <= newest + 1; i++) {
+        filePath(i, path, sizeof(path));
+        storage->remove(path);
+    }
+}
+
+uint32_t FlashLogger::scanFile(uint32_t index, size_t* validBytes, size_t* fileSize) {
+    *validBytes = 0;
+    *fileSize = 0;
+
+    char path[32];
+    filePath(index, path, sizeof(path));
+    if (!storage->exists(path)) return 0;
+
+    LogStorageFile* f = storage->open(path, false);
+    if (f == nullptr) return 0;
+
+    // The scratch page is still unused during recovery
+    uint8_t* scratch = pages[0].data;
+    uint32_t validBlocks = 0;
+    *fileSize = f->size();
+
+    while (true) {
+        LogBlockHeader hdr;
+        if (f->read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) break;
+        if (hdr.magic != LOG_BLOCK_MAGIC) break;
+        if (hdr.payloadLength > LOG_PAGE_SIZE - sizeof(LogBlockHeader)) break;
+        if (f->read(scratch, hdr.payloadLength) != hdr.payloadLength) break;
+        if (blockCrc(hdr, scratch) != hdr.crc) break;
+
+        sequence = hdr.sequence + 1;
+        validBlocks++;
+        *validBytes += sizeof(hdr) + hdr.payloadLength;
+    }
+    storage->close(f);
+    return validBlocks;
+}
+
+bool FlashLogger::rotate() {
+    if (logFile != nullptr) {
+        storage->close(logFile);
+        logFile = nullptr;
+    }
+
+    fileIndex++;
+
+    char path[32];
+    if (fileIndex >= LOG_MAX_FILES) {
+        filePath(fileIndex - LOG_MAX_FILES, path, sizeof(path));
+        if (storage->exists(path)) {
+            storage->remove(path);
+        }
+    }
+
+    filePath(fileIndex, path, sizeof(path));
+    logFile = storage->open(path, true);
+    return logFile != nullptr;
+}
+
+void FlashLogger::filePath(uint32_t index, char* out, size_t len) {
+    snprintf(out, len, LOG_DIR "/%05lu.bin", (unsigned long)index);
+}
+
+uint8_t* FlashLogger::reserve(uint8_t type, uint16_t len, uint32_t nowMs) {
+    uint16_t needed = LOG_RECORD_PREFIX + len;
+
+    if (pages[fillPage].used + needed > LOG_PAGE_SIZE) {
+        sealFillPage();
+    }
+
+    Page& page = pages[fillPage];
+    if (page.sealed) {
+        // Every page is waiting for flash; drop rather than stall the sweep
+        droppedRecords++;
+        return nullptr;
+    }
+
+    if (page.records == 0) {
+        page.openedAt = nowMs;
+    }
+
+    uint8_t* p = page.data + page.used;
+    p[0] = type;
+    p[1] = (uint8_t)len;
+    page.used += needed;
+    page.records++;
+    return p + LOG_RECORD_PREFIX;
+}
+
+void FlashLogger::sealFillPage() {
+    Page& page = pages[fillPage];
+    if (page.sealed || page.records == 0) return;
+
+    LogBlockHeader hdr;
+    hdr.magic = LOG_BLOCK_MAGIC;
+    hdr.sequence = sequence++;
+    hdr.payloadLength = page.used - sizeof(LogBlockHeader);
+    hdr.recordCount = page.records;
+    hdr.crc = blockCrc(hdr, page.data + sizeof(LogBlockHeader));
+    memcpy(page.data, &hdr, sizeof(hdr));
+
+    page.sealed = true;
+    fillPage = (fillPage + 1) % LOG_PAGE_COUNT;
+}
+
+bool FlashLogger::logDetection(const DetectedSignal& sig, uint32_t nowMs) {
+    if (!available) return false;
+
+    uint8_t* p = reserve(LOG_REC_DETECTION, sizeof(LogDetectionRecord), nowMs);
+    if (p == nullptr) return false;
+
+    LogDetectionRecord rec;
+    rec.timestamp = sig.timestamp;
+    rec.frequency = sig.frequency;
+    rec.rssi = sig.rssi;
+    rec.band = sig.band;
+    rec.modType = (uint8_t)sig.modType;
+    memcpy(p, &rec, sizeof(rec));
+    return true;
+}
+
+bool FlashLogger::logSweepRow(uint8_t band, const int8_t* row, int count, uint32_t nowMs) {
+    if (!available) return false;
+    if (count > 255 - (int)sizeof(LogSweepRowHeader)) return false;
+
+    uint8_t* p = reserve(LOG_REC_SWEEP_ROW, sizeof(LogSweepRowHeader) + count, nowMs);
+    if (p == nullptr) return false;
+
+    LogSweepRowHeader hdr;
+    hdr.timestamp = nowMs;
+    hdr.band = band;
+    hdr.channelCount = (uint8_t)count;
+    memcpy(p, &hdr, sizeof(hdr));
+    memcpy(p + sizeof(hdr), row, count);
+    return true;
+}
+
+bool FlashLogger::writePage(uint32_t nowMs) {
+    Page& page = pages[flushPage];
+    if (!page.sealed) return false;
+
+    if (logFile == nullptr || logFile->size() + page.used > LOG_FILE_MAX_BYTES) {
+        if (!rotate()) {
+            available = false;
+            return false;
+        }
+    }
+
+    size_t written = logFile->write(page.data, page.used);
+    logFile->flush();
+
+    if (written != page.used) {
+        // The caller reports it through isAvailable()
+        available = false;
+        return false;
+    }
+
+    blocksWritten++;
+    lastFlushTime = nowMs;
+
+    page.used = sizeof(LogBlockHeader);
+    page.records = 0;
+    page.sealed = false;
+    flushPage = (flushPage + 1) % LOG_PAGE_COUNT;
+    return true;
+}
+
+void FlashLogger::service(uint32_t nowMs) {
+    if (!available) return;
+
+    // Bound how much data a quiet unit can lose on power failure
+    Page& fill = pages[fillPage];
+    if (!fill.sealed && fill.records > 0 && nowMs - fill.openedAt > LOG_MAX_PAGE_AGE_MS) {
+        sealFillPage();
+    }
+
+    // Bound the write rate so flash wear stays predictable
+    if (nowMs - lastFlushTime < LOG_MIN_FLUSH_INTERVAL_MS) return;
+
+    writePage(nowMs);
+}
+
+void FlashLogger::flush(uint32_t nowMs) {
+    if (!available) return;
+
+    sealFillPage();
+    while (pages[flushPage].sealed) {
+        if (!writePage(nowMs)) break;
+    }
+}
+
+bool FlashLogger::isAvailable() {
+    return available;
+}
+
+uint32_t FlashLogger::getDroppedRecords() {
+    return droppedRecords;
+}
+
+uint32_t FlashLogger::getBlocksWritten() {
+    return blocksWritten;
+}
+
+uint32_t FlashLogger::getFileIndex() {
+    return fileIndex;
+}
+
+uint32_t FlashLogger::getNextSequence() {
+    return sequence;
+}
+
+uint32_t FlashLogger::getRecoveredBlocks() {
+    return recoveredBlocks;
+}
+
+uint32_t FlashLogger::getTornBytes() {
+    return tornBytes;
+}
+
+uint32_t FlashLogger::blockCrc(const LogBlockHeader& hdr, const uint8_t* payload) {
+    // Covering the header catches a torn block whose payload happens to be
+    // intact but whose sequence or lengths are not
+    const uint8_t* fields = (const uint8_t*)&hdr.sequence;
+    size_t fieldLen = offsetof(LogBlockHeader, crc) - offsetof(LogBlockHeader, sequence);
+    return crc32(payload, hdr.payloadLength, crc32(fields, fieldLen));
+}
+
+uint32_t FlashLogger::crc32(const uint8_t* data, size_t len, uint32_t crc) {
+    // Nibble-wise table keeps the footprint at 64 bytes
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file gps_receiver.cpp
+ * @brief GPS receiver implementation
+ */
+
+#include "gps_receiver.h"
+#include "esp_timer.h"
+
+#ifndef GPS_RX_PIN
+#define GPS_RX_PIN 9   // Default T-Beam S3 Core GPS pins
+#endif
+#ifndef GPS_TX_PIN
+#define GPS_TX_PIN 8
+#endif
+#ifndef GPS_PPS_PIN
+#define GPS_PPS_PIN -1  // No PPS: the sweep clock never locks
+#endif
+
+volatile int64_t GpsReceiver::pulseUs = 0;
+volatile uint32_t GpsReceiver::pulseCount = 0;
+
+void IRAM_ATTR GpsReceiver::onPps() {
+    pulseUs = esp_timer_get_time();
+    pulseCount = pulseCount + 1;
+}
+
+GpsReceiver::GpsReceiver() {
+    task = nullptr;
+}
+
+bool GpsReceiver::begin(SweepClock* sweepClock) {
+    Serial.println("[GPS] Initializing GPS UART...");
+    Serial1.begin(GPS_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
+
+    if (sweepClock != nullptr && GPS_PPS_PIN >= 0) {
+        pinMode(GPS_PPS_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(GPS_PPS_PIN), onPps, RISING);
+        pairer.begin(sweepClock);
+        Serial.println("[GPS] PPS sweep clock enabled");
+    }
+
+    // Above the loop, so sentences are parsed as they arrive whatever it does
+    xTaskCreate(gpsTask, "gps", GPS_TASK_STACK, this, GPS_TASK_PRIORITY, &task);
+    return true;
+}
+
+void GpsReceiver::gpsTask(void* arg) {
+    GpsReceiver* self = (GpsReceiver*)arg;
+    for (;;) {
+        self->poll();
+        vTaskDelay(pdMS_TO_TICKS(GPS_TASK_PERIOD_MS));
+    }
+}
+
+void GpsReceiver::poll() {
+    while (Serial1.available() > 0) {
+        char c = (char)Serial1.read();
+        gps.encode(c);
+        if (pairer.encode(c)) pairPulse();
+    }
+
+    if (gps.location.isUpdated() || gps.satellites.isUpdated()) {
+        GpsFix fix;
+        published.read(fix);
+        if (gps.location.isUpdated() && gps.location.isValid()) {
+            fix.latitude = (float)gps.location.lat();
+            fix.longitude = (float)gps.location.lng();
+            fix.valid = true;
+            fix.fixMs = millis();
+        }
+        fix.satellites = (uint8_t)gps.satellites.value();
+        published.publish(fix);
+    }
+}
+
+void GpsReceiver::pairPulse() {
+    // The interrupt may land between the two reads; retry until stable
+    uint32_t count;
+    int64_t edgeUs;
+    do {
+        count = pulseCount;
+        edgeUs = pulseUs;
+    } while (count != pulseCount);
+
+    pairer.pairPulse(count, edgeUs, esp_timer_get_time());
+}
+
+bool GpsReceiver::getFix(GpsFix& fix) {
+    published.read(fix);
+    return fix.valid && millis() - fix.fixMs < GPS_FIX_TIMEOUT_MS;
+}
+
+uint8_t GpsReceiver::getSatellites() {
+    GpsFix fix;
+    published.read(fix);
+    return fix.satellites;
+}
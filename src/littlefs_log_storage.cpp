@@ -0,0 +1,71 @@
+/**
+ * @file littlefs_log_storage.cpp
+ * @brief LogStorage on LittleFS
+ */
+
+#include "littlefs_log_storage.h"
+
+class LittleFsLogFile : public LogStorageFile {
+public:
+    explicit LittleFsLogFile(File f) {
+        file = f;
+    }
+
+    size_t read(uint8_t* data, size_t len) override {
+        return file.read(data, len);
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        return file.write(data, len);
+    }
+
+    void flush() override {
+        file.flush();
+    }
+
+    size_t size() override {
+        return file.size();
+    }
+
+    File file;
+};
+
+bool LittleFsLogStorage::mount() {
+    return LittleFS.begin(true);
+}
+
+bool LittleFsLogStorage::exists(const char* path) {
+    return LittleFS.exists(path);
+}
+
+bool LittleFsLogStorage::mkdir(const char* path) {
+    return LittleFS.mkdir(path);
+}
+
+bool LittleFsLogStorage::remove(const char* path) {
+    return LittleFS.remove(path);
+}
+
+LogStorageFile* LittleFsLogStorage::open(const char* path, bool append) {
+    File f = append ? LittleFS.open(path, FILE_APPEND, true) : LittleFS.open(path, FILE_READ);
+    if (!f) return nullptr;
+    return new LittleFsLogFile(f);
+}
+
+void LittleFsLogStorage::close(LogStorageFile* file) {
+    if (file == nullptr) return;
+    static_cast<LittleFsLogFile*>(file)->file.close();
+    delete file;
+}
+
+bool LittleFsLogStorage::listDir(const char* path, LogDirVisitor visit, void* ctx) {
+    File dir = LittleFS.open(path);
+    if (!dir || !dir.isDirectory()) return false;
+
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+        visit(f.name(), ctx);
+        f.close();
+    }
+    dir.close();
+    return true;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file lock_on.cpp
+ * @brief Lock-on tracking implementation
+ */
+
+#include "lock_on.h"
+#include <math.h>
+#include <string.h>
+
+LockOnTracker::LockOnTracker() {
+    memset(&state, 0, sizeof(state));
+    memset(hops, 0, sizeof(hops));
+    hopNext = 0;
+    pointPeak = -128;
+    pointStartMs = 0;
+    lastDwellMs = 0;
+    rateStartMs = 0;
+    rateDwells = 0;
+    rateMaxGapMs = 0;
+}
+
+void LockOnTracker::start(uint8_t band, float freq, uint8_t modType, uint32_t nowMs) {
+    memset(&state, 0, sizeof(state));
+    state.active = true;
+    state.band = band;
+    state.modType = modType;
+    state.frequency = freq;
+    state.hopCount = 1;
+    state.lastDbm = -128;
+    hops[0] = freq;
+    hopNext = 0;
+
+    pointPeak = -128;
+    pointStartMs = nowMs;
+    lastDwellMs = nowMs;
+    rateStartMs = nowMs;
+    rateDwells = 0;
+    rateMaxGapMs = 0;
+    published.publish(state);
+}
+
+void LockOnTracker::stop() {
+    state.active = false;
+    published.publish(state);
+}
+
+bool LockOnTracker::isActive() const {
+    return state.active;
+}
+
+uint8_t LockOnTracker::getBand() const {
+    return state.band;
+}
+
+float LockOnTracker::nextFrequency() {
+    float freq = hops[hopNext];
+    hopNext = (hopNext + 1) % state.hopCount;
+    return freq;
+}
+
+void LockOnTracker::addDwell(int8_t peakDbm, uint32_t nowMs) {
+    if (!state.active) return;
+
+    state.dwells++;
+    rateDwells++;
+    uint32_t gap = nowMs - lastDwellMs;
+    if (gap > rateMaxGapMs) rateMaxGapMs = gap;
+    lastDwellMs = nowMs;
+
+    // Revisit rate and worst-case wait, over whole seconds
+    if (nowMs - rateStartMs >= 1000) {
+        state.revisitHz = (uint16_t)(rateDwells * 1000 / (nowMs - rateStartMs));
+        state.maxGapMs = rateMaxGapMs > UINT16_MAX ? UINT16_MAX : (uint16_t)rateMaxGapMs;
+        rateStartMs = nowMs;
+        rateDwells = 0;
+        rateMaxGapMs = 0;
+    }
+
+    if (peakDbm > pointPeak) pointPeak = peakDbm;
+    if (nowMs - pointStartMs >= LOCK_POINT_MS) {
+        closePoint(nowMs);
+    }
+}
+
+void LockOnTracker::closePoint(uint32_t nowMs) {
+    state.spark[state.sparkNext] = pointPeak;
+    state.sparkMs[state.sparkNext] = nowMs;
+    state.sparkNext = (state.sparkNext + 1) % LOCK_SPARK_POINTS;
+    if (state.sparkCount < LOCK_SPARK_POINTS) state.sparkCount++;
+    state.lastDbm = pointPeak;
+
+    if (state.sparkCount < LOCK_TREND_MIN_POINTS) {
+        state.trend = LOCK_TREND_UNKNOWN;
+    } else {
+        state.trendDbPerS = fitTrend();
+        if (state.trendDbPerS > LOCK_TREND_DB_PER_S) {
+            state.trend = LOCK_TREND_APPROACHING;
+        } else if (state.trendDbPerS < -LOCK_TREND_DB_PER_S) {
+            state.trend = LOCK_TREND_RECEDING;
+        } else {
+            state.trend = LOCK_TREND_STEADY;
+        }
+    }
+
+    pointPeak = -128;
+    pointStartMs = nowMs;
+    published.publish(state);
+}
+
+float LockOnTracker::fitTrend() const {
+    int n = state.sparkCount < LOCK_TREND_POINTS ? state.sparkCount : LOCK_TREND_POINTS;
+    int newest = (state.sparkNext + LOCK_SPARK_POINTS - 1) % LOCK_SPARK_POINTS;
+
+    // Times relative to the newest point keep the sums small; points are
+    // not evenly spaced, background sweeps leave gaps
+    float sumT = 0, sumV = 0, sumTT = 0, sumTV = 0;
+    for (int k = 0; k < n; k++) {
+        int i = (newest + LOCK_SPARK_POINTS - k) % LOCK_SPARK_POINTS;
+        float t = (int32_t)(state.sparkMs[i] - state.sparkMs[newest]) / 1000.0f;
+        float v = state.spark[i];
+        sumT += t;
+        sumV += v;
+        sumTT += t * t;
+        sumTV += t * v;
+    }
+
+    float denom = n * sumTT - sumT * sumT;
+    if (denom <= 0) return 0;
+    return (n * sumTV - sumT * sumV) / denom;
+}
+
+void LockOnTracker::learn(uint8_t band, float freq, uint8_t modType) {
+    if (!state.active || band != state.band) return;
+
+    if (state.modType != MOD_FHSS) {
+        if (fabsf(freq - hops[0]) <= LOCK_FOLLOW_MHZ) {
+            hops[0] = freq;
+            state.frequency = freq;
+        }
+        return;
+    }
+
+    if (modType != MOD_FHSS || fabsf(freq - state.frequency) > LOCK_HOP_SPAN_MHZ) return;
+    if (state.hopCount >= LOCK_HOP_MAX) return;
+
+    // Within half a channel of a known hop is the same hop
+    float half = (band == 0 ? FREQ_900_STEP : FREQ_2400_STEP) / 2;
+    for (int i = 0; i < state.hopCount; i++) {
+        if (fabsf(freq - hops[i]) < half) return;
+    }
+    hops[state.hopCount++] = freq;
+}
+
+void LockOnTracker::getView(LockOnView& out) const {
+    published.read(out);
+}
@@ -14,28 +14,633 @@
  */
 
 #include <Arduino.h>
+#include <SPI.h>
 #include "config.h"
 #include "rf_scanner.h"
 #include "display_ui.h"
+#include "flash_logger.h"
+#include "littlefs_log_storage.h"
+#include "mesh_link.h"
+#include "radiolib_mesh_transport.h"
+#include "radio_scheduler.h"
+#include "gps_receiver.h"
+#include "emitter_locator.h"
+#include "burst_analysis.h"
+#include "warm_state.h"
+#include "watchlist.h"
+#include "arduino_alert_output.h"
+#include "scan_scheduler.h"
+#include "sweep_clock.h"
+#include "lock_on.h"
+#include "survey.h"
+#include <esp_sleep.h>
+#include "esp_timer.h"
 
 // Global instances
 RFScanner rfScanner;
 DisplayUI displayUI;
+FlashLogger flashLogger;
+LittleFsLogStorage logStorage;
+MeshLink meshLink;
+RadioLibMeshTransport meshRadio;
+RadioScheduler radioScheduler;
+GpsReceiver gpsReceiver;
+EmitterLocator emitterLocator;
+WarmState warmState;
+Watchlist watchlist;
+ArduinoAlertOutput alertOutput;
+ScanScheduler scanScheduler;
+SweepClock sweepClock;
+LockOnTracker lockOn;
+Survey survey;
 
 // Button handling
 volatile bool buttonPressed = false;
-unsigned long lastScanTime = 0;
-bool scanning = false;
+volatile bool buttonLongPressed = false;
+volatile bool buttonLockPressed = false;
+volatile uint32_t buttonDownTime = 0;
+volatile bool buttonDown = false;
 
-// Interrupt handler for button
+// Boot: the display and each radio come up in their own task, so a slow
+// or missing module never holds up the others
+volatile bool displayReady = false;
+volatile bool radio900Done = false;
+volatile bool radio2400Done = false;
+volatile uint32_t splashUntil = 0;
+bool radio900Pending = true;
+bool radio2400Pending = true;
+bool firstSweepReported = false;
+
+// Scanner state as of the last sweep, for the log/report/serial paths in
+// the scan task
+ScanSnapshot sweepView;
+
+// Latest snapshot fed to the emitter locator from the loop
+ScanSnapshot locatorView;
+uint32_t locatorVersion = 0;
+
+// Unit ID in telemetry lines; same low MAC bytes as the mesh node ID
+uint16_t unitId = 0;
+
+// Sweep clock lock state last reported on serial
+bool clockLocked = false;
+
+// Survey traces for the serial export, too large for the loop's stack
+SurveyView surveyExport;
+
+// Serial command line being received
+char commandLine[SERIAL_COMMAND_MAX];
+int commandLength = 0;
+
+// Zero-span capture buffer, in internal DMA-capable RAM
+DMA_ATTR static int8_t burstSamples[BURST_CAPTURE_SAMPLES];
+
+// Interrupt handler for button: time the press, classify on release
 void IRAM_ATTR buttonISR() {
-    buttonPressed = true;
+    uint32_t now = millis();
+    if (digitalRead(BUTTON_PIN) == LOW) {
+        buttonDown = true;
+        buttonDownTime = now;
+    } else if (buttonDown) {
+        buttonDown = false;
+        if (now - buttonDownTime >= LOCK_PRESS_MS) {
+            buttonLockPressed = true;
+        } else if (now - buttonDownTime >= LONG_PRESS_MS) {
+            buttonLongPressed = true;
+        } else {
+            buttonPressed = true;
+        }
+    }
+}
+
+// Log and report the detections refreshed by the last sweep,
+// plus every Nth sweep row
+void publishSweep(uint8_t band, uint32_t sweepStart) {
+    rfScanner.getSnapshot(sweepView);
+    const DetectedSignal* signals = sweepView.signals;
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (signals[i].active && signals[i].band == band &&
+            signals[i].timestamp >= sweepStart) {
+            flashLogger.logDetection(signals[i], millis());
+            meshLink.queueReport(signals[i]);
+            lockOn.learn(band, signals[i].frequency, signals[i].modType);
+        }
+    }
+    
+#if LOG_SWEEP_DECIMATION > 0
+    if (sweepView.sweeps[band] % LOG_SWEEP_DECIMATION == 0) {
+        flashLogger.logSweepRow(band, sweepView.rows[band],
+                                rfScanner.getChannelCount(band), millis());
+    }
+#endif
+}
+
+#if TELEMETRY_ENABLED
+// Print one NMEA-style sentence with its XOR checksum, in a single write so
+// lines from other tasks can't land in the middle of it
+static void printSentence(const char* body) {
+    uint8_t checksum = 0;
+    for (const char* p = body; *p; p++) checksum ^= (uint8_t)*p;
+    
+    char line[TELEMETRY_LINE_MAX];
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, checksum);
+    Serial.print(line);
+}
+
+// Append ",seconds.micros" UTC, or just "," when the time is unknown
+static void appendUtc(char* body, size_t size, int64_t utcUs) {
+    size_t n = strlen(body);
+    if (utcUs > 0) {
+        snprintf(body + n, size - n, ",%lu.%06lu", (unsigned long)(utcUs / 1000000),
+                 (unsigned long)(utcUs % 1000000));
+    } else {
+        snprintf(body + n, size - n, ",");
+    }
+}
+
+// Machine-readable sweep summary and detections for tools/spurd
+void sendTelemetry(uint8_t band, uint32_t sweepStart, int detected) {
+    char body[TELEMETRY_LINE_MAX - 8];
+    uint32_t now = millis();
+    
+    snprintf(body, sizeof(body), "SWP,%04X,%lu,%u,%lu,%d", unitId, (unsigned long)now,
+             band, (unsigned long)sweepView.sweeps[band], detected);
+    appendUtc(body, sizeof(body), sweepView.rowUtcUs[band]);
+    printSentence(body);
+    
+    const DetectedSignal* signals = sweepView.signals;
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        const DetectedSignal& sig = signals[i];
+        if (!sig.active || sig.band != band || sig.timestamp < sweepStart) continue;
+        
+        int n = snprintf(body, sizeof(body), "DET,%04X,%lu,%u,%.3f,%.1f,%d,%d,%u,",
+                         unitId, (unsigned long)sig.timestamp, band, sig.frequency,
+                         sig.bandwidth, (int)sig.rssi, (int)sig.modType, sig.occupancy);
+        if (sig.hasPosition) {
+            snprintf(body + n, sizeof(body) - n, "%.6f,%.6f", sig.latitude, sig.longitude);
+        } else {
+            snprintf(body + n, sizeof(body) - n, ",");
+        }
+        appendUtc(body, sizeof(body), sig.utcUs);
+        printSentence(body);
+    }
+}
+#endif
+
+// Runs in the scan task after every sweep, whatever screen is showing
+void handleSweep(uint8_t band, uint32_t sweepStart, int detected) {
+    publishSweep(band, sweepStart);
+    survey.addRow(band, rfScanner.getSweepRow(band), rfScanner.getHitRow(band), millis());
+#if TELEMETRY_ENABLED
+    sendTelemetry(band, sweepStart, detected);
+#endif
+    if (detected == 0) return;
+    
+    Serial.print(band == 0 ? "[SCAN] 900MHz: " : "[SCAN] 2.4GHz: ");
+    Serial.print(detected);
+    Serial.println(" signals detected");
+    
+    // Print detected signals to serial
+    const DetectedSignal* signals = sweepView.signals;
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (signals[i].active && signals[i].band == band) {
+            Serial.print("  -> ");
+            Serial.print(signals[i].frequency, 2);
+            Serial.print(" MHz, BW: ");
+            Serial.print(signals[i].bandwidth, 1);
+            Serial.print(" MHz, RSSI: ");
+            Serial.print(signals[i].rssi, 1);
+            Serial.print(" dBm, Occ: ");
+            Serial.print(signals[i].occupancy);
+            Serial.print("%, Mod: ");
+            Serial.println(signals[i].modType);
+        }
+    }
+}
+
+// Feed the locator the signals refreshed since the last snapshot it saw.
+// Snapshots published in between are skipped, which only thins out
+// repeat observations of the same emitter.
+void updateLocator() {
+    if (rfScanner.getSnapshotVersion() == locatorVersion) return;
+    
+    uint32_t since = locatorView.timestamp;
+    locatorVersion = rfScanner.getSnapshot(locatorView);
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        const DetectedSignal& sig = locatorView.signals[i];
+        if (sig.active && sig.timestamp > since) {
+            emitterLocator.addObservation(sig, millis());
+        }
+    }
+}
+
+// Park a radio on the selected signal and fingerprint its packet timing
+void runBurstCapture(uint8_t band, float freq) {
+    Serial.print("[BURST] Capturing ");
+    Serial.print(freq, 2);
+    Serial.println(" MHz");
+    
+    // Show "capturing" before the radio is tied up for the capture
+    if (displayReady) {
+        displayUI.update(&rfScanner);
+    }
+    
+    BurstProfile profile;
+    scanScheduler.acquireRadios();
+    int overruns = rfScanner.captureZeroSpan(band, freq, burstSamples,
+                                             BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ);
+    scanScheduler.releaseRadios();
+    if (overruns < 0) {
+        Serial.println("[BURST] Capture failed");
+        memset(&profile, 0, sizeof(profile));
+        profile.protocol = "Unknown";
+        displayUI.setBurstProfile(profile, overruns);
+        return;
+    }
+    
+    analyzeBursts(burstSamples, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, band, profile);
+    displayUI.setBurstProfile(profile, overruns);
+    if (profile.modType != MOD_UNKNOWN) {
+        // Tracker writes are the scan task's, so park it meanwhile
+        scanScheduler.acquireRadios();
+        rfScanner.setSignalModulation(band, freq, profile.modType);
+        scanScheduler.releaseRadios();
+    }
+    
+    Serial.print("[BURST] ");
+    Serial.print(profile.protocol);
+    Serial.print(", ");
+    Serial.print(profile.rateHz, 1);
+    Serial.print(" Hz, burst ");
+    Serial.print(profile.meanBurstMs, 2);
+    Serial.print(" ms, duty ");
+    Serial.print(profile.dutyCycle * 100, 1);
+    Serial.print("%, overruns ");
+    Serial.println(overruns);
+}
+
+// Start, stop or reset the survey; its accumulators are the scan task's
+void applySurveyControl(SurveyControl control) {
+    scanScheduler.acquireRadios();
+    switch (control) {
+        case SURVEY_CTL_START:
+            survey.start(millis());
+            Serial.println("[SURVEY] Running");
+            break;
+        case SURVEY_CTL_STOP:
+            survey.stop(millis());
+            Serial.println("[SURVEY] Stopped");
+            break;
+        case SURVEY_CTL_RESET:
+            survey.reset(millis());
+            Serial.println("[SURVEY] Reset");
+            break;
+        default:
+            break;
+    }
+    scanScheduler.releaseRadios();
+}
+
+// Print the survey traces as CSV
+void exportSurvey() {
+    survey.getView(surveyExport);
+    
+    char line[64];
+    snprintf(line, sizeof(line), "[SURVEY] %lu s, sweeps %lu/%lu",
+             (unsigned long)(surveyExport.elapsedMs / 1000),
+             (unsigned long)surveyExport.bands[0].sweeps,
+             (unsigned long)surveyExport.bands[1].sweeps);
+    Serial.println(line);
+    Serial.println("band,channel,freq,max,min,mean,occupancy");
+    for (uint8_t band = 0; band < 2; band++) {
+        const SurveyTrace& t = surveyExport.bands[band];
+        for (int ch = 0; ch < rfScanner.getChannelCount(band); ch++) {
+            snprintf(line, sizeof(line), "%u,%d,%.3f,%d,%d,%.1f,%u", band, ch,
+                     rfScanner.getChannelFrequency(band, ch), t.maxHold[ch], t.minHold[ch],
+                     t.meanQ[ch] / (float)(1 << NOISE_FLOOR_FRAC_BITS), t.occupancy[ch]);
+            Serial.println(line);
+        }
+    }
+}
+
+// Print the survey time buckets, one max, mean and occupancy line per
+// bucket and band. Each bucket is copied with the scan task parked
+void exportSurveyBuckets() {
+    static int8_t maxRow[SWEEP_ROW_MAX];
+    static int8_t meanRow[SWEEP_ROW_MAX];
+    static uint8_t occRow[SWEEP_ROW_MAX];
+    
+    survey.getView(surveyExport);
+    uint32_t bucketMs = surveyExport.bucketMs;
+    Serial.print("[SURVEY] Buckets of ");
+    Serial.print(bucketMs / 1000);
+    Serial.print(" s: ");
+    Serial.println(surveyExport.bucketCount);
+    
+    char cell[8];
+    for (int i = 0; i < surveyExport.bucketCount; i++) {
+        for (uint8_t band = 0; band < 2; band++) {
+            scanScheduler.acquireRadios();
+            bool ok = survey.getBucket(i, band, maxRow, meanRow, occRow);
+            scanScheduler.releaseRadios();
+            
+            // Buckets merged in pairs meanwhile; the indices no longer match
+            survey.getView(surveyExport);
+            if (!ok || surveyExport.bucketMs != bucketMs) {
+                Serial.println("[SURVEY] Buckets merged during export, run it again");
+                return;
+            }
+            
+            int n = rfScanner.getChannelCount(band);
+            const char* kinds[3] = { "M", "A", "O" };
+            for (int k = 0; k < 3; k++) {
+                Serial.print(i);
+                Serial.print(',');
+                Serial.print(band);
+                Serial.print(',');
+                Serial.print(kinds[k]);
+                for (int ch = 0; ch < n; ch++) {
+                    int v = k == 0 ? maxRow[ch] : k == 1 ? meanRow[ch] : occRow[ch];
+                    snprintf(cell, sizeof(cell), ",%d", v);
+                    Serial.print(cell);
+                }
+                Serial.println();
+            }
+        }
+    }
+}
+
+// Seed the detection floors from the survey, or just print the plan
+void planFromSurvey(bool apply) {
+    static int16_t floors[SWEEP_ROW_MAX];
+    survey.getView(surveyExport);
+    
+    for (uint8_t band = 0; band < 2; band++) {
+        const SurveyTrace& t = surveyExport.bands[band];
+        if (t.sweeps == 0) continue;
+        
+        int n = rfScanner.getChannelCount(band);
+        Survey::planFloors(t, n, floors);
+        if (apply) {
+            scanScheduler.acquireRadios();
+            rfScanner.setNoiseFloors(band, floors);
+            scanScheduler.releaseRadios();
+            continue;
+        }
+        
+        char line[48];
+        for (int ch = 0; ch < n; ch++) {
+            int threshold = (floors[ch] >> NOISE_FLOOR_FRAC_BITS) + NOISE_FLOOR_MARGIN_DB;
+            if (threshold < RSSI_THRESHOLD) threshold = RSSI_THRESHOLD;
+            snprintf(line, sizeof(line), "%u,%d,%.3f,%d%s", band, ch,
+                     rfScanner.getChannelFrequency(band, ch), threshold,
+                     t.occupancy[ch] >= SURVEY_BUSY_PERCENT ? ",busy" : "");
+            Serial.println(line);
+        }
+    }
+    Serial.println(apply ? "[SURVEY] Noise floors seeded from survey" : "[SURVEY] Plan done");
+}
+
+// Watchlist the busiest channels the survey found
+void watchFromSurvey() {
+    survey.getView(surveyExport);
+    
+    for (uint8_t band = 0; band < 2; band++) {
+        int busy[WATCHLIST_MAX];
+        int n = Survey::busyChannels(surveyExport.bands[band], rfScanner.getChannelCount(band),
+                                     busy, WATCHLIST_MAX);
+        for (int i = 0; i < n; i++) {
+            float freq = rfScanner.getChannelFrequency(band, busy[i]);
+            scanScheduler.acquireRadios();
+            bool added = watchlist.add(band, freq);
+            scanScheduler.releaseRadios();
+            if (!added) {
+                Serial.println("[SURVEY] Watchlist full");
+                return;
+            }
+            Serial.print("[SURVEY] Watching ");
+            Serial.print(freq, 3);
+            Serial.print(" MHz, ");
+            Serial.print(surveyExport.bands[band].occupancy[busy[i]]);
+            Serial.println("% busy");
+        }
+    }
+}
+
+// Time sweep-step SPI on both radios, driver calls against frames
+void timeSpi() {
+    for (uint8_t band = 0; band < 2; band++) {
+        uint32_t driverUs, framesUs;
+        scanScheduler.acquireRadios();
+        bool ok = rfScanner.timeSpiSteps(band, driverUs, framesUs);
+        scanScheduler.releaseRadios();
+        if (!ok) continue;
+        
+        char line[64];
+        snprintf(line, sizeof(line), "[SPI] %s per step: driver %lu us, frames %lu us",
+                 band == 0 ? "SX1262" : "SX1280", (unsigned long)driverUs, (unsigned long)framesUs);
+        Serial.println(line);
+    }
+}
+
+// Print both bands' spur masks, copied with the scan task parked
+void showSpurs() {
+    static int8_t levels[SWEEP_ROW_MAX];
+    static uint8_t flags[SWEEP_ROW_MAX];
+    
+    for (uint8_t band = 0; band < 2; band++) {
+        int n = rfScanner.getChannelCount(band);
+        scanScheduler.acquireRadios();
+        const SpurMask& mask = rfScanner.getSpurMask(band);
+        for (int ch = 0; ch < n; ch++) {
+            levels[ch] = mask.getLevel(ch);
+            flags[ch] = mask.getFlags(ch);
+        }
+        scanScheduler.releaseRadios();
+        
+        char line[48];
+        for (int ch = 0; ch < n; ch++) {
+            if (flags[ch] == 0) continue;
+            snprintf(line, sizeof(line), "[SPUR] %.3f MHz %d dBm%s%s",
+                     rfScanner.getChannelFrequency(band, ch), levels[ch],
+                     (flags[ch] & SPUR_ALWAYS) ? " always" : "",
+                     (flags[ch] & SPUR_DISPLAY) ? " display" : "");
+            Serial.println(line);
+        }
+    }
+}
+
+// Serial commands: "spi", "spur calibrate|clear|show",
+// "survey start|stop|reset|dump|buckets|plan|apply|watch"
+void runCommand(const char* command) {
+    if (strcmp(command, "spi") == 0) {
+        timeSpi();
+        return;
+    }
+    if (strcmp(command, "spur calibrate") == 0) {
+        scanScheduler.acquireRadios();
+        rfScanner.calibrateSpurs(SPUR_CALIBRATE_ROWS);
+        scanScheduler.releaseRadios();
+        Serial.println("[SPUR] Calibrating, keep transmitters away");
+        return;
+    }
+    if (strcmp(command, "spur clear") == 0) {
+        scanScheduler.acquireRadios();
+        rfScanner.clearSpurs();
+        scanScheduler.releaseRadios();
+        Serial.println("[SPUR] Masks cleared");
+        return;
+    }
+    if (strcmp(command, "spur show") == 0) {
+        showSpurs();
+        return;
+    }
+    if (strncmp(command, "survey ", 7) != 0) {
+        Serial.print("[CMD] Unknown: ");
+        Serial.println(command);
+        return;
+    }
+    
+    const char* arg = command + 7;
+    if (strcmp(arg, "start") == 0) {
+        applySurveyControl(SURVEY_CTL_START);
+    } else if (strcmp(arg, "stop") == 0) {
+        applySurveyControl(SURVEY_CTL_STOP);
+    } else if (strcmp(arg, "reset") == 0) {
+        applySurveyControl(SURVEY_CTL_RESET);
+    } else if (strcmp(arg, "dump") == 0) {
+        exportSurvey();
+    } else if (strcmp(arg, "buckets") == 0) {
+        exportSurveyBuckets();
+    } else if (strcmp(arg, "plan") == 0) {
+        planFromSurvey(false);
+    } else if (strcmp(arg, "apply") == 0) {
+        planFromSurvey(true);
+    } else if (strcmp(arg, "watch") == 0) {
+        watchFromSurvey();
+    } else {
+        Serial.print("[CMD] Unknown: ");
+        Serial.println(command);
+    }
+}
+
+// Collect serial input into lines and run them
+void serviceSerial() {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == '\r') continue;
+        if (c == '\n') {
+            commandLine[commandLength] = '\0';
+            if (commandLength > 0) runCommand(commandLine);
+            commandLength = 0;
+        } else if (commandLength < SERIAL_COMMAND_MAX - 1) {
+            commandLine[commandLength++] = (char)c;
+        }
+    }
+}
+
+void displayBootTask(void* arg) {
+    if (displayUI.begin()) {
+        displayUI.showSplash();
+        splashUntil = millis() + SPLASH_TIME_MS;
+        displayReady = true;
+    } else {
+        Serial.println("[ERROR] Display initialization failed!");
+    }
+    vTaskDelete(nullptr);
+}
+
+void radio900BootTask(void* arg) {
+    rfScanner.begin900();
+    radio900Done = true;
+    vTaskDelete(nullptr);
+}
+
+void radio2400BootTask(void* arg) {
+    rfScanner.begin2400();
+    radio2400Done = true;
+    vTaskDelete(nullptr);
+}
+
+// Reports heard from other units, called from the mesh window
+void printRemoteReport(const RemoteReport& report) {
+    Serial.print("[MESH] Node ");
+    Serial.print(report.nodeId, HEX);
+    Serial.print(": ");
+    Serial.print(report.frequency, 1);
+    Serial.print(" MHz, RSSI: ");
+    Serial.print(report.rssi);
+    Serial.println(" dBm");
+}
+
+// Finish setup that depends on a radio as each one comes up; the scan
+// task starts sweeping a band as soon as its radio is ready
+void serviceBoot() {
+    bool wasPending = radio900Pending || radio2400Pending;
+    
+    if (radio900Pending && radio900Done) {
+        radio900Pending = false;
+        
+        // Share the SX1262 between sweeps and mesh report windows; the
+        // scan task may already be sweeping with it
+        scanScheduler.acquireRadios();
+        meshRadio.setRadio(rfScanner.getRadio900());
+        meshLink.setReportHandler(printRemoteReport);
+        if (meshLink.begin(&meshRadio)) {
+            Serial.print("[MESH] Node ");
+            Serial.print(meshLink.getNodeId(), HEX);
+            Serial.print(" on ");
+            Serial.print(MESH_FREQ, 3);
+            Serial.println(" MHz");
+        } else {
+            Serial.println("[INFO] Mesh reporting disabled");
+        }
+        scanScheduler.releaseRadios();
+    }
+    
+    if (radio2400Pending && radio2400Done) {
+        radio2400Pending = false;
+    }
+    
+    if (wasPending && !radio900Pending && !radio2400Pending &&
+        !rfScanner.is900MHzAvailable() && !rfScanner.is2400MHzAvailable()) {
+        Serial.println("[ERROR] RF Scanner initialization failed!");
+        Serial.println("[ERROR] No radio modules available");
+    }
+    
+    if (!firstSweepReported && rfScanner.getFirstSweepMs() > 0) {
+        firstSweepReported = true;
+        Serial.print("[BOOT] First sweep done ");
+        Serial.print(rfScanner.getFirstSweepMs());
+        Serial.println(" ms after power-on");
+    }
+}
+
+// Save state, power everything down and sleep; the next boot restores
+// the snapshot so the first sweep after waking already has its floors
+void enterDeepSleep(uint32_t sleepMs) {
+    Serial.print("[SLEEP] Deep sleep for ");
+    Serial.print(sleepMs);
+    Serial.println(" ms");
+    
+    // Never released: the scan task stays parked until the chip sleeps
+    scanScheduler.acquireRadios();
+    flashLogger.flush(millis());
+    warmState.save(sleepMs);
+    rfScanner.sleep();
+    if (displayReady) {
+        displayUI.sleep();
+    }
+    
+    esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000);
+    esp_deep_sleep_start();
 }
 
 void setup() {
-    // Initialize serial for debugging
+    // Serial output is not waited for; early lines are lost if no host
+    // is attached yet
     Serial.begin(115200);
-    delay(1000);  // Wait for serial
+    unitId = (uint16_t)(ESP.getEfuseMac() >> 32);
     
     Serial.println();
     Serial.println("================================");
@@ -44,101 +649,164 @@ void setup() {
     Serial.println("================================");
     Serial.println();
     
-    // Initialize display
-    if (!displayUI.begin()) {
-        Serial.println("[ERROR] Display initialization failed!");
+    displayUI.setLocator(&emitterLocator);
+    displayUI.setWatchlist(&watchlist);
+    displayUI.setLockOn(&lockOn);
+    displayUI.setSurvey(&survey);
+    
+#if SURVEY_BUCKETS > 0
+    // Survey time buckets live in PSRAM; without it only totals are kept
+    size_t surveyBytes = (size_t)SURVEY_BUCKETS * SURVEY_BUCKET_BYTES;
+    uint8_t* surveyBuckets = psramFound() ? (uint8_t*)ps_malloc(surveyBytes) : nullptr;
+    survey.begin(surveyBuckets, surveyBuckets != nullptr ? surveyBytes : 0);
+#endif
+    
+    // Both radios share the SPI bus; start it once before their tasks
+    SPI.begin();
+    xTaskCreate(displayBootTask, "bootDisplay", BOOT_TASK_STACK, nullptr, 1, nullptr);
+    xTaskCreate(radio900BootTask, "boot900", BOOT_TASK_STACK, nullptr, 1, nullptr);
+    xTaskCreate(radio2400BootTask, "boot2400", BOOT_TASK_STACK, nullptr, 1, nullptr);
+    
+    // Initialize flash logging
+    Serial.println("[LOG] Mounting LittleFS...");
+    if (flashLogger.begin(&logStorage)) {
+        Serial.print("[LOG] Recovered ");
+        Serial.print(flashLogger.getRecoveredBlocks());
+        Serial.print(" blocks, ignoring ");
+        Serial.print(flashLogger.getTornBytes());
+        Serial.print(" torn bytes; logging after file ");
+        Serial.print(flashLogger.getFileIndex());
+        Serial.print(", next block ");
+        Serial.println(flashLogger.getNextSequence());
     } else {
-        displayUI.showSplash();
-        delay(2000);
+        Serial.println("[ERROR] Flash logging unavailable");
     }
     
-    // Initialize RF scanner
-    if (!rfScanner.begin()) {
-        Serial.println("[ERROR] RF Scanner initialization failed!");
-        Serial.println("[ERROR] No radio modules available");
-    }
+    // The mesh link joins once the SX1262 is up, see serviceBoot()
+    radioScheduler.begin(&meshLink, millis());
+    
+    // Watchlisted frequencies alert straight from the sweep
+    watchlist.begin(&alertOutput);
+    alertOutput.begin(&watchlist, &displayUI);
+    rfScanner.setWatchlist(&watchlist);
+    Serial.print("[WATCH] ");
+    Serial.print(watchlist.getCount());
+    Serial.println(" frequencies watchlisted");
+    
+    // Pick up where the last run left off before deep sleep or reboot
+    warmState.begin(&rfScanner, &radioScheduler);
+    warmState.restore();
+    
+    // GPS positions tag detections and drive emitter localisation; its
+    // PPS disciplines the clock that aligns sweeps across units
+    gpsReceiver.begin(&sweepClock);
+    rfScanner.setClock(&sweepClock);
+    rfScanner.setDisplay(&displayUI);
+    scanScheduler.setClock(&sweepClock);
+    scanScheduler.setLockOn(&lockOn);
+    
+    // Sweep both bands continuously, whatever the screen shows
+    scanScheduler.begin(&rfScanner, &radioScheduler, &flashLogger, handleSweep);
     
     // Setup button interrupt
     pinMode(BUTTON_PIN, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), buttonISR, FALLING);
+    attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), buttonISR, CHANGE);
     
     Serial.println();
-    Serial.println("[READY] SPUR RF Detector initialized");
-    Serial.println("[INFO] Press button to navigate menu");
+    Serial.println("[READY] SPUR RF Detector initialized, radios starting");
+    Serial.println("[INFO] Press button to navigate, hold to select");
     Serial.println();
 }
 
 void loop() {
+    serviceBoot();
+    
     // Handle button press
     if (buttonPressed) {
         buttonPressed = false;
         displayUI.handleButton();
         Serial.println("[UI] Button pressed");
     }
+    if (buttonLongPressed) {
+        buttonLongPressed = false;
+        displayUI.handleLongPress();
+        Serial.println("[UI] Button held");
+    }
+    if (buttonLockPressed) {
+        buttonLockPressed = false;
+        displayUI.handleLockPress();
+        Serial.println("[UI] Button held long");
+    }
     
-    // Get current menu state
-    MenuState state = displayUI.getMenuState();
+    // A long press on a Detected row parks a radio on it for a capture
+    uint8_t burstBand;
+    float burstFreq;
+    if (displayUI.takeBurstRequest(burstBand, burstFreq)) {
+        runBurstCapture(burstBand, burstFreq);
+    }
     
-    // Perform scanning based on current view
-    if (millis() - lastScanTime > SCAN_INTERVAL_MS) {
-        lastScanTime = millis();
-        
-        switch (state) {
-            case MENU_SCAN_900:
-                if (rfScanner.is900MHzAvailable()) {
-                    int detected = rfScanner.scan900MHz();
-                    if (detected > 0) {
-                        Serial.print("[SCAN] 900MHz: ");
-                        Serial.print(detected);
-                        Serial.println(" signals detected");
-                        
-                        // Print detected signals to serial
-                        DetectedSignal* signals = rfScanner.getDetectedSignals();
-                        for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
-                            if (signals[i].active && signals[i].band == 0) {
-                                Serial.print("  -> ");
-                                Serial.print(signals[i].frequency, 2);
-                                Serial.print(" MHz, RSSI: ");
-                                Serial.print(signals[i].rssi, 1);
-                                Serial.print(" dBm, Mod: ");
-                                Serial.println(signals[i].modType);
-                            }
-                        }
-                    }
-                }
-                break;
-                
-            case MENU_SCAN_2400:
-                if (rfScanner.is2400MHzAvailable()) {
-                    int detected = rfScanner.scan2400MHz();
-                    if (detected > 0) {
-                        Serial.print("[SCAN] 2.4GHz: ");
-                        Serial.print(detected);
-                        Serial.println(" signals detected");
-                        
-                        DetectedSignal* signals = rfScanner.getDetectedSignals();
-                        for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
-                            if (signals[i].active && signals[i].band == 1) {
-                                Serial.print("  -> ");
-                                Serial.print(signals[i].frequency, 2);
-                                Serial.print(" MHz, RSSI: ");
-                                Serial.print(signals[i].rssi, 1);
-                                Serial.print(" dBm, Mod: ");
-                                Serial.println(signals[i].modType);
-                            }
-                        }
-                    }
-                }
-                break;
-                
-            default:
-                // Not actively scanning in other menus
-                break;
+    // A longer hold locks on to the row; leaving the screen releases it.
+    // The tracker is the scan task's, so park it meanwhile
+    uint8_t lockBand;
+    float lockFreq;
+    ModulationType lockMod;
+    if (displayUI.takeLockRequest(lockBand, lockFreq, lockMod)) {
+        scanScheduler.acquireRadios();
+        lockOn.start(lockBand, lockFreq, lockMod, millis());
+        scanScheduler.releaseRadios();
+        Serial.print("[LOCK] Tracking ");
+        Serial.print(lockFreq, 2);
+        Serial.println(" MHz");
+    }
+    SurveyControl surveyControl = displayUI.takeSurveyControl();
+    if (surveyControl != SURVEY_CTL_NONE) {
+        applySurveyControl(surveyControl);
+    }
+    serviceSerial();
+    
+    if (displayUI.takeLockRelease()) {
+        scanScheduler.acquireRadios();
+        lockOn.stop();
+        scanScheduler.releaseRadios();
+        Serial.println("[LOCK] Released, full sweeps");
+    }
+    
+    // Track the operator's position, as parsed by the GPS task
+    GpsFix fix;
+    if (gpsReceiver.getFix(fix)) {
+        rfScanner.setPosition(fix.latitude, fix.longitude, true);
+        emitterLocator.setObserver(fix.latitude, fix.longitude);
+    } else {
+        rfScanner.setPosition(0, 0, false);
+    }
+    
+    bool locked = sweepClock.isLocked(esp_timer_get_time());
+    if (locked != clockLocked) {
+        clockLocked = locked;
+        if (locked) {
+            Serial.print("[GPS] Sweep clock locked, drift ");
+            Serial.print(sweepClock.getDriftPpb());
+            Serial.println(" ppb");
+        } else {
+            Serial.println("[GPS] Sweep clock unlocked, sweeping unaligned");
         }
     }
     
-    // Update display
-    displayUI.update(&rfScanner);
+    // Localise from the latest scan snapshot
+    updateLocator();
+    
+#if DUTY_CYCLE_SLEEP_MS > 0
+    // Duty-cycled units sleep once awake long enough with nothing tracked;
+    // the scan task owns the live count, so go by the snapshot just taken
+    if (millis() > DUTY_CYCLE_AWAKE_MS && locatorVersion > 0 && locatorView.signalCount == 0) {
+        enterDeepSleep(DUTY_CYCLE_SLEEP_MS);
+    }
+#endif
+    
+    // Update display once the splash has had its time
+    if (displayReady && (int32_t)(millis() - splashUntil) >= 0) {
+        displayUI.update(&rfScanner);
+    }
     
     // Small delay to prevent tight loop
     delay(10);
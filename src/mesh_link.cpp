@@ -0,0 +1,349 @@
+/**
+ * @file mesh_link.cpp
+ * @brief Detection-report exchange implementation
+ */
+
+#include "mesh_link.h"
+#include <math.h>
+#include <stdlib.h>
+
+MeshLink::MeshLink() {
+    radio = nullptr;
+    available = false;
+    nodeId = 0;
+    sequence = 0;
+    pendingCount = 0;
+    inFlight = 0;
+    inFlightSequence = 0;
+    attempts = 0;
+    retryAt = 0;
+    slotRandom = 1;
+    ackPending = false;
+    ackNode = 0;
+    ackSequence = 0;
+    sentNext = 0;
+    airtimeCreditUs = 0;
+    lastCreditUpdate = 0;
+    packetsSent = 0;
+    packetsReceived = 0;
+    acksSent = 0;
+    airtimeUs = 0;
+    reportHandler = nullptr;
+
+    for (int i = 0; i < MESH_SENT_HISTORY; i++) {
+        sent[i].freqCode = 0;
+        sent[i].band = 0;
+        sent[i].sentAt = 0;
+    }
+
+    for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+        remote[i].active = false;
+    }
+}
+
+bool MeshLink::begin(MeshTransport* transport) {
+#if MESH_ENABLED
+    radio = transport;
+    if (radio == nullptr || !radio->configure()) return false;
+
+    nodeId = radio->getNodeId();
+    slotRandom = nodeId | 1;
+    lastCreditUpdate = radio->nowMs();
+    available = true;
+#endif
+    return available;
+}
+
+void MeshLink::setReportHandler(RemoteReportHandler handler) {
+    reportHandler = handler;
+}
+
+bool MeshLink::recentlySent(uint16_t freqCode, uint8_t band) {
+    uint32_t now = radio->nowMs();
+    for (int i = 0; i < MESH_SENT_HISTORY; i++) {
+        if (sent[i].sentAt != 0 &&
+            sent[i].band == band &&
+            abs((int)sent[i].freqCode - (int)freqCode) <= 10 &&
+            now - sent[i].sentAt < MESH_REPORT_HOLDOFF_MS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MeshLink::queueReport(const DetectedSignal& sig) {
+    if (!available) return;
+
+    uint16_t freqCode = (uint16_t)lroundf(sig.frequency * 10.0f);
+    int rssiDbm = (int)sig.rssi;
+    int8_t rssi = (int8_t)(rssiDbm < -128 ? -128 : (rssiDbm > 0 ? 0 : rssiDbm));
+
+    if (recentlySent(freqCode, sig.band)) return;
+
+    // Merge with a pending report for the same emitter (within 1 MHz)
+    for (int i = 0; i < pendingCount; i++) {
+        MeshReportEntry& e = pending[i].entry;
+        if ((e.flags >> 7) == sig.band &&
+            abs((int)e.freqCode - (int)freqCode) <= 10) {
+            if (rssi > e.rssi) {
+                e.rssi = rssi;
+                e.freqCode = freqCode;
+            }
+            e.flags = (sig.band << 7) | (sig.modType & 0x0F);
+            return;
+        }
+    }
+
+    if (pendingCount >= MESH_MAX_REPORTS) return;
+
+    PendingReport& p = pending[pendingCount++];
+    p.entry.freqCode = freqCode;
+    p.entry.rssi = rssi;
+    p.entry.flags = (sig.band << 7) | (sig.modType & 0x0F);
+    p.queuedAt = radio->nowMs();
+}
+
+void MeshLink::updateCredit() {
+    uint32_t now = radio->nowMs();
+    uint32_t elapsed = now - lastCreditUpdate;
+    lastCreditUpdate = now;
+
+    // Airtime accrues at the duty-cycle rate, capped at one burst
+    uint32_t credit = airtimeCreditUs + elapsed * MESH_DUTY_CYCLE_PERMILLE;
+    if (credit > MESH_AIRTIME_BURST_MS * 1000UL) credit = MESH_AIRTIME_BURST_MS * 1000UL;
+    airtimeCreditUs = credit;
+}
+
+bool MeshLink::batchDue() {
+    if (pendingCount == 0) return false;
+    if (inFlight > 0) return (int32_t)(radio->nowMs() - retryAt) >= 0;
+    if (pendingCount >= MESH_BATCH_SIZE) return true;
+    return radio->nowMs() - pending[0].queuedAt >= MESH_BATCH_MAX_AGE_MS;
+}
+
+uint32_t MeshLink::txOffset() {
+    slotRandom = slotRandom * 1664525u + 1013904223u;
+    return ((slotRandom >> 16) % MESH_TX_SLOTS) * MESH_TX_SLOT_MS;
+}
+
+bool MeshLink::transmitNext(uint32_t deadline) {
+    if (batchDue()) {
+        int count = pendingCount;
+        if (!sendPacket(count, deadline)) return false;
+
+        // Keep the batch until someone acknowledges it, resending less
+        // often each time but at least once per holdoff
+        inFlight = count;
+        inFlightSequence = (uint8_t)(sequence - 1);
+        uint32_t backoff = MESH_RETRY_MS << (attempts < 3 ? attempts : 3);
+        if (backoff > MESH_REPORT_HOLDOFF_MS) backoff = MESH_REPORT_HOLDOFF_MS;
+        attempts++;
+        slotRandom = slotRandom * 1664525u + 1013904223u;
+        retryAt = radio->nowMs() + backoff / 2 + (slotRandom >> 8) % (backoff / 2);
+        return true;
+    }
+    if (ackPending) return sendPacket(0, deadline);
+    return false;
+}
+
+bool MeshLink::sendPacket(int count, uint32_t deadline) {
+    uint8_t buf[MESH_MAX_PACKET_LEN];
+    MeshPacketHeader hdr;
+    hdr.magic = MESH_PACKET_MAGIC;
+    hdr.version = MESH_PACKET_VERSION;
+    hdr.nodeId = nodeId;
+    hdr.sequence = sequence;
+    hdr.count = (uint8_t)count;
+    hdr.ackNode = ackPending ? ackNode : 0;
+    hdr.ackSequence = ackPending ? ackSequence : 0;
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    size_t len = sizeof(hdr);
+    for (int i = 0; i < count; i++) {
+        memcpy(buf + len, &pending[i].entry, sizeof(MeshReportEntry));
+        len += sizeof(MeshReportEntry);
+    }
+
+    // Only send when both the duty-cycle budget and the window allow it
+    uint32_t toaUs = radio->getTimeOnAir(len);
+    if (toaUs > airtimeCreditUs) return false;
+    if ((int32_t)(deadline - radio->nowMs()) <= (int32_t)(toaUs / 1000 + 1)) return false;
+    if (radio->isChannelBusy()) return false;
+
+    if (!radio->transmit(buf, len)) return false;
+
+    airtimeCreditUs -= toaUs;
+    airtimeUs += toaUs;
+    sequence++;
+    if (count > 0) {
+        packetsSent++;
+    } else {
+        acksSent++;
+    }
+    ackPending = false;
+    return true;
+}
+
+void MeshLink::confirmBatch() {
+    uint32_t now = radio->nowMs();
+    for (int i = 0; i < inFlight; i++) {
+        sent[sentNext].freqCode = pending[i].entry.freqCode;
+        sent[sentNext].band = pending[i].entry.flags >> 7;
+        sent[sentNext].sentAt = now;
+        sentNext = (sentNext + 1) % MESH_SENT_HISTORY;
+    }
+
+    // Reports queued since the batch went out stay for the next one
+    for (int i = inFlight; i < pendingCount; i++) {
+        pending[i - inFlight] = pending[i];
+    }
+    pendingCount -= inFlight;
+    inFlight = 0;
+    attempts = 0;
+}
+
+void MeshLink::listen(uint32_t deadline) {
+    radio->startReceive();
+
+    // After a busy channel, try again only once a later packet is heard;
+    // the detection cut off the one that was on the air
+    bool armed = true;
+    bool scheduled = false;
+    uint32_t txAt = 0;
+
+    while ((int32_t)(deadline - radio->nowMs()) > 0) {
+        if (armed && (ackPending || batchDue())) {
+            txAt = radio->nowMs() + txOffset();
+            armed = false;
+            scheduled = true;
+        }
+        if (scheduled && (int32_t)(radio->nowMs() - txAt) >= 0) {
+            scheduled = false;
+            transmitNext(deadline);
+            radio->startReceive();
+        }
+
+        uint8_t buf[MESH_MAX_PACKET_LEN];
+        size_t len = radio->readPacket(buf, sizeof(buf));
+        if (len > 0) {
+            handlePacket(buf, len);
+            armed = true;
+        }
+        radio->idle(1);
+    }
+}
+
+void MeshLink::handlePacket(const uint8_t* data, size_t len) {
+    if (len < sizeof(MeshPacketHeader)) return;
+
+    MeshPacketHeader hdr;
+    memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.magic != MESH_PACKET_MAGIC || hdr.version != MESH_PACKET_VERSION) return;
+    if (hdr.nodeId == nodeId) return;
+    if (len != sizeof(hdr) + hdr.count * sizeof(MeshReportEntry)) return;
+
+    packetsReceived++;
+    uint32_t now = radio->nowMs();
+
+    if (inFlight > 0 && hdr.ackNode == nodeId && hdr.ackSequence == inFlightSequence) {
+        confirmBatch();
+    }
+    if (hdr.count > 0) {
+        ackPending = true;
+        ackNode = hdr.nodeId;
+        ackSequence = hdr.sequence;
+    }
+
+    for (int n = 0; n < hdr.count; n++) {
+        MeshReportEntry e;
+        memcpy(&e, data + sizeof(hdr) + n * sizeof(e), sizeof(e));
+
+        float freq = e.freqCode / 10.0f;
+        uint8_t band = e.flags >> 7;
+
+        // Update the same node's report for this emitter, else take a slot
+        int slot = -1;
+        int oldest = 0;
+        for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+            if (remote[i].active && remote[i].nodeId == hdr.nodeId &&
+                remote[i].band == band && fabs(remote[i].frequency - freq) < 1.0) {
+                slot = i;
+                break;
+            }
+            if (slot < 0 && !remote[i].active) slot = i;
+            if (remote[i].timestamp < remote[oldest].timestamp) oldest = i;
+        }
+        if (slot < 0) slot = oldest;
+
+        remote[slot].nodeId = hdr.nodeId;
+        remote[slot].frequency = freq;
+        remote[slot].rssi = e.rssi;
+        remote[slot].band = band;
+        remote[slot].modType = (ModulationType)(e.flags & 0x0F);
+        remote[slot].timestamp = now;
+        remote[slot].active = true;
+
+        if (reportHandler != nullptr) {
+            reportHandler(remote[slot]);
+        }
+    }
+}
+
+void MeshLink::cleanupRemote() {
+    uint32_t now = radio->nowMs();
+    for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+        if (remote[i].active && now - remote[i].timestamp > MESH_REMOTE_HOLD_MS) {
+            remote[i].active = false;
+        }
+    }
+}
+
+uint32_t MeshLink::runWindow() {
+    if (!available) return 0;
+
+    uint32_t deadline = radio->nowMs() + MESH_WINDOW_MS;
+
+    if (radio->setFrequency(MESH_FREQ)) {
+        updateCredit();
+        listen(deadline);
+    } else {
+        // Keep the window length fixed even if the radio misbehaves
+        while ((int32_t)(deadline - radio->nowMs()) > 0) radio->idle(1);
+    }
+
+    radio->standby();
+    cleanupRemote();
+    return radio->nowMs();
+}
+
+RemoteReport* MeshLink::getRemoteReports() {
+    return remote;
+}
+
+uint16_t MeshLink::getNodeId() {
+    return nodeId;
+}
+
+bool MeshLink::isAvailable() {
+    return available;
+}
+
+uint32_t MeshLink::getPacketsSent() {
+    return packetsSent;
+}
+
+uint32_t MeshLink::getPacketsReceived() {
+    return packetsReceived;
+}
+
+uint32_t MeshLink::getAcksSent() {
+    return acksSent;
+}
+
+int MeshLink::getPendingCount() {
+    return pendingCount;
+}
+
+uint64_t MeshLink::getAirtimeUs() {
+    return airtimeUs;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file pps_pairer.cpp
+ * @brief PPS edge and RMC sentence pairing implementation
+ */
+
+#include "pps_pairer.h"
+#include <string.h>
+
+// Days from 1970-01-01 to a civil date (proleptic Gregorian)
+static int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return (int64_t)era * 146097 + doe - 719468;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Two decimal digits, or -1
+static int twoDigits(const char* p) {
+    if (p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9') return -1;
+    return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+PpsPairer::PpsPairer() {
+    clock = nullptr;
+    length = -1;
+    utcSecond = 0;
+    pairedPulse = 0;
+}
+
+void PpsPairer::begin(SweepClock* sweepClock) {
+    clock = sweepClock;
+}
+
+bool PpsPairer::encode(char c) {
+    if (c == '$') {
+        sentence[0] = c;
+        length = 1;
+        return false;
+    }
+    if (length < 0) return false;
+
+    if (c == '\r' || c == '\n') {
+        sentence[length] = '\0';
+        length = -1;
+        return parseRmc();
+    }
+
+    if (length >= NMEA_SENTENCE_MAX) {
+        length = -1;               // Overlong: drop it
+        return false;
+    }
+    sentence[length++] = c;
+    return false;
+}
+
+bool PpsPairer::parseRmc() {
+    // $ttRMC,...*hh with any talker
+    int len = (int)strlen(sentence);
+    if (len < 10 || strncmp(sentence + 3, "RMC,", 4) != 0) return false;
+
+    const char* star = strchr(sentence, '*');
+    if (star == nullptr || star + 3 != sentence + len) return false;
+    uint8_t sum = 0;
+    for (const char* p = sentence + 1; p < star; p++) sum ^= (uint8_t)*p;
+    int hi = hexDigit(star[1]);
+    int lo = hexDigit(star[2]);
+    if (hi < 0 || lo < 0 || sum != (uint8_t)(hi * 16 + lo)) return false;
+
+    // Fields 1 (hhmmss[.ss]), 2 (status) and 9 (ddmmyy)
+    const char* field[10];
+    int n = 0;
+    for (const char* p = sentence; p < star && n < 10; p++) {
+        if (*p == ',') field[n++] = p + 1;
+    }
+    if (n < 9) return false;
+    const char* time = field[0];
+    const char* status = field[1];
+    const char* date = field[8];
+
+    if (*status != 'A') return false;
+    int hour = twoDigits(time);
+    int minute = twoDigits(time + 2);
+    int second = hour < 0 || minute < 0 ? -1 : twoDigits(time + 4);
+    if (second < 0 || hour > 23 || minute > 59 || second > 60) return false;
+    if (time[6] == '.') {
+        for (const char* p = time + 7; *p >= '0' && *p <= '9'; p++) {
+            if (*p != '0') return false;   // Not a whole-second fix
+        }
+    }
+
+    int day = twoDigits(date);
+    int month = day < 0 ? -1 : twoDigits(date + 2);
+    int year = month < 0 ? -1 : twoDigits(date + 4);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    utcSecond = daysFromCivil(2000 + year, month, day) * 86400 +
+                hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+int64_t PpsPairer::getUtcSecond() const {
+    return utcSecond;
+}
+
+bool PpsPairer::pairPulse(uint32_t count, int64_t edgeUs, int64_t nowUs) {
+    if (clock == nullptr) return false;
+
+    // The sentence for second N follows the edge that starts it
+    if (count == pairedPulse) return false;
+    if (nowUs - edgeUs > (int64_t)GPS_NMEA_MAX_DELAY_MS * 1000) return false;
+
+    pairedPulse = count;
+    clock->discipline(edgeUs, utcSecond);
+    return true;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file radio_commands.cpp
+ * @brief SX126x and SX128x command frame builders
+ */
+
+#include "radio_commands.h"
+#include <string.h>
+
+// Chip mode in the status byte, the same value on both chips
+#define STATUS_MODE_RX 0x05
+
+static void frame(RadioCommand& cmd, const uint8_t* bytes, uint8_t length) {
+    memcpy(cmd.bytes, bytes, length);
+    memset(cmd.reply, 0, sizeof(cmd.reply));
+    cmd.length = length;
+}
+
+// Opcode, then the status byte and the RSSI clocked out by two NOPs
+static bool parseRssiReply(const RadioCommand& read, int modeShift, float& dbm) {
+    if (((read.reply[1] >> modeShift) & 0x07) != STATUS_MODE_RX) return false;
+    dbm = -(float)read.reply[2] / 2;
+    return true;
+}
+
+void SX126xCommands::buildStep(RadioStep& step, uint32_t word) {
+    // Timeout 0xFFFFFF: receive until told otherwise
+    const uint8_t receive[] = { SX126X_OP_SET_RX, 0xFF, 0xFF, 0xFF };
+    const uint8_t read[] = { SX126X_OP_GET_RSSI_INST, 0x00, 0x00 };
+    const uint8_t standby[] = { SX126X_OP_SET_STANDBY, 0x00 };
+
+    setFrequency(step, word);
+    frame(step.commands[RADIO_STEP_RECEIVE], receive, sizeof(receive));
+    frame(step.commands[RADIO_STEP_READ_RSSI], read, sizeof(read));
+    frame(step.commands[RADIO_STEP_STANDBY], standby, sizeof(standby));
+}
+
+void SX126xCommands::setFrequency(RadioStep& step, uint32_t word) {
+    const uint8_t tune[] = { SX126X_OP_SET_RF_FREQUENCY, (uint8_t)(word >> 24),
+                             (uint8_t)(word >> 16), (uint8_t)(word >> 8), (uint8_t)word };
+    frame(step.commands[RADIO_STEP_TUNE], tune, sizeof(tune));
+}
+
+bool SX126xCommands::parseRssi(const RadioCommand& read, float& dbm) {
+    // Chip mode is in status bits 6:4
+    return parseRssiReply(read, 4, dbm);
+}
+
+void SX128xCommands::buildStep(RadioStep& step, uint32_t word) {
+    // Period base 15.625 us, count 0xFFFF: receive until told otherwise
+    const uint8_t receive[] = { SX128X_OP_SET_RX, 0x00, 0xFF, 0xFF };
+    const uint8_t read[] = { SX128X_OP_GET_RSSI_INST, 0x00, 0x00 };
+    const uint8_t standby[] = { SX128X_OP_SET_STANDBY, 0x00 };
+
+    setFrequency(step, word);
+    frame(step.commands[RADIO_STEP_RECEIVE], receive, sizeof(receive));
+    frame(step.commands[RADIO_STEP_READ_RSSI], read, sizeof(read));
+    frame(step.commands[RADIO_STEP_STANDBY], standby, sizeof(standby));
+}
+
+void SX128xCommands::setFrequency(RadioStep& step, uint32_t word) {
+    const uint8_t tune[] = { SX128X_OP_SET_RF_FREQUENCY, (uint8_t)(word >> 16),
+                             (uint8_t)(word >> 8), (uint8_t)word };
+    frame(step.commands[RADIO_STEP_TUNE], tune, sizeof(tune));
+}
+
+bool SX128xCommands::parseRssi(const RadioCommand& read, float& dbm) {
+    // Chip mode is in status bits 7:5
+    return parseRssiReply(read, 5, dbm);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file radio_scheduler.cpp
+ * @brief Time-slot plan implementation
+ */
+
+#include "radio_scheduler.h"
+
+RadioScheduler::RadioScheduler() {
+    mesh = nullptr;
+    slotsInFrame = 0;
+    frameStart = 0;
+    frameMs = 0;
+}
+
+void RadioScheduler::begin(MeshLink* meshLink, uint32_t nowMs) {
+    mesh = meshLink;
+    frameStart = nowMs;
+}
+
+RadioSlot RadioScheduler::nextSlot() {
+    if (mesh != nullptr && mesh->isAvailable() &&
+        slotsInFrame >= MESH_SWEEPS_PER_WINDOW) {
+        return SLOT_MESH;
+    }
+    return SLOT_SWEEP;
+}
+
+void RadioScheduler::slotCompleted() {
+    slotsInFrame++;
+}
+
+void RadioScheduler::runMeshWindow() {
+    uint32_t now = mesh->runWindow();
+    frameMs = now - frameStart;
+    frameStart = now;
+    slotsInFrame = 0;
+}
+
+uint32_t RadioScheduler::getFrameMs() {
+    return frameMs;
+}
+
+int RadioScheduler::getSlotsInFrame() {
+    return slotsInFrame;
+}
+
+void RadioScheduler::setSlotsInFrame(int slots) {
+    slotsInFrame = slots;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file radiolib_mesh_transport.cpp
+ * @brief MeshTransport on the SX1262
+ */
+
+#include "radiolib_mesh_transport.h"
+
+volatile bool RadioLibMeshTransport::packetFlag = false;
+
+void IRAM_ATTR RadioLibMeshTransport::onDio1() {
+    packetFlag = true;
+}
+
+RadioLibMeshTransport::RadioLibMeshTransport() {
+    radio = nullptr;
+}
+
+void RadioLibMeshTransport::setRadio(SX1262* sx1262) {
+    radio = sx1262;
+}
+
+bool RadioLibMeshTransport::configure() {
+    if (radio == nullptr) return false;
+
+    // Shorter symbols keep every TX inside one scheduler window; the
+    // spreading factor has no effect on the RSSI sweep
+    return radio->setSpreadingFactor(MESH_SPREADING_FACTOR) == RADIOLIB_ERR_NONE;
+}
+
+uint16_t RadioLibMeshTransport::getNodeId() {
+    return (uint16_t)(ESP.getEfuseMac() >> 32);
+}
+
+// The sweep calibrates image rejection once for all of 860-930 MHz
+// (SX126xTraits::calibrate). The driver's default setFrequency() would
+// recalibrate for the mesh channel's band alone, so the mesh retunes
+// without it and must stay inside the swept span.
+static_assert(MESH_FREQ >= FREQ_900_START && MESH_FREQ <= FREQ_900_END,
+              "MESH_FREQ outside the 900MHz image calibration");
+
+bool RadioLibMeshTransport::setFrequency(float freq) {
+    return radio->setFrequency(freq, false) == RADIOLIB_ERR_NONE;
+}
+
+uint32_t RadioLibMeshTransport::getTimeOnAir(size_t len) {
+    return radio->getTimeOnAir(len);
+}
+
+bool RadioLibMeshTransport::transmit(const uint8_t* data, size_t len) {
+    // RadioLib 6 takes a non-const buffer but does not modify it
+    return radio->transmit(const_cast<uint8_t*>(data), len) == RADIOLIB_ERR_NONE;
+}
+
+bool RadioLibMeshTransport::isChannelBusy() {
+    // Channel activity detection: a couple of symbols looking for a preamble
+    return radio->scanChannel() == RADIOLIB_LORA_DETECTED;
+}
+
+bool RadioLibMeshTransport::startReceive() {
+    packetFlag = false;
+    radio->setDio1Action(onDio1);
+    return radio->startReceive() == RADIOLIB_ERR_NONE;
+}
+
+size_t RadioLibMeshTransport::readPacket(uint8_t* data, size_t maxLen) {
+    if (!packetFlag) return 0;
+    packetFlag = false;
+
+    size_t len = radio->getPacketLength();
+    bool ok = len <= maxLen && radio->readData(data, len) == RADIOLIB_ERR_NONE;
+    radio->startReceive();
+    return ok ? len : 0;
+}
+
+void RadioLibMeshTransport::standby() {
+    radio->clearDio1Action();
+    radio->standby();
+}
+
+uint32_t RadioLibMeshTransport::nowMs() {
+    return millis();
+}
+
+void RadioLibMeshTransport::idle(uint32_t ms) {
+    delay(ms);
+}
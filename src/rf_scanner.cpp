@@ -4,7 +4,17 @@
  */
 
 #include "rf_scanner.h"
+#include "warm_state.h"
+#include "watchlist.h"
+#include "display_ui.h"
+#include "classifier.h"
+#include "emitter_cluster.h"
+#include <SPI.h>
 #include <cmath>
+#include "esp_timer.h"
+#if SPECTRAL_SCAN_900
+#include <modules/SX126x/patches/SX126x_patch_scan.h>
+#endif
 
 // Create module instances for RadioLib
 #if defined(LORA_CS) && defined(LORA_IRQ) && defined(LORA_RST) && defined(LORA_BUSY)
@@ -19,13 +29,67 @@ static Module mod2400(SX1280_CS, SX1280_IRQ, SX1280_RST, SX1280_BUSY);
 static Module mod2400(5, 39, 14, 15);  // Default 2.4GHz module pins
 #endif
 
+// Task waiting on the zero-span sample timer
+static TaskHandle_t zeroSpanTask = nullptr;
+
+static void IRAM_ATTR onZeroSpanTimer() {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(zeroSpanTask, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// SX1262 side of the hardware spectral scan
+class SX1262Spectral : public SpectralRadio {
+public:
+    SX1262Spectral(SX1262* sx1262) : radio(sx1262) {}
+    
+    bool start(float freq, uint16_t samples) override {
+        radio->standby();  // Retune only from standby
+        if (!SX126xTraits::tune(*radio, SX126xTraits::frequencyWord(freq))) return false;
+        return radio->spectralScanStart(samples) == RADIOLIB_ERR_NONE;
+    }
+    
+    bool finished() override {
+        return radio->spectralScanGetStatus() == RADIOLIB_ERR_NONE;
+    }
+    
+    bool readHistogram(uint16_t* bins) override {
+        return radio->spectralScanGetResult(bins) == RADIOLIB_ERR_NONE;
+    }
+    
+    void stop() override {
+        radio->spectralScanAbort();
+        radio->standby();
+    }
+    
+    void sleepUs(uint32_t us) override {
+        SX126xTraits::delayUs(us);
+    }
+    
+    uint32_t nowUs() override {
+        return micros();
+    }
+    
+private:
+    SX1262* radio;
+};
+
 RFScanner::RFScanner() {
     radio900 = nullptr;
     radio2400 = nullptr;
+    spectralRadio = nullptr;
+    clock = nullptr;
+    lateSamples = 0;
     signalCount = 0;
     currentFreq = 0;
     sx1262Available = false;
     sx1280Available = false;
+    firstSweepMs = 0;
+    watchlist = nullptr;
+    display = nullptr;
+    memset(&staging, 0, sizeof(staging));
     
     // Initialize signals array
     for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
@@ -34,189 +98,310 @@ RFScanner::RFScanner() {
         signals[i].rssi = -120;
         signals[i].modType = MOD_UNKNOWN;
         signals[i].timestamp = 0;
+        signals[i].holdUntil = 0;
         signals[i].band = 0;
+        signals[i].latitude = 0;
+        signals[i].longitude = 0;
+        signals[i].hasPosition = false;
+        signals[i].modFromBurst = false;
+        signals[i].occupancy = 0;
+        signals[i].bandwidth = 0;
+        signals[i].utcUs = 0;
+    }
+    
+    bands[0].analyzer.begin(0, Plan900::CHANNELS, Plan900::frequency(0), FREQ_900_STEP);
+    bands[1].analyzer.begin(1, Plan2400::CHANNELS, Plan2400::frequency(0), FREQ_2400_STEP);
+    for (int b = 0; b < 2; b++) {
+        BandState& st = bands[b];
+        st.analyzer.setSpurMask(&st.spurs);
+        st.spurCount = 0;
+        st.spurCalibrating = false;
+        st.rowUtcUs = 0;
+        memset(st.late, 0, sizeof(st.late));
+        st.sweeps = 0;
+        st.rateWindowStart = 0;
+        st.rateWindowSweeps = 0;
+        st.sweepRate = 0;
     }
 }
 
 bool RFScanner::begin() {
     Serial.println("[RF] Initializing RF Scanner...");
     
-    // Initialize SX1262 for 900MHz band
+    begin900();
+    begin2400();
+    
+    return sx1262Available || sx1280Available;
+}
+
+bool RFScanner::probeRadio(Module& mod, int statusShift) {
+    uint32_t cs = mod.getCs();
+    uint32_t rst = mod.getRst();
+    uint32_t busy = mod.getGpio();
+    
+    pinMode(cs, OUTPUT);
+    digitalWrite(cs, HIGH);
+    pinMode(busy, INPUT);
+    
+    // Reset, then BUSY must drop once the chip is in standby
+    pinMode(rst, OUTPUT);
+    digitalWrite(rst, LOW);
+    delayMicroseconds(200);
+    digitalWrite(rst, HIGH);
+    
+    uint32_t start = millis();
+    while (digitalRead(busy) == HIGH) {
+        if (millis() - start > RADIO_PROBE_TIMEOUT_MS) return false;
+        delay(1);
+    }
+    
+    // GetStatus; an empty socket reads back all zeros or all ones
+    SPI.beginTransaction(SPISettings(RADIO_SPI_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(cs, LOW);
+    SPI.transfer(0xC0);
+    uint8_t status = SPI.transfer(0x00);
+    digitalWrite(cs, HIGH);
+    SPI.endTransaction();
+    
+    uint8_t mode = (status >> statusShift) & 0x07;
+    return mode >= 2 && mode <= 6;
+}
+
+bool RFScanner::begin900() {
+    // SX126x chip mode is in status bits 6:4
+    if (!probeRadio(mod900, 4)) {
+        Serial.println("[RF] SX1262 (900MHz) not detected");
+        sx1262Available = false;
+        return false;
+    }
+    
     radio900 = new SX1262(&mod900);
+    int state = radio900->begin(915.0, Scanner900::bandwidthKHz(SCAN_BANDWIDTH_900_KHZ), 9, 7,
+                                RADIOLIB_SX126X_SYNC_WORD_PRIVATE, 10, 8, 0, false);
+    
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.print("[RF] SX1262 (900MHz) failed, code ");
+        Serial.println(state);
+        sx1262Available = false;
+        return false;
+    }
     
-    Serial.print("[RF] Initializing SX1262 (900MHz)... ");
-    int state = radio900->begin(915.0, 125.0, 9, 7, RADIOLIB_SX126X_SYNC_WORD_PRIVATE, 10, 8, 0, false);
+    // Set to standby mode for scanning
+    radio900->standby();
+    if (!scanner900.begin(radio900)) {
+        Serial.println("[RF] SX1262 image calibration failed");
+    }
     
+#if SPECTRAL_SCAN_900
+    // The scan patch lives in chip RAM, so it goes up on every begin
+    state = radio900->uploadPatch(sx126x_patch_scan, sizeof(sx126x_patch_scan));
     if (state == RADIOLIB_ERR_NONE) {
-        Serial.println("Success!");
-        sx1262Available = true;
-        
-        // Set to standby mode for scanning
-        radio900->standby();
+        if (spectralRadio == nullptr) spectralRadio = new SX1262Spectral(radio900);
+        spectral.begin(spectralRadio, SPECTRAL_SAMPLES, SPECTRAL_SAMPLE_US,
+                       SPECTRAL_TIMEOUT_MS * 1000UL);
+        Serial.println("[RF] SX1262 spectral scan enabled");
     } else {
-        Serial.print("Failed, code ");
+        Serial.print("[RF] SX1262 scan patch failed, code ");
         Serial.println(state);
-        sx1262Available = false;
     }
+#endif
     
-    // Initialize SX1280 for 2.4GHz band (if available)
-    radio2400 = new SX1280(&mod2400);
+    Serial.println("[RF] SX1262 (900MHz) ready");
+    sx1262Available = true;
+    return true;
+}
+
+bool RFScanner::begin2400() {
+    // SX128x chip mode is in status bits 7:5
+    if (!probeRadio(mod2400, 5)) {
+        Serial.println("[RF] SX1280 (2.4GHz) not connected");
+        sx1280Available = false;
+        return false;
+    }
     
-    Serial.print("[RF] Initializing SX1280 (2.4GHz)... ");
-    state = radio2400->begin(2450.0, 1600.0, 7, 9, 0x12, 13);
+    radio2400 = new SX1280(&mod2400);
+    int state = radio2400->begin(2450.0, Scanner2400::bandwidthKHz(SCAN_BANDWIDTH_2400_KHZ), 7, 9, 0x12, 13);
     
-    if (state == RADIOLIB_ERR_NONE) {
-        Serial.println("Success!");
-        sx1280Available = true;
-        radio2400->standby();
-    } else {
-        Serial.print("Not available, code ");
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.print("[RF] SX1280 (2.4GHz) not available, code ");
         Serial.println(state);
         sx1280Available = false;
+        return false;
     }
     
-    return sx1262Available || sx1280Available;
+    radio2400->standby();
+    scanner2400.begin(radio2400);
+    Serial.println("[RF] SX1280 (2.4GHz) ready");
+    sx1280Available = true;
+    return true;
 }
 
-int RFScanner::scan900MHz() {
-    if (!sx1262Available) return 0;
-    
-    int detected = 0;
+int RFScanner::scan(uint8_t band) {
+    if (band == 0 ? !sx1262Available : !sx1280Available) return 0;
+    return sweepBand(band, 0);
+}
+
+int RFScanner::scanAt(uint8_t band, int64_t startUtcUs) {
+    if (band == 0 ? !sx1262Available : !sx1280Available) return 0;
+    return sweepBand(band, startUtcUs);
+}
+
+void RFScanner::setClock(SweepClock* sweepClock) {
+    clock = sweepClock;
+}
+
+uint32_t RFScanner::getLateSamples() {
+    return lateSamples;
+}
+
+template <typename Scanner>
+void RFScanner::measureRow(Scanner& scanner, uint8_t band, bool aligned, int64_t startLocalUs) {
+    BandAnalyzer& analyzer = bands[band].analyzer;
+    bool* late = bands[band].late;
+    bool hardwareScan = Scanner::RadioTraits::SPECTRAL_SCAN && spectralRadio != nullptr;
     
-    // Scan across the 900MHz band
-    for (float freq = FREQ_900_START; freq <= FREQ_900_END; freq += FREQ_900_STEP) {
+    for (int ch = 0; ch < Scanner::CHANNELS; ch++) {
+        float freq = Scanner::frequency(ch);
         currentFreq = freq;
         
-        float rssi = measureRSSI(freq, 0);
+        int64_t dwellUs = startLocalUs + (int64_t)ch * SYNC_DWELL_US;
+        late[ch] = false;
+        if (aligned) {
+            int64_t wait = dwellUs - esp_timer_get_time();
+            if (wait > 0) {
+                delayMicroseconds((uint32_t)wait);
+            } else if (wait < -SYNC_LATE_US) {
+                late[ch] = true;
+            }
+        }
+        
+        // The histogram peak stands in for the single read, so short
+        // bursts between retunes still show up in the row
+        int8_t threshold = analyzer.getThreshold(ch);
+        int8_t value;
+        SpectralStats stats;
+        uint32_t flushes = display != nullptr ? display->getFlushCount() : 0;
+        if (hardwareScan && spectral.measure(freq, threshold, stats)) {
+            value = stats.peakDbm;
+            analyzer.setSample(ch, value, stats.meanDbm, stats.occupancy);
+        } else {
+            value = toRowValue(scanner.measure(ch));
+            analyzer.setSample(ch, value, value, value > threshold ? 100 : 0);
+        }
         
-        if (rssi > RSSI_THRESHOLD) {
-            ModulationType mod = analyzeModulation(freq, 0);
-            addSignal(freq, rssi, mod, 0);
-            detected++;
+        // A flush was running when the sample started, or began during it
+        if (display != nullptr && ((flushes & 1) || display->getFlushCount() != flushes)) {
+            analyzer.markActivity(ch, SPUR_DISPLAY);
+        }
+        
+        // A sample still running into the next channel's dwell was not
+        // taken at its slot time either; other units sampled elsewhere
+        if (aligned) {
+            if (esp_timer_get_time() > dwellUs + SYNC_DWELL_US) late[ch] = true;
+            if (late[ch]) lateSamples++;
+        }
+        
+        // Watchlisted channels alert from here, not after the sweep
+        if (watchlist != nullptr) {
+            watchlist->onSample(band, ch, value, threshold);
         }
     }
     
-    cleanupSignals();
-    return detected;
+    if (hardwareScan) scanner.standby();
 }
 
-int RFScanner::scan2400MHz() {
-    if (!sx1280Available) return 0;
+int RFScanner::sweepBand(uint8_t band, int64_t startUtcUs) {
+    BandState& st = bands[band];
     
-    int detected = 0;
+    // Aligned sweeps are paced on the local timer from one conversion; the
+    // disciplined rate error over a sweep is a few us at most
+    int64_t startLocalUs = 0;
+    bool aligned = startUtcUs != 0 && clock != nullptr && clock->toLocal(startUtcUs, startLocalUs);
+    st.rowUtcUs = aligned ? startUtcUs : 0;
     
-    // Scan across the 2.4GHz band
-    for (float freq = FREQ_2400_START; freq <= FREQ_2400_END; freq += FREQ_2400_STEP) {
-        currentFreq = freq;
-        
-        float rssi = measureRSSI(freq, 1);
-        
-        if (rssi > RSSI_THRESHOLD) {
-            ModulationType mod = analyzeModulation(freq, 1);
-            addSignal(freq, rssi, mod, 1);
-            detected++;
-        }
+    // Measure the whole row first so the kernels see one consistent sweep
+    if (band == 0) {
+        measureRow(scanner900, band, aligned, startLocalUs);
+    } else {
+        measureRow(scanner2400, band, aligned, startLocalUs);
+    }
+    
+    // One tracker entry per transmitter, not per channel it covers
+    EmitterCluster clusters[CLUSTER_MAX];
+    int detected = st.analyzer.detect(clusters, CLUSTER_MAX);
+    logSpurs(band);
+    for (int i = 0; i < detected; i++) {
+        const EmitterCluster& c = clusters[i];
+        ModulationType mod = isWidebandCluster(c) ? classifyWideband(c)
+                                                  : analyzeModulation(band, c.peakChannel);
+        // Only samples taken in their dwell carry the shared timeline
+        bool onTime = aligned && !st.late[c.peakChannel];
+        int64_t utcUs = onTime ? startUtcUs + (int64_t)c.peakChannel * SYNC_DWELL_US : 0;
+        addSignal(c.centerMHz, c.bandwidthMHz, c.peakDbm, st.analyzer.getOccupancy(c.peakChannel),
+                  mod, band, utcUs);
     }
     
+    st.sweeps++;
+    if (firstSweepMs == 0) firstSweepMs = millis();
+    
+    // Sweep rate over a fixed window; the closing sweep opens the next one
+    uint32_t now = millis();
+    if (st.rateWindowSweeps == 0) {
+        st.rateWindowStart = now;
+    } else if (now - st.rateWindowStart >= SWEEP_RATE_WINDOW_MS) {
+        st.sweepRate = st.rateWindowSweeps * 1000.0f / (now - st.rateWindowStart);
+        st.rateWindowStart = now;
+        st.rateWindowSweeps = 0;
+    }
+    st.rateWindowSweeps++;
     cleanupSignals();
+    publish(band);
     return detected;
 }
 
-float RFScanner::measureRSSI(float freq, uint8_t band) {
-    float rssi = -120.0;  // Default very low
+ModulationType RFScanner::analyzeModulation(uint8_t band, int channel) {
+    int16_t features[CLASSIFIER_FEATURES];
+    bands[band == 0 ? 0 : 1].analyzer.features(channel, features);
     
-    if (band == 0 && sx1262Available) {
-        // Set frequency on SX1262
-        int state = radio900->setFrequency(freq);
-        if (state == RADIOLIB_ERR_NONE) {
-            // Put radio in receive mode briefly to measure RSSI
-            // Note: Minimal delay needed for RSSI settling; consider async 
-            // scanning for higher performance in future versions
-            radio900->startReceive();
-            delay(2);  // Minimal settling time
-            rssi = radio900->getRSSI();
-            radio900->standby();
-        }
-    } else if (band == 1 && sx1280Available) {
-        // Set frequency on SX1280
-        int state = radio2400->setFrequency(freq);
-        if (state == RADIOLIB_ERR_NONE) {
-            radio2400->startReceive();
-            delay(2);  // Minimal settling time
-            rssi = radio2400->getRSSI();
-            radio2400->standby();
-        }
-    }
-    
-    return rssi;
-}
-
-ModulationType RFScanner::analyzeModulation(float freq, uint8_t band) {
-    // Modulation analysis based on signal characteristics
-    // This is a simplified heuristic - real implementation would need
-    // more sophisticated signal analysis
-    
-    ModulationType detectedMod = MOD_UNKNOWN;
-    
-    // Check for common drone frequency patterns
-    if (band == 0) {  // 900MHz band
-        // LoRa is common in this band for longer range drones
-        if (freq >= 902.0 && freq <= 928.0) {
-            // FCC 900MHz ISM band - often FHSS or LoRa
-            // Check bandwidth characteristics
-            if (sx1262Available) {
-                // Sample multiple times to check for frequency hopping
-                // Delay between samples to detect signal variance
-                float rssi1 = measureRSSI(freq, 0);
-                delay(5);  // Brief interval for FHSS detection
-                float rssi2 = measureRSSI(freq, 0);
-                
-                if (fabs(rssi1 - rssi2) > 20) {
-                    detectedMod = MOD_FHSS;  // Signal varies - likely FHSS
-                } else if (rssi1 > -60) {
-                    detectedMod = MOD_LORA;  // Strong steady signal
-                } else {
-                    detectedMod = MOD_GFSK;  // Moderate signal
-                }
-            }
-        } else if (freq >= 868.0 && freq <= 870.0) {
-            // EU 868MHz band - typically LoRa
-            detectedMod = MOD_LORA;
-        } else {
-            detectedMod = MOD_FSK;
-        }
-    } else {  // 2.4GHz band
-        // Most consumer drones use this band with FHSS or DSSS
-        if (freq >= 2400.0 && freq <= 2483.0) {
-            // Check signal characteristics
-            float rssi1 = measureRSSI(freq, 1);
-            delay(5);  // Brief interval for FHSS detection
-            float rssi2 = measureRSSI(freq, 1);
-            
-            if (fabs(rssi1 - rssi2) > 15) {
-                detectedMod = MOD_FHSS;  // Frequency hopping detected
-            } else if (rssi1 > -50) {
-                // Strong signal - could be DSSS or OFDM
-                detectedMod = MOD_DSSS;
-            } else {
-                detectedMod = MOD_GFSK;
-            }
-        }
+#if CLASSIFIER_LOG_FEATURES
+    // Training rows for tools/train_classifier.py
+    Serial.print("[FEAT] ");
+    for (int f = 0; f < CLASSIFIER_FEATURES; f++) {
+        if (f > 0) Serial.print(',');
+        Serial.print(features[f]);
     }
+    Serial.println();
+#endif
     
-    return detectedMod;
+    return classifyEmitter(features);
 }
 
-void RFScanner::addSignal(float freq, float rssi, ModulationType mod, uint8_t band) {
-    // Check if signal already exists
+void RFScanner::addSignal(float freq, float bandwidth, float rssi, uint8_t occupancy,
+                          ModulationType mod, uint8_t band, int64_t utcUs) {
+    // One consistent copy even if the loop moves the position meanwhile
+    ObserverPosition pos;
+    position.read(pos);
+    
+    // Check if signal already exists: within 1 MHz, or overlapping in band
     for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        float separation = fabs(signals[i].frequency - freq);
         if (signals[i].active && 
-            fabs(signals[i].frequency - freq) < 1.0 &&
+            (separation < 1.0 || separation < (signals[i].bandwidth + bandwidth) / 2) &&
             signals[i].band == band) {
             // Update existing signal
+            signals[i].frequency = freq;
+            signals[i].bandwidth = bandwidth;
             signals[i].rssi = rssi;
-            signals[i].modType = mod;
+            signals[i].occupancy = occupancy;
+            if (!signals[i].modFromBurst) {
+                signals[i].modType = mod;  // Keep the better burst-timing result
+            }
             signals[i].timestamp = millis();
+            signals[i].holdUntil = signals[i].timestamp + SIGNAL_HOLD_TIME_MS;
+            signals[i].utcUs = utcUs;
+            signals[i].latitude = pos.latitude;
+            signals[i].longitude = pos.longitude;
+            signals[i].hasPosition = pos.valid;
             return;
         }
     }
@@ -225,10 +410,18 @@ void RFScanner::addSignal(float freq, float rssi, ModulationType mod, uint8_t ba
     for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
         if (!signals[i].active) {
             signals[i].frequency = freq;
+            signals[i].bandwidth = bandwidth;
             signals[i].rssi = rssi;
+            signals[i].occupancy = occupancy;
             signals[i].modType = mod;
+            signals[i].modFromBurst = false;
             signals[i].band = band;
             signals[i].timestamp = millis();
+            signals[i].holdUntil = signals[i].timestamp + SIGNAL_HOLD_TIME_MS;
+            signals[i].utcUs = utcUs;
+            signals[i].latitude = pos.latitude;
+            signals[i].longitude = pos.longitude;
+            signals[i].hasPosition = pos.valid;
             signals[i].active = true;
             signalCount++;
             return;
@@ -246,10 +439,18 @@ void RFScanner::addSignal(float freq, float rssi, ModulationType mod, uint8_t ba
     }
     
     signals[oldestIdx].frequency = freq;
+    signals[oldestIdx].bandwidth = bandwidth;
     signals[oldestIdx].rssi = rssi;
+    signals[oldestIdx].occupancy = occupancy;
     signals[oldestIdx].modType = mod;
+    signals[oldestIdx].modFromBurst = false;
     signals[oldestIdx].band = band;
     signals[oldestIdx].timestamp = millis();
+    signals[oldestIdx].holdUntil = signals[oldestIdx].timestamp + SIGNAL_HOLD_TIME_MS;
+    signals[oldestIdx].utcUs = utcUs;
+    signals[oldestIdx].latitude = pos.latitude;
+    signals[oldestIdx].longitude = pos.longitude;
+    signals[oldestIdx].hasPosition = pos.valid;
     signals[oldestIdx].active = true;
 }
 
@@ -259,7 +460,7 @@ void RFScanner::cleanupSignals() {
     
     for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
         if (signals[i].active) {
-            if (now - signals[i].timestamp > SIGNAL_HOLD_TIME_MS) {
+            if ((int32_t)(now - signals[i].holdUntil) > 0) {
                 signals[i].active = false;
             } else {
                 signalCount++;
@@ -281,6 +482,7 @@ void RFScanner::clearSignals() {
         signals[i].active = false;
     }
     signalCount = 0;
+    publish(staging.band);
 }
 
 bool RFScanner::is900MHzAvailable() {
@@ -294,3 +496,307 @@ bool RFScanner::is2400MHzAvailable() {
 float RFScanner::getCurrentFrequency() {
     return currentFreq;
 }
+
+const int8_t* RFScanner::getSweepRow(uint8_t band) {
+    return bands[band == 0 ? 0 : 1].analyzer.getRow();
+}
+
+const uint8_t* RFScanner::getHitRow(uint8_t band) {
+    return bands[band == 0 ? 0 : 1].analyzer.getHits();
+}
+
+int RFScanner::getChannelCount(uint8_t band) {
+    return band == 0 ? Plan900::CHANNELS : Plan2400::CHANNELS;
+}
+
+uint32_t RFScanner::getSweepCount(uint8_t band) {
+    return bands[band == 0 ? 0 : 1].sweeps;
+}
+
+const int8_t* RFScanner::getMaxHoldRow(uint8_t band) {
+    return bands[band == 0 ? 0 : 1].analyzer.getMaxHold();
+}
+
+void RFScanner::resetMaxHold() {
+    bands[0].analyzer.resetMaxHold();
+    bands[1].analyzer.resetMaxHold();
+}
+
+float RFScanner::getNoiseFloor(uint8_t band, int channel) {
+    return bands[band == 0 ? 0 : 1].analyzer.getNoiseFloors()[channel] / (float)(1 << NOISE_FLOOR_FRAC_BITS);
+}
+
+void RFScanner::setNoiseFloors(uint8_t band, const int16_t* floors) {
+    bands[band == 0 ? 0 : 1].analyzer.setNoiseFloors(floors, getChannelCount(band));
+}
+
+uint16_t RFScanner::getChannelVariance(uint8_t band, int channel) {
+    return bands[band == 0 ? 0 : 1].analyzer.getVariance(channel);
+}
+
+uint8_t RFScanner::getChannelOccupancy(uint8_t band, int channel) {
+    return bands[band == 0 ? 0 : 1].analyzer.getOccupancy(channel);
+}
+
+int8_t RFScanner::getChannelMean(uint8_t band, int channel) {
+    return bands[band == 0 ? 0 : 1].analyzer.getMean(channel);
+}
+
+bool RFScanner::isSpectralScanActive() {
+    return spectralRadio != nullptr;
+}
+
+float RFScanner::getChannelFrequency(uint8_t band, int channel) {
+    return band == 0 ? Plan900::frequency(channel) : Plan2400::frequency(channel);
+}
+
+SX1262* RFScanner::getRadio900() {
+    return sx1262Available ? radio900 : nullptr;
+}
+
+int RFScanner::captureZeroSpan(uint8_t band, float freq, int8_t* samples, int count, uint32_t sampleRateHz) {
+    if (band == 0 && sx1262Available) {
+        return zeroSpan(scanner900, freq, samples, count, sampleRateHz);
+    } else if (band == 1 && sx1280Available) {
+        return zeroSpan(scanner2400, freq, samples, count, sampleRateHz);
+    }
+    return -1;
+}
+
+template <typename Scanner>
+int RFScanner::zeroSpan(Scanner& scanner, float freq, int8_t* samples, int count, uint32_t sampleRateHz) {
+    if (!scanner.listen(freq)) return -1;
+    currentFreq = freq;
+    
+    // 1 MHz timer ticks; each alarm wakes this task for one sample
+    zeroSpanTask = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, 0);
+    hw_timer_t* timer = timerBegin(BURST_TIMER_NUM, 80, true);
+    timerAttachInterrupt(timer, onZeroSpanTimer, true);
+    timerAlarmWrite(timer, 1000000 / sampleRateHz, true);
+    timerAlarmEnable(timer);
+    
+    int taken = 0;
+    int overruns = 0;
+    while (taken < count) {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        if (ticks == 0) break;  // Timer stopped firing
+        
+        int8_t value = toRowValue(scanner.readRssi());
+        for (uint32_t t = 0; t < ticks && taken < count; t++) {
+            samples[taken++] = value;
+        }
+        overruns += ticks - 1;
+    }
+    
+    timerAlarmDisable(timer);
+    timerDetachInterrupt(timer);
+    timerEnd(timer);
+    scanner.standby();
+    
+    return taken == count ? overruns : -1;
+}
+
+bool RFScanner::dwell(uint8_t band, float freq, int reads, int8_t& peakDbm) {
+    if (band == 0 && sx1262Available) {
+        return dwellPeak(scanner900, freq, reads, peakDbm);
+    } else if (band == 1 && sx1280Available) {
+        return dwellPeak(scanner2400, freq, reads, peakDbm);
+    }
+    return false;
+}
+
+template <typename Scanner>
+bool RFScanner::dwellPeak(Scanner& scanner, float freq, int reads, int8_t& peakDbm) {
+    if (!scanner.listen(freq)) return false;
+    currentFreq = freq;
+    
+    // Peak, not mean: bursty links are only up for part of the dwell
+    int8_t peak = -128;
+    for (int i = 0; i < reads; i++) {
+        int8_t value = toRowValue(scanner.readRssi());
+        if (value > peak) peak = value;
+    }
+    scanner.standby();
+    peakDbm = peak;
+    return true;
+}
+
+bool RFScanner::timeSpiSteps(uint8_t band, uint32_t& driverUs, uint32_t& framesUs) {
+    if (band == 0 && sx1262Available) {
+        scanner900.timeSteps(SPI_BENCH_STEPS, driverUs, framesUs);
+        return true;
+    } else if (band == 1 && sx1280Available) {
+        scanner2400.timeSteps(SPI_BENCH_STEPS, driverUs, framesUs);
+        return true;
+    }
+    return false;
+}
+
+void RFScanner::setSignalModulation(uint8_t band, float freq, ModulationType mod) {
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (signals[i].active && signals[i].band == band &&
+            fabs(signals[i].frequency - freq) < 1.0) {
+            signals[i].modType = mod;
+            signals[i].modFromBurst = true;
+            publish(band);
+            return;
+        }
+    }
+}
+
+float RFScanner::getSweepRate(uint8_t band) {
+    return bands[band == 0 ? 0 : 1].sweepRate;
+}
+
+uint32_t RFScanner::getFirstSweepMs() {
+    return firstSweepMs;
+}
+
+void RFScanner::exportState(WarmSnapshot& snap) {
+    memcpy(snap.noiseFloor900, bands[0].analyzer.getNoiseFloors(), sizeof(snap.noiseFloor900));
+    memcpy(snap.noiseFloor2400, bands[1].analyzer.getNoiseFloors(), sizeof(snap.noiseFloor2400));
+    snap.sweeps[0] = bands[0].sweeps;
+    snap.sweeps[1] = bands[1].sweeps;
+    
+    uint32_t now = millis();
+    int count = 0;
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        if (!signals[i].active) continue;
+        WarmSignal& w = snap.signals[count++];
+        w.frequency = signals[i].frequency;
+        w.latitude = signals[i].latitude;
+        w.longitude = signals[i].longitude;
+        int32_t left = (int32_t)(signals[i].holdUntil - now);
+        w.holdMs = left > 0 ? left : 0;
+        w.rssi = toRowValue(signals[i].rssi);
+        w.modType = signals[i].modType;
+        w.flags = (signals[i].band ? WARM_SIG_BAND_2400 : 0) |
+                  (signals[i].hasPosition ? WARM_SIG_HAS_POSITION : 0) |
+                  (signals[i].modFromBurst ? WARM_SIG_MOD_FROM_BURST : 0);
+    }
+    snap.signalCount = count;
+}
+
+void RFScanner::importState(const WarmSnapshot& snap, uint32_t elapsedMs) {
+    // The snapshot is packed; copy the floors out before handing them over
+    int16_t floors[SWEEP_ROW_MAX];
+    memcpy(floors, snap.noiseFloor900, sizeof(snap.noiseFloor900));
+    bands[0].analyzer.setNoiseFloors(floors, CHANNELS_900);
+    memcpy(floors, snap.noiseFloor2400, sizeof(snap.noiseFloor2400));
+    bands[1].analyzer.setNoiseFloors(floors, CHANNELS_2400);
+    bands[0].sweeps = snap.sweeps[0];
+    bands[1].sweeps = snap.sweeps[1];
+    
+    for (int i = 0; i < MAX_DETECTED_SIGNALS; i++) {
+        signals[i].active = false;
+    }
+    
+    uint32_t now = millis();
+    signalCount = 0;
+    for (int i = 0; i < snap.signalCount && i < MAX_DETECTED_SIGNALS; i++) {
+        const WarmSignal& w = snap.signals[i];
+        if (w.holdMs <= elapsedMs) continue;
+        
+        DetectedSignal& sig = signals[signalCount++];
+        sig.frequency = w.frequency;
+        sig.rssi = w.rssi;
+        sig.modType = (ModulationType)w.modType;
+        sig.band = (w.flags & WARM_SIG_BAND_2400) ? 1 : 0;
+        sig.latitude = w.latitude;
+        sig.longitude = w.longitude;
+        sig.hasPosition = (w.flags & WARM_SIG_HAS_POSITION) != 0;
+        sig.modFromBurst = (w.flags & WARM_SIG_MOD_FROM_BURST) != 0;
+        sig.occupancy = 0;
+        sig.bandwidth = 0;  // Re-measured on the next sweep
+        sig.utcUs = 0;
+        // Last seen before this boot; the hold carries on from now for
+        // whatever was left of it
+        sig.timestamp = 0;
+        sig.holdUntil = now + (w.holdMs - elapsedMs);
+        sig.active = true;
+    }
+    publish(staging.band);
+}
+
+void RFScanner::sleep() {
+    if (sx1262Available) radio900->sleep();
+    if (sx1280Available) radio2400->sleep();
+}
+
+void RFScanner::publish(uint8_t band) {
+    staging.version = published.getVersion() + 1;
+    staging.timestamp = millis();
+    staging.band = band;
+    staging.sweeps[0] = bands[0].sweeps;
+    staging.sweeps[1] = bands[1].sweeps;
+    staging.signalCount = signalCount;
+    memcpy(staging.signals, signals, sizeof(staging.signals));
+    memcpy(staging.rows[0], bands[0].analyzer.getRow(), sizeof(staging.rows[0]));
+    memcpy(staging.rows[1], bands[1].analyzer.getRow(), sizeof(staging.rows[1]));
+    staging.rowUtcUs[0] = bands[0].rowUtcUs;
+    staging.rowUtcUs[1] = bands[1].rowUtcUs;
+    published.publish(staging);
+}
+
+uint32_t RFScanner::getSnapshot(ScanSnapshot& out) {
+    return published.read(out);
+}
+
+uint32_t RFScanner::getSnapshotVersion() {
+    return published.getVersion();
+}
+
+void RFScanner::setWatchlist(Watchlist* list) {
+    watchlist = list;
+}
+
+void RFScanner::setDisplay(DisplayUI* ui) {
+    display = ui;
+}
+
+void RFScanner::calibrateSpurs(int rows) {
+    for (int b = 0; b < 2; b++) {
+        bands[b].spurs.calibrate(rows);
+        bands[b].spurCalibrating = true;
+    }
+}
+
+void RFScanner::clearSpurs() {
+    for (int b = 0; b < 2; b++) {
+        bands[b].spurs.clear();
+        bands[b].spurCount = 0;
+        bands[b].spurCalibrating = false;
+    }
+}
+
+const SpurMask& RFScanner::getSpurMask(uint8_t band) {
+    return bands[band].spurs;
+}
+
+void RFScanner::logSpurs(uint8_t band) {
+    BandState& st = bands[band];
+    bool finished = st.spurCalibrating && !st.spurs.isCalibrating();
+    if (!finished && st.spurs.getCount() == st.spurCount) return;
+    
+    st.spurCalibrating = st.spurs.isCalibrating();
+    st.spurCount = st.spurs.getCount();
+    Serial.print(band == 0 ? "[SPUR] 900MHz" : "[SPUR] 2.4GHz");
+    Serial.print(finished ? " calibrated, " : " mask now ");
+    Serial.print(st.spurCount);
+    Serial.println(" channels");
+}
+
+void RFScanner::setPosition(float lat, float lon, bool valid) {
+    ObserverPosition pos;
+    pos.latitude = lat;
+    pos.longitude = lon;
+    pos.valid = valid;
+    position.publish(pos);
+}
+
+int8_t RFScanner::toRowValue(float rssi) {
+    if (rssi <= -128.0f) return -128;
+    if (rssi >= 127.0f) return 127;
+    return (int8_t)lroundf(rssi);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file scan_scheduler.cpp
+ * @brief Background scan task implementation
+ */
+
+#include "scan_scheduler.h"
+#include "esp_timer.h"
+
+#define SCAN_ROTATION_LENGTH (SCAN_WEIGHT_900 + SCAN_WEIGHT_2400)
+#define SYNC_SLOT_US ((int64_t)SYNC_SLOT_MS * 1000)
+
+static_assert((int64_t)CHANNELS_900 * SYNC_DWELL_US < SYNC_SLOT_US &&
+              (int64_t)CHANNELS_2400 * SYNC_DWELL_US < SYNC_SLOT_US,
+              "an aligned sweep must fit in its slot");
+
+ScanScheduler::ScanScheduler() {
+    scanner = nullptr;
+    scheduler = nullptr;
+    logger = nullptr;
+    handler = nullptr;
+    clock = nullptr;
+    lockOn = nullptr;
+    radioLock = nullptr;
+    rotationPos = 0;
+    lockSlots = 0;
+}
+
+void ScanScheduler::begin(RFScanner* rfScanner, RadioScheduler* radioScheduler,
+                          FlashLogger* flashLogger, SweepHandler sweepHandler) {
+    scanner = rfScanner;
+    scheduler = radioScheduler;
+    logger = flashLogger;
+    handler = sweepHandler;
+    radioLock = xSemaphoreCreateMutex();
+
+    // Off the loop's core, so UI work never delays a sweep
+    xTaskCreatePinnedToCore(scanTask, "scan", SCAN_TASK_STACK, this,
+                            SCAN_TASK_PRIORITY, nullptr, SCAN_TASK_CORE);
+}
+
+void ScanScheduler::setClock(SweepClock* sweepClock) {
+    clock = sweepClock;
+}
+
+void ScanScheduler::setLockOn(LockOnTracker* tracker) {
+    lockOn = tracker;
+}
+
+void ScanScheduler::acquireRadios() {
+    xSemaphoreTake(radioLock, portMAX_DELAY);
+}
+
+void ScanScheduler::releaseRadios() {
+    xSemaphoreGive(radioLock);
+}
+
+int ScanScheduler::nextBand() {
+    for (int tries = 0; tries < SCAN_ROTATION_LENGTH; tries++) {
+        int band = rotationPos < SCAN_WEIGHT_900 ? 0 : 1;
+        rotationPos = (rotationPos + 1) % SCAN_ROTATION_LENGTH;
+
+        if (band == 0 ? scanner->is900MHzAvailable() : scanner->is2400MHzAvailable()) {
+            return band;
+        }
+    }
+    return -1;
+}
+
+int ScanScheduler::slotBand(int64_t slotUtcUs) {
+    // The same weighted rotation, indexed by slot number instead of count
+    int pos = (int)((slotUtcUs / SYNC_SLOT_US) % SCAN_ROTATION_LENGTH);
+    int band = pos < SCAN_WEIGHT_900 ? 0 : 1;
+
+    // A unit missing a radio still sweeps aligned, on the band it has
+    bool has900 = scanner->is900MHzAvailable();
+    bool has2400 = scanner->is2400MHzAvailable();
+    if (band == 0 && !has900) band = has2400 ? 1 : -1;
+    if (band == 1 && !has2400) band = has900 ? 0 : -1;
+    return band;
+}
+
+int64_t ScanScheduler::waitForSlot() {
+#if SYNC_ENABLED
+    if (clock == nullptr) return 0;
+
+    // Mesh windows run as soon as they are due, off the slot grid
+    if (scheduler->nextSlot() == SLOT_MESH) return 0;
+    
+    // Lock-on dwells as much as it can; waiting for slots would waste it
+    if (lockOn != nullptr && lockOn->isActive()) return 0;
+
+    int64_t nowUtc;
+    if (!clock->toUtc(esp_timer_get_time(), nowUtc)) return 0;
+
+    int64_t slotUtc = (nowUtc / SYNC_SLOT_US + 1) * SYNC_SLOT_US;
+    if (slotUtc - nowUtc < SYNC_LEAD_US) slotUtc += SYNC_SLOT_US;
+
+    // Sleep to within SYNC_LEAD_US; the sweep spins off the rest
+    int64_t sleepUs = slotUtc - nowUtc - SYNC_LEAD_US;
+    vTaskDelay(pdMS_TO_TICKS(sleepUs / 1000));
+    return slotUtc;
+#else
+    return 0;
+#endif
+}
+
+bool ScanScheduler::runSlot(int64_t slotUtcUs) {
+    // Every few slots the SX1262 is lent to the mesh for a fixed window
+    if (scheduler->nextSlot() == SLOT_MESH) {
+        scheduler->runMeshWindow();
+        return false;
+    }
+    
+    // A locked target gets most slots; a background sweep keeps the
+    // tracker (and its hop set) fed. Mesh frames count sweeps only, so
+    // lock-on slots stretch the frame rather than add mesh windows
+    if (lockOn != nullptr && lockOn->isActive() && lockSlots < LOCK_SLOTS_PER_SWEEP) {
+        runLockSlot();
+        lockSlots++;
+        return true;
+    }
+    lockSlots = 0;
+
+    int band = slotUtcUs != 0 ? slotBand(slotUtcUs) : nextBand();
+    if (band >= 0) {
+        uint32_t sweepStart = millis();
+        int detected = slotUtcUs != 0 ? scanner->scanAt(band, slotUtcUs) : scanner->scan(band);
+        if (handler != nullptr) {
+            handler(band, sweepStart, detected);
+        }
+    }
+    scheduler->slotCompleted();
+    return false;
+}
+
+void ScanScheduler::runLockSlot() {
+    uint8_t band = lockOn->getBand();
+    uint32_t start = millis();
+    
+    while (millis() - start < LOCK_SLOT_MS) {
+        int8_t peak;
+        if (!scanner->dwell(band, lockOn->nextFrequency(), LOCK_DWELL_READS, peak)) break;
+        lockOn->addDwell(peak, millis());
+    }
+}
+
+void ScanScheduler::scanTask(void* arg) {
+    ScanScheduler* self = (ScanScheduler*)arg;
+
+    for (;;) {
+        // Locked units wait for the shared slot boundary outside the lock
+        int64_t slotUtc = self->waitForSlot();
+
+        xSemaphoreTake(self->radioLock, portMAX_DELAY);
+        bool locked = self->runSlot(slotUtc);
+
+        // Write at most one buffered log page, between sweeps
+        if (self->logger != nullptr && self->logger->isAvailable()) {
+            self->logger->service(millis());
+            if (!self->logger->isAvailable()) {
+                Serial.println("[LOG] Write failed, logging disabled");
+            }
+        }
+        xSemaphoreGive(self->radioLock);
+
+        // Gap between slots, also where acquireRadios() gets its turn;
+        // aligned slots get theirs while waiting for the next boundary
+        if (slotUtc == 0) {
+            vTaskDelay(pdMS_TO_TICKS(locked ? LOCK_GAP_MS : SCAN_INTERVAL_MS));
+        }
+    }
+}
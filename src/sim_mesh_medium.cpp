@@ -0,0 +1,218 @@
+/**
+ * @file sim_mesh_medium.cpp
+ * @brief In-memory shared LoRa channel implementation
+ */
+
+#include "sim_mesh_medium.h"
+#include <string.h>
+#include "config.h"
+
+// LoRa modem settings the simulated time on air assumes
+#define SIM_LORA_BANDWIDTH_HZ 125000
+#define SIM_LORA_CODING_RATE 1         // 4/5
+#define SIM_LORA_PREAMBLE 8
+
+SimMeshMedium::SimMeshMedium() {
+    transmissions = 0;
+    collisions = 0;
+    deliveries = 0;
+}
+
+int SimMeshMedium::join() {
+    std::lock_guard<std::mutex> guard(lock);
+
+    Node n;
+    n.time = 0;
+    for (const Node& other : nodes) {
+        if (other.active && other.time > n.time) n.time = other.time;
+    }
+    n.active = true;
+    n.receiving = false;
+    n.freq = 0;
+    n.rxSince = 0;
+    n.delivered = n.time;
+    nodes.push_back(n);
+    return (int)nodes.size() - 1;
+}
+
+void SimMeshMedium::leave(int node) {
+    std::lock_guard<std::mutex> guard(lock);
+    nodes[node].active = false;
+    changed.notify_all();
+}
+
+uint32_t SimMeshMedium::now(int node) {
+    std::lock_guard<std::mutex> guard(lock);
+    return nodes[node].time;
+}
+
+bool SimMeshMedium::othersReached(int node, uint32_t time) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if ((int)i != node && nodes[i].active && nodes[i].time < time) return false;
+    }
+    return true;
+}
+
+void SimMeshMedium::advance(int node, uint32_t ms) {
+    std::unique_lock<std::mutex> guard(lock);
+    nodes[node].time += ms;
+    changed.notify_all();
+
+    // Only the nodes at the earliest time run, so everything that happens
+    // before a given instant is on the air by the time anyone looks at it
+    uint32_t target = nodes[node].time;
+    changed.wait(guard, [&]() { return othersReached(node, target); });
+}
+
+void SimMeshMedium::transmit(int node, float freq, const uint8_t* data, size_t len, uint32_t airMs) {
+    std::lock_guard<std::mutex> guard(lock);
+
+    Packet p;
+    p.from = node;
+    p.freq = freq;
+    p.start = nodes[node].time;
+    p.end = p.start + airMs;
+    p.collided = false;
+    p.data.assign(data, data + len);
+
+    // Earlier packets are all on the air already; later ones check us
+    for (Packet& other : air) {
+        if (other.freq == freq && other.end > p.start && other.start < p.end) {
+            if (!other.collided) collisions++;
+            if (!p.collided) collisions++;
+            other.collided = true;
+            p.collided = true;
+        }
+    }
+
+    air.push_back(p);
+    transmissions++;
+    nodes[node].receiving = false;
+}
+
+bool SimMeshMedium::busy(int node, float freq) {
+    std::lock_guard<std::mutex> guard(lock);
+    uint32_t now = nodes[node].time;
+    nodes[node].receiving = false;
+
+    for (const Packet& p : air) {
+        if (p.from != node && p.freq == freq && p.start <= now && p.end > now) return true;
+    }
+    return false;
+}
+
+void SimMeshMedium::startReceive(int node, float freq) {
+    std::lock_guard<std::mutex> guard(lock);
+    Node& n = nodes[node];
+    n.receiving = true;
+    n.freq = freq;
+    n.rxSince = n.time;
+    n.delivered = n.time;
+}
+
+void SimMeshMedium::standby(int node) {
+    std::lock_guard<std::mutex> guard(lock);
+    nodes[node].receiving = false;
+}
+
+size_t SimMeshMedium::poll(int node, uint8_t* data, size_t maxLen) {
+    std::lock_guard<std::mutex> guard(lock);
+    Node& n = nodes[node];
+    if (!n.receiving) return 0;
+
+    for (const Packet& p : air) {
+        if (p.end <= n.delivered || p.end > n.time) continue;
+        if (p.from == node || p.freq != n.freq || p.start < n.rxSince) continue;
+        if (p.collided || p.data.size() > maxLen) continue;
+
+        n.delivered = p.end;
+        memcpy(data, p.data.data(), p.data.size());
+        deliveries++;
+        return p.data.size();
+    }
+
+    n.delivered = n.time;
+    return 0;
+}
+
+uint32_t SimMeshMedium::getTransmissions() {
+    std::lock_guard<std::mutex> guard(lock);
+    return transmissions;
+}
+
+uint32_t SimMeshMedium::getCollisions() {
+    std::lock_guard<std::mutex> guard(lock);
+    return collisions;
+}
+
+uint32_t SimMeshMedium::getDeliveries() {
+    std::lock_guard<std::mutex> guard(lock);
+    return deliveries;
+}
+
+SimMeshTransport::SimMeshTransport(SimMeshMedium* medium, uint16_t nodeId) {
+    this->medium = medium;
+    this->nodeId = nodeId;
+    node = medium->join();
+    freq = 0;
+}
+
+void SimMeshTransport::leave() {
+    medium->leave(node);
+}
+
+bool SimMeshTransport::configure() {
+    return true;
+}
+
+uint16_t SimMeshTransport::getNodeId() {
+    return nodeId;
+}
+
+bool SimMeshTransport::setFrequency(float mhz) {
+    freq = mhz;
+    return true;
+}
+
+uint32_t SimMeshTransport::getTimeOnAir(size_t len) {
+    // Semtech AN1200.13 with explicit header and CRC, no low data rate
+    // optimisation
+    const int sf = MESH_SPREADING_FACTOR;
+    uint32_t symbolUs = (1000000UL << sf) / SIM_LORA_BANDWIDTH_HZ;
+    int bits = 8 * (int)len - 4 * sf + 28 + 16;
+    int blocks = bits > 0 ? (bits + 4 * sf - 1) / (4 * sf) : 0;
+    int payloadSymbols = 8 + blocks * (SIM_LORA_CODING_RATE + 4);
+    return (uint32_t)((SIM_LORA_PREAMBLE * 4 + 17 + payloadSymbols * 4) * symbolUs / 4);
+}
+
+bool SimMeshTransport::transmit(const uint8_t* data, size_t len) {
+    uint32_t airMs = (getTimeOnAir(len) + 999) / 1000;
+    medium->transmit(node, freq, data, len, airMs);
+    medium->advance(node, airMs);
+    return true;
+}
+
+bool SimMeshTransport::isChannelBusy() {
+    return medium->busy(node, freq);
+}
+
+bool SimMeshTransport::startReceive() {
+    medium->startReceive(node, freq);
+    return true;
+}
+
+size_t SimMeshTransport::readPacket(uint8_t* data, size_t maxLen) {
+    return medium->poll(node, data, maxLen);
+}
+
+void SimMeshTransport::standby() {
+    medium->standby(node);
+}
+
+uint32_t SimMeshTransport::nowMs() {
+    return medium->now(node);
+}
+
+void SimMeshTransport::idle(uint32_t ms) {
+    medium->advance(node, ms);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file spectral_scan.cpp
+ * @brief Hardware spectral scan state machine and histogram reduction
+ */
+
+#include "spectral_scan.h"
+
+// Completion is polled this often once the expected scan time has passed
+#define SPECTRAL_POLL_US 200
+
+int spectralBinDbm(int bin) {
+    return SPECTRAL_BIN0_DBM - bin * SPECTRAL_BIN_DB;
+}
+
+void reduceSpectralHistogram(const uint16_t* bins, int8_t threshold, SpectralStats& out) {
+    uint32_t total = 0;
+    uint32_t above = 0;
+    int32_t levelSum = 0;
+    int peak = -128;
+
+    for (int i = 0; i < SPECTRAL_BINS; i++) {
+        if (bins[i] == 0) continue;
+        int level = spectralBinDbm(i);
+        if (level > peak) peak = level;
+        if (level > threshold) above += bins[i];
+        total += bins[i];
+        levelSum += level * (int32_t)bins[i];
+    }
+
+    out.samples = total > 0xFFFF ? 0xFFFF : (uint16_t)total;
+    if (total == 0) {
+        out.peakDbm = -128;
+        out.meanDbm = -128;
+        out.occupancy = 0;
+        return;
+    }
+
+    int mean = levelSum / (int32_t)total;
+    out.peakDbm = peak < -128 ? -128 : peak;
+    out.meanDbm = mean < -128 ? -128 : mean;
+    out.occupancy = (uint8_t)((above * 100 + total / 2) / total);
+}
+
+SpectralScan::SpectralScan() {
+    radio = nullptr;
+    state = SPECTRAL_IDLE;
+    samples = 0;
+    expectedUs = 0;
+    timeoutUs = 0;
+    startUs = 0;
+    scanCount = 0;
+    timeoutCount = 0;
+}
+
+void SpectralScan::begin(SpectralRadio* spectralRadio, uint16_t sampleCount,
+                         uint32_t sampleUs, uint32_t timeout) {
+    radio = spectralRadio;
+    samples = sampleCount;
+    expectedUs = (uint32_t)sampleCount * sampleUs;
+    timeoutUs = timeout;
+    state = SPECTRAL_IDLE;
+    scanCount = 0;
+    timeoutCount = 0;
+}
+
+bool SpectralScan::start(float freq) {
+    if (radio == nullptr || state == SPECTRAL_SCANNING) return false;
+
+    if (!radio->start(freq, samples)) {
+        radio->stop();
+        state = SPECTRAL_IDLE;
+        return false;
+    }
+    startUs = radio->nowUs();
+    state = SPECTRAL_SCANNING;
+    return true;
+}
+
+SpectralState SpectralScan::poll() {
+    if (state != SPECTRAL_SCANNING) return state;
+
+    if (radio->finished()) {
+        state = SPECTRAL_READY;
+    } else if (radio->nowUs() - startUs > timeoutUs) {
+        radio->stop();
+        timeoutCount++;
+        state = SPECTRAL_TIMEOUT;
+    }
+    return state;
+}
+
+bool SpectralScan::collect(int8_t threshold, SpectralStats& out) {
+    if (state != SPECTRAL_READY) {
+        if (state == SPECTRAL_TIMEOUT) state = SPECTRAL_IDLE;
+        return false;
+    }
+
+    uint16_t bins[SPECTRAL_BINS];
+    bool ok = radio->readHistogram(bins);
+    state = SPECTRAL_IDLE;
+    if (!ok) return false;
+
+    reduceSpectralHistogram(bins, threshold, out);
+    scanCount++;
+    return true;
+}
+
+bool SpectralScan::measure(float freq, int8_t threshold, SpectralStats& out) {
+    if (!start(freq)) return false;
+
+    // The radio does the sampling; sleep through most of it, then poll
+    radio->sleepUs(expectedUs);
+    while (poll() == SPECTRAL_SCANNING) {
+        radio->sleepUs(SPECTRAL_POLL_US);
+    }
+    return collect(threshold, out);
+}
+
+SpectralState SpectralScan::getState() {
+    return state;
+}
+
+uint32_t SpectralScan::getScanCount() {
+    return scanCount;
+}
+
+uint32_t SpectralScan::getTimeoutCount() {
+    return timeoutCount;
+}
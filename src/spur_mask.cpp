@@ -0,0 +1,164 @@
+/**
+ * @file spur_mask.cpp
+ * @brief Spur mask and learner implementation
+ */
+
+#include "spur_mask.h"
+#include <string.h>
+
+SpurMask::SpurMask() {
+    clear();
+}
+
+void SpurMask::clear() {
+    memset(level, -128, sizeof(level));
+    memset(alwaysLevel, -128, sizeof(alwaysLevel));
+    memset(displayLevel, -128, sizeof(displayLevel));
+    memset(flags, 0, sizeof(flags));
+    count = 0;
+
+    memset(activeSamples, 0, sizeof(activeSamples));
+    memset(activeHits, 0, sizeof(activeHits));
+    memset(activeSum, 0, sizeof(activeSum));
+    memset(quietSamples, 0, sizeof(quietSamples));
+    memset(quietHits, 0, sizeof(quietHits));
+    learnRows = 0;
+
+    memset(calibrateHits, 0, sizeof(calibrateHits));
+    memset(calibrateSum, 0, sizeof(calibrateSum));
+    calibrateRows = 0;
+    calibrateTarget = 0;
+}
+
+void SpurMask::calibrate(int rows) {
+    memset(calibrateHits, 0, sizeof(calibrateHits));
+    memset(calibrateSum, 0, sizeof(calibrateSum));
+    calibrateRows = 0;
+    calibrateTarget = rows;
+}
+
+bool SpurMask::isCalibrating() const {
+    return calibrateTarget > 0;
+}
+
+bool SpurMask::isNarrowPeak(const int8_t* row, const int8_t* threshold, int channel, int channels) {
+    int v = row[channel];
+    if (v <= threshold[channel]) return false;
+    if (channel > 0 && v - row[channel - 1] < SPUR_NARROW_DB) return false;
+    if (channel < channels - 1 && v - row[channel + 1] < SPUR_NARROW_DB) return false;
+    return true;
+}
+
+void SpurMask::learn(const int8_t* row, const int8_t* threshold, const uint8_t* activity, int channels) {
+    for (int ch = 0; ch < channels; ch++) {
+        bool peak = isNarrowPeak(row, threshold, ch, channels);
+
+        if (activity[ch] & SPUR_DISPLAY) {
+            activeSamples[ch]++;
+            if (peak) {
+                activeHits[ch]++;
+                activeSum[ch] += row[ch];
+            }
+        } else {
+            quietSamples[ch]++;
+            if (peak) quietHits[ch]++;
+        }
+
+        if (calibrateTarget > 0 && peak) {
+            calibrateHits[ch]++;
+            calibrateSum[ch] += row[ch];
+        }
+    }
+
+    if (++learnRows >= SPUR_LEARN_ROWS) closeWindow(channels);
+    if (calibrateTarget > 0 && ++calibrateRows >= calibrateTarget) finishCalibration(channels);
+}
+
+void SpurMask::closeWindow(int channels) {
+    for (int ch = 0; ch < channels; ch++) {
+        // Too few flushes landed on this channel to tell either way
+        if (activeSamples[ch] < SPUR_ACTIVE_MIN) continue;
+
+        int activePercent = activeHits[ch] * 100 / activeSamples[ch];
+        int quietPercent = quietSamples[ch] > 0 ? quietHits[ch] * 100 / quietSamples[ch] : 0;
+
+        if (activePercent >= SPUR_ACTIVE_PERCENT && quietPercent <= SPUR_QUIET_PERCENT) {
+            displayLevel[ch] = (int8_t)(activeSum[ch] / activeHits[ch]);
+            flags[ch] |= SPUR_DISPLAY;
+        } else {
+            flags[ch] &= ~SPUR_DISPLAY;
+        }
+        updateLevel(ch);
+    }
+
+    memset(activeSamples, 0, sizeof(activeSamples));
+    memset(activeHits, 0, sizeof(activeHits));
+    memset(activeSum, 0, sizeof(activeSum));
+    memset(quietSamples, 0, sizeof(quietSamples));
+    memset(quietHits, 0, sizeof(quietHits));
+    learnRows = 0;
+    recount(channels);
+}
+
+void SpurMask::finishCalibration(int channels) {
+    for (int ch = 0; ch < channels; ch++) {
+        flags[ch] &= ~SPUR_ALWAYS;
+        if (calibrateHits[ch] * 100 >= SPUR_PERSIST_PERCENT * calibrateRows) {
+            alwaysLevel[ch] = (int8_t)(calibrateSum[ch] / calibrateHits[ch]);
+            flags[ch] |= SPUR_ALWAYS;
+        }
+        updateLevel(ch);
+    }
+    calibrateTarget = 0;
+    recount(channels);
+}
+
+void SpurMask::updateLevel(int channel) {
+    int8_t spur = -128;
+    if ((flags[channel] & SPUR_ALWAYS) && alwaysLevel[channel] > spur) spur = alwaysLevel[channel];
+    if ((flags[channel] & SPUR_DISPLAY) && displayLevel[channel] > spur) spur = displayLevel[channel];
+    level[channel] = spur;
+}
+
+void SpurMask::recount(int channels) {
+    count = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        if (flags[ch] != 0) count++;
+    }
+}
+
+int SpurMask::apply(int8_t* threshold, const uint8_t* activity, uint8_t* masked, int channels) const {
+    memset(masked, 0, channels);
+    if (count == 0) return 0;
+
+    int raised = 0;
+    for (int ch = 0; ch < channels; ch++) {
+        // Only the levels of the bits that apply to this sample
+        uint8_t applies = flags[ch] & (SPUR_ALWAYS | activity[ch]);
+        if (!applies) continue;
+        int spur = -128;
+        if ((applies & SPUR_ALWAYS) && alwaysLevel[ch] > spur) spur = alwaysLevel[ch];
+        if ((applies & SPUR_DISPLAY) && displayLevel[ch] > spur) spur = displayLevel[ch];
+
+        int t = spur + SPUR_MARGIN_DB;
+        if (t > 127) t = 127;
+        if (t > threshold[ch]) {
+            threshold[ch] = (int8_t)t;
+            masked[ch] = 1;
+            raised++;
+        }
+    }
+    return raised;
+}
+
+uint8_t SpurMask::getFlags(int channel) const {
+    return flags[channel];
+}
+
+int8_t SpurMask::getLevel(int channel) const {
+    return level[channel];
+}
+
+int SpurMask::getCount() const {
+    return count;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file stdio_log_storage.cpp
+ * @brief LogStorage on a host directory
+ */
+
+#include "stdio_log_storage.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+class StdioLogFile : public LogStorageFile {
+public:
+    explicit StdioLogFile(FILE* f) {
+        file = f;
+    }
+
+    size_t read(uint8_t* data, size_t len) override {
+        return fread(data, 1, len, file);
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        return fwrite(data, 1, len, file);
+    }
+
+    void flush() override {
+        fflush(file);
+    }
+
+    size_t size() override {
+        struct stat st;
+        fflush(file);
+        if (fstat(fileno(file), &st) != 0) return 0;
+        return (size_t)st.st_size;
+    }
+
+    FILE* file;
+};
+
+StdioLogStorage::StdioLogStorage(const char* root) {
+    snprintf(this->root, sizeof(this->root), "%s", root);
+}
+
+void StdioLogStorage::hostPath(const char* path, char* out, size_t len) {
+    snprintf(out, len, "%s%s", root, path);
+}
+
+bool StdioLogStorage::mount() {
+    struct stat st;
+    return stat(root, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool StdioLogStorage::exists(const char* path) {
+    char host[STDIO_LOG_PATH_MAX];
+    struct stat st;
+    hostPath(path, host, sizeof(host));
+    return stat(host, &st) == 0;
+}
+
+bool StdioLogStorage::mkdir(const char* path) {
+    char host[STDIO_LOG_PATH_MAX];
+    hostPath(path, host, sizeof(host));
+    return ::mkdir(host, 0755) == 0;
+}
+
+bool StdioLogStorage::remove(const char* path) {
+    char host[STDIO_LOG_PATH_MAX];
+    hostPath(path, host, sizeof(host));
+    return ::remove(host) == 0;
+}
+
+LogStorageFile* StdioLogStorage::open(const char* path, bool append) {
+    char host[STDIO_LOG_PATH_MAX];
+    hostPath(path, host, sizeof(host));
+    FILE* f = fopen(host, append ? "ab" : "rb");
+    if (f == nullptr) return nullptr;
+    return new StdioLogFile(f);
+}
+
+void StdioLogStorage::close(LogStorageFile* file) {
+    if (file == nullptr) return;
+    fclose(static_cast<StdioLogFile*>(file)->file);
+    delete file;
+}
+
+bool StdioLogStorage::listDir(const char* path, LogDirVisitor visit, void* ctx) {
+    char host[STDIO_LOG_PATH_MAX];
+    hostPath(path, host, sizeof(host));
+    DIR* dir = opendir(host);
+    if (dir == nullptr) return false;
+
+    for (struct dirent* e = readdir(dir); e != nullptr; e = readdir(dir)) {
+        if (e->d_name[0] == '.') continue;
+        visit(e->d_name, ctx);
+    }
+    closedir(dir);
+    return true;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file survey.cpp
+ * @brief Site survey accumulator implementation
+ */
+
+#include "survey.h"
+#include <string.h>
+
+static int channelCount(uint8_t band) {
+    return band == 0 ? CHANNELS_900 : CHANNELS_2400;
+}
+
+// num / den rounded to nearest, den > 0
+static int32_t roundDiv(int64_t num, int64_t den) {
+    return (int32_t)(num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den));
+}
+
+Survey::Survey() {
+    buckets = nullptr;
+    bucketCapacity = 0;
+    running = false;
+    memset(&state, 0, sizeof(state));
+    reset(0);
+}
+
+void Survey::begin(uint8_t* buffer, size_t bytes) {
+    buckets = buffer;
+    bucketCapacity = buffer != nullptr ? (int)(bytes / SURVEY_BUCKET_BYTES) : 0;
+    if (bucketCapacity > UINT16_MAX) bucketCapacity = UINT16_MAX;
+    bucketCapacity &= ~1;          // Buckets merge in pairs
+    reset(0);
+}
+
+void Survey::clearTotals(Totals& t) {
+    memset(t.maxHold, -128, sizeof(t.maxHold));
+    memset(t.minHold, 127, sizeof(t.minHold));
+    memset(t.sum, 0, sizeof(t.sum));
+    memset(t.above, 0, sizeof(t.above));
+    t.sweeps = 0;
+}
+
+void Survey::start(uint32_t nowMs) {
+    if (running) return;
+    running = true;
+    runStartMs = nowMs;
+    bucketStartMs = nowMs;
+    publish(nowMs);
+}
+
+void Survey::stop(uint32_t nowMs) {
+    if (!running) return;
+
+    // Buckets only ever cover running time
+    if (bucket[0].sweeps > 0 || bucket[1].sweeps > 0) closeBucket(nowMs);
+    runMs += nowMs - runStartMs;
+    running = false;
+    publish(nowMs);
+}
+
+void Survey::reset(uint32_t nowMs) {
+    for (int b = 0; b < 2; b++) {
+        clearTotals(totals[b]);
+        clearTotals(bucket[b]);
+        updateTrace(b);
+    }
+    bucketCount = 0;
+    bucketMs = SURVEY_BUCKET_MS;
+    bucketStartMs = nowMs;
+    runStartMs = nowMs;
+    runMs = 0;
+    publish(nowMs);
+}
+
+bool Survey::isRunning() const {
+    return running;
+}
+
+void Survey::addRow(uint8_t band, const int8_t* row, const uint8_t* hits, uint32_t nowMs) {
+    if (!running) return;
+
+    if (nowMs - bucketStartMs >= bucketMs) closeBucket(nowMs);
+
+    int n = channelCount(band);
+    Totals& t = totals[band];
+    sweepMaxHold(t.maxHold, row, n);
+    sweepMinHold(t.minHold, row, n);
+    sweepAccumulate(t.sum, t.above, row, hits, n);
+    t.sweeps++;
+
+    if (bucketCapacity > 0) {
+        Totals& b = bucket[band];
+        sweepMaxHold(b.maxHold, row, n);
+        sweepAccumulate(b.sum, b.above, row, hits, n);
+        b.sweeps++;
+    }
+
+    updateTrace(band);
+    publish(nowMs);
+}
+
+uint8_t* Survey::bucketBand(int index, uint8_t band) const {
+    return buckets + (size_t)index * SURVEY_BUCKET_BYTES + (band == 0 ? 0 : 3 * CHANNELS_900);
+}
+
+uint32_t Survey::bucketSweeps(int index, uint8_t band) const {
+    uint32_t sweeps;
+    memcpy(&sweeps, bucketBand(index, 0) + 3 * (CHANNELS_900 + CHANNELS_2400) +
+           band * sizeof(uint32_t), sizeof(sweeps));
+    return sweeps;
+}
+
+void Survey::setBucketSweeps(int index, uint8_t band, uint32_t sweeps) {
+    memcpy(bucketBand(index, 0) + 3 * (CHANNELS_900 + CHANNELS_2400) +
+           band * sizeof(uint32_t), &sweeps, sizeof(sweeps));
+}
+
+void Survey::closeBucket(uint32_t nowMs) {
+    bucketStartMs = nowMs;
+    if (bucketCapacity == 0) return;
+
+    for (uint8_t band = 0; band < 2; band++) {
+        int n = channelCount(band);
+        Totals& b = bucket[band];
+        int8_t* dst = (int8_t*)bucketBand(bucketCount, band);
+        for (int ch = 0; ch < n; ch++) {
+            if (b.sweeps == 0) {
+                dst[ch] = -128;
+                dst[n + ch] = -128;
+                dst[2 * n + ch] = 0;
+            } else {
+                dst[ch] = b.maxHold[ch];
+                dst[n + ch] = (int8_t)(b.sum[ch] / (int32_t)b.sweeps);
+                dst[2 * n + ch] = (int8_t)((uint64_t)b.above[ch] * 100 / b.sweeps);
+            }
+        }
+        setBucketSweeps(bucketCount, band, b.sweeps);
+        clearTotals(b);
+    }
+    bucketCount++;
+
+    // Full: halve the resolution of everything so far rather than drop it.
+    // Merging now, not when the next bucket closes, means that bucket is
+    // already accumulated at the doubled length
+    if (bucketCount == bucketCapacity) {
+        for (int i = 0; i < bucketCount; i += 2) {
+            for (uint8_t band = 0; band < 2; band++) {
+                int n = channelCount(band);
+                int8_t* dst = (int8_t*)bucketBand(i / 2, band);
+                const int8_t* a = (const int8_t*)bucketBand(i, band);
+                const int8_t* b = (const int8_t*)bucketBand(i + 1, band);
+
+                // Weight by sweeps: a short bucket from stop() or an
+                // empty one (no sweeps, mean -128) doesn't count as a
+                // full one
+                uint32_t sweepsA = bucketSweeps(i, band);
+                uint32_t sweepsB = bucketSweeps(i + 1, band);
+                int64_t sweeps = (int64_t)sweepsA + sweepsB;
+                for (int ch = 0; ch < n; ch++) {
+                    dst[ch] = a[ch] > b[ch] ? a[ch] : b[ch];
+                    if (sweeps == 0) {
+                        dst[n + ch] = -128;
+                        dst[2 * n + ch] = 0;
+                        continue;
+                    }
+                    int64_t mean = (int64_t)a[n + ch] * sweepsA + (int64_t)b[n + ch] * sweepsB;
+                    int64_t occ = (int64_t)(uint8_t)a[2 * n + ch] * sweepsA +
+                                  (int64_t)(uint8_t)b[2 * n + ch] * sweepsB;
+                    dst[n + ch] = (int8_t)roundDiv(mean, sweeps);
+                    dst[2 * n + ch] = (int8_t)roundDiv(occ, sweeps);
+                }
+                setBucketSweeps(i / 2, band, (uint32_t)sweeps);
+            }
+        }
+        bucketCount /= 2;
+        bucketMs *= 2;
+    }
+}
+
+void Survey::updateTrace(uint8_t band) {
+    int n = channelCount(band);
+    const Totals& t = totals[band];
+    SurveyTrace& trace = state.bands[band];
+
+    memcpy(trace.maxHold, t.maxHold, n);
+    memcpy(trace.minHold, t.minHold, n);
+    trace.sweeps = t.sweeps;
+    for (int ch = 0; ch < n; ch++) {
+        if (t.sweeps == 0) {
+            trace.meanQ[ch] = -128 * (1 << NOISE_FLOOR_FRAC_BITS);
+            trace.occupancy[ch] = 0;
+        } else {
+            trace.meanQ[ch] = (int16_t)((int64_t)t.sum[ch] * (1 << NOISE_FLOOR_FRAC_BITS) / t.sweeps);
+            trace.occupancy[ch] = (uint8_t)((uint64_t)t.above[ch] * 100 / t.sweeps);
+        }
+    }
+}
+
+void Survey::publish(uint32_t nowMs) {
+    state.running = running;
+    state.elapsedMs = runMs + (running ? nowMs - runStartMs : 0);
+    state.bucketCount = (uint16_t)bucketCount;
+    state.bucketCapacity = (uint16_t)bucketCapacity;
+    state.bucketMs = bucketMs;
+    published.publish(state);
+}
+
+void Survey::getView(SurveyView& out) const {
+    published.read(out);
+}
+
+bool Survey::getBucket(int index, uint8_t band, int8_t* maxOut, int8_t* meanOut,
+                       uint8_t* occupancyOut) const {
+    if (index < 0 || index >= bucketCount) return false;
+
+    int n = channelCount(band);
+    const uint8_t* src = bucketBand(index, band);
+    memcpy(maxOut, src, n);
+    memcpy(meanOut, src + n, n);
+    memcpy(occupancyOut, src + 2 * n, n);
+    return true;
+}
+
+void Survey::planFloors(const SurveyTrace& trace, int channels, int16_t* floors) {
+    for (int ch = 0; ch < channels; ch++) {
+        if (trace.occupancy[ch] >= SURVEY_BUSY_PERCENT) {
+            floors[ch] = trace.minHold[ch] * (1 << NOISE_FLOOR_FRAC_BITS);
+        } else {
+            floors[ch] = trace.meanQ[ch];
+        }
+    }
+}
+
+int Survey::busyChannels(const SurveyTrace& trace, int channels, int* out, int maxOut) {
+    int count = 0;
+    int ch = 0;
+    while (ch < channels) {
+        if (trace.occupancy[ch] < SURVEY_BUSY_PERCENT) {
+            ch++;
+            continue;
+        }
+
+        // Busiest channel of this run
+        int best = ch;
+        for (; ch < channels && trace.occupancy[ch] >= SURVEY_BUSY_PERCENT; ch++) {
+            if (trace.occupancy[ch] > trace.occupancy[best]) best = ch;
+        }
+
+        // Insert in descending order, dropping the least busy when full
+        int pos = count < maxOut ? count++ : maxOut;
+        while (pos > 0 && trace.occupancy[out[pos - 1]] < trace.occupancy[best]) {
+            if (pos < maxOut) out[pos] = out[pos - 1];
+            pos--;
+        }
+        if (pos < maxOut) out[pos] = best;
+    }
+    return count;
+}
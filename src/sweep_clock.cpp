@@ -0,0 +1,87 @@
+/**
+ * @file sweep_clock.cpp
+ * @brief PPS-disciplined sweep clock implementation
+ */
+
+#include "sweep_clock.h"
+
+#define US_PER_SECOND 1000000LL
+#define PPB 1000000000LL
+
+SweepClock::SweepClock() {
+    fix.ppsLocalUs = 0;
+    fix.ppsUtcUs = 0;
+    fix.driftPpb = 0;
+    fix.goodPulses = 0;
+}
+
+void SweepClock::discipline(int64_t ppsLocalUs, int64_t utcSecond) {
+    int64_t utcUs = utcSecond * US_PER_SECOND;
+    int64_t span = utcUs - fix.ppsUtcUs;
+    int64_t error = (ppsLocalUs - fix.ppsLocalUs) - span;
+    int64_t seconds = span / US_PER_SECOND;
+
+    // Missed pulses or sentences are fine as long as the timer interval
+    // still matches the UTC step; anything else restarts the lock
+    bool consistent = fix.ppsUtcUs != 0 && seconds >= 1 &&
+                      seconds * 1000 <= SYNC_HOLDOVER_MS &&
+                      error <= seconds * SYNC_PPS_TOLERANCE_US &&
+                      error >= -seconds * SYNC_PPS_TOLERANCE_US;
+
+    if (consistent) {
+        int32_t measured = (int32_t)(error * PPB / span);
+        if (fix.goodPulses == 0) {
+            fix.driftPpb = measured;
+        } else {
+            fix.driftPpb += (measured - fix.driftPpb) / (1 << SYNC_DRIFT_SHIFT);
+        }
+        fix.goodPulses++;
+    } else {
+        fix.goodPulses = 0;
+    }
+
+    fix.ppsLocalUs = ppsLocalUs;
+    fix.ppsUtcUs = utcUs;
+    published.publish(fix);
+}
+
+bool SweepClock::locked(const SweepClockFix& f, int64_t nowLocalUs) {
+    return f.goodPulses >= SYNC_LOCK_PPS &&
+           nowLocalUs - f.ppsLocalUs < (int64_t)SYNC_HOLDOVER_MS * 1000;
+}
+
+bool SweepClock::isLocked(int64_t nowLocalUs) const {
+    SweepClockFix f;
+    published.read(f);
+    return locked(f, nowLocalUs);
+}
+
+bool SweepClock::toUtc(int64_t localUs, int64_t& utcUs) const {
+    SweepClockFix f;
+    published.read(f);
+    if (!locked(f, localUs)) return false;
+
+    // A fast timer counts more than one local us per UTC us
+    int64_t elapsed = localUs - f.ppsLocalUs;
+    utcUs = f.ppsUtcUs + elapsed - elapsed * f.driftPpb / PPB;
+    return true;
+}
+
+bool SweepClock::toLocal(int64_t utcUs, int64_t& localUs) const {
+    SweepClockFix f;
+    published.read(f);
+
+    int64_t elapsed = utcUs - f.ppsUtcUs;
+    localUs = f.ppsLocalUs + elapsed + elapsed * f.driftPpb / PPB;
+    return locked(f, localUs);
+}
+
+int32_t SweepClock::getDriftPpb() const {
+    SweepClockFix f;
+    published.read(f);
+    return f.driftPpb;
+}
+
+uint32_t SweepClock::getPulseCount() const {
+    return published.getVersion();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file sweep_kernels.cpp
+ * @brief Whole-row analytics kernels (PIE and portable implementations)
+ */
+
+#include "sweep_kernels.h"
+
+#if SWEEP_KERNELS_PIE
+// One 16-lane step: load both rows, combine into q0, store back to dst.
+// The .ip post-increment of 0 leaves the pointer registers unchanged.
+#define PIE_BINARY_OP(op, dst, src)                  \
+    asm volatile(                                    \
+        "ee.vld.128.ip q0, %0, 0\n\t"                \
+        "ee.vld.128.ip q1, %1, 0\n\t"                \
+        op " q0, q0, q1\n\t"                         \
+        "ee.vst.128.ip q0, %0, 0\n\t"                \
+        :                                            \
+        : "r"(dst), "r"(src)                         \
+        : "memory")
+
+#define PIE_COMPARE_OP(op, dst, a, b)                \
+    asm volatile(                                    \
+        "ee.vld.128.ip q0, %1, 0\n\t"                \
+        "ee.vld.128.ip q1, %2, 0\n\t"                \
+        op " q2, q0, q1\n\t"                         \
+        "ee.vst.128.ip q2, %0, 0\n\t"                \
+        :                                            \
+        : "r"(dst), "r"(a), "r"(b)                   \
+        : "memory")
+#endif
+
+void sweepMaxHoldScalar(int8_t* hold, const int8_t* row, int n) {
+    for (int i = 0; i < n; i++) {
+        if (row[i] > hold[i]) hold[i] = row[i];
+    }
+}
+
+void sweepMinHoldScalar(int8_t* hold, const int8_t* row, int n) {
+    for (int i = 0; i < n; i++) {
+        if (row[i] < hold[i]) hold[i] = row[i];
+    }
+}
+
+int sweepCompareScalar(uint8_t* hits, const int8_t* row, const int8_t* threshold, int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        hits[i] = row[i] > threshold[i] ? 0xFF : 0;
+        count += hits[i] & 1;
+    }
+    return count;
+}
+
+void sweepMaxHold(int8_t* hold, const int8_t* row, int n) {
+    int i = 0;
+#if SWEEP_KERNELS_PIE
+    for (; i + 16 <= n; i += 16) {
+        PIE_BINARY_OP("ee.vmax.s8", hold + i, row + i);
+    }
+#endif
+    sweepMaxHoldScalar(hold + i, row + i, n - i);
+}
+
+void sweepMinHold(int8_t* hold, const int8_t* row, int n) {
+    int i = 0;
+#if SWEEP_KERNELS_PIE
+    for (; i + 16 <= n; i += 16) {
+        PIE_BINARY_OP("ee.vmin.s8", hold + i, row + i);
+    }
+#endif
+    sweepMinHoldScalar(hold + i, row + i, n - i);
+}
+
+void sweepNoiseFloorUpdate(int16_t* floorQ, const int8_t* row, const uint8_t* hits, int n, int riseShift, int fallShift) {
+    for (int i = 0; i < n; i++) {
+        int delta = row[i] * (1 << NOISE_FLOOR_FRAC_BITS) - floorQ[i];
+        int shift = delta > 0 ? riseShift : fallShift;
+        int step = delta >> shift;
+
+        // A gap under 2^shift LSBs truncates to no step at all, which would
+        // leave the floor parked below the row for good
+        if (step == 0 && delta > 0) step = 1;
+        if (hits[i]) step = 0;
+        floorQ[i] = (int16_t)(floorQ[i] + step);
+    }
+}
+
+void sweepThresholdRow(int8_t* threshold, const int16_t* floorQ, int n, int8_t margin, int8_t minimum) {
+    for (int i = 0; i < n; i++) {
+        int t = (floorQ[i] >> NOISE_FLOOR_FRAC_BITS) + margin;
+        if (t < minimum) t = minimum;
+        if (t > 127) t = 127;
+        threshold[i] = (int8_t)t;
+    }
+}
+
+int sweepCompare(uint8_t* hits, const int8_t* row, const int8_t* threshold, int n) {
+#if SWEEP_KERNELS_PIE
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        PIE_COMPARE_OP("ee.vcmp.gt.s8", hits + i, row + i, threshold + i);
+    }
+
+    int count = 0;
+    for (int k = 0; k < i; k++) {
+        count += hits[k] & 1;
+    }
+    return count + sweepCompareScalar(hits + i, row + i, threshold + i, n - i);
+#else
+    return sweepCompareScalar(hits, row, threshold, n);
+#endif
+}
+
+void sweepHistoryUpdate(int16_t* sum, int32_t* sumSq, const int8_t* row, const int8_t* evicted, int n) {
+    if (evicted == nullptr) {
+        for (int i = 0; i < n; i++) {
+            sum[i] += row[i];
+            sumSq[i] += row[i] * row[i];
+        }
+    } else {
+        for (int i = 0; i < n; i++) {
+            sum[i] += row[i] - evicted[i];
+            sumSq[i] += row[i] * row[i] - evicted[i] * evicted[i];
+        }
+    }
+}
+
+void sweepAccumulate(int32_t* sum, uint32_t* above, const int8_t* row, const uint8_t* hits, int n) {
+    for (int i = 0; i < n; i++) {
+        sum[i] += row[i];
+        above[i] += hits[i] & 1;
+    }
+}
+
+void sweepVariance(uint16_t* variance, const int16_t* sum, const int32_t* sumSq, int n, int count) {
+    if (count <= 0) return;
+    int32_t count2 = count * count;
+    for (int i = 0; i < n; i++) {
+        // n * sum(x^2) - sum(x)^2 is exact in integers
+        int32_t v = (sumSq[i] * count - (int32_t)sum[i] * sum[i]) / count2;
+        variance[i] = (uint16_t)(v > UINT16_MAX ? UINT16_MAX : v);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file warm_state.cpp
+ * @brief Warm-restart snapshot implementation
+ */
+
+#include "warm_state.h"
+#include "flash_logger.h"
+#include <Preferences.h>
+#include <esp_system.h>
+#include <stddef.h>
+
+// Survives deep sleep and software resets, not power loss
+RTC_NOINIT_ATTR static uint8_t rtcSnapshot[WARM_RTC_BYTES];
+
+// Working copy, kept off the stack
+static WarmSnapshot snapshot;
+
+// The snapshot goes to RTC memory whenever it fits
+static const bool useRtc = sizeof(WarmSnapshot) <= WARM_RTC_BYTES;
+
+static WarmState* shutdownState = nullptr;
+
+static void onShutdown() {
+    shutdownState->save(0);
+}
+
+WarmState::WarmState() {
+    scanner = nullptr;
+    scheduler = nullptr;
+}
+
+void WarmState::begin(RFScanner* rfScanner, RadioScheduler* radioScheduler) {
+    scanner = rfScanner;
+    scheduler = radioScheduler;
+
+    // Called by esp_restart(), so every controlled reboot keeps state
+    shutdownState = this;
+    esp_register_shutdown_handler(onShutdown);
+}
+
+uint32_t WarmState::snapshotCrc(const WarmSnapshot& snap) {
+    const size_t start = offsetof(WarmSnapshot, crc) + sizeof(snap.crc);
+    return FlashLogger::crc32((const uint8_t*)&snap + start, sizeof(WarmSnapshot) - start);
+}
+
+bool WarmState::isValid(const WarmSnapshot& snap) {
+    return snap.magic == WARM_MAGIC &&
+           snap.version == WARM_VERSION &&
+           snap.length == sizeof(WarmSnapshot) &&
+           snap.signalCount <= MAX_DETECTED_SIGNALS &&
+           snap.crc == snapshotCrc(snap);
+}
+
+bool WarmState::save(uint32_t sleepMs) {
+    if (scanner == nullptr || scheduler == nullptr) return false;
+
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.magic = WARM_MAGIC;
+    snapshot.version = WARM_VERSION;
+    snapshot.length = sizeof(WarmSnapshot);
+    snapshot.sleepMs = sleepMs;
+    snapshot.schedulerSlots = scheduler->getSlotsInFrame();
+    scanner->exportState(snapshot);
+    snapshot.crc = snapshotCrc(snapshot);
+
+    if (useRtc) {
+        memcpy(rtcSnapshot, &snapshot, sizeof(snapshot));
+        return true;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(WARM_NVS_NAMESPACE, false)) return false;
+    size_t written = prefs.putBytes(WARM_NVS_KEY, &snapshot, sizeof(snapshot));
+    prefs.end();
+    return written == sizeof(snapshot);
+}
+
+bool WarmState::restore() {
+    if (scanner == nullptr || scheduler == nullptr) return false;
+
+    bool found = false;
+    if (useRtc) {
+        // RTC contents are garbage after power-on or brownout
+        esp_reset_reason_t reason = esp_reset_reason();
+        if (reason == ESP_RST_SW || reason == ESP_RST_DEEPSLEEP) {
+            memcpy(&snapshot, rtcSnapshot, sizeof(snapshot));
+            found = true;
+        }
+        memset(rtcSnapshot, 0, sizeof(WarmSnapshot));
+    } else {
+        Preferences prefs;
+        if (prefs.begin(WARM_NVS_NAMESPACE, false)) {
+            if (prefs.getBytesLength(WARM_NVS_KEY) == sizeof(snapshot)) {
+                found = prefs.getBytes(WARM_NVS_KEY, &snapshot, sizeof(snapshot)) == sizeof(snapshot);
+                prefs.remove(WARM_NVS_KEY);
+            }
+            prefs.end();
+        }
+    }
+
+    if (!found) return false;
+    if (!isValid(snapshot)) {
+        Serial.println("[WARM] Snapshot invalid, starting cold");
+        return false;
+    }
+
+    scanner->importState(snapshot, snapshot.sleepMs + millis());
+    scheduler->setSlotsInFrame(snapshot.schedulerSlots);
+
+    Serial.print("[WARM] Restored noise floors and ");
+    Serial.print(scanner->getSignalCount());
+    Serial.print(" signals from ");
+    Serial.println(useRtc ? "RTC memory" : "NVS");
+    return true;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file watchlist.cpp
+ * @brief Watchlist alert implementation
+ */
+
+#include "watchlist.h"
+#include <math.h>
+#include <string.h>
+#include "band_scanner.h"
+
+// Entry::state: the low bit is set while alerting, and every sample that
+// raises or holds the alert adds WATCH_HELD
+#define WATCH_ALERTING 1u
+#define WATCH_HELD 2u
+
+Watchlist::Watchlist() {
+    entryCount = 0;
+    memset(channelEntry, -1, sizeof(channelEntry));
+    output = nullptr;
+    alertCount = 0;
+    lastAlertUs = 0;
+    maxAlertUs = 0;
+    lastOverlayUs = 0;
+    latencyMisses = 0;
+}
+
+void Watchlist::begin(AlertOutput* alertOutput) {
+    output = alertOutput;
+
+    add(0, DRONE_FREQ_900_1);
+    add(0, DRONE_FREQ_900_2);
+    add(0, DRONE_FREQ_900_3);
+    add(1, DRONE_FREQ_2400_1);
+    add(1, DRONE_FREQ_2400_2);
+    add(1, DRONE_FREQ_2400_3);
+}
+
+bool Watchlist::add(uint8_t band, float freq) {
+    if (entryCount >= WATCHLIST_MAX) return false;
+
+    float start = band == 0 ? FREQ_900_START : FREQ_2400_START;
+    float step = band == 0 ? FREQ_900_STEP : FREQ_2400_STEP;
+    int channels = band == 0 ? Plan900::CHANNELS : Plan2400::CHANNELS;
+    int channel = (int)lroundf((freq - start) / step);
+    if (channel < 0 || channel >= channels) return false;
+    if (channelEntry[band][channel] >= 0) return true;  // Already watched
+
+    Entry& e = entries[entryCount];
+    e.frequency = band == 0 ? Plan900::frequency(channel) : Plan2400::frequency(channel);
+    e.band = band;
+    e.state.store(0);
+    e.pending.store(false);
+    e.rssi.store(-128);
+    e.detectedUs = 0;
+    e.lastAboveMs.store(0);
+    e.lastSampleMs.store(0);
+    e.revisitMs.store(0);
+    output->prepareBanner(entryCount, e.frequency);
+
+    channelEntry[band][channel] = entryCount++;
+    return true;
+}
+
+void Watchlist::checkSample(int e, int8_t rssi, int8_t threshold) {
+    Entry& w = entries[e];
+    int64_t now = output->nowUs();
+    uint32_t nowMs = (uint32_t)(now / 1000);
+    uint32_t lastSample = w.lastSampleMs.load(std::memory_order_relaxed);
+    if (lastSample != 0) w.revisitMs.store(nowMs - lastSample, std::memory_order_relaxed);
+    w.lastSampleMs.store(nowMs, std::memory_order_relaxed);
+
+    bool above = rssi > threshold;
+    if (!above && rssi < threshold - WATCH_HYSTERESIS_DB) return;
+
+    // Above raises or holds; inside the hysteresis band only holds. The
+    // swap fails if the alert task cleared the alert meanwhile, and the
+    // sample is then judged against the cleared state
+    uint32_t state = w.state.load(std::memory_order_acquire);
+    bool raise;
+    do {
+        raise = above && !(state & WATCH_ALERTING);
+        if (!above && !(state & WATCH_ALERTING)) return;
+        w.lastAboveMs.store(nowMs, std::memory_order_relaxed);
+        if (raise) w.detectedUs = now;
+    } while (!w.state.compare_exchange_weak(state, (state + WATCH_HELD) | WATCH_ALERTING,
+                                            std::memory_order_acq_rel, std::memory_order_acquire));
+
+    if (above) w.rssi.store(rssi, std::memory_order_relaxed);
+    if (raise) {
+        w.pending.store(true, std::memory_order_release);
+        output->wake();
+    }
+}
+
+void Watchlist::service() {
+    // Pin first, for every pending hit: it is the cheapest output and the
+    // one with the bound, so no banner is drawn until all of them are up
+    bool raised[WATCHLIST_MAX];
+    uint32_t alertUs[WATCHLIST_MAX];
+    int lastRaised = -1;
+    for (int i = 0; i < entryCount; i++) {
+        Entry& w = entries[i];
+        raised[i] = w.pending.exchange(false, std::memory_order_acq_rel);
+        if (!raised[i]) continue;
+
+        output->setPin(true);
+        alertUs[i] = (uint32_t)(output->nowUs() - w.detectedUs);
+        lastRaised = i;
+    }
+
+    for (int i = 0; i < entryCount; i++) {
+        if (!raised[i]) continue;
+        Entry& w = entries[i];
+
+        // Only the newest banner is shown; the others are already stale
+        if (i == lastRaised) output->showBanner(i);
+        uint32_t overlayUs = (uint32_t)(output->nowUs() - w.detectedUs);
+
+        lastAlertUs = alertUs[i];
+        if (alertUs[i] > maxAlertUs) maxAlertUs = alertUs[i];
+        if (alertUs[i] > WATCH_LATENCY_BUDGET_US) latencyMisses++;
+        lastOverlayUs = overlayUs;
+        alertCount++;
+
+        output->alerted(w.frequency, w.rssi, alertUs[i], overlayUs);
+    }
+
+    // Clear alerts that have been below the hysteresis band long enough.
+    // A wait for a sample still to come counts as a revisit, so the hold
+    // covers a channel not yet seen again
+    uint32_t now = (uint32_t)(output->nowUs() / 1000);
+    int showing = -1;
+    bool cleared = false;
+    for (int i = 0; i < entryCount; i++) {
+        Entry& w = entries[i];
+        uint32_t state = w.state.load(std::memory_order_acquire);
+        if (!(state & WATCH_ALERTING)) continue;
+        uint32_t lastSample = w.lastSampleMs.load(std::memory_order_relaxed);
+        uint32_t revisit = w.revisitMs.load(std::memory_order_relaxed);
+        if ((int32_t)(now - lastSample) > (int32_t)revisit) revisit = now - lastSample;
+        uint32_t hold = WATCH_HOLD_REVISITS * revisit;
+        if (hold < WATCH_HOLD_MS) hold = WATCH_HOLD_MS;
+
+        // Only if no sample held the alert since its state was read. The
+        // sweep's clock may be ahead of ours: a sample stamped after now
+        // is not old
+        int32_t quietMs = (int32_t)(now - w.lastAboveMs.load(std::memory_order_relaxed));
+        if (quietMs > (int32_t)hold &&
+            w.state.compare_exchange_strong(state, state & ~WATCH_ALERTING,
+                                            std::memory_order_acq_rel)) {
+            cleared = true;
+        } else {
+            showing = i;
+        }
+    }
+
+    if (cleared) {
+        if (showing >= 0) {
+            output->showBanner(showing);
+        } else {
+            output->setPin(false);
+            output->clearBanner();
+        }
+    }
+}
+
+int Watchlist::getCount() {
+    return entryCount;
+}
+
+bool Watchlist::isAlerting() {
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].state.load(std::memory_order_acquire) & WATCH_ALERTING) return true;
+    }
+    return false;
+}
+
+uint32_t Watchlist::getAlertCount() {
+    return alertCount;
+}
+
+uint32_t Watchlist::getLastAlertUs() {
+    return lastAlertUs;
+}
+
+uint32_t Watchlist::getMaxAlertUs() {
+    return maxAlertUs;
+}
+
+uint32_t Watchlist::getLastOverlayUs() {
+    return lastOverlayUs;
+}
+
+uint32_t Watchlist::getLatencyMisses() {
+    return latencyMisses;
+}
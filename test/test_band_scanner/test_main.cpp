@@ -0,0 +1,295 @@
+/**
+ * @file test_main.cpp
+ * @brief BandScanner specialisations against a simulated radio
+ *
+ * Each chip's real constants and frames (radio_chips.h) are paired with a
+ * simulated radio in place of the driver and SPI bus. The radio decodes
+ * the frames as the chip would: the frequency register with its own
+ * crystal scaling, receive, standby, and an instantaneous RSSI taken from
+ * a scripted spectrum, which it only reports once receiving has settled.
+ * Time is virtual.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "band_scanner.h"
+#include "radio_chips.h"
+
+#define NOISE_DBM -110.0f
+#define SIGNAL_DBM -52.5f
+
+// Opcodes and register layout of one chip, as the simulation decodes them
+struct SX126xModel {
+    static const int WORD_BYTES = 4;
+    static const uint8_t OP_GET_RSSI = 0x15;
+    static const int MODE_SHIFT = 4;
+    static double wordToMHz(uint32_t word) { return word * 32.0 / (1UL << 25); }
+    // Synthesiser range, give or take a register step
+    static bool inRange(double mhz) { return mhz > 149.9 && mhz < 960.1; }
+};
+
+struct SX128xModel {
+    static const int WORD_BYTES = 3;
+    static const uint8_t OP_GET_RSSI = 0x1F;
+    static const int MODE_SHIFT = 5;
+    static double wordToMHz(uint32_t word) { return word * 52.0 / (1UL << 18); }
+    // Synthesiser range, give or take a register step
+    static bool inRange(double mhz) { return mhz > 2399.9 && mhz < 2500.1; }
+};
+
+static uint32_t simUs;
+
+template <typename Model>
+class SimRadio {
+public:
+    SimRadio() {
+        receiving = false;
+        frequencyMHz = 0;
+        rxSinceUs = 0;
+        emitterMHz = 0;
+        dead = false;
+        unsettledReads = 0;
+        frames = 0;
+        calibrations = 0;
+        calibrateLo = calibrateHi = 0;
+    }
+
+    // One frame over the bus
+    bool execute(RadioCommand& cmd) {
+        if (dead) return false;
+        frames++;
+        memset(cmd.reply, 0, sizeof(cmd.reply));
+
+        switch (cmd.bytes[0]) {
+            case 0x86: {                          // SetRfFrequency
+                uint32_t word = 0;
+                for (int i = 0; i < Model::WORD_BYTES; i++) word = (word << 8) | cmd.bytes[1 + i];
+                tune(word);
+                break;
+            }
+            case 0x82:                            // SetRx
+                startReceive();
+                break;
+            case 0x80:                            // SetStandby
+                standby();
+                break;
+            default:
+                if (cmd.bytes[0] != Model::OP_GET_RSSI) break;
+                cmd.reply[1] = (uint8_t)((receiving ? 0x05 : 0x02) << Model::MODE_SHIFT);
+                cmd.reply[2] = (uint8_t)lroundf(-2 * rssi());
+                break;
+        }
+        return true;
+    }
+
+    void tune(uint32_t word) {
+        double mhz = Model::wordToMHz(word);
+        // A word the chip cannot synthesise leaves it unable to receive
+        frequencyMHz = Model::inRange(mhz) ? mhz : 0;
+    }
+
+    int16_t startReceive() {
+        receiving = frequencyMHz != 0;
+        rxSinceUs = simUs;
+        return 0;
+    }
+
+    int16_t standby() {
+        receiving = false;
+        return 0;
+    }
+
+    // Scripted spectrum: one emitter, 2 MHz wide, over the noise
+    float rssi() {
+        if (simUs - rxSinceUs < settleUs) unsettledReads++;
+        return fabs(frequencyMHz - emitterMHz) < 1.0 ? SIGNAL_DBM : NOISE_DBM;
+    }
+
+    bool receiving;
+    double frequencyMHz;
+    uint32_t rxSinceUs;
+    uint32_t settleUs;
+    double emitterMHz;
+    bool dead;                   // Stops answering, as with BUSY stuck high
+    int unsettledReads;
+    int frames;
+    int calibrations;
+    float calibrateLo;
+    float calibrateHi;
+};
+
+// A chip's constants and frames over the simulated bus
+template <typename Chip, typename Model>
+struct SimTraits : Chip {
+    typedef SimRadio<Model> Radio;
+
+    static void delayUs(uint32_t us) {
+        simUs += us;
+    }
+
+
+    static uint32_t nowUs() {
+        return simUs;
+    }
+
+    static bool transfer(Radio& radio, RadioCommand* commands, int count) {
+        simUs += 10;  // Bus time per call
+        for (int i = 0; i < count; i++) {
+            if (!radio.execute(commands[i])) return false;
+        }
+        return true;
+    }
+
+    static bool tune(Radio& radio, uint32_t word) {
+        radio.tune(word);
+        return true;
+    }
+
+    static float readRssi(Radio& radio) {
+        return radio.rssi();
+    }
+
+    static bool calibrate(Radio& radio, float loMHz, float hiMHz) {
+        radio.calibrations++;
+        radio.calibrateLo = loMHz;
+        radio.calibrateHi = hiMHz;
+        return true;
+    }
+};
+
+typedef BandScanner<SimTraits<SX126xChip, SX126xModel>, Plan900> SimScanner900;
+typedef BandScanner<SimTraits<SX128xChip, SX128xModel>, Plan2400> SimScanner2400;
+
+// Sweep the plan with an emitter on one channel; every channel must read
+// back as the spectrum has it, at the frequency the plan gives
+template <typename Scanner>
+static void checkSweep(float emitterMHz) {
+    typename Scanner::Radio radio;
+    radio.settleUs = Scanner::RadioTraits::SETTLE_US;
+    radio.emitterMHz = emitterMHz;
+    Scanner scanner;
+    TEST_ASSERT_TRUE(scanner.begin(&radio));
+    TEST_ASSERT_TRUE(scanner.getRadio() == &radio);
+
+    int hits = 0;
+    for (int ch = 0; ch < Scanner::CHANNELS; ch++) {
+        float expected = fabs(Scanner::frequency(ch) - emitterMHz) < 1.0f ? SIGNAL_DBM : NOISE_DBM;
+        uint32_t before = simUs;
+        float rssi = scanner.measure(ch);
+
+        TEST_ASSERT_EQUAL_FLOAT(expected, rssi);
+        // Tuned within a register step of the plan, and left in standby
+        TEST_ASSERT_FLOAT_WITHIN(0.001, Scanner::frequency(ch), radio.frequencyMHz);
+        TEST_ASSERT_FALSE(radio.receiving);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(Scanner::RadioTraits::SETTLE_US, simUs - before);
+        if (expected == SIGNAL_DBM) hits++;
+    }
+    TEST_ASSERT_GREATER_THAN_INT(0, hits);
+    TEST_ASSERT_EQUAL_INT(0, radio.unsettledReads);
+    // Tune, receive, read and standby: four frames per channel
+    TEST_ASSERT_EQUAL_INT(4 * Scanner::CHANNELS, radio.frames);
+}
+
+template <typename Scanner>
+static void checkListenAndErrors(float inBandMHz, float outOfRangeMHz) {
+    typename Scanner::Radio radio;
+    radio.settleUs = Scanner::RadioTraits::SETTLE_US;
+    radio.emitterMHz = inBandMHz;
+    Scanner scanner;
+    scanner.begin(&radio);
+
+    // Step by step: listen, read while receiving, standby
+    TEST_ASSERT_TRUE(scanner.listen(inBandMHz));
+    TEST_ASSERT_TRUE(radio.receiving);
+    TEST_ASSERT_EQUAL_FLOAT(SIGNAL_DBM, scanner.readRssi());
+    scanner.standby();
+    TEST_ASSERT_FALSE(radio.receiving);
+
+    // A frequency the chip rejects reads as nothing, not as noise
+    TEST_ASSERT_TRUE(scanner.listen(outOfRangeMHz));
+    TEST_ASSERT_FALSE(radio.receiving);
+    TEST_ASSERT_EQUAL_FLOAT(-120.0f, scanner.readRssi());
+
+    // A radio that stops answering
+    radio.dead = true;
+    TEST_ASSERT_FALSE(scanner.listen(inBandMHz));
+    TEST_ASSERT_EQUAL_FLOAT(-120.0f, scanner.measure(0));
+    TEST_ASSERT_EQUAL_FLOAT(-120.0f, scanner.readRssi());
+    TEST_ASSERT_EQUAL_INT(0, radio.unsettledReads);
+}
+
+template <typename Scanner>
+static void checkTimeSteps() {
+    typename Scanner::Radio radio;
+    radio.settleUs = Scanner::RadioTraits::SETTLE_US;
+    Scanner scanner;
+    scanner.begin(&radio);
+
+    uint32_t driverUs = 0;
+    uint32_t framesUs = 0;
+    scanner.timeSteps(Scanner::CHANNELS + 10, driverUs, framesUs);
+    TEST_ASSERT_FALSE(radio.receiving);
+    TEST_ASSERT_EQUAL_INT(0, radio.unsettledReads);
+    // Settling is excluded: what is left is the simulated bus time
+    TEST_ASSERT_LESS_THAN_UINT32(Scanner::RadioTraits::SETTLE_US, framesUs);
+    TEST_ASSERT_EQUAL_UINT32(20, framesUs);
+}
+
+void setUp(void) {
+    simUs = 1000;
+}
+
+void tearDown(void) {
+}
+
+void test_sx126x_calibrates_the_plan_once(void) {
+    SimScanner900::Radio radio;
+    SimScanner900 scanner;
+    TEST_ASSERT_TRUE(scanner.begin(&radio));
+    TEST_ASSERT_EQUAL_INT(1, radio.calibrations);
+    TEST_ASSERT_EQUAL_FLOAT(FREQ_900_START, radio.calibrateLo);
+    TEST_ASSERT_EQUAL_FLOAT(FREQ_900_END, radio.calibrateHi);
+}
+
+void test_sx126x_sweeps_900_plan(void) {
+    checkSweep<SimScanner900>(915.0f);
+}
+
+void test_sx128x_sweeps_2400_plan(void) {
+    checkSweep<SimScanner2400>(2437.0f);
+}
+
+void test_sx126x_listen_and_errors(void) {
+    checkListenAndErrors<SimScanner900>(868.0f, 1200.0f);
+}
+
+void test_sx128x_listen_and_errors(void) {
+    checkListenAndErrors<SimScanner2400>(2450.0f, 2600.0f);
+}
+
+void test_time_steps(void) {
+    checkTimeSteps<SimScanner900>();
+    checkTimeSteps<SimScanner2400>();
+}
+
+void test_bandwidth_snaps_to_chip(void) {
+    TEST_ASSERT_EQUAL_FLOAT(125.0f, SimScanner900::bandwidthKHz(100.0f));
+    TEST_ASSERT_EQUAL_FLOAT(7.8f, SimScanner900::bandwidthKHz(1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(500.0f, SimScanner900::bandwidthKHz(2000.0f));
+    TEST_ASSERT_EQUAL_FLOAT(812.5f, SimScanner2400::bandwidthKHz(800.0f));
+    TEST_ASSERT_EQUAL_FLOAT(203.125f, SimScanner2400::bandwidthKHz(1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(1625.0f, SimScanner2400::bandwidthKHz(5000.0f));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sx126x_calibrates_the_plan_once);
+    RUN_TEST(test_sx126x_sweeps_900_plan);
+    RUN_TEST(test_sx128x_sweeps_2400_plan);
+    RUN_TEST(test_sx126x_listen_and_errors);
+    RUN_TEST(test_sx128x_listen_and_errors);
+    RUN_TEST(test_time_steps);
+    RUN_TEST(test_bandwidth_snaps_to_chip);
+    return UNITY_END();
+}
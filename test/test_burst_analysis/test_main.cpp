@@ -0,0 +1,167 @@
+/**
+ * @file test_main.cpp
+ * @brief analyzeBursts() on synthesized zero-span captures
+ *
+ * Captures are built at BURST_SAMPLE_RATE_HZ the way the firmware takes
+ * them: a noise floor with a couple of dB of jitter and flat bursts on a
+ * fixed cadence, optionally landing on only some periods as a hopper's
+ * would.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "burst_analysis.h"
+
+#define NOISE_DBM -100
+#define BURST_DBM -55
+
+static int8_t capture[BURST_CAPTURE_SAMPLES];
+static uint32_t rngState;
+
+static int jitter(int span) {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (int)((rngState >> 16) % (2 * span + 1)) - span;
+}
+
+/**
+ * @brief Fill the capture with bursts every periodMs
+ * @param dwell Periods on this channel, repeating; nullptr for all of them
+ */
+static void synthesize(float periodMs, float burstMs, float phaseMs,
+                       const uint8_t* dwell = nullptr, int dwellCount = 0) {
+    const float samplesPerMs = BURST_SAMPLE_RATE_HZ / 1000.0f;
+
+    for (int i = 0; i < BURST_CAPTURE_SAMPLES; i++) {
+        capture[i] = (int8_t)(NOISE_DBM + jitter(2));
+    }
+
+    for (int k = 0; ; k++) {
+        int start = (int)lroundf((phaseMs + k * periodMs) * samplesPerMs);
+        if (start >= BURST_CAPTURE_SAMPLES) break;
+        if (dwell && !dwell[k % dwellCount]) continue;
+
+        int len = (int)lroundf(burstMs * samplesPerMs);
+        if (len < 1) len = 1;
+        for (int i = start; i < start + len && i < BURST_CAPTURE_SAMPLES; i++) {
+            capture[i] = (int8_t)(BURST_DBM + jitter(1));
+        }
+    }
+}
+
+void setUp(void) {
+    rngState = 4242;
+}
+
+void tearDown(void) {
+}
+
+void test_elrs_250hz_control_link(void) {
+    BurstProfile p;
+    synthesize(4.0f, 1.0f, 0.3f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+
+    TEST_ASSERT_EQUAL_STRING("ELRS 250Hz", p.protocol);
+    TEST_ASSERT_EQUAL_INT(MOD_LORA, p.modType);
+    TEST_ASSERT_FALSE(p.hopping);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.0f, p.periodMs);
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 250.0f, p.rateHz);
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.25f, p.dutyCycle);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.0f, p.meanBurstMs);
+    TEST_ASSERT_INT_WITHIN(2, NOISE_DBM, p.noiseDbm);
+    TEST_ASSERT_INT_WITHIN(1, BURST_DBM, p.peakDbm);
+
+    // ~1 s at 250 Hz, every interval in the 4 ms histogram bin
+    int expected = BURST_CAPTURE_SAMPLES / 16;
+    TEST_ASSERT_INT_WITHIN(1, expected, p.burstCount);
+    int bin = (int)(log2f(4.0f / BURST_HIST_MIN_MS) * BURST_HIST_BINS_PER_OCTAVE);
+    TEST_ASSERT_EQUAL_UINT16(p.burstCount - 1, p.intervalHistogram[bin]);
+}
+
+void test_hopper_on_some_periods(void) {
+    // Back on this channel after 3, 2, 5 and 3 hops: no interval is the
+    // period, but all are whole multiples of it, and only 10 ms explains
+    // the odd ones
+    static const uint8_t dwell[13] = {1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 0};
+    BurstProfile p;
+    synthesize(10.0f, 2.0f, 1.0f, dwell, 13);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 0, p);
+
+    TEST_ASSERT_EQUAL_STRING("ELRS 100Hz", p.protocol);
+    TEST_ASSERT_TRUE(p.hopping);
+    TEST_ASSERT_EQUAL_INT(MOD_FHSS, p.modType);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 10.0f, p.periodMs);
+}
+
+void test_video_frames(void) {
+    BurstProfile p;
+    synthesize(33.333f, 16.0f, 5.0f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+
+    TEST_ASSERT_EQUAL_STRING("Video 30fps", p.protocol);
+    TEST_ASSERT_EQUAL_INT(MOD_OFDM, p.modType);
+    TEST_ASSERT_FALSE(p.hopping);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 33.333f, p.periodMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.48f, p.dutyCycle);
+}
+
+void test_fingerprints_respect_band(void) {
+    BurstProfile p;
+
+    // The same 4 ms train is ELRS 250Hz on 2.4GHz, but no 900MHz link uses
+    // it; the period still comes out of the interval histogram
+    synthesize(4.0f, 1.0f, 0.0f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 0, p);
+
+    TEST_ASSERT_EQUAL_STRING("Unknown", p.protocol);
+    TEST_ASSERT_EQUAL_INT(MOD_UNKNOWN, p.modType);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 4.0f, p.periodMs);
+}
+
+void test_duty_cycle_separates_video_from_control(void) {
+    BurstProfile p;
+
+    // 20 ms cadence on 2.4GHz: short packets are a control link,
+    // long frames are video
+    synthesize(20.0f, 2.0f, 0.0f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+    TEST_ASSERT_EQUAL_STRING("ELRS/CRSF 50Hz", p.protocol);
+
+    synthesize(20.0f, 12.0f, 0.0f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+    TEST_ASSERT_EQUAL_STRING("Video 50fps", p.protocol);
+}
+
+void test_noise_only(void) {
+    BurstProfile p;
+    for (int i = 0; i < BURST_CAPTURE_SAMPLES; i++) {
+        capture[i] = (int8_t)(NOISE_DBM + jitter(2));
+    }
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+
+    TEST_ASSERT_EQUAL_UINT16(0, p.burstCount);
+    TEST_ASSERT_EQUAL_STRING("Unknown", p.protocol);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.periodMs);
+}
+
+void test_single_burst_has_no_period(void) {
+    BurstProfile p;
+    synthesize(2000.0f, 5.0f, 100.0f);
+    analyzeBursts(capture, BURST_CAPTURE_SAMPLES, BURST_SAMPLE_RATE_HZ, 1, p);
+
+    TEST_ASSERT_EQUAL_UINT16(1, p.burstCount);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.periodMs);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.rateHz);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_elrs_250hz_control_link);
+    RUN_TEST(test_hopper_on_some_periods);
+    RUN_TEST(test_video_frames);
+    RUN_TEST(test_fingerprints_respect_band);
+    RUN_TEST(test_duty_cycle_separates_video_from_control);
+    RUN_TEST(test_noise_only);
+    RUN_TEST(test_single_burst_has_no_period);
+    return UNITY_END();
+}
@@ -0,0 +1,654 @@
+/**
+ * @file classifier_predictions.h
+ * @brief Predictions of tools/train_classifier.py (generated, do not edit)
+ *
+ * Every row the model was trained and tested on, from: classifier_seed.csv
+ * with the class the tool predicted for it. classifyEmitter() must agree.
+ */
+
+#ifndef CLASSIFIER_PREDICTIONS_H
+#define CLASSIFIER_PREDICTIONS_H
+
+#include <stdint.h>
+
+#define CLASSIFIER_PREDICTION_COUNT 600
+
+// Feature names in the order the tool used them
+static const char* const predictionFeatureNames[8] = {
+    "band", "freq", "rssi", "margin", "variance", "occupancy", "width", "presence"
+};
+
+// Feature vectors
+static constexpr int16_t predictionFeatures[CLASSIFIER_PREDICTION_COUNT][8] = {
+    {0, 8825, -53, 56, 12, 63, 5, 8},
+    {1, 24040, -45, 73, 392, 45, 10, 2},
+    {0, 9265, -94, 16, 223, 31, 5, 3},
+    {1, 24100, -86, 23, 23, 56, 10, 7},
+    {0, 8985, -45, 61, 68, 87, 10, 7},
+    {1, 24920, -89, 20, 31, 96, 30, 7},
+    {0, 8680, -80, 24, 43, 52, 10, 7},
+    {1, 24060, -36, 73, 289, 22, 10, 1},
+    {0, 8680, -63, 44, 338, 6, 10, 3},
+    {1, 24940, -63, 53, 27, 81, 30, 7},
+    {0, 8655, -64, 43, 70, 93, 10, 7},
+    {1, 24880, -70, 38, 187, 21, 162, 2},
+    {0, 8690, -34, 75, 16, 99, 5, 7},
+    {1, 24560, -86, 25, 50, 54, 10, 6},
+    {0, 8680, -80, 30, 110, 44, 5, 3},
+    {1, 24730, -55, 54, 239, 36, 10, 1},
+    {0, 9295, -66, 45, 285, 18, 5, 1},
+    {1, 24950, -32, 82, 3, 66, 10, 8},
+    {0, 8965, -57, 51, 64, 100, 5, 8},
+    {1, 24980, -74, 36, 29, 100, 10, 6},
+    {0, 9085, -53, 64, 44, 64, 5, 6},
+    {1, 24280, -99, 12, 78, 55, 20, 8},
+    {0, 8690, -77, 35, 61, 96, 10, 6},
+    {1, 24400, -83, 35, 21, 59, 159, 8},
+    {0, 9175, -83, 35, 390, 38, 5, 1},
+    {1, 24750, -96, 18, 27, 98, 164, 6},
+    {0, 9010, -41, 67, 291, 37, 15, 4},
+    {1, 24130, -99, 7, 23, 80, 10, 6},
+    {0, 8680, -38, 68, 71, 53, 5, 8},
+    {1, 24250, -96, 10, 71, 70, 10, 7},
+    {0, 8690, -31, 75, 370, 38, 10, 2},
+    {1, 24780, -42, 74, 25, 70, 30, 7},
+    {0, 8680, -80, 27, 172, 21, 10, 2},
+    {1, 24880, -49, 55, 12, 95, 10, 6},
+    {0, 8900, -53, 65, 11, 79, 10, 8},
+    {1, 24020, -34, 83, 37, 56, 200, 6},
+    {0, 8660, -45, 60, 176, 14, 10, 4},
+    {1, 24430, -64, 54, 11, 54, 10, 7},
+    {0, 9025, -91, 23, 223, 5, 5, 4},
+    {1, 24460, -32, 75, 5, 66, 114, 6},
+    {0, 9070, -62, 49, 26, 61, 15, 8},
+    {1, 24670, -35, 75, 119, 33, 30, 2},
+    {0, 9235, -35, 79, 50, 71, 5, 6},
+    {1, 24200, -93, 12, 44, 97, 109, 8},
+    {0, 8680, -63, 46, 64, 68, 5, 8},
+    {1, 24150, -53, 60, 33, 52, 20, 6},
+    {0, 9275, -39, 75, 152, 20, 15, 2},
+    {1, 24000, -48, 61, 18, 69, 102, 7},
+    {0, 9040, -50, 56, 76, 81, 10, 8},
+    {1, 24150, -45, 62, 372, 42, 10, 1},
+    {0, 8700, -94, 22, 125, 29, 10, 1},
+    {1, 24840, -37, 77, 31, 82, 108, 8},
+    {0, 8690, -90, 15, 32, 96, 10, 6},
+    {1, 24190, -90, 21, 48, 89, 20, 6},
+    {0, 9070, -82, 36, 265, 36, 10, 1},
+    {1, 24270, -33, 81, 37, 85, 30, 6},
+    {0, 8740, -35, 76, 149, 18, 10, 4},
+    {1, 24920, -32, 82, 18, 90, 10, 8},
+    {0, 8955, -49, 69, 62, 81, 5, 6},
+    {1, 24680, -59, 58, 48, 98, 10, 7},
+    {0, 8835, -67, 46, 37, 74, 5, 7},
+    {1, 24490, -93, 21, 35, 90, 184, 7},
+    {0, 8685, -45, 59, 301, 40, 5, 4},
+    {1, 24550, -42, 67, 52, 53, 20, 7},
+    {0, 9165, -67, 40, 262, 20, 10, 4},
+    {1, 24460, -90, 25, 192, 33, 30, 2},
+    {0, 9235, -88, 28, 31, 55, 10, 8},
+    {1, 24320, -50, 62, 52, 67, 10, 7},
+    {0, 9035, -32, 76, 367, 22, 5, 1},
+    {1, 24320, -97, 19, 39, 87, 190, 7},
+    {0, 8700, -68, 38, 57, 59, 5, 6},
+    {1, 24150, -89, 21, 58, 64, 10, 6},
+    {0, 9000, -44, 63, 67, 54, 5, 6},
+    {1, 24300, -99, 19, 28, 70, 30, 7},
+    {0, 9050, -47, 60, 3, 51, 10, 6},
+    {1, 24730, -45, 59, 226, 26, 30, 1},
+    {0, 9105, -91, 24, 64, 69, 10, 6},
+    {1, 24160, -86, 23, 261, 36, 10, 2},
+    {0, 8890, -72, 46, 6, 76, 15, 6},
+    {1, 24050, -85, 32, 40, 61, 20, 6},
+    {0, 9155, -52, 61, 48, 56, 10, 6},
+    {1, 24230, -73, 39, 15, 55, 20, 7},
+    {0, 9145, -39, 79, 296, 45, 10, 2},
+    {1, 24770, -67, 48, 7, 67, 20, 7},
+    {0, 8680, -64, 50, 40, 98, 5, 8},
+    {1, 24600, -86, 25, 229, 21, 30, 4},
+    {0, 9230, -80, 29, 265, 25, 5, 3},
+    {1, 24460, -79, 36, 50, 85, 10, 7},
+    {0, 8980, -89, 26, 33, 81, 5, 7},
+    {1, 24990, -41, 68, 323, 23, 10, 1},
+    {0, 8685, -68, 48, 334, 14, 5, 2},
+    {1, 24280, -67, 48, 312, 34, 10, 1},
+    {0, 9295, -94, 10, 47, 57, 10, 6},
+    {1, 24050, -34, 71, 47, 99, 177, 7},
+    {0, 8680, -72, 46, 44, 59, 10, 7},
+    {1, 24040, -98, 7, 26, 89, 20, 6},
+    {0, 8695, -87, 19, 52, 85, 10, 8},
+    {1, 24150, -47, 67, 34, 69, 30, 6},
+    {0, 9120, -74, 38, 46, 50, 10, 6},
+    {1, 24430, -53, 58, 51, 53, 10, 6},
+    {0, 8985, -35, 81, 47, 68, 5, 7},
+    {1, 24160, -74, 40, 361, 25, 105, 4},
+    {0, 8690, -71, 38, 20, 62, 10, 8},
+    {1, 24830, -79, 33, 375, 17, 10, 2},
+    {0, 8630, -84, 28, 41, 85, 15, 7},
+    {1, 24650, -45, 67, 237, 16, 30, 4},
+    {0, 8615, -41, 64, 79, 75, 5, 7},
+    {1, 24110, -35, 75, 56, 58, 10, 8},
+    {0, 8695, -51, 57, 368, 9, 5, 1},
+    {1, 25000, -63, 43, 361, 9, 10, 2},
+    {0, 9180, -41, 75, 35, 80, 10, 8},
+    {1, 24210, -74, 42, 128, 29, 20, 3},
+    {0, 8680, -42, 68, 294, 21, 15, 1},
+    {1, 24520, -66, 46, 47, 71, 10, 7},
+    {0, 8685, -33, 81, 37, 87, 10, 8},
+    {1, 24930, -80, 34, 28, 82, 30, 7},
+    {0, 8690, -93, 25, 2, 69, 15, 7},
+    {1, 24110, -82, 33, 38, 58, 30, 6},
+    {0, 9230, -65, 47, 184, 8, 10, 1},
+    {1, 24470, -43, 66, 74, 60, 30, 6},
+    {0, 9030, -92, 12, 191, 44, 5, 1},
+    {1, 24550, -35, 73, 66, 69, 10, 8},
+    {0, 8700, -99, 13, 68, 79, 10, 8},
+    {1, 24080, -66, 49, 163, 21, 10, 3},
+    {0, 9090, -66, 48, 66, 82, 5, 6},
+    {1, 24020, -79, 28, 25, 71, 10, 7},
+    {0, 8695, -39, 72, 68, 50, 15, 8},
+    {1, 24860, -72, 40, 39, 60, 10, 8},
+    {0, 8700, -96, 22, 182, 45, 5, 2},
+    {1, 24040, -74, 31, 296, 11, 10, 4},
+    {0, 8680, -38, 79, 257, 18, 5, 1},
+    {1, 24280, -63, 55, 241, 43, 20, 3},
+    {0, 8955, -44, 66, 3, 80, 5, 7},
+    {1, 24700, -63, 53, 11, 98, 10, 7},
+    {0, 9125, -36, 73, 23, 66, 10, 8},
+    {1, 24580, -36, 80, 29, 81, 181, 6},
+    {0, 8695, -48, 56, 158, 32, 10, 1},
+    {1, 24890, -30, 80, 329, 34, 180, 2},
+    {0, 8695, -58, 52, 44, 92, 5, 7},
+    {1, 24270, -70, 46, 32, 62, 10, 8},
+    {0, 8695, -68, 39, 189, 15, 10, 3},
+    {1, 24790, -78, 30, 13, 59, 149, 6},
+    {0, 9155, -64, 51, 164, 7, 10, 4},
+    {1, 24710, -62, 49, 64, 97, 132, 8},
+    {0, 9215, -46, 59, 75, 96, 5, 8},
+    {1, 24650, -41, 71, 15, 65, 10, 7},
+    {0, 9205, -41, 77, 61, 83, 15, 7},
+    {1, 24680, -98, 14, 41, 66, 10, 6},
+    {0, 8980, -41, 69, 12, 80, 5, 8},
+    {1, 24530, -41, 74, 52, 82, 10, 7},
+    {0, 9050, -64, 48, 32, 50, 10, 6},
+    {1, 24760, -71, 43, 13, 79, 10, 7},
+    {0, 8695, -71, 34, 397, 45, 5, 3},
+    {1, 24660, -83, 23, 37, 67, 20, 6},
+    {0, 8700, -64, 49, 111, 25, 5, 3},
+    {1, 24480, -80, 24, 46, 55, 30, 6},
+    {0, 9180, -98, 10, 44, 54, 5, 6},
+    {1, 24660, -76, 30, 29, 75, 10, 6},
+    {0, 8700, -61, 54, 11, 63, 10, 8},
+    {1, 24620, -84, 30, 14, 81, 10, 7},
+    {0, 8700, -78, 32, 63, 50, 15, 8},
+    {1, 24270, -52, 60, 59, 90, 10, 6},
+    {0, 8850, -87, 23, 42, 98, 10, 7},
+    {1, 24030, -87, 18, 43, 99, 20, 7},
+    {0, 9220, -93, 12, 238, 27, 10, 3},
+    {1, 24340, -73, 35, 44, 62, 10, 7},
+    {0, 8690, -48, 59, 130, 39, 15, 4},
+    {1, 24570, -39, 70, 207, 44, 10, 4},
+    {0, 8695, -41, 67, 130, 16, 5, 1},
+    {1, 24870, -52, 53, 1, 95, 20, 8},
+    {0, 9100, -93, 18, 399, 12, 15, 1},
+    {1, 24350, -50, 59, 1, 99, 10, 7},
+    {0, 8890, -98, 14, 80, 93, 5, 6},
+    {1, 24670, -83, 28, 172, 33, 192, 2},
+    {0, 8680, -89, 25, 18, 81, 15, 8},
+    {1, 24770, -95, 23, 6, 89, 183, 8},
+    {0, 8655, -92, 21, 62, 96, 10, 8},
+    {1, 24440, -53, 55, 14, 74, 153, 7},
+    {0, 8685, -92, 17, 253, 43, 15, 3},
+    {1, 24730, -45, 59, 39, 74, 149, 8},
+    {0, 9255, -66, 48, 41, 87, 10, 6},
+    {1, 24920, -81, 33, 182, 39, 30, 3},
+    {0, 8660, -60, 49, 29, 75, 5, 8},
+    {1, 24170, -50, 61, 1, 64, 20, 6},
+    {0, 8685, -74, 41, 369, 10, 5, 2},
+    {1, 24580, -48, 58, 45, 52, 10, 6},
+    {0, 9150, -80, 33, 10, 72, 15, 6},
+    {1, 24280, -37, 72, 399, 32, 20, 3},
+    {0, 8690, -95, 18, 32, 74, 5, 6},
+    {1, 24040, -37, 68, 58, 90, 10, 8},
+    {0, 9050, -88, 16, 229, 16, 15, 4},
+    {1, 24450, -77, 41, 28, 85, 20, 6},
+    {0, 8680, -92, 25, 61, 98, 5, 7},
+    {1, 24170, -86, 25, 56, 57, 20, 7},
+    {0, 8860, -40, 67, 1, 60, 5, 6},
+    {1, 24180, -42, 75, 17, 90, 30, 6},
+    {0, 8655, -53, 63, 80, 97, 10, 6},
+    {1, 24060, -65, 47, 19, 67, 10, 6},
+    {0, 9095, -41, 63, 40, 59, 10, 6},
+    {1, 24980, -84, 30, 36, 66, 20, 7},
+    {0, 9260, -92, 13, 20, 90, 10, 6},
+    {1, 24670, -99, 7, 56, 73, 20, 6},
+    {0, 8685, -33, 73, 202, 17, 5, 2},
+    {1, 24690, -73, 43, 22, 69, 10, 8},
+    {0, 9035, -33, 73, 7, 68, 10, 7},
+    {1, 24720, -38, 78, 319, 16, 20, 2},
+    {0, 8680, -99, 14, 76, 83, 15, 7},
+    {1, 24070, -51, 58, 41, 56, 10, 7},
+    {0, 8690, -97, 18, 17, 89, 5, 6},
+    {1, 24090, -97, 20, 3, 51, 10, 7},
+    {0, 9185, -55, 50, 13, 61, 5, 8},
+    {1, 24100, -85, 32, 35, 87, 117, 8},
+    {0, 9080, -97, 11, 21, 76, 10, 8},
+    {1, 24600, -53, 60, 6, 77, 20, 8},
+    {0, 9165, -93, 20, 71, 93, 15, 6},
+    {1, 24210, -53, 64, 1, 77, 10, 7},
+    {0, 9195, -94, 12, 58, 91, 5, 6},
+    {1, 24760, -87, 27, 4, 65, 101, 7},
+    {0, 8685, -34, 70, 140, 34, 10, 1},
+    {1, 24770, -62, 42, 177, 20, 20, 3},
+    {0, 9215, -71, 37, 72, 85, 10, 6},
+    {1, 24380, -60, 58, 60, 82, 128, 6},
+    {0, 9270, -58, 52, 232, 22, 10, 4},
+    {1, 24820, -79, 31, 121, 8, 144, 4},
+    {0, 8960, -46, 67, 19, 93, 10, 6},
+    {1, 24510, -87, 20, 66, 100, 30, 7},
+    {0, 9185, -47, 59, 0, 57, 15, 8},
+    {1, 24500, -85, 27, 35, 96, 30, 7},
+    {0, 8690, -99, 7, 41, 78, 10, 7},
+    {1, 24300, -70, 47, 48, 88, 20, 7},
+    {0, 9270, -96, 22, 1, 81, 10, 8},
+    {1, 24450, -33, 72, 55, 79, 30, 7},
+    {0, 8850, -70, 47, 67, 82, 10, 7},
+    {1, 24400, -37, 75, 53, 83, 20, 8},
+    {0, 9045, -34, 82, 39, 68, 5, 8},
+    {1, 24680, -62, 43, 67, 61, 10, 7},
+    {0, 8680, -47, 71, 5, 95, 5, 7},
+    {1, 24000, -98, 10, 12, 99, 122, 7},
+    {0, 8695, -74, 38, 18, 59, 15, 6},
+    {1, 24160, -78, 32, 148, 8, 30, 4},
+    {0, 9055, -64, 52, 45, 90, 5, 7},
+    {1, 24100, -50, 68, 340, 33, 150, 1},
+    {0, 8640, -59, 59, 22, 76, 10, 7},
+    {1, 24800, -68, 40, 8, 69, 10, 7},
+    {0, 8880, -54, 58, 197, 23, 5, 1},
+    {1, 24300, -57, 55, 49, 72, 10, 7},
+    {0, 9120, -64, 44, 127, 14, 5, 3},
+    {1, 24240, -43, 68, 175, 28, 10, 2},
+    {0, 8690, -35, 80, 353, 13, 5, 4},
+    {1, 24830, -31, 84, 47, 98, 10, 6},
+    {0, 9155, -96, 12, 49, 69, 15, 6},
+    {1, 24020, -58, 57, 29, 85, 10, 6},
+    {0, 9240, -88, 27, 269, 30, 10, 2},
+    {1, 24330, -83, 21, 80, 93, 10, 7},
+    {0, 9160, -68, 37, 59, 90, 10, 7},
+    {1, 24240, -94, 18, 28, 62, 120, 7},
+    {0, 8695, -70, 39, 201, 32, 10, 3},
+    {1, 24670, -94, 10, 256, 12, 10, 2},
+    {0, 9105, -46, 61, 11, 89, 10, 8},
+    {1, 24830, -43, 61, 327, 18, 30, 1},
+    {0, 8900, -94, 13, 24, 61, 15, 7},
+    {1, 24550, -92, 24, 31, 62, 30, 6},
+    {0, 9055, -69, 49, 30, 78, 15, 8},
+    {1, 24530, -69, 44, 182, 15, 10, 4},
+    {0, 9060, -62, 56, 14, 63, 10, 7},
+    {1, 24740, -42, 75, 268, 41, 156, 4},
+    {0, 8855, -89, 18, 62, 86, 10, 8},
+    {1, 24540, -58, 60, 69, 68, 10, 8},
+    {0, 9265, -82, 25, 10, 99, 5, 6},
+    {1, 24120, -78, 39, 379, 29, 20, 3},
+    {0, 9235, -67, 48, 299, 11, 5, 1},
+    {1, 24520, -36, 76, 27, 88, 10, 7},
+    {0, 9005, -88, 30, 315, 17, 10, 4},
+    {1, 24220, -45, 71, 65, 95, 10, 8},
+    {0, 8690, -78, 34, 22, 78, 10, 6},
+    {1, 24800, -58, 52, 69, 88, 10, 7},
+    {0, 8680, -46, 67, 262, 24, 10, 2},
+    {1, 24870, -42, 65, 28, 73, 184, 8},
+    {0, 8990, -66, 51, 50, 62, 5, 6},
+    {1, 24090, -32, 76, 24, 85, 30, 6},
+    {0, 8695, -89, 16, 75, 54, 10, 8},
+    {1, 24800, -86, 25, 65, 60, 30, 8},
+    {0, 9280, -48, 67, 139, 7, 5, 3},
+    {1, 24020, -82, 30, 15, 62, 10, 8},
+    {0, 8995, -98, 7, 43, 65, 10, 6},
+    {1, 24610, -54, 63, 5, 57, 20, 8},
+    {0, 9255, -97, 8, 338, 12, 15, 4},
+    {1, 24790, -80, 30, 23, 87, 30, 6},
+    {0, 9160, -96, 17, 1, 82, 5, 7},
+    {1, 24480, -39, 77, 310, 19, 30, 4},
+    {0, 9180, -83, 26, 39, 63, 15, 6},
+    {1, 24300, -50, 54, 349, 42, 10, 3},
+    {0, 8685, -81, 33, 184, 9, 10, 3},
+    {1, 24500, -87, 18, 4, 86, 154, 8},
+    {0, 9045, -90, 24, 18, 73, 10, 8},
+    {1, 24530, -57, 61, 51, 82, 20, 7},
+    {0, 9085, -99, 5, 215, 33, 10, 4},
+    {1, 24400, -61, 46, 18, 62, 20, 6},
+    {0, 8685, -54, 52, 59, 54, 10, 8},
+    {1, 24840, -30, 88, 241, 6, 20, 2},
+    {0, 8685, -87, 28, 366, 13, 5, 1},
+    {1, 24070, -75, 39, 0, 70, 10, 8},
+    {0, 8685, -48, 61, 358, 8, 10, 2},
+    {1, 24860, -36, 73, 42, 51, 30, 6},
+    {0, 9250, -79, 38, 42, 63, 5, 6},
+    {1, 24140, -45, 68, 46, 88, 10, 8},
+    {0, 8690, -60, 48, 4, 79, 15, 8},
+    {1, 24300, -39, 78, 114, 45, 20, 2},
+    {0, 8760, -92, 18, 15, 85, 15, 6},
+    {1, 24220, -79, 31, 22, 65, 199, 8},
+    {0, 9245, -41, 74, 49, 56, 10, 6},
+    {1, 24010, -92, 23, 44, 92, 30, 7},
+    {0, 9080, -70, 43, 30, 98, 5, 7},
+    {1, 24230, -38, 67, 190, 24, 20, 2},
+    {0, 8800, -72, 37, 341, 28, 5, 2},
+    {1, 24640, -61, 47, 181, 5, 114, 2},
+    {0, 9100, -40, 68, 196, 31, 10, 1},
+    {1, 24760, -69, 46, 4, 58, 10, 6},
+    {0, 8955, -59, 58, 6, 81, 5, 6},
+    {1, 24970, -81, 27, 386, 36, 10, 3},
+    {0, 9270, -77, 41, 34, 54, 10, 7},
+    {1, 24970, -53, 61, 71, 91, 188, 6},
+    {0, 9095, -48, 64, 34, 76, 10, 8},
+    {1, 24130, -99, 16, 18, 89, 20, 8},
+    {0, 8695, -93, 19, 127, 33, 15, 3},
+    {1, 24550, -34, 79, 60, 90, 30, 6},
+    {0, 9155, -65, 44, 67, 90, 10, 6},
+    {1, 24550, -55, 55, 352, 9, 10, 2},
+    {0, 8690, -69, 39, 297, 34, 5, 2},
+    {1, 24180, -45, 72, 295, 11, 20, 4},
+    {0, 9190, -64, 48, 11, 94, 10, 7},
+    {1, 24110, -99, 9, 19, 92, 162, 8},
+    {0, 9115, -74, 44, 394, 8, 15, 3},
+    {1, 24250, -69, 45, 32, 90, 10, 8},
+    {0, 9045, -94, 13, 47, 73, 10, 7},
+    {1, 24630, -67, 46, 77, 89, 174, 6},
+    {0, 9275, -57, 48, 214, 33, 5, 1},
+    {1, 24440, -86, 23, 3, 77, 30, 8},
+    {0, 9145, -34, 72, 17, 64, 5, 8},
+    {1, 24740, -57, 49, 37, 55, 30, 6},
+    {0, 8755, -41, 77, 27, 71, 5, 8},
+    {1, 24050, -47, 58, 17, 70, 180, 6},
+    {0, 8680, -88, 25, 244, 24, 10, 3},
+    {1, 24420, -61, 54, 39, 66, 30, 8},
+    {0, 8685, -37, 70, 59, 73, 15, 6},
+    {1, 24280, -93, 14, 71, 86, 10, 7},
+    {0, 9030, -41, 71, 217, 18, 10, 2},
+    {1, 24060, -36, 80, 146, 36, 192, 2},
+    {0, 8755, -81, 25, 20, 56, 5, 8},
+    {1, 24470, -71, 37, 53, 77, 30, 8},
+    {0, 8710, -62, 44, 338, 40, 5, 3},
+    {1, 24260, -80, 26, 219, 7, 10, 4},
+    {0, 8685, -74, 37, 11, 61, 5, 8},
+    {1, 24430, -84, 24, 290, 36, 10, 3},
+    {0, 8845, -61, 48, 253, 17, 15, 1},
+    {1, 24140, -95, 14, 38, 62, 10, 7},
+    {0, 9190, -68, 45, 61, 57, 10, 6},
+    {1, 24790, -87, 20, 58, 75, 10, 8},
+    {0, 8925, -46, 63, 16, 73, 10, 6},
+    {1, 24610, -57, 61, 156, 14, 30, 3},
+    {0, 8785, -30, 87, 68, 65, 10, 7},
+    {1, 24440, -63, 49, 25, 96, 10, 6},
+    {0, 9210, -37, 69, 137, 19, 15, 2},
+    {1, 24140, -49, 60, 54, 57, 20, 8},
+    {0, 8685, -92, 13, 65, 88, 5, 6},
+    {1, 24340, -61, 52, 22, 87, 197, 7},
+    {0, 9025, -88, 18, 4, 96, 5, 6},
+    {1, 24140, -74, 30, 26, 54, 142, 8},
+    {0, 9225, -91, 15, 42, 54, 15, 8},
+    {1, 24520, -55, 54, 11, 99, 163, 8},
+    {0, 9055, -78, 34, 59, 100, 10, 8},
+    {1, 24940, -70, 45, 239, 36, 158, 2},
+    {0, 9005, -56, 49, 50, 55, 10, 7},
+    {1, 24560, -60, 58, 54, 80, 10, 6},
+    {0, 9175, -54, 58, 10, 52, 10, 8},
+    {1, 24070, -47, 61, 336, 18, 10, 1},
+    {0, 9080, -80, 33, 42, 72, 5, 6},
+    {1, 24510, -35, 71, 273, 30, 10, 2},
+    {0, 8970, -54, 54, 32, 97, 5, 8},
+    {1, 24430, -46, 71, 239, 22, 20, 4},
+    {0, 8695, -92, 12, 66, 73, 10, 7},
+    {1, 24690, -60, 46, 57, 88, 10, 8},
+    {0, 9125, -81, 34, 248, 30, 15, 1},
+    {1, 24490, -62, 44, 30, 76, 30, 8},
+    {0, 9230, -64, 49, 46, 81, 5, 8},
+    {1, 24660, -33, 73, 25, 97, 10, 7},
+    {0, 8700, -53, 54, 306, 24, 5, 3},
+    {1, 24390, -86, 22, 51, 74, 30, 7},
+    {0, 8680, -79, 27, 52, 59, 10, 6},
+    {1, 24440, -49, 64, 35, 68, 30, 8},
+    {0, 9195, -60, 53, 400, 21, 15, 3},
+    {1, 24980, -85, 19, 52, 90, 10, 8},
+    {0, 8690, -49, 62, 51, 61, 10, 7},
+    {1, 24120, -82, 33, 36, 54, 10, 7},
+    {0, 8695, -64, 42, 27, 64, 5, 6},
+    {1, 24670, -51, 53, 4, 67, 30, 8},
+    {0, 8690, -71, 43, 219, 41, 5, 3},
+    {1, 24670, -90, 27, 374, 5, 20, 2},
+    {0, 8690, -95, 23, 338, 12, 15, 4},
+    {1, 24240, -70, 45, 67, 86, 10, 7},
+    {0, 8975, -45, 68, 34, 67, 5, 8},
+    {1, 24490, -47, 68, 75, 84, 10, 7},
+    {0, 9275, -41, 67, 55, 62, 15, 7},
+    {1, 24160, -90, 17, 209, 17, 10, 4},
+    {0, 9155, -97, 7, 37, 51, 15, 8},
+    {1, 24060, -31, 83, 80, 90, 10, 8},
+    {0, 8680, -46, 58, 291, 11, 5, 4},
+    {1, 24710, -37, 80, 60, 58, 20, 7},
+    {0, 9155, -97, 7, 238, 38, 5, 3},
+    {1, 24610, -82, 34, 333, 6, 127, 4},
+    {0, 9235, -31, 73, 26, 71, 5, 7},
+    {1, 24730, -99, 16, 26, 56, 145, 7},
+    {0, 9250, -43, 63, 74, 96, 5, 8},
+    {1, 24720, -39, 68, 30, 81, 10, 6},
+    {0, 9020, -71, 37, 399, 11, 5, 2},
+    {1, 24910, -48, 67, 134, 40, 10, 1},
+    {0, 9045, -86, 20, 61, 59, 5, 6},
+    {1, 24140, -99, 18, 305, 8, 10, 1},
+    {0, 8690, -96, 20, 216, 18, 15, 4},
+    {1, 24120, -88, 22, 14, 96, 10, 6},
+    {0, 8765, -60, 46, 38, 81, 10, 6},
+    {1, 24610, -94, 23, 148, 34, 10, 4},
+    {0, 9290, -97, 8, 10, 96, 5, 8},
+    {1, 24570, -76, 33, 7, 95, 30, 7},
+    {0, 8695, -79, 32, 158, 44, 5, 4},
+    {1, 24830, -98, 14, 237, 39, 20, 2},
+    {0, 9220, -31, 85, 10, 70, 5, 6},
+    {1, 24430, -79, 36, 58, 83, 10, 7},
+    {0, 9085, -66, 46, 116, 44, 5, 2},
+    {1, 24570, -56, 58, 31, 63, 10, 8},
+    {0, 8695, -91, 16, 8, 54, 10, 7},
+    {1, 24060, -81, 29, 148, 33, 163, 3},
+    {0, 9045, -43, 64, 22, 71, 5, 7},
+    {1, 24170, -86, 19, 28, 71, 144, 8},
+    {0, 8795, -66, 50, 269, 35, 5, 2},
+    {1, 24820, -71, 47, 155, 13, 101, 3},
+    {0, 9255, -52, 61, 238, 20, 5, 1},
+    {1, 24140, -71, 37, 3, 73, 128, 7},
+    {0, 8770, -52, 63, 303, 35, 10, 1},
+    {1, 24100, -88, 24, 62, 64, 161, 6},
+    {0, 9035, -69, 35, 60, 53, 10, 8},
+    {1, 24070, -85, 33, 48, 83, 10, 6},
+    {0, 8720, -41, 65, 59, 78, 5, 6},
+    {1, 24080, -91, 26, 46, 66, 30, 7},
+    {0, 8695, -95, 15, 60, 92, 5, 7},
+    {1, 24600, -94, 11, 41, 64, 10, 8},
+    {0, 9140, -63, 48, 128, 24, 5, 2},
+    {1, 24750, -98, 15, 21, 80, 10, 6},
+    {0, 8695, -72, 43, 79, 69, 10, 6},
+    {1, 25000, -95, 17, 41, 95, 152, 8},
+    {0, 8615, -41, 70, 242, 13, 15, 4},
+    {1, 24470, -82, 28, 19, 60, 141, 6},
+    {0, 9065, -71, 34, 32, 67, 5, 8},
+    {1, 24970, -97, 7, 163, 13, 20, 2},
+    {0, 8695, -85, 26, 65, 92, 5, 7},
+    {1, 24560, -75, 37, 71, 74, 132, 8},
+    {0, 8725, -67, 41, 67, 97, 5, 8},
+    {1, 24060, -43, 68, 1, 70, 10, 7},
+    {0, 9150, -82, 22, 51, 97, 5, 7},
+    {1, 24320, -71, 37, 16, 52, 134, 6},
+    {0, 8690, -57, 52, 342, 27, 15, 3},
+    {1, 24700, -79, 33, 2, 91, 20, 8},
+    {0, 8745, -67, 49, 38, 79, 5, 8},
+    {1, 24850, -31, 81, 117, 9, 20, 1},
+    {0, 9160, -77, 37, 227, 6, 5, 1},
+    {1, 24110, -90, 20, 281, 35, 20, 4},
+    {0, 9105, -91, 18, 156, 13, 5, 3},
+    {1, 24600, -75, 34, 18, 94, 10, 6},
+    {0, 9095, -87, 30, 60, 62, 15, 6},
+    {1, 24380, -88, 17, 29, 50, 30, 6},
+    {0, 8680, -35, 77, 33, 71, 15, 8},
+    {1, 24720, -72, 36, 258, 16, 30, 2},
+    {0, 9100, -71, 40, 141, 30, 10, 3},
+    {1, 24320, -88, 26, 40, 59, 165, 6},
+    {0, 8725, -35, 72, 171, 35, 15, 3},
+    {1, 24530, -50, 62, 79, 82, 20, 8},
+    {0, 8690, -31, 80, 47, 53, 10, 8},
+    {1, 24380, -83, 34, 395, 9, 10, 3},
+    {0, 8685, -87, 20, 311, 23, 5, 1},
+    {1, 24910, -79, 26, 40, 65, 30, 6},
+    {0, 9220, -41, 69, 31, 66, 5, 6},
+    {1, 24780, -63, 43, 23, 100, 10, 8},
+    {0, 8690, -56, 50, 65, 66, 5, 6},
+    {1, 24510, -58, 55, 78, 93, 195, 7},
+    {0, 8730, -67, 42, 1, 70, 5, 6},
+    {1, 24260, -52, 57, 38, 57, 30, 7},
+    {0, 8695, -68, 37, 72, 60, 5, 8},
+    {1, 24670, -51, 61, 41, 84, 10, 6},
+    {0, 9100, -30, 78, 17, 79, 5, 8},
+    {1, 24390, -56, 57, 27, 70, 112, 6},
+    {0, 9255, -36, 71, 144, 34, 5, 2},
+    {1, 24260, -39, 74, 39, 72, 20, 8},
+    {0, 8690, -46, 72, 338, 18, 5, 2},
+    {1, 24360, -95, 16, 72, 95, 30, 6},
+    {0, 9280, -87, 28, 45, 64, 15, 6},
+    {1, 24780, -46, 69, 149, 36, 20, 2},
+    {0, 8985, -78, 38, 48, 85, 5, 8},
+    {1, 24090, -73, 37, 138, 37, 164, 2},
+    {0, 8925, -45, 71, 3, 66, 15, 8},
+    {1, 24600, -93, 24, 59, 60, 20, 8},
+    {0, 8685, -77, 27, 29, 96, 5, 8},
+    {1, 24720, -34, 84, 327, 10, 10, 4},
+    {0, 9255, -78, 30, 345, 31, 5, 3},
+    {1, 24770, -54, 55, 319, 45, 20, 2},
+    {0, 9040, -76, 36, 261, 42, 10, 4},
+    {1, 24780, -34, 82, 60, 72, 10, 6},
+    {0, 9270, -54, 53, 42, 59, 10, 8},
+    {1, 24470, -54, 56, 354, 44, 30, 4},
+    {0, 8695, -53, 55, 184, 42, 10, 3},
+    {1, 24570, -76, 38, 51, 70, 103, 8},
+    {0, 8685, -31, 75, 44, 80, 10, 8},
+    {1, 24210, -91, 22, 308, 26, 10, 3},
+    {0, 9150, -73, 45, 208, 24, 5, 2},
+    {1, 24050, -81, 29, 164, 32, 10, 2},
+    {0, 8690, -77, 32, 11, 52, 5, 7},
+    {1, 24080, -85, 26, 196, 43, 123, 2},
+    {0, 8850, -58, 54, 55, 78, 10, 7},
+    {1, 24230, -55, 53, 187, 38, 10, 4},
+    {0, 8695, -98, 13, 73, 88, 10, 6},
+    {1, 24630, -33, 83, 71, 94, 30, 6},
+    {0, 8700, -53, 59, 0, 74, 5, 8},
+    {1, 24340, -79, 34, 78, 63, 10, 7},
+    {0, 8695, -66, 40, 40, 60, 15, 7},
+    {1, 24450, -37, 67, 10, 77, 10, 6},
+    {0, 8700, -88, 21, 0, 74, 5, 6},
+    {1, 24090, -89, 18, 32, 52, 20, 6},
+    {0, 8685, -73, 31, 299, 41, 15, 4},
+    {1, 24540, -48, 60, 40, 52, 30, 6},
+    {0, 9125, -83, 30, 69, 66, 10, 6},
+    {1, 24030, -95, 20, 151, 23, 30, 1},
+    {0, 8840, -76, 29, 15, 71, 15, 7},
+    {1, 24160, -67, 47, 28, 89, 10, 6},
+    {0, 9280, -72, 45, 56, 70, 10, 7},
+    {1, 24680, -32, 83, 61, 93, 10, 8},
+    {0, 8685, -36, 68, 60, 73, 10, 8},
+    {1, 24410, -52, 60, 158, 42, 10, 4},
+    {0, 8800, -59, 56, 124, 23, 10, 1},
+    {1, 24310, -30, 75, 25, 62, 10, 7},
+    {0, 9025, -91, 21, 75, 85, 5, 6},
+    {1, 24070, -85, 23, 30, 93, 10, 6},
+    {0, 9195, -59, 45, 253, 37, 15, 1},
+    {1, 24420, -77, 27, 213, 12, 10, 2},
+    {0, 9250, -48, 59, 49, 88, 5, 6},
+    {1, 24830, -34, 82, 34, 53, 10, 6},
+    {0, 9295, -82, 31, 46, 84, 10, 7},
+    {1, 24140, -79, 35, 173, 31, 10, 4},
+    {0, 8925, -99, 16, 30, 99, 10, 6},
+    {1, 24400, -94, 21, 60, 82, 10, 7},
+    {0, 8765, -57, 49, 152, 10, 5, 3},
+    {1, 24260, -77, 37, 189, 15, 10, 4},
+    {0, 8700, -92, 22, 20, 71, 15, 6},
+    {1, 24050, -70, 38, 21, 79, 133, 8},
+    {0, 8665, -74, 38, 12, 93, 5, 8},
+    {1, 24290, -71, 47, 279, 14, 30, 1},
+    {0, 9035, -51, 59, 12, 62, 10, 7},
+    {1, 24770, -83, 33, 352, 6, 155, 2},
+    {0, 9090, -85, 21, 9, 53, 10, 6},
+    {1, 24790, -47, 60, 297, 33, 10, 4},
+    {0, 9055, -66, 41, 19, 74, 5, 6},
+    {1, 24090, -89, 16, 291, 41, 20, 4},
+    {0, 8685, -54, 56, 301, 44, 15, 2},
+    {1, 24280, -76, 42, 76, 99, 20, 6},
+    {0, 9135, -30, 82, 371, 23, 15, 3},
+    {1, 24590, -42, 63, 27, 73, 20, 7},
+    {0, 8660, -67, 41, 55, 51, 10, 8},
+    {1, 24050, -32, 72, 55, 71, 20, 6},
+    {0, 8695, -52, 63, 162, 7, 10, 4},
+    {1, 24740, -63, 49, 56, 61, 119, 8},
+    {0, 8680, -95, 10, 42, 77, 5, 6},
+    {1, 24130, -65, 46, 14, 75, 20, 6},
+    {0, 9120, -57, 59, 274, 18, 5, 2},
+    {1, 24020, -69, 46, 212, 7, 20, 1},
+    {0, 9000, -69, 46, 15, 76, 10, 7},
+    {1, 24920, -69, 39, 314, 42, 10, 3},
+    {0, 8690, -39, 67, 34, 50, 10, 7},
+    {1, 24050, -39, 71, 22, 66, 10, 6},
+    {0, 9130, -99, 18, 218, 16, 5, 1},
+    {1, 24360, -33, 80, 288, 37, 10, 1},
+    {0, 8685, -54, 51, 308, 23, 10, 3},
+    {1, 24510, -31, 77, 46, 57, 20, 8},
+    {0, 9130, -79, 29, 111, 28, 5, 4},
+    {1, 24190, -92, 26, 301, 7, 20, 4},
+    {0, 8950, -76, 38, 199, 44, 15, 2},
+    {1, 24550, -82, 25, 383, 22, 10, 2},
+    {0, 8690, -71, 37, 73, 70, 10, 8},
+    {1, 24630, -78, 27, 70, 89, 113, 6},
+    {0, 8695, -91, 25, 34, 51, 15, 6},
+    {1, 24620, -31, 84, 58, 90, 10, 7},
+    {0, 8835, -84, 34, 2, 68, 5, 8},
+    {1, 24670, -64, 46, 56, 68, 10, 8},
+    {0, 8700, -81, 31, 76, 74, 15, 7},
+    {1, 24790, -64, 50, 28, 94, 10, 6},
+    {0, 9030, -40, 70, 47, 81, 10, 8},
+    {1, 24630, -55, 56, 20, 83, 30, 6},
+    {0, 8685, -68, 45, 211, 21, 15, 1},
+    {1, 24530, -59, 53, 221, 13, 20, 3},
+    {0, 8985, -62, 46, 21, 77, 5, 8},
+    {1, 24360, -80, 32, 161, 19, 119, 3},
+    {0, 9050, -79, 32, 207, 33, 15, 2},
+    {1, 24650, -43, 75, 212, 18, 10, 4}
+};
+
+// ModulationType the tool predicted for each row
+static constexpr uint8_t predictionClass[CLASSIFIER_PREDICTION_COUNT] = {
+    1, 4, 4, 2, 1, 0, 3, 4, 3, 0, 1, 0, 3, 2, 3, 4, 1, 0, 1, 0, 3, 4, 3, 6,
+    4, 6, 1, 2, 3, 4, 3, 5, 3, 0, 1, 6, 1, 2, 4, 6, 2, 4, 3, 6, 3, 2, 4, 6,
+    3, 4, 3, 0, 3, 2, 4, 5, 1, 0, 1, 2, 1, 6, 3, 5, 4, 4, 2, 2, 4, 6, 3, 4,
+    1, 2, 3, 4, 2, 4, 1, 2, 3, 2, 4, 2, 3, 4, 4, 2, 1, 0, 3, 4, 2, 6, 3, 2,
+    3, 5, 2, 2, 1, 6, 3, 4, 1, 4, 1, 5, 3, 0, 3, 4, 3, 2, 3, 0, 3, 2, 4, 4,
+    4, 4, 3, 4, 2, 2, 3, 0, 3, 4, 3, 4, 1, 2, 3, 6, 3, 0, 3, 2, 3, 6, 4, 6,
+    3, 5, 3, 2, 1, 5, 2, 2, 3, 2, 3, 2, 2, 2, 3, 2, 3, 4, 1, 2, 4, 2, 3, 4,
+    3, 0, 4, 2, 1, 6, 3, 6, 1, 6, 3, 6, 2, 0, 1, 2, 3, 5, 2, 4, 3, 4, 4, 2,
+    3, 2, 1, 5, 1, 2, 3, 0, 2, 2, 3, 2, 3, 4, 3, 2, 3, 2, 3, 6, 2, 2, 2, 2,
+    2, 6, 3, 4, 2, 6, 4, 6, 1, 4, 3, 2, 3, 2, 2, 5, 1, 5, 3, 4, 3, 6, 3, 4,
+    2, 6, 1, 2, 1, 2, 4, 4, 3, 5, 2, 2, 4, 4, 2, 6, 3, 4, 3, 4, 1, 2, 2, 4,
+    2, 6, 1, 4, 2, 4, 4, 5, 1, 4, 3, 4, 3, 0, 1, 5, 3, 4, 1, 2, 1, 2, 4, 2,
+    2, 4, 2, 4, 3, 6, 2, 2, 4, 2, 3, 0, 3, 2, 3, 0, 2, 5, 3, 4, 1, 6, 3, 2,
+    2, 4, 1, 6, 4, 2, 1, 0, 2, 0, 3, 2, 3, 4, 2, 4, 3, 4, 2, 6, 4, 2, 2, 6,
+    4, 2, 3, 2, 1, 6, 3, 2, 3, 4, 4, 6, 1, 2, 1, 4, 3, 4, 1, 2, 2, 4, 1, 4,
+    1, 2, 4, 5, 3, 6, 2, 6, 2, 6, 2, 0, 1, 2, 3, 4, 2, 4, 1, 4, 3, 4, 4, 2,
+    2, 5, 3, 2, 3, 5, 4, 0, 3, 2, 3, 2, 3, 4, 3, 4, 1, 4, 3, 4, 2, 4, 3, 4,
+    4, 6, 3, 6, 3, 5, 4, 0, 2, 4, 3, 2, 1, 4, 2, 2, 3, 4, 3, 4, 4, 2, 3, 6,
+    3, 6, 1, 6, 4, 6, 1, 6, 2, 2, 1, 2, 3, 2, 4, 2, 3, 0, 1, 6, 2, 0, 3, 6,
+    1, 5, 2, 6, 3, 2, 1, 0, 4, 4, 4, 2, 2, 2, 3, 4, 4, 6, 1, 4, 3, 4, 3, 0,
+    3, 2, 3, 6, 1, 2, 3, 2, 3, 6, 4, 5, 3, 4, 2, 4, 1, 6, 1, 4, 3, 4, 4, 4,
+    4, 4, 3, 4, 3, 6, 3, 4, 4, 4, 3, 6, 1, 4, 3, 4, 3, 4, 3, 5, 3, 2, 3, 5,
+    2, 4, 1, 2, 2, 4, 3, 4, 1, 5, 2, 2, 4, 4, 3, 5, 2, 4, 1, 4, 1, 4, 3, 6,
+    1, 4, 3, 6, 2, 4, 2, 4, 3, 4, 4, 5, 1, 5, 3, 6, 3, 2, 4, 4, 1, 0, 3, 5,
+    4, 4, 3, 5, 4, 4, 1, 4, 3, 6, 3, 4, 1, 2, 3, 2, 3, 2, 3, 4, 1, 6, 4, 4
+};
+
+#endif // CLASSIFIER_PREDICTIONS_H
@@ -0,0 +1,66 @@
+/**
+ * @file test_main.cpp
+ * @brief classifyEmitter() against the predictions of the training tool
+ *
+ * classifier_predictions.h is written by tools/train_classifier.py next to
+ * classifier_model.h: every row it trained and tested on, with the class
+ * its own tree walk gave. The firmware walk of the generated tables must
+ * agree on every one, or the model on the unit is not the one evaluated.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "classifier.h"
+#include "classifier_predictions.h"
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_feature_layout_matches_tool(void) {
+    TEST_ASSERT_EQUAL_INT(CLASSIFIER_FEATURES,
+                          (int)(sizeof(predictionFeatureNames) / sizeof(predictionFeatureNames[0])));
+    for (int f = 0; f < CLASSIFIER_FEATURES; f++) {
+        TEST_ASSERT_EQUAL_STRING(predictionFeatureNames[f], classifierFeatureName(f));
+    }
+}
+
+void test_firmware_matches_tool_predictions(void) {
+    int mismatches = 0;
+    int firstMismatch = -1;
+    for (int i = 0; i < CLASSIFIER_PREDICTION_COUNT; i++) {
+        if (classifyEmitter(predictionFeatures[i]) != (ModulationType)predictionClass[i]) {
+            if (firstMismatch < 0) firstMismatch = i;
+            mismatches++;
+        }
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%d mismatches, first at row %d", mismatches, firstMismatch);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, mismatches, msg);
+}
+
+void test_every_class_is_exercised(void) {
+    // The rows reach more than one leaf class, so the check above means something
+    bool seen[8];
+    memset(seen, 0, sizeof(seen));
+    for (int i = 0; i < CLASSIFIER_PREDICTION_COUNT; i++) {
+        if (predictionClass[i] < 8) seen[predictionClass[i]] = true;
+    }
+    int classes = 0;
+    for (int c = 0; c < 8; c++) {
+        if (seen[c]) classes++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(5, classes);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_feature_layout_matches_tool);
+    RUN_TEST(test_firmware_matches_tool_predictions);
+    RUN_TEST(test_every_class_is_exercised);
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_main.cpp
+ * @brief clusterRow() and wideband classification on synthetic sweep rows
+ *
+ * Rows are built channel by channel over a -100 dBm floor and thresholded
+ * at -90 dBm, as the sweep does, on the 1 MHz 2.4GHz plan.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "emitter_cluster.h"
+
+#define ROW_CHANNELS 101
+#define NOISE_DBM -100
+#define THRESHOLD_DBM -90
+#define START_MHZ 2400.0f
+#define STEP_MHZ 1.0f
+
+static int8_t row[ROW_CHANNELS];
+static uint8_t hits[ROW_CHANNELS];
+static EmitterCluster clusters[CLUSTER_MAX];
+
+static void threshold() {
+    for (int ch = 0; ch < ROW_CHANNELS; ch++) hits[ch] = row[ch] > THRESHOLD_DBM;
+}
+
+static int cluster(int maxOut = CLUSTER_MAX) {
+    threshold();
+    return clusterRow(row, hits, ROW_CHANNELS, START_MHZ, STEP_MHZ, clusters, maxOut);
+}
+
+void setUp(void) {
+    memset(row, NOISE_DBM, sizeof(row));
+    memset(clusters, 0, sizeof(clusters));
+}
+
+void tearDown(void) {
+}
+
+void test_ofdm_plateau_is_one_emitter(void) {
+    // 20 MHz flat top with a dB of ripple, e.g. Wi-Fi channel 6
+    static const int8_t ripple[4] = {0, -1, 1, 0};
+    for (int ch = 28; ch < 48; ch++) row[ch] = -60 + ripple[ch % 4];
+
+    TEST_ASSERT_EQUAL_INT(1, cluster());
+    EmitterCluster& c = clusters[0];
+    TEST_ASSERT_EQUAL_INT(28, c.firstChannel);
+    TEST_ASSERT_EQUAL_INT(47, c.lastChannel);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, c.bandwidthMHz);
+    TEST_ASSERT_EQUAL_FLOAT(2437.5f, c.centerMHz);
+    TEST_ASSERT_EQUAL_INT8(-59, c.peakDbm);
+    TEST_ASSERT_EQUAL_INT8(-60, c.meanDbm);
+    TEST_ASSERT_TRUE(isWidebandCluster(c));
+    TEST_ASSERT_EQUAL_INT(MOD_OFDM, classifyWideband(c));
+
+    // The centre holds while the peak wanders across the top
+    float centre = c.centerMHz;
+    int peak = c.peakChannel;
+    for (int ch = 28; ch < 48; ch++) row[ch] = -60;
+    row[45] = -58;
+    TEST_ASSERT_EQUAL_INT(1, cluster());
+    TEST_ASSERT_TRUE(clusters[0].peakChannel != peak);
+    TEST_ASSERT_EQUAL_FLOAT(centre, clusters[0].centerMHz);
+}
+
+void test_dsss_rolls_off_from_its_peak(void) {
+    // 22 MHz wide, falling 3 dB per channel from the centre like a sinc
+    for (int ch = 29; ch <= 49; ch++) {
+        int off = ch < 39 ? 39 - ch : ch - 39;
+        row[ch] = (int8_t)(-55 - 3 * off);
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, cluster());
+    EmitterCluster& c = clusters[0];
+    TEST_ASSERT_EQUAL_INT(29, c.firstChannel);
+    TEST_ASSERT_EQUAL_INT(49, c.lastChannel);
+    TEST_ASSERT_EQUAL_INT(39, c.peakChannel);
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, c.bandwidthMHz);
+    TEST_ASSERT_EQUAL_FLOAT(2439.0f, c.centerMHz);
+    TEST_ASSERT_EQUAL_INT8(-55, c.peakDbm);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(CLUSTER_DSSS_ROLLOFF_DB, c.peakDbm - c.meanDbm);
+    TEST_ASSERT_EQUAL_INT(MOD_DSSS, classifyWideband(c));
+
+    // Too narrow for OFDM even when flat
+    memset(row, NOISE_DBM, sizeof(row));
+    for (int ch = 60; ch < 66; ch++) row[ch] = -60;
+    TEST_ASSERT_EQUAL_INT(1, cluster());
+    TEST_ASSERT_TRUE(isWidebandCluster(clusters[0]));
+    TEST_ASSERT_EQUAL_INT(MOD_DSSS, classifyWideband(clusters[0]));
+}
+
+void test_narrow_emitter_is_interpolated(void) {
+    row[20] = -66;
+    row[21] = -60;
+    row[22] = -62;
+
+    TEST_ASSERT_EQUAL_INT(1, cluster());
+    EmitterCluster& c = clusters[0];
+    TEST_ASSERT_FALSE(isWidebandCluster(c));
+    TEST_ASSERT_EQUAL_INT(21, c.peakChannel);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, c.bandwidthMHz);
+    // Parabola through -66, -60, -62: a quarter channel right of the peak
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2421.25f, c.centerMHz);
+}
+
+void test_gaps_are_bridged_up_to_the_limit(void) {
+    // A one-channel dip inside an emitter is bridged...
+    for (int ch = 10; ch <= 14; ch++) row[ch] = -60;
+    row[12] = -95;
+
+    // ...a wider one splits it; the last run reaches the end of the row
+    for (int ch = 40; ch <= 41; ch++) row[ch] = -70;
+    for (int ch = 42; ch < 42 + CLUSTER_MAX_GAP + 1; ch++) row[ch] = NOISE_DBM;
+    for (int ch = 42 + CLUSTER_MAX_GAP + 1; ch < ROW_CHANNELS; ch++) row[ch] = -70;
+
+    TEST_ASSERT_EQUAL_INT(3, cluster());
+
+    EmitterCluster& a = clusters[0];
+    TEST_ASSERT_EQUAL_INT(10, a.firstChannel);
+    TEST_ASSERT_EQUAL_INT(14, a.lastChannel);
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, a.bandwidthMHz);
+    // The bridged channel is not a hit and does not drag the mean down
+    TEST_ASSERT_EQUAL_INT8(-60, a.meanDbm);
+
+    TEST_ASSERT_EQUAL_INT(40, clusters[1].firstChannel);
+    TEST_ASSERT_EQUAL_INT(41, clusters[1].lastChannel);
+    TEST_ASSERT_EQUAL_INT(42 + CLUSTER_MAX_GAP + 1, clusters[2].firstChannel);
+    TEST_ASSERT_EQUAL_INT(ROW_CHANNELS - 1, clusters[2].lastChannel);
+}
+
+void test_full_output_keeps_the_strongest(void) {
+    // Six narrow emitters, room for three
+    static const int8_t levels[6] = {-80, -50, -75, -60, -85, -55};
+    for (int i = 0; i < 6; i++) row[5 + 10 * i] = levels[i];
+
+    TEST_ASSERT_EQUAL_INT(3, cluster(3));
+
+    bool kept[6];
+    memset(kept, 0, sizeof(kept));
+    for (int i = 0; i < 3; i++) {
+        int e = (clusters[i].peakChannel - 5) / 10;
+        TEST_ASSERT_EQUAL_INT8(levels[e], clusters[i].peakDbm);
+        kept[e] = true;
+    }
+    TEST_ASSERT_TRUE(kept[1]);
+    TEST_ASSERT_TRUE(kept[3]);
+    TEST_ASSERT_TRUE(kept[5]);
+
+    // Nothing above threshold, nothing out
+    memset(row, NOISE_DBM, sizeof(row));
+    TEST_ASSERT_EQUAL_INT(0, cluster());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ofdm_plateau_is_one_emitter);
+    RUN_TEST(test_dsss_rolls_off_from_its_peak);
+    RUN_TEST(test_narrow_emitter_is_interpolated);
+    RUN_TEST(test_gaps_are_bridged_up_to_the_limit);
+    RUN_TEST(test_full_output_keeps_the_strongest);
+    return UNITY_END();
+}
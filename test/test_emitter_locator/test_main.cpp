@@ -0,0 +1,227 @@
+/**
+ * @file test_main.cpp
+ * @brief EmitterLocator on synthetic walks around a known emitter
+ *
+ * RSSI follows the same log-distance model the filter assumes, plus
+ * Gaussian shadowing from a fixed-seed generator so runs are repeatable.
+ * The cost test times batches of updates with every track in use, early
+ * and after a long walk, so work per observation is shown to stay flat.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "emitter_locator.h"
+
+#define ORIGIN_LAT 47.0
+#define ORIGIN_LON 8.0
+#define EMITTER_X 250.0f           // Metres east of the start of the walk
+#define EMITTER_Y 200.0f           // Metres north
+#define EMITTER_P0 -30.0f          // dBm at 1 m
+#define SHADOWING_DB 3.0f
+#define COST_BATCH 200             // Updates timed per batch
+#define COST_BATCHES 5             // Fastest batch counts, against scheduling noise
+#define COST_WALK 20000            // Observations between early and late timing
+#define COST_BUDGET_US 500         // Generous per-update bound on the host
+
+static uint32_t rngState;
+
+static float gaussian() {
+    // Box-Muller on a 32-bit LCG
+    rngState = rngState * 1664525u + 1013904223u;
+    float u1 = ((rngState >> 8) + 1.0f) / 16777217.0f;
+    rngState = rngState * 1664525u + 1013904223u;
+    float u2 = (rngState >> 8) / 16777216.0f;
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
+
+static double toLat(float y) {
+    return ORIGIN_LAT + y / 110540.0;
+}
+
+static double toLon(float x) {
+    return ORIGIN_LON + x / (111320.0 * cos(ORIGIN_LAT * M_PI / 180.0));
+}
+
+// The observer at (x, y) sees the emitter and tells the locator
+static void observe(EmitterLocator& locator, float x, float y, uint32_t now,
+                    float freq = 2437.0f) {
+    float dx = EMITTER_X - x;
+    float dy = EMITTER_Y - y;
+    float d = sqrtf(dx * dx + dy * dy);
+
+    DetectedSignal sig;
+    memset(&sig, 0, sizeof(sig));
+    sig.frequency = freq;
+    sig.band = 1;
+    sig.active = true;
+    sig.hasPosition = true;
+    sig.latitude = (float)toLat(y);
+    sig.longitude = (float)toLon(x);
+    sig.rssi = EMITTER_P0 - 10.0f * PATH_LOSS_EXPONENT * log10f(d) + SHADOWING_DB * gaussian();
+
+    locator.setObserver(sig.latitude, sig.longitude);
+    locator.addObservation(sig, now);
+}
+
+static void trueBearing(float x, float y, float& bearing, float& distance) {
+    float dx = EMITTER_X - x;
+    float dy = EMITTER_Y - y;
+    distance = sqrtf(dx * dx + dy * dy);
+    bearing = atan2f(dx, dy) * 180.0f / (float)M_PI;
+    if (bearing < 0) bearing += 360.0f;
+}
+
+static float angleError(float a, float b) {
+    float e = fabsf(a - b);
+    return e > 180.0f ? 360.0f - e : e;
+}
+
+static uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Walk step k of a circle, round-robin over every emitter slot
+static void walkStep(EmitterLocator& locator, uint32_t k) {
+    float angle = 2.0f * (float)M_PI * (k % 72) / 72;
+    float freq = 2412.0f + 5.0f * (k % LOCATOR_MAX_EMITTERS);
+    observe(locator, 200.0f * sinf(angle), 200.0f * cosf(angle), 100 * k, freq);
+}
+
+// Fastest batch of COST_BATCH updates, in ns per update
+static uint64_t updateCost(EmitterLocator& locator, uint32_t& k) {
+    uint64_t best = UINT64_MAX;
+    for (int b = 0; b < COST_BATCHES; b++) {
+        uint64_t t0 = nowNs();
+        for (int i = 0; i < COST_BATCH; i++) walkStep(locator, k++);
+        uint64_t perUpdate = (nowNs() - t0) / COST_BATCH;
+        if (perUpdate < best) best = perUpdate;
+    }
+    return best;
+}
+
+void setUp(void) {
+    rngState = 12345;
+}
+
+void tearDown(void) {
+}
+
+void test_walk_converges_on_emitter(void) {
+    EmitterLocator locator;
+    const float radius = 200.0f;
+    const int stepsPerLap = 72;
+    float bearing, distance;
+    float expectBearing, expectDistance;
+    float firstError = -1;
+
+    // Start at the centre so the first fix is the local origin
+    observe(locator, 0, 0, 0);
+
+    for (int step = 0; step < 2 * stepsPerLap; step++) {
+        float angle = 2.0f * (float)M_PI * step / stepsPerLap;
+        float x = radius * sinf(angle);
+        float y = radius * cosf(angle);
+        observe(locator, x, y, 1000 * (step + 1));
+
+        if (step + 2 < LOCATOR_MIN_OBSERVATIONS) {
+            TEST_ASSERT_FALSE(locator.getEstimate(1, 2437.0f, bearing, distance));
+            continue;
+        }
+        if (firstError < 0 && locator.getEstimate(1, 2437.0f, bearing, distance)) {
+            trueBearing(x, y, expectBearing, expectDistance);
+            firstError = fabsf(distance - expectDistance);
+        }
+    }
+
+    float x = radius * sinf(0);
+    float y = radius * cosf(0);
+    trueBearing(x, y, expectBearing, expectDistance);
+
+    TEST_ASSERT_TRUE(locator.getEstimate(1, 2437.0f, bearing, distance));
+    TEST_ASSERT_LESS_OR_EQUAL(10.0f, angleError(bearing, expectBearing));
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * expectDistance, expectDistance, distance);
+
+    // The estimate tightens as the walk goes on
+    if (firstError >= 0) {
+        TEST_ASSERT_LESS_OR_EQUAL(firstError + 1.0f, fabsf(distance - expectDistance));
+    }
+
+    // Another emitter on another band is not confused with this one
+    TEST_ASSERT_FALSE(locator.getEstimate(0, 2437.0f, bearing, distance));
+}
+
+void test_bearing_follows_the_observer(void) {
+    EmitterLocator locator;
+    const float radius = 200.0f;
+    float bearing, distance;
+    float expectBearing, expectDistance;
+
+    observe(locator, 0, 0, 0);
+    for (int step = 0; step < 144; step++) {
+        float angle = 2.0f * (float)M_PI * step / 72;
+        observe(locator, radius * sinf(angle), radius * cosf(angle), 1000 * (step + 1));
+    }
+
+    // Without new observations, moving the observer moves the answer
+    const float spots[3][2] = {{0, 0}, {250, 0}, {0, 200}};
+    for (int i = 0; i < 3; i++) {
+        locator.setObserver((float)toLat(spots[i][1]), (float)toLon(spots[i][0]));
+        trueBearing(spots[i][0], spots[i][1], expectBearing, expectDistance);
+
+        TEST_ASSERT_TRUE(locator.getEstimate(1, 2437.0f, bearing, distance));
+        TEST_ASSERT_LESS_OR_EQUAL(12.0f, angleError(bearing, expectBearing));
+        TEST_ASSERT_FLOAT_WITHIN(0.25f * expectDistance + 15.0f, expectDistance, distance);
+    }
+}
+
+void test_standing_still_does_not_converge(void) {
+    EmitterLocator locator;
+    float bearing, distance;
+
+    // One spot only fixes the range ring, not the direction
+    for (int i = 0; i < 100; i++) {
+        observe(locator, 0, 0, 1000 * i);
+    }
+    TEST_ASSERT_FALSE(locator.getEstimate(1, 2437.0f, bearing, distance));
+}
+
+void test_update_cost_is_bounded_and_flat(void) {
+    static EmitterLocator locator;
+    uint32_t k = 0;
+
+    // Every track live before timing, so slot search is at its longest
+    for (int i = 0; i < LOCATOR_MAX_EMITTERS; i++) walkStep(locator, k++);
+    uint64_t early = updateCost(locator, k);
+
+    for (int i = 0; i < COST_WALK; i++) walkStep(locator, k++);
+    uint64_t late = updateCost(locator, k);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%d emitters, %d cells, ns/update: early %lu, after %d more %lu",
+             LOCATOR_MAX_EMITTERS, LOCATOR_CELLS, (unsigned long)early, COST_WALK,
+             (unsigned long)late);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE_MESSAGE(early <= (uint64_t)COST_BUDGET_US * 1000, msg);
+    TEST_ASSERT_TRUE_MESSAGE(late <= (uint64_t)COST_BUDGET_US * 1000, msg);
+
+    // Constant work per observation: a long history costs nothing extra
+    TEST_ASSERT_TRUE_MESSAGE(late <= 2 * early + 1000, msg);
+
+    // The walk is still being tracked, not discarded
+    float bearing, distance;
+    TEST_ASSERT_TRUE(locator.getEstimate(1, 2412.0f, bearing, distance));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_walk_converges_on_emitter);
+    RUN_TEST(test_bearing_follows_the_observer);
+    RUN_TEST(test_standing_still_does_not_converge);
+    RUN_TEST(test_update_cost_is_bounded_and_flat);
+    return UNITY_END();
+}
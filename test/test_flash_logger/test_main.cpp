@@ -0,0 +1,275 @@
+/**
+ * @file test_main.cpp
+ * @brief FlashLogger power-loss recovery on a host directory
+ *
+ * A wrapper around StdioLogStorage stops accepting bytes after a budget,
+ * which is what a power cut looks like to the logger. Each test session
+ * begins a fresh logger on the same directory, as a reboot would.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "flash_logger.h"
+#include "stdio_log_storage.h"
+
+#define ROW_CHANNELS 20
+#define ROWS_PER_BLOCK 3
+#define BLOCK_BYTES (sizeof(LogBlockHeader) + \
+                     ROWS_PER_BLOCK * (2 + sizeof(LogSweepRowHeader) + ROW_CHANNELS))
+
+static char root[64];
+
+// Accepts writes until its budget runs out, then writes nothing more
+class CuttingFile : public LogStorageFile {
+public:
+    CuttingFile(LogStorageFile* inner, long* budget) {
+        this->inner = inner;
+        this->budget = budget;
+    }
+
+    size_t read(uint8_t* data, size_t len) override {
+        return inner->read(data, len);
+    }
+
+    size_t write(const uint8_t* data, size_t len) override {
+        if (*budget >= 0 && (long)len > *budget) len = (size_t)*budget;
+        size_t written = inner->write(data, len);
+        if (*budget >= 0) *budget -= (long)written;
+        return written;
+    }
+
+    void flush() override {
+        inner->flush();
+    }
+
+    size_t size() override {
+        return inner->size();
+    }
+
+    LogStorageFile* inner;
+    long* budget;
+};
+
+class CuttingStorage : public LogStorage {
+public:
+    CuttingStorage(const char* root, long budget) : disk(root) {
+        this->budget = budget;
+    }
+
+    bool mount() override { return disk.mount(); }
+    bool exists(const char* path) override { return disk.exists(path); }
+    bool mkdir(const char* path) override { return disk.mkdir(path); }
+    bool remove(const char* path) override { return disk.remove(path); }
+
+    LogStorageFile* open(const char* path, bool append) override {
+        LogStorageFile* f = disk.open(path, append);
+        return f == nullptr ? nullptr : new CuttingFile(f, &budget);
+    }
+
+    void close(LogStorageFile* file) override {
+        if (file == nullptr) return;
+        disk.close(static_cast<CuttingFile*>(file)->inner);
+        delete file;
+    }
+
+    bool listDir(const char* path, LogDirVisitor visit, void* ctx) override {
+        return disk.listDir(path, visit, ctx);
+    }
+
+    StdioLogStorage disk;
+    long budget;                   // Bytes left before the cut, -1 = never
+};
+
+struct ParsedBlock {
+    uint32_t file;
+    uint32_t sequence;
+    uint8_t firstCell;             // First cell of the first sweep row
+};
+
+// Independent walk of every log file, in index order
+static void parseLogs(std::vector<ParsedBlock>& blocks, uint32_t* tornFiles) {
+    blocks.clear();
+    *tornFiles = 0;
+
+    for (uint32_t index = 0; index <= LOG_MAX_FILES; index++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s" LOG_DIR "/%05lu.bin", root, (unsigned long)index);
+        FILE* f = fopen(path, "rb");
+        if (f == nullptr) continue;
+
+        while (true) {
+            LogBlockHeader hdr;
+            static uint8_t payload[LOG_PAGE_SIZE];
+            size_t got = fread(&hdr, 1, sizeof(hdr), f);
+            if (got == 0) break;
+            if (got != sizeof(hdr) || hdr.magic != LOG_BLOCK_MAGIC ||
+                hdr.payloadLength > sizeof(payload) ||
+                fread(payload, 1, hdr.payloadLength, f) != hdr.payloadLength ||
+                FlashLogger::blockCrc(hdr, payload) != hdr.crc) {
+                (*tornFiles)++;
+                break;
+            }
+
+            ParsedBlock b;
+            b.file = index;
+            b.sequence = hdr.sequence;
+            b.firstCell = payload[2 + sizeof(LogSweepRowHeader)];
+            blocks.push_back(b);
+        }
+        fclose(f);
+    }
+}
+
+// Writes `count` blocks, each flushed on its own, tagged with `tag + n`
+static void writeBlocks(FlashLogger& logger, int count, uint8_t tag) {
+    int8_t row[ROW_CHANNELS];
+    for (int b = 0; b < count; b++) {
+        memset(row, (int8_t)(tag + b), sizeof(row));
+        for (int r = 0; r < ROWS_PER_BLOCK; r++) {
+            logger.logSweepRow(0, row, ROW_CHANNELS, 1000 * b);
+        }
+        logger.flush(1000 * b);
+    }
+}
+
+void setUp(void) {
+    snprintf(root, sizeof(root), "/tmp/flashlogXXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(root));
+}
+
+void tearDown(void) {
+    for (uint32_t index = 0; index <= LOG_MAX_FILES; index++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s" LOG_DIR "/%05lu.bin", root, (unsigned long)index);
+        unlink(path);
+    }
+    char dir[128];
+    snprintf(dir, sizeof(dir), "%s" LOG_DIR, root);
+    rmdir(dir);
+    rmdir(root);
+}
+
+void test_blocks_round_trip(void) {
+    StdioLogStorage disk(root);
+    FlashLogger logger;
+    TEST_ASSERT_TRUE(logger.begin(&disk));
+    writeBlocks(logger, 4, 10);
+    TEST_ASSERT_EQUAL_UINT32(4, logger.getBlocksWritten());
+
+    std::vector<ParsedBlock> blocks;
+    uint32_t torn;
+    parseLogs(blocks, &torn);
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL(4, blocks.size());
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, blocks[i].sequence);
+        TEST_ASSERT_EQUAL_UINT8(10 + i, blocks[i].firstCell);
+    }
+}
+
+void test_cut_at_every_byte(void) {
+    const int before = 3;          // Blocks written in full by the first boot
+    const int during = 4;          // Blocks attempted by the boot that loses power
+    const int after = 2;           // Blocks written by the boot that recovers
+    const long span = during * (long)BLOCK_BYTES;
+
+    for (long cut = 0; cut <= span; cut++) {
+        tearDown();
+        setUp();
+
+        {
+            StdioLogStorage disk(root);
+            FlashLogger logger;
+            TEST_ASSERT_TRUE(logger.begin(&disk));
+            writeBlocks(logger, before, 0);
+        }
+
+        {
+            CuttingStorage disk(root, cut);
+            FlashLogger logger;
+            TEST_ASSERT_TRUE(logger.begin(&disk));
+            writeBlocks(logger, during, 100);
+            TEST_ASSERT_EQUAL(cut == span, logger.isAvailable());
+        }
+
+        int complete = (int)(cut / (long)BLOCK_BYTES);
+        uint32_t expectNext = before + complete;
+
+        {
+            StdioLogStorage disk(root);
+            FlashLogger logger;
+            TEST_ASSERT_TRUE(logger.begin(&disk));
+
+            char msg[64];
+            snprintf(msg, sizeof(msg), "cut at byte %ld", cut);
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(expectNext, logger.getNextSequence(), msg);
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(complete > 0 ? complete : before,
+                                             logger.getRecoveredBlocks(), msg);
+            if (complete > 0) {
+                TEST_ASSERT_EQUAL_UINT32_MESSAGE(cut - complete * (long)BLOCK_BYTES,
+                                                 logger.getTornBytes(), msg);
+            }
+
+            writeBlocks(logger, after, 200);
+        }
+
+        std::vector<ParsedBlock> blocks;
+        uint32_t torn;
+        parseLogs(blocks, &torn);
+
+        // Only the file that lost power may end in a partial block
+        bool partial = cut % (long)BLOCK_BYTES != 0;
+        TEST_ASSERT_EQUAL_UINT32(partial ? 1 : 0, torn);
+        TEST_ASSERT_EQUAL(before + complete + after, (int)blocks.size());
+
+        for (size_t i = 1; i < blocks.size(); i++) {
+            TEST_ASSERT_TRUE(blocks[i].sequence > blocks[i - 1].sequence);
+            TEST_ASSERT_TRUE(blocks[i].file >= blocks[i - 1].file);
+        }
+        for (int i = 0; i < complete; i++) {
+            TEST_ASSERT_EQUAL_UINT8(100 + i, blocks[before + i].firstCell);
+        }
+        TEST_ASSERT_EQUAL_UINT8(200, blocks[before + complete].firstCell);
+        TEST_ASSERT_EQUAL_UINT32(expectNext, blocks[before + complete].sequence);
+    }
+}
+
+void test_header_corruption_is_detected(void) {
+    {
+        StdioLogStorage disk(root);
+        FlashLogger logger;
+        TEST_ASSERT_TRUE(logger.begin(&disk));
+        writeBlocks(logger, 3, 0);
+    }
+
+    // Flip a bit of the second block's sequence; its payload stays intact
+    char path[128];
+    snprintf(path, sizeof(path), "%s" LOG_DIR "/00001.bin", root);
+    FILE* f = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(f);
+    long at = (long)BLOCK_BYTES + offsetof(LogBlockHeader, sequence);
+    fseek(f, at, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, at, SEEK_SET);
+    fputc(c ^ 0x04, f);
+    fclose(f);
+
+    StdioLogStorage disk(root);
+    FlashLogger logger;
+    TEST_ASSERT_TRUE(logger.begin(&disk));
+    TEST_ASSERT_EQUAL_UINT32(1, logger.getRecoveredBlocks());
+    TEST_ASSERT_EQUAL_UINT32(1, logger.getNextSequence());
+    TEST_ASSERT_EQUAL_UINT32(2 * BLOCK_BYTES, logger.getTornBytes());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_round_trip);
+    RUN_TEST(test_cut_at_every_byte);
+    RUN_TEST(test_header_corruption_is_detected);
+    return UNITY_END();
+}
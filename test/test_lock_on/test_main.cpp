@@ -0,0 +1,285 @@
+/**
+ * @file test_main.cpp
+ * @brief LockOnTracker following a simulated moving emitter
+ *
+ * The scan task is replayed in virtual time as ScanScheduler runs it
+ * while locked: LOCK_SLOTS_PER_SWEEP slots of LOCK_SLOT_MS dwelling on
+ * the target, each followed by LOCK_GAP_MS, then a background sweep and
+ * SCAN_INTERVAL_MS. The operator walks towards the emitter, past it at
+ * CLOSEST_M and away again; each dwell reads free-space loss over the
+ * distance at that moment, with a few dB of fading.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "lock_on.h"
+#include "band_analyzer.h"
+
+#define DWELL_US 2700              // Tune, settle and LOCK_DWELL_READS reads
+#define SWEEP_US 350000            // A background sweep of the 900MHz plan
+#define TARGET_MHZ 915.0f
+#define LEVEL_AT_1M_DBM -30.0f
+#define FADE_DB 2
+#define WALK_M_PER_S 4.0f
+#define START_M 48.0f
+#define CLOSEST_M 8.0f
+#define TURN_S ((START_M - CLOSEST_M) / WALK_M_PER_S)
+#define RUN_S (2 * TURN_S)
+
+// The slope needs most of its window on one side of the turn to cross
+// LOCK_TREND_DB_PER_S again, so a reversal shows before the window has
+// turned over completely
+#define REVERSAL_BUDGET_MS (LOCK_TREND_POINTS * LOCK_POINT_MS)
+
+static LockOnTracker* tracker;
+static uint64_t nowUs;
+static uint64_t startUs;           // When the walk began
+static uint32_t rngState;
+
+static int fade() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (int)((rngState >> 16) % (2 * FADE_DB + 1)) - FADE_DB;
+}
+
+static float distanceAt(uint64_t us) {
+    float s = (us - startUs) / 1e6f;
+    return fabsf(START_M - WALK_M_PER_S * s - CLOSEST_M) + CLOSEST_M;
+}
+
+static float levelAt(uint64_t us) {
+    return LEVEL_AT_1M_DBM - 20 * log10f(distanceAt(us));
+}
+
+// What the scan task does, as it happens
+struct Observer {
+    virtual void afterDwell() {}
+    virtual void afterSweep() {}
+};
+
+// One lock-on cycle: the dwelling slots, then a background sweep
+static void runCycle(Observer& observer) {
+    for (int slot = 0; slot < LOCK_SLOTS_PER_SWEEP; slot++) {
+        uint64_t start = nowUs;
+        while (nowUs - start < LOCK_SLOT_MS * 1000ULL) {
+            float freq = tracker->nextFrequency();
+            nowUs += DWELL_US;
+            int8_t peak = fabsf(freq - TARGET_MHZ) < 0.01f ? (int8_t)lroundf(levelAt(nowUs) + fade()) : -110;
+            tracker->addDwell(peak, (uint32_t)(nowUs / 1000));
+            observer.afterDwell();
+        }
+        nowUs += LOCK_GAP_MS * 1000ULL;
+    }
+
+    nowUs += SWEEP_US;
+    observer.afterSweep();
+    nowUs += SCAN_INTERVAL_MS * 1000ULL;
+}
+
+void setUp(void) {
+    tracker = new LockOnTracker();
+    nowUs = 5000000;
+    startUs = nowUs;
+    rngState = 1;
+}
+
+void tearDown(void) {
+    delete tracker;
+}
+
+// Records the trend, and how long each dwell takes to be published
+struct WalkObserver : Observer {
+    uint32_t pendingMs;            // Oldest dwell not yet in the view
+    uint32_t worstLatencyMs;
+    uint64_t sumLatencyMs;
+    uint32_t updates;
+    int8_t worstErrorDb;
+    uint64_t lastApproachingUs;
+    uint64_t firstRecedingUs;
+    bool recededBeforeTurn;
+    bool approachedAfterReversal;
+
+    void afterDwell() override {
+        LockOnView view;
+        tracker->getView(view);
+        uint64_t t = nowUs - startUs;
+        if (view.sparkCount == 0) return;
+
+        int newest = (view.sparkNext + LOCK_SPARK_POINTS - 1) % LOCK_SPARK_POINTS;
+        uint32_t nowMs = (uint32_t)(nowUs / 1000);
+        if (pendingMs != 0 && view.sparkMs[newest] >= pendingMs) {
+            uint32_t latency = view.sparkMs[newest] - pendingMs;
+            if (latency > worstLatencyMs) worstLatencyMs = latency;
+            sumLatencyMs += latency;
+            updates++;
+            pendingMs = 0;
+        }
+        if (pendingMs == 0 && view.sparkMs[newest] < nowMs) pendingMs = nowMs;
+
+        // The newest point against the truth when it closed
+        float truth = levelAt((uint64_t)view.sparkMs[newest] * 1000);
+        int8_t error = (int8_t)fabsf(view.lastDbm - truth);
+        if (error > worstErrorDb) worstErrorDb = error;
+
+        if (view.trend == LOCK_TREND_APPROACHING) {
+            lastApproachingUs = t;
+            if (firstRecedingUs != 0) approachedAfterReversal = true;
+        }
+        if (view.trend == LOCK_TREND_RECEDING) {
+            if (t < TURN_S * 1e6f) recededBeforeTurn = true;
+            if (firstRecedingUs == 0 && t >= TURN_S * 1e6f) firstRecedingUs = t;
+        }
+    }
+};
+
+void test_walk_past_emitter(void) {
+    WalkObserver walk;
+    walk.pendingMs = 0;
+    walk.worstLatencyMs = 0;
+    walk.sumLatencyMs = 0;
+    walk.updates = 0;
+    walk.worstErrorDb = 0;
+    walk.lastApproachingUs = 0;
+    walk.firstRecedingUs = 0;
+    walk.recededBeforeTurn = false;
+    walk.approachedAfterReversal = false;
+
+    tracker->start(0, TARGET_MHZ, MOD_LORA, (uint32_t)(nowUs / 1000));
+    while (nowUs - startUs < RUN_S * 1e6f) runCycle(walk);
+
+    LockOnView view;
+    tracker->getView(view);
+    TEST_ASSERT_TRUE(view.active);
+    TEST_ASSERT_EQUAL_UINT8(1, view.hopCount);
+    TEST_ASSERT_EQUAL_UINT8(LOCK_SPARK_POINTS, view.sparkCount);
+
+    // Revisit rate: the slots' share of each cycle, at one dwell per DWELL_US
+    uint32_t cycleMs = LOCK_SLOTS_PER_SWEEP * (LOCK_SLOT_MS + LOCK_GAP_MS) +
+                       SWEEP_US / 1000 + SCAN_INTERVAL_MS;
+    uint32_t expectedHz = LOCK_SLOTS_PER_SWEEP * LOCK_SLOT_MS * 1000 / DWELL_US * 1000 / cycleMs;
+    TEST_ASSERT_UINT32_WITHIN(expectedHz / 10, expectedHz, view.revisitHz);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(150, view.revisitHz);
+
+    // The longest wait is the background sweep and the gaps around it
+    uint32_t sweepGapMs = SWEEP_US / 1000 + SCAN_INTERVAL_MS + LOCK_GAP_MS + DWELL_US / 1000 + 1;
+    TEST_ASSERT_UINT32_WITHIN(2, sweepGapMs, view.maxGapMs);
+
+    // Update latency: a point closes every LOCK_POINT_MS of dwelling, so
+    // a dwell is on screen within a point, or a point and the sweep when
+    // it came just before one. One point in sixteen waits out a sweep
+    TEST_ASSERT_GREATER_THAN_UINT32(0, walk.updates);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2 * LOCK_POINT_MS, (uint32_t)(walk.sumLatencyMs / walk.updates));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LOCK_POINT_MS + sweepGapMs, walk.worstLatencyMs);
+    TEST_ASSERT_GREATER_THAN_UINT32(sweepGapMs, walk.worstLatencyMs);
+    TEST_ASSERT_LESS_OR_EQUAL_INT(FADE_DB + 2, walk.worstErrorDb);
+
+    // Approaching up to the turn, receding soon after it and from then on
+    TEST_ASSERT_FALSE(walk.recededBeforeTurn);
+    TEST_ASSERT_TRUE(walk.lastApproachingUs >= (uint64_t)(TURN_S * 1e6f) - 1000000);
+    TEST_ASSERT_TRUE(walk.firstRecedingUs > 0);
+    TEST_ASSERT_TRUE(walk.firstRecedingUs - (uint64_t)(TURN_S * 1e6f) <= REVERSAL_BUDGET_MS * 1000ULL);
+    TEST_ASSERT_FALSE(walk.approachedAfterReversal);
+
+    // Back at START_M the loss flattens out below LOCK_TREND_DB_PER_S
+    TEST_ASSERT_EQUAL_UINT8(LOCK_TREND_STEADY, view.trend);
+}
+
+void test_standing_still_is_steady(void) {
+    tracker->start(0, TARGET_MHZ, MOD_LORA, (uint32_t)(nowUs / 1000));
+    uint64_t start = nowUs;
+
+    LockOnView view;
+    tracker->getView(view);
+    TEST_ASSERT_EQUAL_UINT8(LOCK_TREND_UNKNOWN, view.trend);
+
+    // Fading alone, no movement
+    while (nowUs - start < 5000000) {
+        for (int slot = 0; slot < LOCK_SLOTS_PER_SWEEP; slot++) {
+            uint64_t slotStart = nowUs;
+            while (nowUs - slotStart < LOCK_SLOT_MS * 1000ULL) {
+                tracker->nextFrequency();
+                nowUs += DWELL_US;
+                tracker->addDwell((int8_t)(-60 + fade()), (uint32_t)(nowUs / 1000));
+            }
+            nowUs += LOCK_GAP_MS * 1000ULL;
+        }
+        nowUs += SWEEP_US + SCAN_INTERVAL_MS * 1000ULL;
+    }
+
+    tracker->getView(view);
+    TEST_ASSERT_EQUAL_UINT8(LOCK_TREND_STEADY, view.trend);
+    TEST_ASSERT_FLOAT_WITHIN(LOCK_TREND_DB_PER_S, 0.0f, view.trendDbPerS);
+}
+
+// Background sweeps turning up hops, some of them not the target's
+struct HopObserver : Observer {
+    int sweeps = 0;
+    void afterSweep() override {
+        const float found[] = { 917.0f, 912.5f, 950.0f, 917.2f, 921.0f, 909.0f };
+        const uint8_t kinds[] = { MOD_FHSS, MOD_FHSS, MOD_FHSS, MOD_FHSS, MOD_LORA, MOD_FHSS };
+        if (sweeps < 6) tracker->learn(0, found[sweeps], kinds[sweeps]);
+        tracker->learn(1, 2440.0f, MOD_FHSS);
+        sweeps++;
+    }
+};
+
+void test_hopper_learns_hop_set(void) {
+    HopObserver hops;
+    tracker->start(0, TARGET_MHZ, MOD_FHSS, (uint32_t)(nowUs / 1000));
+    for (int i = 0; i < 8; i++) runCycle(hops);
+
+    // 950 is out of span, 917.2 the same hop as 917, 921 not a hopper,
+    // 2440 the other band
+    LockOnView view;
+    tracker->getView(view);
+    TEST_ASSERT_EQUAL_UINT8(4, view.hopCount);
+    TEST_ASSERT_EQUAL_FLOAT(TARGET_MHZ, view.frequency);
+
+    // Dwells take the hops in the order they were learned
+    const float expected[] = { TARGET_MHZ, 917.0f, 912.5f, 909.0f };
+    int tries = 0;
+    while (tracker->nextFrequency() != TARGET_MHZ && tries < 4) tries++;
+    for (int i = 1; i < 9; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(expected[i % 4], tracker->nextFrequency());
+    }
+}
+
+void test_follows_drift_then_stops(void) {
+    Observer none;
+    tracker->start(0, TARGET_MHZ, MOD_LORA, (uint32_t)(nowUs / 1000));
+    runCycle(none);
+
+    // Re-detections walk the target up; one too far away is another emitter
+    tracker->learn(0, 915.5f, MOD_LORA);
+    tracker->learn(0, 916.25f, MOD_LORA);
+    tracker->learn(0, 918.0f, MOD_LORA);
+    TEST_ASSERT_EQUAL_FLOAT(916.25f, tracker->nextFrequency());
+    TEST_ASSERT_EQUAL_FLOAT(916.25f, tracker->nextFrequency());
+
+    LockOnView view;
+    tracker->stop();
+    TEST_ASSERT_FALSE(tracker->isActive());
+    tracker->getView(view);
+    uint32_t dwells = view.dwells;
+    TEST_ASSERT_GREATER_THAN_UINT32(0, dwells);
+    tracker->addDwell(-40, (uint32_t)(nowUs / 1000) + 1000);
+    tracker->getView(view);
+    TEST_ASSERT_FALSE(view.active);
+    TEST_ASSERT_EQUAL_UINT32(dwells, view.dwells);
+
+    // A new target starts from nothing
+    tracker->start(1, 2440.0f, MOD_OFDM, (uint32_t)(nowUs / 1000));
+    tracker->getView(view);
+    TEST_ASSERT_TRUE(view.active);
+    TEST_ASSERT_EQUAL_UINT8(1, view.band);
+    TEST_ASSERT_EQUAL_UINT8(0, view.sparkCount);
+    TEST_ASSERT_EQUAL_UINT32(0, view.dwells);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_walk_past_emitter);
+    RUN_TEST(test_standing_still_is_steady);
+    RUN_TEST(test_hopper_learns_hop_set);
+    RUN_TEST(test_follows_drift_then_stops);
+    return UNITY_END();
+}
@@ -0,0 +1,308 @@
+/**
+ * @file test_main.cpp
+ * @brief MeshLink and RadioScheduler on a simulated shared channel
+ *
+ * Every virtual node runs the firmware's slot plan on its own thread:
+ * MESH_SWEEPS_PER_WINDOW sweep slots with the radio off the mesh channel,
+ * then one mesh window.
+ */
+
+#include <unity.h>
+#include <set>
+#include <thread>
+#include <vector>
+#include "mesh_link.h"
+#include "radio_scheduler.h"
+#include "sim_mesh_medium.h"
+
+struct VirtualNode {
+    SimMeshTransport* transport;
+    MeshLink link;
+    RadioScheduler scheduler;
+    uint32_t sweepMs;              // Length of every sweep slot
+    std::vector<DetectedSignal> detections;
+    uint32_t detectEveryMs;        // 0 = queue detections once at start
+    float driftMhz;                // Shift applied to the detections each time
+    bool started;
+    std::set<uint16_t> heard;      // Nodes ever present in the remote table
+    uint32_t minFrameMs;
+    uint32_t maxFrameMs;
+    uint32_t frames;
+};
+
+static DetectedSignal detection(float freq, float rssi) {
+    DetectedSignal sig;
+    memset(&sig, 0, sizeof(sig));
+    sig.frequency = freq;
+    sig.rssi = rssi;
+    sig.modType = MOD_LORA;
+    sig.band = 0;
+    sig.active = true;
+    return sig;
+}
+
+static void runNode(VirtualNode* n, uint32_t untilMs) {
+    MeshTransport* radio = n->transport;
+    n->started = n->link.begin(radio);
+    n->scheduler.begin(&n->link, radio->nowMs());
+    n->minFrameMs = UINT32_MAX;
+    n->maxFrameMs = 0;
+    n->frames = 0;
+
+    uint32_t lastDetect = radio->nowMs();
+    for (const DetectedSignal& sig : n->detections) n->link.queueReport(sig);
+
+    while (radio->nowMs() < untilMs) {
+        if (n->scheduler.nextSlot() == SLOT_MESH) {
+            n->scheduler.runMeshWindow();
+            uint32_t frame = n->scheduler.getFrameMs();
+            if (frame < n->minFrameMs) n->minFrameMs = frame;
+            if (frame > n->maxFrameMs) n->maxFrameMs = frame;
+            n->frames++;
+
+            RemoteReport* remote = n->link.getRemoteReports();
+            for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+                if (remote[i].active) n->heard.insert(remote[i].nodeId);
+            }
+            continue;
+        }
+
+        // A sweep slot: the radio is off the mesh channel throughout
+        radio->standby();
+        radio->idle(n->sweepMs);
+        n->scheduler.slotCompleted();
+
+        if (n->detectEveryMs > 0 && radio->nowMs() - lastDetect >= n->detectEveryMs) {
+            lastDetect = radio->nowMs();
+            for (DetectedSignal& sig : n->detections) {
+                sig.frequency += n->driftMhz;
+                n->link.queueReport(sig);
+            }
+        }
+    }
+    n->transport->leave();
+}
+
+static void runAll(std::vector<VirtualNode*>& nodes, uint32_t untilMs) {
+    std::vector<std::thread> threads;
+    for (VirtualNode* n : nodes) threads.emplace_back(runNode, n, untilMs);
+    for (std::thread& t : threads) t.join();
+    for (VirtualNode* n : nodes) TEST_ASSERT_TRUE(n->started);
+}
+
+static bool hasRemote(VirtualNode* n, uint16_t nodeId, float freq) {
+    RemoteReport* remote = n->link.getRemoteReports();
+    for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+        if (remote[i].active && remote[i].nodeId == nodeId &&
+            fabsf(remote[i].frequency - freq) < 0.05f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Most sends of one batch within a holdoff, following the resend backoff
+static uint32_t sendsPerHoldoff() {
+    uint32_t elapsed = 0;
+    uint32_t sends = 1;
+    for (int attempt = 0; ; attempt++) {
+        uint32_t backoff = MESH_RETRY_MS << (attempt < 3 ? attempt : 3);
+        if (backoff > MESH_REPORT_HOLDOFF_MS) backoff = MESH_REPORT_HOLDOFF_MS;
+        elapsed += backoff;
+        if (elapsed >= MESH_REPORT_HOLDOFF_MS) return sends;
+        sends++;
+    }
+}
+
+static int remoteCount(VirtualNode* n) {
+    int count = 0;
+    RemoteReport* remote = n->link.getRemoteReports();
+    for (int i = 0; i < MAX_REMOTE_REPORTS; i++) {
+        if (remote[i].active) count++;
+    }
+    return count;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_reports_reach_every_node(void) {
+    SimMeshMedium medium;
+    const uint16_t ids[3] = {0x1111, 0x2222, 0x3333};
+    const uint32_t sweeps[3] = {230, 270, 310};
+    const float freqs[3] = {903.2f, 915.0f, 2437.0f};
+    VirtualNode nodes[3];
+    std::vector<VirtualNode*> all;
+
+    for (int i = 0; i < 3; i++) {
+        nodes[i].transport = new SimMeshTransport(&medium, ids[i]);
+        nodes[i].sweepMs = sweeps[i];
+        nodes[i].detections.push_back(detection(freqs[i], -70.0f - i));
+        nodes[i].detectEveryMs = sweeps[i];
+        nodes[i].driftMhz = 0;
+        all.push_back(&nodes[i]);
+    }
+
+    const uint32_t runMs = 300000;
+    runAll(all, runMs);
+
+    // Slot sharing: every frame is exactly two sweeps and one window,
+    // whatever the mesh traffic did
+    for (int i = 0; i < 3; i++) {
+        uint32_t frame = MESH_SWEEPS_PER_WINDOW * sweeps[i] + MESH_WINDOW_MS;
+        TEST_ASSERT_GREATER_THAN_UINT32(10, nodes[i].frames);
+        TEST_ASSERT_EQUAL_UINT32(frame, nodes[i].minFrameMs);
+        TEST_ASSERT_EQUAL_UINT32(frame, nodes[i].maxFrameMs);
+    }
+
+    // A packet is only heard by nodes whose window happens to be open, but
+    // windows drift past each other with different sweep times, and a
+    // batch is resent until acknowledged, so every report gets through
+    for (int i = 0; i < 3; i++) {
+        uint32_t batches = runMs / MESH_REPORT_HOLDOFF_MS + 1;
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(batches * sendsPerHoldoff(), nodes[i].link.getPacketsSent());
+        for (int j = 0; j < 3; j++) {
+            if (i == j) continue;
+            char msg[48];
+            snprintf(msg, sizeof(msg), "node %d hears node %d", i, j);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(1, (int)nodes[i].heard.count(ids[j]), msg);
+        }
+        TEST_ASSERT_EQUAL_INT(0, (int)nodes[i].heard.count(ids[i]));
+    }
+
+    for (int i = 0; i < 3; i++) delete nodes[i].transport;
+}
+
+void test_aligned_windows_both_deliver(void) {
+    SimMeshMedium medium;
+    VirtualNode nodes[2];
+    std::vector<VirtualNode*> all;
+
+    // Identical timing, as with GPS-locked sweeps: both windows open at the
+    // same instant and both nodes have a full batch to send
+    for (int i = 0; i < 2; i++) {
+        nodes[i].transport = new SimMeshTransport(&medium, 0x100 + i);
+        nodes[i].sweepMs = 250;
+        for (int k = 0; k < MESH_BATCH_SIZE; k++) {
+            nodes[i].detections.push_back(detection(902.0f + 3 * k + i, -60.0f));
+        }
+        nodes[i].detectEveryMs = 0;
+        nodes[i].driftMhz = 0;
+        all.push_back(&nodes[i]);
+    }
+
+    runAll(all, 30000);
+
+    // Every report arrives, and each sender knows it did
+    for (int i = 0; i < 2; i++) {
+        VirtualNode* other = &nodes[1 - i];
+        for (int k = 0; k < MESH_BATCH_SIZE; k++) {
+            TEST_ASSERT_TRUE(hasRemote(other, 0x100 + i, 902.0f + 3 * k + i));
+        }
+        TEST_ASSERT_EQUAL_INT(0, nodes[i].link.getPendingCount());
+        TEST_ASSERT_GREATER_THAN_UINT32(0, nodes[i].link.getPacketsReceived());
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2, medium.getDeliveries());
+
+    for (int i = 0; i < 2; i++) delete nodes[i].transport;
+}
+
+void test_unacknowledged_batch_is_kept(void) {
+    SimMeshMedium medium;
+    VirtualNode node;
+    std::vector<VirtualNode*> all;
+
+    // Nobody to hear it: the batch is resent, backing off, and never dropped
+    node.transport = new SimMeshTransport(&medium, 0xDDDD);
+    node.sweepMs = 250;
+    for (int k = 0; k < MESH_BATCH_SIZE; k++) {
+        node.detections.push_back(detection(904.0f + 3 * k, -60.0f));
+    }
+    node.detectEveryMs = 0;
+    node.driftMhz = 0;
+    all.push_back(&node);
+
+    const uint32_t runMs = 60000;
+    runAll(all, runMs);
+
+    TEST_ASSERT_EQUAL_INT(MESH_BATCH_SIZE, node.link.getPendingCount());
+    TEST_ASSERT_GREATER_THAN_UINT32(1, node.link.getPacketsSent());
+    uint32_t holdoffs = (runMs + MESH_REPORT_HOLDOFF_MS - 1) / MESH_REPORT_HOLDOFF_MS;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(holdoffs * sendsPerHoldoff(), node.link.getPacketsSent());
+    TEST_ASSERT_EQUAL_UINT32(0, node.link.getAcksSent());
+
+    delete node.transport;
+}
+
+void test_repeats_are_deduplicated(void) {
+    SimMeshMedium medium;
+    VirtualNode nodes[2];
+    std::vector<VirtualNode*> all;
+
+    // The sender keeps seeing the same emitter, a few hundred kHz apart
+    nodes[0].transport = new SimMeshTransport(&medium, 0xAAAA);
+    nodes[0].sweepMs = 240;
+    nodes[0].detections.push_back(detection(915.0f, -80.0f));
+    nodes[0].detections.push_back(detection(915.3f, -75.0f));
+    nodes[0].detectEveryMs = 240;
+    nodes[0].driftMhz = 0;
+    nodes[1].transport = new SimMeshTransport(&medium, 0xBBBB);
+    nodes[1].sweepMs = 260;
+    nodes[1].detectEveryMs = 0;
+    nodes[1].driftMhz = 0;
+    all.push_back(&nodes[0]);
+    all.push_back(&nodes[1]);
+
+    const uint32_t runMs = 60000;
+    runAll(all, runMs);
+
+    // One batch per holdoff period, each carrying the merged report and
+    // resent only until acknowledged
+    uint32_t batches = (runMs + MESH_REPORT_HOLDOFF_MS - 1) / MESH_REPORT_HOLDOFF_MS;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(batches * sendsPerHoldoff(), nodes[0].link.getPacketsSent());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, nodes[1].link.getAcksSent());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, nodes[1].link.getPacketsReceived());
+    TEST_ASSERT_EQUAL_INT(1, remoteCount(&nodes[1]));
+    TEST_ASSERT_TRUE(hasRemote(&nodes[1], 0xAAAA, 915.3f));
+
+    for (int i = 0; i < 2; i++) delete nodes[i].transport;
+}
+
+void test_airtime_stays_within_duty_cycle(void) {
+    SimMeshMedium medium;
+    VirtualNode node;
+    std::vector<VirtualNode*> all;
+
+    // A busy band: a fresh batch of new emitters after every sweep, moved
+    // far enough each time that holdoff never suppresses them
+    node.transport = new SimMeshTransport(&medium, 0xCCCC);
+    node.sweepMs = 200;
+    for (int k = 0; k < MESH_MAX_REPORTS; k++) {
+        node.detections.push_back(detection(903.0f + 2.5f * k, -65.0f));
+    }
+    node.detectEveryMs = 200;
+    node.driftMhz = 1.5f;
+    all.push_back(&node);
+
+    const uint32_t runMs = 120000;
+    runAll(all, runMs);
+
+    uint64_t budgetUs = (uint64_t)runMs * MESH_DUTY_CYCLE_PERMILLE + MESH_AIRTIME_BURST_MS * 1000ULL;
+    TEST_ASSERT_GREATER_THAN_UINT32(0, node.link.getPacketsSent());
+    TEST_ASSERT_TRUE(node.link.getAirtimeUs() <= budgetUs);
+
+    delete node.transport;
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reports_reach_every_node);
+    RUN_TEST(test_aligned_windows_both_deliver);
+    RUN_TEST(test_unacknowledged_batch_is_kept);
+    RUN_TEST(test_repeats_are_deduplicated);
+    RUN_TEST(test_airtime_stays_within_duty_cycle);
+    return UNITY_END();
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_main.cpp
+ * @brief PPS/RMC pairing over a pseudo-terminal
+ *
+ * A simulated GPS module writes real NMEA sentences, checksums and line
+ * endings included, into the master side of a pty, and raises PPS edges
+ * the way the interrupt does. The GPS task's side reads the slave end in
+ * raw mode every GPS_TASK_PERIOD_MS of simulated time, feeding each
+ * character to PpsPairer and handing it the latest edge whenever an RMC
+ * sentence completes, as GpsReceiver::poll() does with the UART.
+ */
+
+#include <unity.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "pps_pairer.h"
+#include "sweep_clock.h"
+
+#define UTC_START_S 1767225595LL        // 2025-12-31 23:59:55, over a year end
+#define LOCAL_START_US 5000000LL        // Local timer at the first edge
+#define RMC_DELAY_MS 420                // Sentence for a second after its edge
+#define GGA_DELAY_MS 180
+
+static int master;
+static int slave;
+static size_t written;
+static size_t readBack;
+
+static PpsPairer* pairer;
+static SweepClock* sweepClock;
+static uint32_t pulseCount;
+static int64_t pulseUs;
+static int pairings;
+
+static int64_t localAt(int64_t second, int ms) {
+    return LOCAL_START_US + (second - UTC_START_S) * 1000000 + (int64_t)ms * 1000;
+}
+
+// GPS side: one sentence with checksum and CRLF into the pty
+static void send(const char* body) {
+    uint8_t sum = 0;
+    for (const char* p = body; *p; p++) sum ^= (uint8_t)*p;
+    char line[NMEA_SENTENCE_MAX + 8];
+    int len = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+    TEST_ASSERT_EQUAL_INT(len, (int)write(master, line, len));
+    written += len;
+}
+
+static void sendRaw(const char* line) {
+    size_t len = strlen(line);
+    TEST_ASSERT_EQUAL_INT((int)len, (int)write(master, line, len));
+    written += len;
+}
+
+static void rmcBody(char* out, size_t size, int64_t utcSecond, const char* fraction,
+                    char status) {
+    time_t t = (time_t)utcSecond;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    snprintf(out, size, "GNRMC,%02d%02d%02d%s,%c,5230.1234,N,01322.5678,E,0.02,,%02d%02d%02d,,,A",
+             tm.tm_hour, tm.tm_min, tm.tm_sec, fraction, status,
+             tm.tm_mday, tm.tm_mon + 1, tm.tm_year % 100);
+}
+
+static void sendRmc(int64_t utcSecond) {
+    char body[NMEA_SENTENCE_MAX];
+    rmcBody(body, sizeof(body), utcSecond, ".00", 'A');
+    send(body);
+}
+
+static void sendGga() {
+    send("GNGGA,000000.00,5230.1234,N,01322.5678,E,1,09,1.0,34.5,M,44.1,M,,");
+}
+
+// The interrupt
+static void edge(int64_t localUs) {
+    pulseUs = localUs;
+    pulseCount++;
+}
+
+// The GPS task waking at nowUs: everything written so far is in the UART
+static void pollAt(int64_t nowUs) {
+    while (readBack < written) {
+        struct pollfd p = { slave, POLLIN, 0 };
+        TEST_ASSERT_EQUAL_INT_MESSAGE(1, poll(&p, 1, 1000), "pty stalled");
+        char buf[256];
+        ssize_t n = read(slave, buf, sizeof(buf));
+        TEST_ASSERT_TRUE(n > 0);
+        readBack += n;
+        for (ssize_t i = 0; i < n; i++) {
+            if (pairer->encode(buf[i]) && pairer->pairPulse(pulseCount, pulseUs, nowUs)) {
+                pairings++;
+            }
+        }
+    }
+}
+
+// The task's wake-ups fall on GPS_TASK_PERIOD_MS boundaries
+static int64_t nextPoll(int64_t localUs) {
+    int64_t period = (int64_t)GPS_TASK_PERIOD_MS * 1000;
+    return (localUs / period + 1) * period;
+}
+
+// One ordinary second: edge, GGA, RMC naming it
+static void second(int64_t utcSecond) {
+    edge(localAt(utcSecond, 0));
+    sendGga();
+    pollAt(nextPoll(localAt(utcSecond, GGA_DELAY_MS)));
+    sendRmc(utcSecond);
+    pollAt(nextPoll(localAt(utcSecond, RMC_DELAY_MS)));
+}
+
+void setUp(void) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    TEST_ASSERT_TRUE(master >= 0);
+    TEST_ASSERT_EQUAL_INT(0, grantpt(master));
+    TEST_ASSERT_EQUAL_INT(0, unlockpt(master));
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    TEST_ASSERT_TRUE(slave >= 0);
+
+    // A UART: bytes exactly as sent, CRs included
+    struct termios t;
+    tcgetattr(slave, &t);
+    cfmakeraw(&t);
+    tcsetattr(slave, TCSANOW, &t);
+    written = 0;
+    readBack = 0;
+
+    sweepClock = new SweepClock();
+    pairer = new PpsPairer();
+    pairer->begin(sweepClock);
+    pulseCount = 0;
+    pulseUs = 0;
+    pairings = 0;
+}
+
+void tearDown(void) {
+    close(slave);
+    close(master);
+    delete pairer;
+    delete sweepClock;
+}
+
+void test_locks_from_sentences_over_year_end(void) {
+    int seconds = SYNC_LOCK_PPS + 3;
+    for (int n = 0; n < seconds; n++) second(UTC_START_S + n);
+
+    TEST_ASSERT_EQUAL_INT(seconds, pairings);
+    TEST_ASSERT_EQUAL_UINT32(seconds, sweepClock->getPulseCount());
+    int64_t last = UTC_START_S + seconds - 1;
+    TEST_ASSERT_TRUE(pairer->getUtcSecond() == last);
+
+    // The UTC the clock gives matches what the sentences said
+    int64_t utcUs;
+    TEST_ASSERT_TRUE(sweepClock->isLocked(localAt(last, 500)));
+    TEST_ASSERT_TRUE(sweepClock->toUtc(localAt(last, 500), utcUs));
+    TEST_ASSERT_TRUE(utcUs == last * 1000000 + 500000);
+}
+
+void test_dates_convert_to_utc_seconds(void) {
+    // Leap days, century rules and the end of the two-digit year range
+    const int64_t seconds[] = {
+        946684800LL,               // 2000-01-01 00:00:00
+        951868799LL,               // 2000-02-29 23:59:59
+        1709251199LL,              // 2024-02-29 23:59:59
+        1767225600LL,              // 2026-01-01 00:00:00
+        4102444799LL,              // 2099-12-31 23:59:59
+    };
+    for (size_t i = 0; i < sizeof(seconds) / sizeof(seconds[0]); i++) {
+        char body[NMEA_SENTENCE_MAX];
+        rmcBody(body, sizeof(body), seconds[i], "", 'A');
+        send(body);
+        pollAt(0);
+        TEST_ASSERT_TRUE(pairer->getUtcSecond() == seconds[i]);
+    }
+}
+
+void test_fractional_void_and_corrupt_sentences_ignored(void) {
+    second(UTC_START_S);
+    int64_t named = pairer->getUtcSecond();
+    edge(localAt(UTC_START_S + 1, 0));
+
+    // Half a second in, a void fix, a bad checksum, a truncated line
+    char body[NMEA_SENTENCE_MAX];
+    rmcBody(body, sizeof(body), UTC_START_S + 1, ".50", 'A');
+    send(body);
+    rmcBody(body, sizeof(body), UTC_START_S + 1, ".00", 'V');
+    send(body);
+    rmcBody(body, sizeof(body), UTC_START_S + 1, ".00", 'A');
+    char line[NMEA_SENTENCE_MAX + 8];
+    snprintf(line, sizeof(line), "$%s*00\r\n", body);
+    sendRaw(line);
+    snprintf(line, sizeof(line), "$%.30s\r\n", body);
+    sendRaw(line);
+    pollAt(nextPoll(localAt(UTC_START_S + 1, RMC_DELAY_MS)));
+
+    TEST_ASSERT_EQUAL_INT(1, pairings);
+    TEST_ASSERT_TRUE(pairer->getUtcSecond() == named);
+
+    // The edge is still unpaired, so the good sentence takes it
+    sendRmc(UTC_START_S + 1);
+    pollAt(nextPoll(localAt(UTC_START_S + 1, RMC_DELAY_MS + 20)));
+    TEST_ASSERT_EQUAL_INT(2, pairings);
+}
+
+void test_one_pairing_per_edge(void) {
+    second(UTC_START_S);
+
+    // A repeated sentence before the next edge names nothing new
+    sendRmc(UTC_START_S);
+    pollAt(nextPoll(localAt(UTC_START_S, RMC_DELAY_MS + 100)));
+    TEST_ASSERT_EQUAL_INT(1, pairings);
+
+    // No edge for second 1 (PPS glitch): its sentence must not take edge 0
+    sendRmc(UTC_START_S + 1);
+    pollAt(nextPoll(localAt(UTC_START_S + 1, RMC_DELAY_MS)));
+    TEST_ASSERT_EQUAL_INT(1, pairings);
+
+    second(UTC_START_S + 2);
+    TEST_ASSERT_EQUAL_INT(2, pairings);
+    TEST_ASSERT_EQUAL_UINT32(2, sweepClock->getPulseCount());
+}
+
+void test_sentence_read_too_late_is_not_paired(void) {
+    second(UTC_START_S);
+
+    // The task stalled: the sentence is only read past the delay limit
+    edge(localAt(UTC_START_S + 1, 0));
+    sendRmc(UTC_START_S + 1);
+    pollAt(localAt(UTC_START_S + 1, GPS_NMEA_MAX_DELAY_MS + GPS_TASK_PERIOD_MS));
+    TEST_ASSERT_EQUAL_INT(1, pairings);
+
+    // Just inside it, the next one pairs
+    edge(localAt(UTC_START_S + 2, 0));
+    sendRmc(UTC_START_S + 2);
+    pollAt(localAt(UTC_START_S + 2, GPS_NMEA_MAX_DELAY_MS));
+    TEST_ASSERT_EQUAL_INT(2, pairings);
+}
+
+void test_sentence_split_across_polls(void) {
+    // At 9600 baud an RMC sentence takes about 70 ms: several task periods
+    edge(localAt(UTC_START_S, 0));
+    char body[NMEA_SENTENCE_MAX];
+    rmcBody(body, sizeof(body), UTC_START_S, ".00", 'A');
+    uint8_t sum = 0;
+    for (const char* p = body; *p; p++) sum ^= (uint8_t)*p;
+    char line[NMEA_SENTENCE_MAX + 8];
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+
+    size_t len = strlen(line);
+    char part[NMEA_SENTENCE_MAX + 8];
+    int64_t t = localAt(UTC_START_S, RMC_DELAY_MS);
+    for (size_t at = 0; at < len; at += 12, t += GPS_TASK_PERIOD_MS * 1000) {
+        snprintf(part, sizeof(part), "%.12s", line + at);
+        sendRaw(part);
+        pollAt(t);
+        TEST_ASSERT_EQUAL_INT(at + 12 >= len ? 1 : 0, pairings);
+    }
+    TEST_ASSERT_TRUE(pairer->getUtcSecond() == UTC_START_S);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_locks_from_sentences_over_year_end);
+    RUN_TEST(test_dates_convert_to_utc_seconds);
+    RUN_TEST(test_fractional_void_and_corrupt_sentences_ignored);
+    RUN_TEST(test_one_pairing_per_edge);
+    RUN_TEST(test_sentence_read_too_late_is_not_paired);
+    RUN_TEST(test_sentence_split_across_polls);
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+/**
+ * @file test_main.cpp
+ * @brief Sweep-step frames against the datasheet opcodes and registers
+ *
+ * Each chip's step is built at a known frequency and compared byte for
+ * byte with the frames the datasheets give: SetRfFrequency with the
+ * register value for that frequency, continuous SetRx, GetRssiInst with
+ * its two NOPs, and SetStandby(RC).
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "radio_chips.h"
+#include "radio_commands.h"
+
+static void assertFrame(const uint8_t* expected, int length, const RadioCommand& cmd) {
+    TEST_ASSERT_EQUAL_INT(length, cmd.length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, cmd.bytes, length);
+    for (int i = 0; i < RADIO_COMMAND_MAX; i++) TEST_ASSERT_EQUAL_HEX8(0, cmd.reply[i]);
+}
+
+// A read frame as it comes back: status, then RSSI as -2 * dBm
+static RadioCommand readReply(uint8_t status, uint8_t rssi) {
+    RadioCommand read;
+    memset(&read, 0, sizeof(read));
+    read.length = 3;
+    read.reply[1] = status;
+    read.reply[2] = rssi;
+    return read;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_sx126x_frequency_words(void) {
+    // Fxtal 32 MHz, 2^25 steps
+    TEST_ASSERT_EQUAL_HEX32(0x39300000, SX126xChip::frequencyWord(915.0));
+    TEST_ASSERT_EQUAL_HEX32(0x36400000, SX126xChip::frequencyWord(868.0));
+    TEST_ASSERT_EQUAL_HEX32(0x36C00000, SX126xChip::frequencyWord(876.0));
+    TEST_ASSERT_EQUAL_HEX32(0x3A200000, SX126xChip::frequencyWord(930.0));
+    // A plan step is 0.5 MHz: 2^19 register steps
+    TEST_ASSERT_EQUAL_HEX32(0x00080000, SX126xChip::frequencyWord(915.5) - SX126xChip::frequencyWord(915.0));
+}
+
+void test_sx128x_frequency_words(void) {
+    // Fxtal 52 MHz, 2^18 steps; rounded to the nearest step
+    TEST_ASSERT_EQUAL_HEX32(0xBC7627, SX128xChip::frequencyWord(2450.0));
+    TEST_ASSERT_EQUAL_HEX32(0xB89D8A, SX128xChip::frequencyWord(2400.0));
+    TEST_ASSERT_EQUAL_HEX32(0xC04EC5, SX128xChip::frequencyWord(2500.0));
+}
+
+void test_sx126x_step_at_915(void) {
+    RadioStep step;
+    SX126xCommands::buildStep(step, SX126xChip::frequencyWord(915.0));
+
+    const uint8_t tune[] = { 0x86, 0x39, 0x30, 0x00, 0x00 };
+    const uint8_t receive[] = { 0x82, 0xFF, 0xFF, 0xFF };
+    const uint8_t read[] = { 0x15, 0x00, 0x00 };
+    const uint8_t standby[] = { 0x80, 0x00 };
+    assertFrame(tune, sizeof(tune), step.commands[RADIO_STEP_TUNE]);
+    assertFrame(receive, sizeof(receive), step.commands[RADIO_STEP_RECEIVE]);
+    assertFrame(read, sizeof(read), step.commands[RADIO_STEP_READ_RSSI]);
+    assertFrame(standby, sizeof(standby), step.commands[RADIO_STEP_STANDBY]);
+}
+
+void test_sx128x_step_at_2450(void) {
+    RadioStep step;
+    SX128xCommands::buildStep(step, SX128xChip::frequencyWord(2450.0));
+
+    const uint8_t tune[] = { 0x86, 0xBC, 0x76, 0x27 };
+    const uint8_t receive[] = { 0x82, 0x00, 0xFF, 0xFF };
+    const uint8_t read[] = { 0x1F, 0x00, 0x00 };
+    const uint8_t standby[] = { 0x80, 0x00 };
+    assertFrame(tune, sizeof(tune), step.commands[RADIO_STEP_TUNE]);
+    assertFrame(receive, sizeof(receive), step.commands[RADIO_STEP_RECEIVE]);
+    assertFrame(read, sizeof(read), step.commands[RADIO_STEP_READ_RSSI]);
+    assertFrame(standby, sizeof(standby), step.commands[RADIO_STEP_STANDBY]);
+}
+
+void test_retune_patches_only_the_tune_frame(void) {
+    RadioStep step;
+    SX126xCommands::buildStep(step, SX126xChip::frequencyWord(915.0));
+    RadioStep before = step;
+
+    // Replies from the last step are cleared with the new word
+    step.commands[RADIO_STEP_TUNE].reply[0] = 0xA2;
+    SX126xCommands::setFrequency(step, SX126xChip::frequencyWord(868.0));
+    const uint8_t tune[] = { 0x86, 0x36, 0x40, 0x00, 0x00 };
+    assertFrame(tune, sizeof(tune), step.commands[RADIO_STEP_TUNE]);
+    for (int i = RADIO_STEP_RECEIVE; i < RADIO_STEP_COMMANDS; i++) {
+        TEST_ASSERT_EQUAL_MEMORY(&before.commands[i], &step.commands[i], sizeof(RadioCommand));
+    }
+
+    SX128xCommands::buildStep(step, SX128xChip::frequencyWord(2450.0));
+    SX128xCommands::setFrequency(step, SX128xChip::frequencyWord(2500.0));
+    const uint8_t tune128[] = { 0x86, 0xC0, 0x4E, 0xC5 };
+    assertFrame(tune128, sizeof(tune128), step.commands[RADIO_STEP_TUNE]);
+}
+
+void test_sx126x_rssi_reply(void) {
+    float dbm = 0;
+
+    // Status 0x52: mode RX (5) in bits 6:4, command status 1; 0xA0 is -80 dBm
+    TEST_ASSERT_TRUE(SX126xCommands::parseRssi(readReply(0x52, 0xA0), dbm));
+    TEST_ASSERT_EQUAL_FLOAT(-80.0f, dbm);
+    TEST_ASSERT_TRUE(SX126xCommands::parseRssi(readReply(0x52, 0xDB), dbm));
+    TEST_ASSERT_EQUAL_FLOAT(-109.5f, dbm);
+
+    // STBY_RC (2): the tune was rejected, or the chip reset
+    dbm = 1;
+    TEST_ASSERT_FALSE(SX126xCommands::parseRssi(readReply(0x22, 0xA0), dbm));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, dbm);
+    // The SX128x's RX status means something else here
+    TEST_ASSERT_FALSE(SX126xCommands::parseRssi(readReply(0xA0, 0xA0), dbm));
+}
+
+void test_sx128x_rssi_reply(void) {
+    float dbm = 0;
+
+    // Status 0xA4: mode RX (5) in bits 7:5, command status 1
+    TEST_ASSERT_TRUE(SX128xCommands::parseRssi(readReply(0xA4, 0x78), dbm));
+    TEST_ASSERT_EQUAL_FLOAT(-60.0f, dbm);
+
+    TEST_ASSERT_FALSE(SX128xCommands::parseRssi(readReply(0x44, 0x78), dbm));
+    TEST_ASSERT_FALSE(SX128xCommands::parseRssi(readReply(0x52, 0x78), dbm));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sx126x_frequency_words);
+    RUN_TEST(test_sx128x_frequency_words);
+    RUN_TEST(test_sx126x_step_at_915);
+    RUN_TEST(test_sx128x_step_at_2450);
+    RUN_TEST(test_retune_patches_only_the_tune_frame);
+    RUN_TEST(test_sx126x_rssi_reply);
+    RUN_TEST(test_sx128x_rssi_reply);
+    return UNITY_END();
+}
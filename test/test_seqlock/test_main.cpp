@@ -0,0 +1,127 @@
+/**
+ * @file test_main.cpp
+ * @brief SeqLock under a writer racing several readers
+ *
+ * Every published value is self-checking: each word is derived from the
+ * publish number, so a copy mixing two publishes shows up as words that
+ * disagree. Threads only record what they saw; the checks run after join.
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "seqlock.h"
+
+#define STRESS_PUBLISHES 200000
+#define STRESS_READERS 3
+#define STRESS_WORDS 61            // Odd size, larger than a cache line
+
+struct Stamped {
+    uint32_t version;
+    uint32_t words[STRESS_WORDS];
+};
+
+struct ReaderResult {
+    uint32_t reads;
+    uint32_t torn;                 // Words not matching the version
+    uint32_t mismatched;           // Version not matching read()'s count
+    uint32_t backwards;            // Older than a previous read
+    uint32_t lastVersion;
+};
+
+static uint32_t stamp(uint32_t version, int i) {
+    return version * 2654435761u + (uint32_t)i * 40503u;
+}
+
+static void fill(Stamped& s, uint32_t version) {
+    s.version = version;
+    for (int i = 0; i < STRESS_WORDS; i++) s.words[i] = stamp(version, i);
+}
+
+static void writer(SeqLock<Stamped>* lock, std::atomic<bool>* done) {
+    Stamped s;
+    for (uint32_t v = 1; v <= STRESS_PUBLISHES; v++) {
+        fill(s, v);
+        lock->publish(s);
+        // Let the readers in mid-stream on a single core as well
+        if ((v & 255) == 0) std::this_thread::yield();
+    }
+    done->store(true);
+}
+
+static void reader(SeqLock<Stamped>* lock, std::atomic<bool>* done, ReaderResult* r) {
+    Stamped s;
+    memset(r, 0, sizeof(*r));
+    while (!done->load()) {
+        uint32_t count = lock->read(s);
+        r->reads++;
+        if (s.version != count) r->mismatched++;
+        if (s.version < r->lastVersion) r->backwards++;
+        r->lastVersion = s.version;
+        // Version 0 is the zeroed initial value
+        for (int i = 0; i < STRESS_WORDS; i++) {
+            if (s.words[i] != (s.version == 0 ? 0 : stamp(s.version, i))) {
+                r->torn++;
+                break;
+            }
+        }
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_readers_never_see_a_torn_value(void) {
+    static SeqLock<Stamped> lock;
+    std::atomic<bool> done(false);
+    ReaderResult results[STRESS_READERS];
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        threads.emplace_back(reader, &lock, &done, &results[i]);
+    }
+    threads.emplace_back(writer, &lock, &done);
+    for (std::thread& t : threads) t.join();
+
+    uint32_t totalReads = 0;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, results[i].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, results[i].mismatched);
+        TEST_ASSERT_EQUAL_UINT32(0, results[i].backwards);
+        totalReads += results[i].reads;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(STRESS_READERS, totalReads);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_PUBLISHES, lock.getVersion());
+
+    // After the writer stops, everyone gets the last value
+    Stamped last;
+    TEST_ASSERT_EQUAL_UINT32(STRESS_PUBLISHES, lock.read(last));
+    TEST_ASSERT_EQUAL_UINT32(STRESS_PUBLISHES, last.version);
+}
+
+void test_versions_count_publishes(void) {
+    SeqLock<Stamped> lock;
+    Stamped a, b, out;
+    fill(a, 1);
+    fill(b, 2);
+    TEST_ASSERT_EQUAL_UINT32(0, lock.getVersion());
+    lock.publish(a);
+
+    TEST_ASSERT_EQUAL_UINT32(1, lock.read(out));
+    TEST_ASSERT_EQUAL_MEMORY(&a, &out, sizeof(out));
+    lock.publish(b);
+    TEST_ASSERT_EQUAL_UINT32(2, lock.read(out));
+    TEST_ASSERT_EQUAL_MEMORY(&b, &out, sizeof(out));
+    TEST_ASSERT_EQUAL_UINT32(2, lock.getVersion());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_readers_never_see_a_torn_value);
+    RUN_TEST(test_versions_count_publishes);
+    return UNITY_END();
+}
@@ -0,0 +1,270 @@
+/**
+ * @file test_main.cpp
+ * @brief SpectralScan against a mock radio playing scripted RSSI
+ *
+ * The mock bins each scripted sample the way the SX126x scan does, bin 0
+ * at SPECTRAL_BIN0_DBM and SPECTRAL_BIN_DB per bin downwards, and keeps
+ * virtual time: the scan finishes once its samples have been taken.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "spectral_scan.h"
+
+#define MAX_SCRIPT 1024
+
+class MockSpectralRadio : public SpectralRadio {
+public:
+    MockSpectralRadio() {
+        now = 1000;
+        scriptLength = 0;
+        lagUs = 0;
+        refuseStart = false;
+        failRead = false;
+        hang = false;
+        running = false;
+        stops = 0;
+        sleeps = 0;
+        lastFreq = 0;
+    }
+
+    // Levels the next scan samples, repeated to fill it
+    void script(const int8_t* levels, int count) {
+        memcpy(rssi, levels, count);
+        scriptLength = count;
+    }
+
+    bool start(float freq, uint16_t samples) override {
+        if (refuseStart) return false;
+        lastFreq = freq;
+        sampleCount = samples;
+        startUs = now;
+        running = true;
+
+        memset(bins, 0, sizeof(bins));
+        for (int i = 0; i < samples; i++) {
+            int level = rssi[i % scriptLength];
+            int bin = (SPECTRAL_BIN0_DBM - level) / SPECTRAL_BIN_DB;
+            if (bin < 0) bin = 0;
+            if (bin >= SPECTRAL_BINS) bin = SPECTRAL_BINS - 1;
+            bins[bin]++;
+        }
+        return true;
+    }
+
+    bool finished() override {
+        return running && !hang &&
+               now - startUs >= (uint32_t)sampleCount * SPECTRAL_SAMPLE_US + lagUs;
+    }
+
+    bool readHistogram(uint16_t* out) override {
+        running = false;
+        if (failRead) return false;
+        memcpy(out, bins, sizeof(bins));
+        return true;
+    }
+
+    void stop() override {
+        running = false;
+        stops++;
+    }
+
+    void sleepUs(uint32_t us) override {
+        now += us;
+        sleeps++;
+    }
+
+    uint32_t nowUs() override {
+        return now;
+    }
+
+    uint32_t now;
+    uint32_t lagUs;                // Extra chip time beyond the samples
+    bool refuseStart;
+    bool failRead;
+    bool hang;                     // Never reports completion
+    int stops;
+    int sleeps;
+    float lastFreq;
+    uint16_t bins[SPECTRAL_BINS];
+
+private:
+    int8_t rssi[MAX_SCRIPT];
+    int scriptLength;
+    uint16_t sampleCount;
+    uint32_t startUs;
+    bool running;
+};
+
+static MockSpectralRadio* radio;
+static SpectralScan* scan;
+
+void setUp(void) {
+    radio = new MockSpectralRadio();
+    scan = new SpectralScan();
+    scan->begin(radio, SPECTRAL_SAMPLES, SPECTRAL_SAMPLE_US, SPECTRAL_TIMEOUT_MS * 1000UL);
+}
+
+void tearDown(void) {
+    delete scan;
+    delete radio;
+}
+
+void test_bursty_channel(void) {
+    // A quarter of the time a -40 dBm burst, the rest at -100 dBm
+    int8_t levels[8] = {-40, -40, -100, -100, -100, -100, -100, -100};
+    radio->script(levels, 8);
+
+    SpectralStats stats;
+    TEST_ASSERT_TRUE(scan->measure(915.0f, -80, stats));
+    TEST_ASSERT_EQUAL_FLOAT(915.0f, radio->lastFreq);
+
+    // -40 lands in bin 7 (-39 dBm), -100 in bin 22 (-99 dBm)
+    TEST_ASSERT_EQUAL_UINT16(SPECTRAL_SAMPLES / 4, radio->bins[7]);
+    TEST_ASSERT_EQUAL_UINT16(SPECTRAL_SAMPLES * 3 / 4, radio->bins[22]);
+    TEST_ASSERT_EQUAL_INT(-39, spectralBinDbm(7));
+    TEST_ASSERT_EQUAL_INT(-99, spectralBinDbm(22));
+
+    TEST_ASSERT_EQUAL_INT8(-39, stats.peakDbm);
+    TEST_ASSERT_EQUAL_INT8(-84, stats.meanDbm);        // (-39 + 3 * -99) / 4
+    TEST_ASSERT_EQUAL_UINT8(25, stats.occupancy);
+    TEST_ASSERT_EQUAL_UINT16(SPECTRAL_SAMPLES, stats.samples);
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_IDLE, scan->getState());
+    TEST_ASSERT_EQUAL_UINT32(1, scan->getScanCount());
+}
+
+void test_quiet_channel(void) {
+    int8_t levels[1] = {-110};
+    radio->script(levels, 1);
+
+    SpectralStats stats;
+    TEST_ASSERT_TRUE(scan->measure(902.0f, -80, stats));
+    TEST_ASSERT_EQUAL_INT8(spectralBinDbm(24), stats.peakDbm);
+    TEST_ASSERT_EQUAL_INT8(stats.peakDbm, stats.meanDbm);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.occupancy);
+}
+
+void test_overload_and_floor(void) {
+    // Stronger than bin 0, and as weak as an int8 goes
+    int8_t levels[2] = {0, -128};
+    radio->script(levels, 2);
+
+    SpectralStats stats;
+    TEST_ASSERT_TRUE(scan->measure(868.0f, -80, stats));
+    TEST_ASSERT_EQUAL_UINT16(SPECTRAL_SAMPLES / 2, radio->bins[0]);
+    TEST_ASSERT_EQUAL_UINT16(SPECTRAL_SAMPLES / 2, radio->bins[29]);
+    TEST_ASSERT_EQUAL_INT8(SPECTRAL_BIN0_DBM, stats.peakDbm);
+    TEST_ASSERT_EQUAL_INT8((SPECTRAL_BIN0_DBM + spectralBinDbm(29)) / 2, stats.meanDbm);
+    TEST_ASSERT_EQUAL_UINT8(50, stats.occupancy);
+}
+
+void test_measure_sleeps_through_the_scan(void) {
+    int8_t levels[1] = {-90};
+    radio->script(levels, 1);
+    radio->lagUs = 500;
+
+    SpectralStats stats;
+    uint32_t before = radio->now;
+    TEST_ASSERT_TRUE(scan->measure(915.0f, -80, stats));
+
+    // One long sleep for the samples, then short polls for the lag
+    uint32_t scanUs = SPECTRAL_SAMPLES * SPECTRAL_SAMPLE_US + 500;
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(scanUs, radio->now - before);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(scanUs + 200, radio->now - before);
+    TEST_ASSERT_LESS_OR_EQUAL_INT(1 + 3, radio->sleeps);
+}
+
+void test_stalled_scan_times_out(void) {
+    int8_t levels[1] = {-90};
+    radio->script(levels, 1);
+    radio->hang = true;
+
+    SpectralStats stats;
+    TEST_ASSERT_FALSE(scan->measure(915.0f, -80, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, scan->getTimeoutCount());
+    TEST_ASSERT_EQUAL_UINT32(0, scan->getScanCount());
+    TEST_ASSERT_EQUAL_INT(1, radio->stops);
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_IDLE, scan->getState());
+
+    // The next channel scans normally
+    radio->hang = false;
+    TEST_ASSERT_TRUE(scan->measure(916.0f, -80, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, scan->getScanCount());
+}
+
+void test_step_by_step(void) {
+    int8_t levels[1] = {-70};
+    radio->script(levels, 1);
+    SpectralStats stats;
+
+    // Nothing to collect before a scan, and one scan at a time
+    TEST_ASSERT_FALSE(scan->collect(-80, stats));
+    TEST_ASSERT_TRUE(scan->start(915.0f));
+    TEST_ASSERT_FALSE(scan->start(916.0f));
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_SCANNING, scan->poll());
+    TEST_ASSERT_FALSE(scan->collect(-80, stats));
+
+    radio->sleepUs(SPECTRAL_SAMPLES * SPECTRAL_SAMPLE_US);
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_READY, scan->poll());
+    TEST_ASSERT_TRUE(scan->collect(-80, stats));
+    TEST_ASSERT_EQUAL_UINT8(100, stats.occupancy);
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_IDLE, scan->getState());
+}
+
+void test_radio_errors(void) {
+    int8_t levels[1] = {-70};
+    radio->script(levels, 1);
+    SpectralStats stats;
+
+    radio->refuseStart = true;
+    TEST_ASSERT_FALSE(scan->measure(915.0f, -80, stats));
+    TEST_ASSERT_EQUAL_INT(1, radio->stops);
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_IDLE, scan->getState());
+
+    radio->refuseStart = false;
+    radio->failRead = true;
+    TEST_ASSERT_FALSE(scan->measure(915.0f, -80, stats));
+    TEST_ASSERT_EQUAL_INT(SPECTRAL_IDLE, scan->getState());
+    TEST_ASSERT_EQUAL_UINT32(0, scan->getScanCount());
+}
+
+void test_reduce_edge_cases(void) {
+    uint16_t bins[SPECTRAL_BINS];
+    SpectralStats stats;
+
+    memset(bins, 0, sizeof(bins));
+    reduceSpectralHistogram(bins, -80, stats);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.samples);
+    TEST_ASSERT_EQUAL_INT8(-128, stats.peakDbm);
+    TEST_ASSERT_EQUAL_INT8(-128, stats.meanDbm);
+    TEST_ASSERT_EQUAL_UINT8(0, stats.occupancy);
+
+    // Occupancy rounds to the nearest percent; the sample count saturates
+    bins[5] = 1;
+    bins[20] = 2;
+    reduceSpectralHistogram(bins, -80, stats);
+    TEST_ASSERT_EQUAL_UINT8(33, stats.occupancy);
+    bins[5] = 2;
+    bins[20] = 1;
+    reduceSpectralHistogram(bins, -80, stats);
+    TEST_ASSERT_EQUAL_UINT8(67, stats.occupancy);
+
+    bins[5] = 0xFFFF;
+    bins[20] = 0xFFFF;
+    reduceSpectralHistogram(bins, -80, stats);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, stats.samples);
+    TEST_ASSERT_EQUAL_UINT8(50, stats.occupancy);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bursty_channel);
+    RUN_TEST(test_quiet_channel);
+    RUN_TEST(test_overload_and_floor);
+    RUN_TEST(test_measure_sleeps_through_the_scan);
+    RUN_TEST(test_stalled_scan_times_out);
+    RUN_TEST(test_step_by_step);
+    RUN_TEST(test_radio_errors);
+    RUN_TEST(test_reduce_edge_cases);
+    return UNITY_END();
+}
@@ -0,0 +1,293 @@
+/**
+ * @file test_main.cpp
+ * @brief SpurMask learning and calibration, through BandAnalyzer
+ *
+ * Rows of the 900MHz plan are made up of noise, the board's own spurs and
+ * outside emitters, and fed through a BandAnalyzer with the mask attached
+ * as the scan task does. A display flush covers part of every third
+ * sweep; the display spur is only there while it runs.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "band_analyzer.h"
+#include "spur_mask.h"
+
+#define CHANNELS CHANNELS_900
+#define NOISE_DBM -105
+#define FLUSH_FIRST 20             // Channels swept while the display flushes
+#define FLUSH_LAST 60
+#define DISPLAY_CH 40
+#define DISPLAY_SPUR_DBM -82
+#define STEADY_CH 90
+#define STEADY_SPUR_DBM -88
+
+static BandAnalyzer* analyzer;
+static SpurMask* mask;
+static uint32_t rngState;
+static int rowCount;
+
+static int noise() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return NOISE_DBM + (int)((rngState >> 16) % 5) - 2;
+}
+
+static bool flushing(int rowIndex) {
+    return rowIndex % 3 == 0;
+}
+
+// What is on the air besides the noise, for one row
+struct Scene {
+    bool displaySpur;
+    bool steadySpur;
+    int emitterCh;                 // -1 for none
+    int emitterDbm;
+    bool emitterEveryOther;        // Keyed on alternate sweeps
+};
+
+static Scene quietScene() {
+    Scene s;
+    s.displaySpur = false;
+    s.steadySpur = false;
+    s.emitterCh = -1;
+    s.emitterDbm = -128;
+    s.emitterEveryOther = false;
+    return s;
+}
+
+// Sweep one row and return whether anything was detected on a channel
+static bool sweepRow(const Scene& scene, int watchCh) {
+    bool flush = flushing(rowCount);
+    for (int ch = 0; ch < CHANNELS; ch++) {
+        int v = noise();
+        bool inFlush = flush && ch >= FLUSH_FIRST && ch <= FLUSH_LAST;
+        if (scene.displaySpur && inFlush && ch == DISPLAY_CH) v = DISPLAY_SPUR_DBM;
+        if (scene.steadySpur && ch == STEADY_CH) v = STEADY_SPUR_DBM;
+        if (ch == scene.emitterCh && (!scene.emitterEveryOther || rowCount % 2 == 0) &&
+            scene.emitterDbm > v) v = scene.emitterDbm;
+
+        analyzer->setSample(ch, (int8_t)v, (int8_t)v, 0);
+        if (inFlush) analyzer->markActivity(ch, SPUR_DISPLAY);
+    }
+    rowCount++;
+
+    EmitterCluster clusters[CLUSTER_MAX];
+    int n = analyzer->detect(clusters, CLUSTER_MAX);
+    for (int i = 0; i < n; i++) {
+        if (watchCh >= clusters[i].firstChannel && watchCh <= clusters[i].lastChannel) return true;
+    }
+    return false;
+}
+
+// Rows swept, and of those how many (during a flush, or not) saw watchCh
+struct Tally {
+    int flushRows;
+    int flushHits;
+    int idleRows;
+    int idleHits;
+};
+
+static Tally sweepRows(const Scene& scene, int rows, int watchCh) {
+    Tally t = { 0, 0, 0, 0 };
+    for (int r = 0; r < rows; r++) {
+        bool flush = flushing(rowCount);
+        bool hit = sweepRow(scene, watchCh);
+        if (flush) {
+            t.flushRows++;
+            if (hit) t.flushHits++;
+        } else {
+            t.idleRows++;
+            if (hit) t.idleHits++;
+        }
+    }
+    return t;
+}
+
+void setUp(void) {
+    analyzer = new BandAnalyzer();
+    mask = new SpurMask();
+    analyzer->begin(0, CHANNELS, FREQ_900_START, FREQ_900_STEP);
+    analyzer->setSpurMask(mask);
+    rngState = 1;
+    rowCount = 0;
+
+    // Floors settle on the noise first
+    sweepRows(quietScene(), 32, -1);
+}
+
+void tearDown(void) {
+    delete analyzer;
+    delete mask;
+}
+
+void test_display_spur_is_learned(void) {
+    Scene scene = quietScene();
+    scene.displaySpur = true;
+
+    // Until a learner window closes the spur is a detection on every flush
+    Tally before = sweepRows(scene, SPUR_LEARN_ROWS - 32 - 1, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_INT(before.flushRows, before.flushHits);
+    TEST_ASSERT_EQUAL_INT(0, before.idleHits);
+    TEST_ASSERT_EQUAL_INT(0, mask->getCount());
+
+    sweepRows(scene, 1, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_INT(1, mask->getCount());
+    TEST_ASSERT_EQUAL_HEX8(SPUR_DISPLAY, mask->getFlags(DISPLAY_CH));
+    TEST_ASSERT_EQUAL_INT8(DISPLAY_SPUR_DBM, mask->getLevel(DISPLAY_CH));
+
+    // From then on it is gone
+    Tally after = sweepRows(scene, 60, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_INT(0, after.flushHits);
+    TEST_ASSERT_EQUAL_INT(0, after.idleHits);
+
+    // A window with the display quiet clears the bit again
+    sweepRows(quietScene(), SPUR_LEARN_ROWS, -1);
+    TEST_ASSERT_EQUAL_HEX8(0, mask->getFlags(DISPLAY_CH));
+    TEST_ASSERT_EQUAL_INT8(-128, mask->getLevel(DISPLAY_CH));
+    TEST_ASSERT_EQUAL_INT(0, mask->getCount());
+}
+
+void test_emitter_on_spur_channel_stays_visible(void) {
+    Scene scene = quietScene();
+    scene.displaySpur = true;
+    sweepRows(scene, SPUR_LEARN_ROWS, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_HEX8(SPUR_DISPLAY, mask->getFlags(DISPLAY_CH));
+
+    // Above the spur plus the margin, it shows during flushes too
+    scene.emitterCh = DISPLAY_CH;
+    scene.emitterDbm = DISPLAY_SPUR_DBM + SPUR_MARGIN_DB + 10;
+    Tally strong = sweepRows(scene, 60, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_INT(strong.flushRows, strong.flushHits);
+    TEST_ASSERT_EQUAL_INT(strong.idleRows, strong.idleHits);
+
+    // Weaker than the spur, it still shows whenever the display is idle
+    scene.emitterDbm = DISPLAY_SPUR_DBM - 4;
+    Tally weak = sweepRows(scene, 60, DISPLAY_CH);
+    TEST_ASSERT_EQUAL_INT(0, weak.flushHits);
+    TEST_ASSERT_EQUAL_INT(weak.idleRows, weak.idleHits);
+}
+
+void test_outside_emitter_is_not_learned(void) {
+    // Keyed on and off regardless of the display, inside the flush span
+    Scene scene = quietScene();
+    scene.emitterCh = 30;
+    scene.emitterDbm = -80;
+    scene.emitterEveryOther = true;
+
+    Tally t = sweepRows(scene, 2 * SPUR_LEARN_ROWS, 30);
+    TEST_ASSERT_EQUAL_INT(0, mask->getCount());
+    TEST_ASSERT_EQUAL_INT(t.flushRows + t.idleRows, 2 * (t.flushHits + t.idleHits));
+}
+
+void test_calibration_masks_steady_spurs(void) {
+    Scene scene = quietScene();
+    scene.steadySpur = true;
+    Tally before = sweepRows(scene, 16, STEADY_CH);
+    TEST_ASSERT_EQUAL_INT(16, before.flushHits + before.idleHits);
+
+    // An emitter on half the sweeps is not steady enough to mask
+    scene.emitterCh = 110;
+    scene.emitterDbm = -85;
+    scene.emitterEveryOther = true;
+    mask->calibrate(SPUR_CALIBRATE_ROWS);
+    TEST_ASSERT_TRUE(mask->isCalibrating());
+    sweepRows(scene, SPUR_CALIBRATE_ROWS, -1);
+    TEST_ASSERT_FALSE(mask->isCalibrating());
+
+    TEST_ASSERT_EQUAL_INT(1, mask->getCount());
+    TEST_ASSERT_EQUAL_HEX8(SPUR_ALWAYS, mask->getFlags(STEADY_CH));
+    TEST_ASSERT_EQUAL_INT8(STEADY_SPUR_DBM, mask->getLevel(STEADY_CH));
+    TEST_ASSERT_EQUAL_HEX8(0, mask->getFlags(110));
+
+    Tally after = sweepRows(scene, 30, STEADY_CH);
+    TEST_ASSERT_EQUAL_INT(0, after.flushHits + after.idleHits);
+
+    // A real emitter on the spur's channel comes through
+    scene.emitterCh = STEADY_CH;
+    scene.emitterDbm = STEADY_SPUR_DBM + SPUR_MARGIN_DB + 8;
+    scene.emitterEveryOther = false;
+    Tally emitter = sweepRows(scene, 30, STEADY_CH);
+    TEST_ASSERT_EQUAL_INT(30, emitter.flushHits + emitter.idleHits);
+}
+
+void test_recalibration_keeps_the_display_level(void) {
+    // A strong steady spur and a weaker display one on the same channel
+    const int8_t steadyDbm = -70;
+    int8_t row[CHANNELS];
+    int8_t threshold[CHANNELS];
+    uint8_t activity[CHANNELS];
+    uint8_t masked[CHANNELS];
+    memset(threshold, -95, sizeof(threshold));
+    delete mask;
+    mask = new SpurMask();
+
+    // A learner window with only the display spur, then a calibration with
+    // the steady one on top
+    for (int r = 0; r < SPUR_LEARN_ROWS + SPUR_CALIBRATE_ROWS; r++) {
+        if (r == SPUR_LEARN_ROWS) mask->calibrate(SPUR_CALIBRATE_ROWS);
+        memset(row, NOISE_DBM, sizeof(row));
+        memset(activity, 0, sizeof(activity));
+        if (flushing(r)) {
+            activity[DISPLAY_CH] = SPUR_DISPLAY;
+            row[DISPLAY_CH] = DISPLAY_SPUR_DBM;
+        }
+        if (r >= SPUR_LEARN_ROWS) row[DISPLAY_CH] = steadyDbm;
+        mask->learn(row, threshold, activity, CHANNELS);
+    }
+    TEST_ASSERT_EQUAL_HEX8(SPUR_ALWAYS | SPUR_DISPLAY, mask->getFlags(DISPLAY_CH));
+    TEST_ASSERT_EQUAL_INT8(steadyDbm, mask->getLevel(DISPLAY_CH));
+
+    // The steady spur is gone by the next calibration: the channel falls
+    // back to the display spur's own level, not the old steady one
+    mask->calibrate(SPUR_CALIBRATE_ROWS);
+    for (int r = 0; r < SPUR_CALIBRATE_ROWS; r++) {
+        memset(row, NOISE_DBM, sizeof(row));
+        memset(activity, 0, sizeof(activity));
+        if (flushing(r)) {
+            activity[DISPLAY_CH] = SPUR_DISPLAY;
+            row[DISPLAY_CH] = DISPLAY_SPUR_DBM;
+        }
+        mask->learn(row, threshold, activity, CHANNELS);
+    }
+    TEST_ASSERT_FALSE(mask->isCalibrating());
+    TEST_ASSERT_EQUAL_HEX8(SPUR_DISPLAY, mask->getFlags(DISPLAY_CH));
+    TEST_ASSERT_EQUAL_INT8(DISPLAY_SPUR_DBM, mask->getLevel(DISPLAY_CH));
+
+    // Raised to the display level during a flush, untouched otherwise
+    memset(activity, 0, sizeof(activity));
+    activity[DISPLAY_CH] = SPUR_DISPLAY;
+    TEST_ASSERT_EQUAL_INT(1, mask->apply(threshold, activity, masked, CHANNELS));
+    TEST_ASSERT_EQUAL_INT8(DISPLAY_SPUR_DBM + SPUR_MARGIN_DB, threshold[DISPLAY_CH]);
+
+    memset(threshold, -95, sizeof(threshold));
+    memset(activity, 0, sizeof(activity));
+    TEST_ASSERT_EQUAL_INT(0, mask->apply(threshold, activity, masked, CHANNELS));
+    TEST_ASSERT_EQUAL_INT8(-95, threshold[DISPLAY_CH]);
+}
+
+void test_clear_forgets_everything(void) {
+    Scene scene = quietScene();
+    scene.displaySpur = true;
+    scene.steadySpur = true;
+    mask->calibrate(SPUR_CALIBRATE_ROWS);
+    sweepRows(scene, SPUR_LEARN_ROWS, -1);
+    TEST_ASSERT_EQUAL_INT(2, mask->getCount());
+
+    mask->clear();
+    TEST_ASSERT_EQUAL_INT(0, mask->getCount());
+    TEST_ASSERT_EQUAL_HEX8(0, mask->getFlags(STEADY_CH));
+    TEST_ASSERT_EQUAL_INT8(-128, mask->getLevel(DISPLAY_CH));
+    Tally t = sweepRows(scene, 9, STEADY_CH);
+    TEST_ASSERT_EQUAL_INT(9, t.flushHits + t.idleHits);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_display_spur_is_learned);
+    RUN_TEST(test_emitter_on_spur_channel_stays_visible);
+    RUN_TEST(test_outside_emitter_is_not_learned);
+    RUN_TEST(test_calibration_masks_steady_spurs);
+    RUN_TEST(test_recalibration_keeps_the_display_level);
+    RUN_TEST(test_clear_forgets_everything);
+    return UNITY_END();
+}
@@ -0,0 +1,270 @@
+/**
+ * @file test_main.cpp
+ * @brief Survey totals, time buckets and their merging, and planning
+ *
+ * Rows are flat levels with every channel above or below threshold, fed
+ * on a simulated clock, so each bucket's expected max, mean and occupancy
+ * follow from the sweeps it covers. Buffers of two and four buckets make
+ * the pair merges happen after a handful of closes.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "survey.h"
+
+#define SWEEP_MS 1000              // Simulated time between rows
+
+static Survey* survey;
+static uint8_t* buffer;
+static uint32_t rngState;
+
+static int8_t row[SWEEP_ROW_MAX];
+static uint8_t hits[SWEEP_ROW_MAX];
+static int8_t maxRow[SWEEP_ROW_MAX];
+static int8_t meanRow[SWEEP_ROW_MAX];
+static uint8_t occRow[SWEEP_ROW_MAX];
+
+static int channelCount(uint8_t band) {
+    return band == 0 ? CHANNELS_900 : CHANNELS_2400;
+}
+
+static uint32_t randomBelow(uint32_t range) {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (rngState >> 8) % range;
+}
+
+// Give the survey a buffer of this many buckets
+static void withBuckets(int count) {
+    free(buffer);
+    buffer = (uint8_t*)malloc((size_t)count * SURVEY_BUCKET_BYTES);
+    survey->begin(buffer, (size_t)count * SURVEY_BUCKET_BYTES);
+}
+
+// One row at a flat level, every channel above threshold or none
+static void addFlat(uint8_t band, int8_t dbm, bool above, uint32_t nowMs) {
+    memset(row, dbm, sizeof(row));
+    memset(hits, above ? 1 : 0, sizeof(hits));
+    survey->addRow(band, row, hits, nowMs);
+}
+
+static void expectBucket(int index, uint8_t band, int8_t max, int8_t mean, uint8_t occupancy) {
+    TEST_ASSERT_TRUE(survey->getBucket(index, band, maxRow, meanRow, occRow));
+    for (int ch = 0; ch < channelCount(band); ch++) {
+        TEST_ASSERT_EQUAL_INT8(max, maxRow[ch]);
+        TEST_ASSERT_EQUAL_INT8(mean, meanRow[ch]);
+        TEST_ASSERT_EQUAL_UINT8(occupancy, occRow[ch]);
+    }
+}
+
+void setUp(void) {
+    survey = new Survey();
+    buffer = nullptr;
+    rngState = 4242;
+    memset(row, 0, sizeof(row));
+    memset(hits, 0, sizeof(hits));
+}
+
+void tearDown(void) {
+    delete survey;
+    free(buffer);
+}
+
+void test_totals_track_each_channel(void) {
+    survey->begin(nullptr, 0);
+    survey->start(0);
+    addFlat(0, -90, false, 0);
+    addFlat(0, -70, true, SWEEP_MS);
+    addFlat(0, -80, false, 2 * SWEEP_MS);
+    addFlat(0, -60, true, 3 * SWEEP_MS);
+
+    SurveyView view;
+    survey->getView(view);
+    TEST_ASSERT_TRUE(view.running);
+    TEST_ASSERT_EQUAL_UINT32(3 * SWEEP_MS, view.elapsedMs);
+    TEST_ASSERT_EQUAL_UINT16(0, view.bucketCapacity);
+
+    const SurveyTrace& t = view.bands[0];
+    TEST_ASSERT_EQUAL_UINT32(4, t.sweeps);
+    for (int ch = 0; ch < CHANNELS_900; ch++) {
+        TEST_ASSERT_EQUAL_INT8(-60, t.maxHold[ch]);
+        TEST_ASSERT_EQUAL_INT8(-90, t.minHold[ch]);
+        TEST_ASSERT_EQUAL_INT(-75 * (1 << NOISE_FLOOR_FRAC_BITS), t.meanQ[ch]);
+        TEST_ASSERT_EQUAL_UINT8(50, t.occupancy[ch]);
+    }
+
+    // The other band saw nothing: the empty sentinel
+    TEST_ASSERT_EQUAL_UINT32(0, view.bands[1].sweeps);
+    TEST_ASSERT_EQUAL_INT(-128 * (1 << NOISE_FLOOR_FRAC_BITS), view.bands[1].meanQ[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, view.bands[1].occupancy[0]);
+
+    // Stopped time doesn't count, and rows are ignored until restarted
+    survey->stop(4 * SWEEP_MS);
+    addFlat(0, -20, true, 5 * SWEEP_MS);
+    survey->getView(view);
+    TEST_ASSERT_FALSE(view.running);
+    TEST_ASSERT_EQUAL_UINT32(4 * SWEEP_MS, view.elapsedMs);
+    TEST_ASSERT_EQUAL_UINT32(4, view.bands[0].sweeps);
+    TEST_ASSERT_EQUAL_INT8(-60, view.bands[0].maxHold[0]);
+}
+
+void test_buckets_close_on_time_with_empty_sentinel(void) {
+    withBuckets(4);
+    survey->start(0);
+
+    // One bucket of 900MHz rows only, then one of both bands
+    uint32_t now = 0;
+    for (; now < SURVEY_BUCKET_MS; now += SWEEP_MS) {
+        addFlat(0, now < SURVEY_BUCKET_MS / 2 ? -90 : -70, now < SURVEY_BUCKET_MS / 4, now);
+    }
+    for (; now < 2 * SURVEY_BUCKET_MS; now += SWEEP_MS) {
+        addFlat(0, -100, false, now);
+        addFlat(1, -85, true, now);
+    }
+    addFlat(0, -100, false, now);          // Closes the second
+
+    SurveyView view;
+    survey->getView(view);
+    TEST_ASSERT_EQUAL_UINT16(2, view.bucketCount);
+    TEST_ASSERT_EQUAL_UINT16(4, view.bucketCapacity);
+    TEST_ASSERT_EQUAL_UINT32(SURVEY_BUCKET_MS, view.bucketMs);
+
+    expectBucket(0, 0, -70, -80, 25);
+    expectBucket(0, 1, -128, -128, 0);
+    expectBucket(1, 0, -100, -100, 0);
+    expectBucket(1, 1, -85, -85, 100);
+    TEST_ASSERT_FALSE(survey->getBucket(2, 0, maxRow, meanRow, occRow));
+    TEST_ASSERT_FALSE(survey->getBucket(-1, 0, maxRow, meanRow, occRow));
+}
+
+void test_short_bucket_from_stop_is_weighted_by_its_sweeps(void) {
+    withBuckets(2);
+    survey->start(0);
+
+    // A full quiet bucket, then one busy sweep before stop() closes it
+    int full = SURVEY_BUCKET_MS / SWEEP_MS;
+    uint32_t now = 0;
+    for (int i = 0; i < full; i++, now += SWEEP_MS) addFlat(0, -90, false, now);
+    addFlat(0, -30, true, now);
+    addFlat(1, -60, true, now);
+    survey->stop(now + 1);
+
+    // The pair merged at once: one bucket, twice as long
+    SurveyView view;
+    survey->getView(view);
+    TEST_ASSERT_EQUAL_UINT16(1, view.bucketCount);
+    TEST_ASSERT_EQUAL_UINT32(2 * SURVEY_BUCKET_MS, view.bucketMs);
+
+    // One sweep in full + 1 moves the mean by a dB and occupancy by 2%,
+    // not halfway; the other band's empty half doesn't dilute its one sweep
+    long mean = lround((-90.0 * full - 30.0) / (full + 1));
+    long occupancy = lround(100.0 / (full + 1));
+    expectBucket(0, 0, -30, (int8_t)mean, (uint8_t)occupancy);
+    expectBucket(0, 1, -60, -60, 100);
+}
+
+void test_merged_buckets_agree_with_totals(void) {
+    // With two buckets every close merges, so the one bucket left always
+    // covers the whole survey and must match the totals however unevenly
+    // the runs were cut
+    withBuckets(2);
+    uint32_t now = 0;
+    for (int run = 0; run < 40; run++) {
+        survey->start(now);
+        int rows = 1 + (int)randomBelow(150);
+        for (int i = 0; i < rows; i++, now += SWEEP_MS) {
+            int8_t dbm = (int8_t)(-110 + (int)randomBelow(60));
+            addFlat(0, dbm, dbm > -80, now);
+        }
+        survey->stop(now);
+        now += 10 * SWEEP_MS;
+    }
+
+    SurveyView view;
+    survey->getView(view);
+    TEST_ASSERT_EQUAL_UINT16(1, view.bucketCount);
+    const SurveyTrace& t = view.bands[0];
+    TEST_ASSERT_TRUE(survey->getBucket(0, 0, maxRow, meanRow, occRow));
+    TEST_ASSERT_EQUAL_INT8(t.maxHold[0], maxRow[0]);
+    TEST_ASSERT_INT32_WITHIN(2, t.meanQ[0] / (1 << NOISE_FLOOR_FRAC_BITS), meanRow[0]);
+    TEST_ASSERT_INT32_WITHIN(2, t.occupancy[0], occRow[0]);
+}
+
+void test_reset_clears_buckets(void) {
+    withBuckets(4);
+    survey->start(0);
+    for (uint32_t now = 0; now <= SURVEY_BUCKET_MS; now += SWEEP_MS) addFlat(0, -90, false, now);
+
+    survey->reset(SURVEY_BUCKET_MS);
+    SurveyView view;
+    survey->getView(view);
+    TEST_ASSERT_TRUE(view.running);
+    TEST_ASSERT_EQUAL_UINT16(0, view.bucketCount);
+    TEST_ASSERT_EQUAL_UINT32(0, view.elapsedMs);
+    TEST_ASSERT_EQUAL_UINT32(0, view.bands[0].sweeps);
+    TEST_ASSERT_FALSE(survey->getBucket(0, 0, maxRow, meanRow, occRow));
+}
+
+void test_plan_floors_uses_min_hold_on_busy_channels(void) {
+    SurveyTrace trace;
+    memset(&trace, 0, sizeof(trace));
+    for (int ch = 0; ch < 4; ch++) {
+        trace.minHold[ch] = -110;
+        trace.meanQ[ch] = -100 * (1 << NOISE_FLOOR_FRAC_BITS) + ch;
+    }
+    trace.occupancy[0] = 0;
+    trace.occupancy[1] = SURVEY_BUSY_PERCENT - 1;
+    trace.occupancy[2] = SURVEY_BUSY_PERCENT;
+    trace.occupancy[3] = 100;
+
+    int16_t floors[4];
+    Survey::planFloors(trace, 4, floors);
+    TEST_ASSERT_EQUAL_INT(trace.meanQ[0], floors[0]);
+    TEST_ASSERT_EQUAL_INT(trace.meanQ[1], floors[1]);
+    TEST_ASSERT_EQUAL_INT(-110 * (1 << NOISE_FLOOR_FRAC_BITS), floors[2]);
+    TEST_ASSERT_EQUAL_INT(-110 * (1 << NOISE_FLOOR_FRAC_BITS), floors[3]);
+}
+
+void test_busy_channels_one_per_run_busiest_first(void) {
+    SurveyTrace trace;
+    memset(&trace, 0, sizeof(trace));
+    const int channels = 20;
+
+    // Runs at 2-4 (peak 3), 8 alone, 12-13 (peak 13) and 18-19, the
+    // last touching the end of the band
+    const uint8_t busy[][2] = {
+        {2, 30}, {3, 70}, {4, 40}, {8, 50}, {12, 25}, {13, 90}, {18, 60}, {19, 20},
+    };
+    for (size_t i = 0; i < sizeof(busy) / sizeof(busy[0]); i++) {
+        trace.occupancy[busy[i][0]] = busy[i][1];
+    }
+    trace.occupancy[10] = SURVEY_BUSY_PERCENT - 1;  // Quiet, however close
+
+    int out[8];
+    TEST_ASSERT_EQUAL_INT(4, Survey::busyChannels(trace, channels, out, 8));
+    TEST_ASSERT_EQUAL_INT(13, out[0]);
+    TEST_ASSERT_EQUAL_INT(3, out[1]);
+    TEST_ASSERT_EQUAL_INT(18, out[2]);
+    TEST_ASSERT_EQUAL_INT(8, out[3]);
+
+    // Short of room, the least busy runs are dropped
+    TEST_ASSERT_EQUAL_INT(2, Survey::busyChannels(trace, channels, out, 2));
+    TEST_ASSERT_EQUAL_INT(13, out[0]);
+    TEST_ASSERT_EQUAL_INT(3, out[1]);
+
+    memset(trace.occupancy, 0, sizeof(trace.occupancy));
+    TEST_ASSERT_EQUAL_INT(0, Survey::busyChannels(trace, channels, out, 8));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_totals_track_each_channel);
+    RUN_TEST(test_buckets_close_on_time_with_empty_sentinel);
+    RUN_TEST(test_short_bucket_from_stop_is_weighted_by_its_sweeps);
+    RUN_TEST(test_merged_buckets_agree_with_totals);
+    RUN_TEST(test_reset_clears_buckets);
+    RUN_TEST(test_plan_floors_uses_min_hold_on_busy_channels);
+    RUN_TEST(test_busy_channels_one_per_run_busiest_first);
+    return UNITY_END();
+}
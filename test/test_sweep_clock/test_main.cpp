@@ -0,0 +1,149 @@
+/**
+ * @file test_main.cpp
+ * @brief SweepClock disciplined by synthetic PPS edges and NMEA seconds
+ *
+ * The simulated local timer runs 20 ppm fast from an arbitrary boot
+ * offset, and each PPS edge is captured with up to a microsecond of
+ * interrupt jitter. Each edge is paired with the UTC second its RMC
+ * sentence names, as GpsReceiver does.
+ */
+
+#include <unity.h>
+#include "sweep_clock.h"
+
+#define UTC_START_S 1760000000LL        // Second of the first edge
+#define LOCAL_START_US 12345678LL       // Timer value at the first edge
+#define DRIFT_PPB 20000                 // Timer runs this fast
+#define JITTER_US 1
+
+static SweepClock* clock;
+static uint32_t rngState;
+
+// Timer value at a UTC instant, without capture jitter
+static int64_t localAt(int64_t utcUs) {
+    int64_t elapsed = utcUs - UTC_START_S * 1000000;
+    return LOCAL_START_US + elapsed + elapsed * DRIFT_PPB / 1000000000LL;
+}
+
+static int64_t jitter() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (int64_t)((rngState >> 16) % (2 * JITTER_US + 1)) - JITTER_US;
+}
+
+// The edge starting second n, paired with the sentence naming second m
+static void pair(int n, int m) {
+    clock->discipline(localAt((UTC_START_S + n) * 1000000) + jitter(), UTC_START_S + m);
+}
+
+static void pairs(int first, int last) {
+    for (int n = first; n <= last; n++) pair(n, n);
+}
+
+void setUp(void) {
+    clock = new SweepClock();
+    rngState = 1;
+}
+
+void tearDown(void) {
+    delete clock;
+}
+
+void test_locks_after_consistent_edges(void) {
+    // The first edge only sets the reference; each after it must agree
+    pairs(0, SYNC_LOCK_PPS - 1);
+    int64_t now = localAt((UTC_START_S + SYNC_LOCK_PPS - 1) * 1000000) + 1000;
+    int64_t utcUs;
+    TEST_ASSERT_FALSE(clock->isLocked(now));
+    TEST_ASSERT_FALSE(clock->toUtc(now, utcUs));
+
+    pair(SYNC_LOCK_PPS, SYNC_LOCK_PPS);
+    TEST_ASSERT_TRUE(clock->isLocked(localAt((UTC_START_S + SYNC_LOCK_PPS) * 1000000) + 1000));
+    TEST_ASSERT_EQUAL_UINT32(SYNC_LOCK_PPS + 1, clock->getPulseCount());
+}
+
+void test_estimates_drift_and_converts(void) {
+    pairs(0, 40);
+    TEST_ASSERT_INT32_WITHIN(1500, DRIFT_PPB, clock->getDriftPpb());
+
+    // Half a second after the last edge, both ways
+    int64_t trueUtc = (UTC_START_S + 40) * 1000000 + 500000;
+    int64_t local = localAt(trueUtc);
+    int64_t utcUs;
+    TEST_ASSERT_TRUE(clock->toUtc(local, utcUs));
+    TEST_ASSERT_TRUE(utcUs - trueUtc <= 3 && trueUtc - utcUs <= 3);
+
+    int64_t back;
+    TEST_ASSERT_TRUE(clock->toLocal(utcUs, back));
+    TEST_ASSERT_TRUE(back - local <= 1 && local - back <= 1);
+
+    // A slot boundary a few seconds ahead lands within a few us too
+    int64_t slotUtc = (UTC_START_S + 43) * 1000000;
+    TEST_ASSERT_TRUE(clock->toLocal(slotUtc, back));
+    TEST_ASSERT_TRUE(back - localAt(slotUtc) <= 5 && localAt(slotUtc) - back <= 5);
+}
+
+void test_missed_edges_keep_the_lock(void) {
+    pairs(0, 10);
+    uint32_t pulses = clock->getPulseCount();
+
+    // Edges 11, 12 and 14 never paired: a lost edge or a lost sentence
+    pair(13, 13);
+    pair(15, 15);
+    TEST_ASSERT_EQUAL_UINT32(pulses + 2, clock->getPulseCount());
+    TEST_ASSERT_TRUE(clock->isLocked(localAt((UTC_START_S + 15) * 1000000) + 100000));
+    TEST_ASSERT_INT32_WITHIN(1500, DRIFT_PPB, clock->getDriftPpb());
+}
+
+void test_edge_paired_with_wrong_second_drops_the_lock(void) {
+    pairs(0, 10);
+    int64_t now = localAt((UTC_START_S + 11) * 1000000) + 100000;
+
+    // A sentence for second 10 parsed after edge 11 was captured, as
+    // happens when it is read late; that costs the lock...
+    pair(11, 10);
+    TEST_ASSERT_FALSE(clock->isLocked(now));
+    int64_t utcUs;
+    TEST_ASSERT_FALSE(clock->toUtc(now, utcUs));
+
+    // ...and takes SYNC_LOCK_PPS good edges past the next one to regain
+    pairs(12, 12 + SYNC_LOCK_PPS - 1);
+    TEST_ASSERT_FALSE(clock->isLocked(localAt((UTC_START_S + 11 + SYNC_LOCK_PPS) * 1000000)));
+    pair(12 + SYNC_LOCK_PPS, 12 + SYNC_LOCK_PPS);
+    TEST_ASSERT_TRUE(clock->isLocked(localAt((UTC_START_S + 12 + SYNC_LOCK_PPS) * 1000000) + 1000));
+}
+
+void test_edge_off_by_more_than_tolerance_restarts(void) {
+    pairs(0, 10);
+    clock->discipline(localAt((UTC_START_S + 11) * 1000000) + 2 * SYNC_PPS_TOLERANCE_US,
+                      UTC_START_S + 11);
+    TEST_ASSERT_FALSE(clock->isLocked(localAt((UTC_START_S + 11) * 1000000) + 1000));
+}
+
+void test_holdover_then_unlock(void) {
+    pairs(0, 10);
+    int64_t lastEdge = localAt((UTC_START_S + 10) * 1000000);
+    int64_t utcUs;
+
+    TEST_ASSERT_TRUE(clock->isLocked(lastEdge + (int64_t)SYNC_HOLDOVER_MS * 1000 - 1000));
+    TEST_ASSERT_TRUE(clock->toUtc(lastEdge + (int64_t)SYNC_HOLDOVER_MS * 1000 - 1000, utcUs));
+    TEST_ASSERT_FALSE(clock->isLocked(lastEdge + (int64_t)SYNC_HOLDOVER_MS * 1000));
+    TEST_ASSERT_FALSE(clock->toUtc(lastEdge + (int64_t)SYNC_HOLDOVER_MS * 1000, utcUs));
+
+    // PPS back after longer than the holdover: start over
+    int back = 10 + SYNC_HOLDOVER_MS / 1000 + 2;
+    pair(back, back);
+    TEST_ASSERT_FALSE(clock->isLocked(localAt((UTC_START_S + back) * 1000000) + 1000));
+    pairs(back + 1, back + SYNC_LOCK_PPS);
+    TEST_ASSERT_TRUE(clock->isLocked(localAt((UTC_START_S + back + SYNC_LOCK_PPS) * 1000000) + 1000));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_locks_after_consistent_edges);
+    RUN_TEST(test_estimates_drift_and_converts);
+    RUN_TEST(test_missed_edges_keep_the_lock);
+    RUN_TEST(test_edge_paired_with_wrong_second_drops_the_lock);
+    RUN_TEST(test_edge_off_by_more_than_tolerance_restarts);
+    RUN_TEST(test_holdover_then_unlock);
+    return UNITY_END();
+}
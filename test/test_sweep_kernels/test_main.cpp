@@ -0,0 +1,216 @@
+/**
+ * @file test_main.cpp
+ * @brief Sweep kernels: vector paths against scalar, floor tracking, timing
+ *
+ * Runs on the host (pio test -e native) and on the unit
+ * (pio test -e tbeam-s3-core), where SWEEP_KERNELS_PIE is live and the
+ * comparisons exercise the PIE instructions and their scalar tails.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "band_analyzer.h"
+#include "sweep_kernels.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+#define BENCH_ROWS 2000
+
+static int8_t rowA[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+static int8_t rowB[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+static int8_t holdVec[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+static int8_t holdRef[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+static uint8_t hitsVec[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+static uint8_t hitsRef[SWEEP_ROW_MAX] __attribute__((aligned(SWEEP_ROW_ALIGN)));
+
+static uint32_t rngState;
+
+static int8_t randomDbm() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (int8_t)(rngState >> 24);
+}
+
+static void randomRow(int8_t* row, int n) {
+    for (int i = 0; i < n; i++) row[i] = randomDbm();
+}
+
+static uint32_t nowUs() {
+#ifdef ARDUINO
+    return micros();
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void setUp(void) {
+    rngState = 0xC0FFEE;
+}
+
+void tearDown(void) {
+}
+
+void test_max_min_hold_match_scalar(void) {
+    // Every length, so each tail size after the 16-lane blocks is covered
+    for (int n = 1; n <= SWEEP_ROW_MAX; n++) {
+        for (int round = 0; round < 4; round++) {
+            randomRow(rowA, n);
+            randomRow(rowB, n);
+
+            memcpy(holdVec, rowA, n);
+            memcpy(holdRef, rowA, n);
+            sweepMaxHold(holdVec, rowB, n);
+            sweepMaxHoldScalar(holdRef, rowB, n);
+            TEST_ASSERT_EQUAL_INT8_ARRAY(holdRef, holdVec, n);
+
+            memcpy(holdVec, rowA, n);
+            memcpy(holdRef, rowA, n);
+            sweepMinHold(holdVec, rowB, n);
+            sweepMinHoldScalar(holdRef, rowB, n);
+            TEST_ASSERT_EQUAL_INT8_ARRAY(holdRef, holdVec, n);
+        }
+    }
+}
+
+void test_compare_matches_scalar(void) {
+    for (int n = 1; n <= SWEEP_ROW_MAX; n++) {
+        for (int round = 0; round < 4; round++) {
+            randomRow(rowA, n);
+            randomRow(rowB, n);
+
+            // Some ties, where "greater than" must say no
+            for (int i = 0; i < n; i += 5) rowB[i] = rowA[i];
+
+            memset(hitsVec, 0x55, sizeof(hitsVec));
+            memset(hitsRef, 0x55, sizeof(hitsRef));
+            int countVec = sweepCompare(hitsVec, rowA, rowB, n);
+            int countRef = sweepCompareScalar(hitsRef, rowA, rowB, n);
+            TEST_ASSERT_EQUAL_INT(countRef, countVec);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(hitsRef, hitsVec, n);
+
+            // Nothing past the row is touched
+            if (n < SWEEP_ROW_MAX) TEST_ASSERT_EQUAL_HEX8(0x55, hitsVec[n]);
+        }
+    }
+}
+
+void test_floor_rises_all_the_way(void) {
+    int16_t floorQ[1];
+    int8_t row[1] = {-90};
+    uint8_t hits[1] = {0};
+
+    // 1 dB under the row: (16 >> 5) truncates to 0
+    floorQ[0] = (int16_t)((-91) * (1 << NOISE_FLOOR_FRAC_BITS));
+    for (int k = 0; k < 64; k++) {
+        sweepNoiseFloorUpdate(floorQ, row, hits, 1, NOISE_FLOOR_RISE_SHIFT, NOISE_FLOOR_FALL_SHIFT);
+    }
+    TEST_ASSERT_EQUAL_INT16(-90 * (1 << NOISE_FLOOR_FRAC_BITS), floorQ[0]);
+
+    // And it settles there rather than oscillating
+    sweepNoiseFloorUpdate(floorQ, row, hits, 1, NOISE_FLOOR_RISE_SHIFT, NOISE_FLOOR_FALL_SHIFT);
+    TEST_ASSERT_EQUAL_INT16(-90 * (1 << NOISE_FLOOR_FRAC_BITS), floorQ[0]);
+
+    // A hit still freezes it
+    row[0] = -60;
+    hits[0] = 0xFF;
+    sweepNoiseFloorUpdate(floorQ, row, hits, 1, NOISE_FLOOR_RISE_SHIFT, NOISE_FLOOR_FALL_SHIFT);
+    TEST_ASSERT_EQUAL_INT16(-90 * (1 << NOISE_FLOOR_FRAC_BITS), floorQ[0]);
+}
+
+void test_floor_falls_fast(void) {
+    int16_t floorQ[1] = {(int16_t)(-70 * (1 << NOISE_FLOOR_FRAC_BITS))};
+    int8_t row[1] = {-100};
+    uint8_t hits[1] = {0};
+
+    for (int k = 0; k < 40; k++) {
+        sweepNoiseFloorUpdate(floorQ, row, hits, 1, NOISE_FLOOR_RISE_SHIFT, NOISE_FLOOR_FALL_SHIFT);
+    }
+    TEST_ASSERT_EQUAL_INT16(-100 * (1 << NOISE_FLOOR_FRAC_BITS), floorQ[0]);
+}
+
+void test_variance_matches_direct(void) {
+    const int n = 37;
+    const int count = SWEEP_HISTORY;
+    int8_t rows[SWEEP_HISTORY][37];
+    int16_t sum[37];
+    int32_t sumSq[37];
+    uint16_t variance[37];
+
+    memset(sum, 0, sizeof(sum));
+    memset(sumSq, 0, sizeof(sumSq));
+    for (int k = 0; k < count; k++) {
+        randomRow(rows[k], n);
+        sweepHistoryUpdate(sum, sumSq, rows[k], nullptr, n);
+    }
+    sweepVariance(variance, sum, sumSq, n, count);
+
+    for (int i = 0; i < n; i++) {
+        double mean = 0;
+        for (int k = 0; k < count; k++) mean += rows[k][i];
+        mean /= count;
+        double var = 0;
+        for (int k = 0; k < count; k++) var += (rows[k][i] - mean) * (rows[k][i] - mean);
+        var /= count;
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, (float)var, (float)variance[i]);
+    }
+}
+
+void test_benchmark(void) {
+    const int n = SWEEP_ROW_MAX;
+    randomRow(rowA, n);
+    randomRow(rowB, n);
+    memcpy(holdVec, rowA, n);
+    volatile int sink = 0;
+
+    uint32_t t0 = nowUs();
+    for (int k = 0; k < BENCH_ROWS; k++) sweepMaxHold(holdVec, rowB, n);
+    uint32_t t1 = nowUs();
+    for (int k = 0; k < BENCH_ROWS; k++) sweepMaxHoldScalar(holdVec, rowB, n);
+    uint32_t t2 = nowUs();
+    for (int k = 0; k < BENCH_ROWS; k++) sink += sweepCompare(hitsVec, rowA, rowB, n);
+    uint32_t t3 = nowUs();
+    for (int k = 0; k < BENCH_ROWS; k++) sink += sweepCompareScalar(hitsRef, rowA, rowB, n);
+    uint32_t t4 = nowUs();
+    (void)sink;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%d channels, ns/row: maxHold %lu (scalar %lu), compare %lu (scalar %lu), PIE %s",
+             n,
+             (unsigned long)((t1 - t0) * 1000UL / BENCH_ROWS),
+             (unsigned long)((t2 - t1) * 1000UL / BENCH_ROWS),
+             (unsigned long)((t3 - t2) * 1000UL / BENCH_ROWS),
+             (unsigned long)((t4 - t3) * 1000UL / BENCH_ROWS),
+             SWEEP_KERNELS_PIE ? "on" : "off");
+    TEST_MESSAGE(msg);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_max_min_hold_match_scalar);
+    RUN_TEST(test_compare_matches_scalar);
+    RUN_TEST(test_floor_rises_all_the_way);
+    RUN_TEST(test_floor_falls_fast);
+    RUN_TEST(test_variance_matches_direct);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // Give the USB serial port time to come up before the results
+    delay(2000);
+    runTests();
+}
+
+void loop() {
+}
+#else
+int main(int argc, char** argv) {
+    return runTests();
+}
+#endif
@@ -0,0 +1,484 @@
+/**
+ * @file test_main.cpp
+ * @brief Watchlist alert latency against a simulated radio and display
+ *
+ * Runs in real time on three threads, as on the unit: a sweep stepping a
+ * simulated radio through the 900MHz plan, the alert task woken by the
+ * watchlist, and a display sending frames back to back a page at a time.
+ * The display stands in for DisplayUI: a banner that finds it busy goes
+ * out with the rest of the frame instead of waiting for it.
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+#include <thread>
+#include <vector>
+#include "band_scanner.h"
+#include "watchlist.h"
+
+#define SAMPLE_US 250              // Tune, settle and read one channel
+#define PAGE_US 3000               // One 128-byte page over I2C
+#define PAGES 8
+#define BANNER_FIRST_PAGE 6
+#define NOISE_DBM -105
+#define THRESHOLD_DBM -90
+#define EMITTER_DBM -60
+
+// A banner raised mid-frame goes out with that frame's last pages, one
+// raised too late for them right after; either way within about a frame,
+// where waiting for the display cost up to two. The slack is for sleeps
+// overrunning on a loaded host.
+#define BANNER_BUDGET_US (PAGES * PAGE_US + 6000)
+
+static std::chrono::steady_clock::time_point testStart;
+
+static int64_t elapsedUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - testStart).count();
+}
+
+static void sleepUs(int64_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+struct Emitter {
+    float frequency;
+    int64_t onUs;
+    int64_t offUs;                 // Drops into the hysteresis band...
+    int64_t goneUs;                // ...then to the noise
+    int channel;
+    int64_t firstHitUs;            // First sample above threshold
+};
+
+struct BannerSent {
+    int entry;
+    int64_t atUs;
+};
+
+class SimAlertOutput : public AlertOutput {
+public:
+    SimAlertOutput() {
+        woken = false;
+        stopping = false;
+        pin = false;
+        bannerEntry = -1;
+        bannerDirty = false;
+        prepared = 0;
+        cleared = 0;
+    }
+
+    int64_t nowUs() override {
+        return elapsedUs();
+    }
+
+    void wake() override {
+        std::lock_guard<std::mutex> guard(taskLock);
+        woken = true;
+        taskWake.notify_one();
+    }
+
+    void setPin(bool on) override {
+        if (on) pinRises.push_back(elapsedUs());
+        pin = on;
+    }
+
+    void prepareBanner(int entry, float freq) override {
+        entryFreq[entry] = freq;
+        prepared++;
+    }
+
+    void showBanner(int entry) override {
+        bannerEntry = entry;
+        bannerDirty = true;
+        if (displayLock.try_lock()) {
+            pushBanner();
+            displayLock.unlock();
+        }
+    }
+
+    void clearBanner() override {
+        cleared++;
+    }
+
+    void alerted(float freq, int8_t rssi, uint32_t pinUs, uint32_t bannerUs) override {
+        alertPinUs.push_back(pinUs);
+    }
+
+    // The alert task: woken by the sweep, and polled for expiry. It
+    // outranks everything else, as on the unit, where the host allows it.
+    void runAlertTask(Watchlist* list) {
+        sched_param param;
+        param.sched_priority = 1;
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> guard(taskLock);
+                taskWake.wait_for(guard, std::chrono::milliseconds(WATCH_POLL_MS),
+                                  [&]() { return woken || stopping; });
+                if (stopping) return;
+                woken = false;
+            }
+            list->service();
+        }
+    }
+
+    // The display: whole frames, back to back, until stopped
+    void runDisplay() {
+        while (!stopping) {
+            displayLock.lock();
+            for (int page = 0; page < PAGES; page++) {
+                if (page <= BANNER_FIRST_PAGE && bannerDirty) takeBanner();
+                sleepUs(PAGE_US);
+                if (page == PAGES - 1) sendTaken();
+            }
+            displayLock.unlock();
+
+            if (bannerDirty && displayLock.try_lock()) {
+                pushBanner();
+                displayLock.unlock();
+            }
+            sleepUs(500);
+        }
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> guard(taskLock);
+        stopping = true;
+        taskWake.notify_one();
+    }
+
+    std::atomic<bool> pin;
+    std::atomic<int> prepared;
+    std::atomic<int> cleared;
+    float entryFreq[WATCHLIST_MAX];
+    std::vector<int64_t> pinRises;         // Alert task only
+    std::vector<uint32_t> alertPinUs;      // Alert task only
+    std::vector<BannerSent> banners;       // Under displayLock
+
+private:
+    std::mutex taskLock;
+    std::condition_variable taskWake;
+    bool woken;
+    std::atomic<bool> stopping;
+
+    std::mutex displayLock;
+    std::atomic<int> bannerEntry;
+    std::atomic<bool> bannerDirty;
+    int taken = -1;                        // Banner drawn into the frame
+
+    void takeBanner() {
+        bannerDirty = false;
+        taken = bannerEntry;
+    }
+
+    void sendTaken() {
+        if (taken >= 0) banners.push_back({taken, elapsedUs()});
+        taken = -1;
+    }
+
+    // Banner pages only
+    void pushBanner() {
+        if (!bannerDirty) return;
+        takeBanner();
+        sleepUs((PAGES - BANNER_FIRST_PAGE) * PAGE_US);
+        sendTaken();
+    }
+};
+
+// Time set by the test; nothing runs on other threads
+class ClockedAlertOutput : public SimAlertOutput {
+public:
+    ClockedAlertOutput() {
+        now = 0;
+    }
+
+    int64_t nowUs() override {
+        return now;
+    }
+
+    int64_t now;
+};
+
+// Time set by the test, with a sample the sweep takes on the other core
+// just as the alert task reads the clock
+class RacingAlertOutput : public ClockedAlertOutput {
+public:
+    RacingAlertOutput() {
+        list = nullptr;
+        channel = -1;
+        raceAtUs = -1;
+    }
+
+    int64_t nowUs() override {
+        int64_t t = now;
+        if (raceAtUs >= 0) {
+            now = raceAtUs;
+            raceAtUs = -1;
+            list->onSample(0, channel, EMITTER_DBM, THRESHOLD_DBM);
+            now = t;
+        }
+        return t;
+    }
+
+    Watchlist* list;
+    int channel;
+    int64_t raceAtUs;              // Sample time, -1 once taken
+};
+
+static int rssiAt(const std::vector<Emitter>& emitters, int channel, int64_t t) {
+    int rssi = NOISE_DBM;
+    for (const Emitter& e : emitters) {
+        if (e.channel != channel || t < e.onUs || t >= e.goneUs) continue;
+        // Inside the hysteresis band once it fades
+        int level = t < e.offUs ? EMITTER_DBM : THRESHOLD_DBM - WATCH_HYSTERESIS_DB / 2;
+        if (level > rssi) rssi = level;
+    }
+    return rssi;
+}
+
+static void runSweep(Watchlist* list, std::vector<Emitter>* emitters, int64_t untilUs) {
+    while (elapsedUs() < untilUs) {
+        for (int ch = 0; ch < Plan900::CHANNELS; ch++) {
+            sleepUs(SAMPLE_US);
+            int64_t t = elapsedUs();
+            int rssi = rssiAt(*emitters, ch, t);
+            if (rssi > THRESHOLD_DBM) {
+                for (Emitter& e : *emitters) {
+                    if (e.channel == ch && e.firstHitUs < 0) e.firstHitUs = t;
+                }
+            }
+            list->onSample(0, ch, (int8_t)rssi, THRESHOLD_DBM);
+        }
+    }
+}
+
+static Emitter emitter(float freq, int64_t onMs, int64_t offMs, int64_t goneMs) {
+    Emitter e;
+    e.frequency = freq;
+    e.onUs = onMs * 1000;
+    e.offUs = offMs * 1000;
+    e.goneUs = goneMs * 1000;
+    e.channel = (int)lroundf((freq - FREQ_900_START) / FREQ_900_STEP);
+    e.firstHitUs = -1;
+    return e;
+}
+
+// Sweep, alert task and display together until untilMs
+static void run(Watchlist& list, SimAlertOutput& output, std::vector<Emitter>& emitters,
+                int64_t untilMs) {
+    std::thread alertTask(&SimAlertOutput::runAlertTask, &output, &list);
+    std::thread display(&SimAlertOutput::runDisplay, &output);
+    runSweep(&list, &emitters, untilMs * 1000);
+    output.stop();
+    alertTask.join();
+    display.join();
+}
+
+void setUp(void) {
+    testStart = std::chrono::steady_clock::now();
+}
+
+void tearDown(void) {
+}
+
+void test_add_snaps_to_sweep_channels(void) {
+    SimAlertOutput output;
+    Watchlist list;
+    list.begin(&output);
+
+    TEST_ASSERT_EQUAL_INT(6, list.getCount());
+    TEST_ASSERT_EQUAL_INT(6, output.prepared);
+
+    // 902.2 is the 902.0 channel, already watched
+    TEST_ASSERT_TRUE(list.add(0, 902.2f));
+    TEST_ASSERT_EQUAL_INT(6, list.getCount());
+
+    TEST_ASSERT_FALSE(list.add(0, 850.0f));
+    TEST_ASSERT_FALSE(list.add(1, 2600.0f));
+
+    TEST_ASSERT_TRUE(list.add(0, 880.0f));
+    TEST_ASSERT_TRUE(list.add(1, 2450.0f));
+    TEST_ASSERT_FALSE(list.add(0, 925.0f));
+    TEST_ASSERT_EQUAL_INT(WATCHLIST_MAX, list.getCount());
+}
+
+void test_pin_within_budget_while_display_busy(void) {
+    SimAlertOutput output;
+    Watchlist list;
+    list.begin(&output);
+    list.add(0, 880.0f);
+    list.add(0, 925.0f);
+
+    // One at a time, then two at once in the same sweep
+    std::vector<Emitter> emitters;
+    emitters.push_back(emitter(868.0f, 100, 2000, 2000));
+    emitters.push_back(emitter(880.0f, 250, 2000, 2000));
+    emitters.push_back(emitter(902.0f, 400, 2000, 2000));
+    emitters.push_back(emitter(915.0f, 550, 2000, 2000));
+    emitters.push_back(emitter(925.0f, 550, 2000, 2000));
+
+    run(list, output, emitters, 900);
+
+    TEST_ASSERT_EQUAL_UINT32(emitters.size(), list.getAlertCount());
+    TEST_ASSERT_EQUAL_UINT32(0, list.getLatencyMisses());
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(WATCH_LATENCY_BUDGET_US, list.getMaxAlertUs());
+    TEST_ASSERT_TRUE(output.pin);
+    TEST_ASSERT_TRUE(list.isAlerting());
+
+    // Independently of the watchlist's own figures: the pin goes up
+    // within the bound of the first sample that saw each emitter
+    for (const Emitter& e : emitters) {
+        TEST_ASSERT_TRUE(e.firstHitUs >= 0);
+        int64_t rise = -1;
+        for (int64_t t : output.pinRises) {
+            if (t >= e.firstHitUs) {
+                rise = t;
+                break;
+            }
+        }
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%.1f MHz: %lld us to pin", e.frequency,
+                 (long long)(rise - e.firstHitUs));
+        TEST_ASSERT_TRUE_MESSAGE(rise >= 0 && rise - e.firstHitUs <= WATCH_LATENCY_BUDGET_US, msg);
+    }
+
+    // Banners ride along with frames rather than waiting for them
+    TEST_ASSERT_GREATER_OR_EQUAL_INT(4, (int)output.banners.size());
+    for (const BannerSent& b : output.banners) {
+        for (const Emitter& e : emitters) {
+            if (fabsf(e.frequency - output.entryFreq[b.entry]) > 0.01f) continue;
+            TEST_ASSERT_TRUE(e.firstHitUs >= 0);
+            TEST_ASSERT_TRUE(b.atUs - e.firstHitUs <= BANNER_BUDGET_US);
+        }
+    }
+}
+
+void test_alert_holds_then_clears(void) {
+    SimAlertOutput output;
+    Watchlist list;
+    list.begin(&output);
+
+    // On for 200 ms, in the hysteresis band for a second, then gone
+    std::vector<Emitter> emitters;
+    emitters.push_back(emitter(915.0f, 100, 300, 1300));
+
+    run(list, output, emitters, 1300 + WATCH_HOLD_MS - 300);
+    TEST_ASSERT_TRUE(list.isAlerting());
+    TEST_ASSERT_TRUE(output.pin);
+    TEST_ASSERT_EQUAL_INT(0, output.cleared);
+
+    // Same again, past the hold
+    SimAlertOutput output2;
+    Watchlist list2;
+    list2.begin(&output2);
+    testStart = std::chrono::steady_clock::now();
+    emitters[0].firstHitUs = -1;
+
+    run(list2, output2, emitters, 1300 + WATCH_HOLD_MS + 3 * WATCH_POLL_MS);
+    TEST_ASSERT_FALSE(list2.isAlerting());
+    TEST_ASSERT_FALSE(output2.pin);
+    TEST_ASSERT_EQUAL_INT(1, output2.cleared);
+    TEST_ASSERT_EQUAL_UINT32(1, list2.getAlertCount());
+}
+
+void test_hold_scales_with_revisits(void) {
+    ClockedAlertOutput output;
+    Watchlist list;
+    list.begin(&output);
+    int ch = (int)lroundf((915.0f - FREQ_900_START) / FREQ_900_STEP);
+
+    // Swept every 100 ms, then every 2.5 s as while locked on elsewhere
+    int64_t t = 1000;
+    for (int i = 0; i < 5; i++, t += 100) {
+        output.now = t * 1000;
+        list.onSample(0, ch, EMITTER_DBM, THRESHOLD_DBM);
+        list.service();
+    }
+    int64_t lastAbove = t - 100 + 2500;
+    output.now = lastAbove * 1000;
+    list.onSample(0, ch, EMITTER_DBM, THRESHOLD_DBM);
+    list.service();
+    TEST_ASSERT_EQUAL_UINT32(1, list.getAlertCount());
+
+    // Polled through the next gap: the channel has not been seen since,
+    // so the alert holds past WATCH_HOLD_MS
+    for (t = lastAbove; t < lastAbove + 2500; t += WATCH_POLL_MS) {
+        output.now = t * 1000;
+        list.service();
+    }
+    TEST_ASSERT_TRUE(list.isAlerting());
+
+    // Quiet at the next revisit, still within two of them
+    output.now = (lastAbove + 2500) * 1000;
+    list.onSample(0, ch, NOISE_DBM, THRESHOLD_DBM);
+    for (t = lastAbove + 2500; t <= lastAbove + WATCH_HOLD_REVISITS * 2500; t += WATCH_POLL_MS) {
+        output.now = t * 1000;
+        list.service();
+    }
+    TEST_ASSERT_TRUE(list.isAlerting());
+    TEST_ASSERT_EQUAL_INT(0, output.cleared);
+
+    // Quiet again at the one after: cleared, once, without flapping
+    output.now = (lastAbove + 5000) * 1000;
+    list.onSample(0, ch, NOISE_DBM, THRESHOLD_DBM);
+    output.now += WATCH_POLL_MS * 1000;
+    list.service();
+    TEST_ASSERT_FALSE(list.isAlerting());
+    TEST_ASSERT_FALSE(output.pin);
+    TEST_ASSERT_EQUAL_INT(1, output.cleared);
+    TEST_ASSERT_EQUAL_UINT32(1, list.getAlertCount());
+}
+
+void test_sample_during_expiry_holds_alert(void) {
+    RacingAlertOutput output;
+    Watchlist list;
+    list.begin(&output);
+    int ch = (int)lroundf((915.0f - FREQ_900_START) / FREQ_900_STEP);
+    output.list = &list;
+    output.channel = ch;
+
+    int64_t t = 1000;
+    output.now = t * 1000;
+    list.onSample(0, ch, EMITTER_DBM, THRESHOLD_DBM);
+    list.service();
+    for (t += 100; t <= 1000 + WATCH_HOLD_MS + 500; t += 100) {
+        output.now = t * 1000;
+        list.onSample(0, ch, NOISE_DBM, THRESHOLD_DBM);
+    }
+    TEST_ASSERT_TRUE(list.isAlerting());
+
+    // Expired by the alert task's clock, but the sweep's clock has moved
+    // on and it sees the emitter again before the alert is cleared
+    output.now = t * 1000;
+    output.raceAtUs = (t + 1) * 1000;
+    list.service();
+    TEST_ASSERT_EQUAL_INT(-1, (int)output.raceAtUs);
+    TEST_ASSERT_TRUE(list.isAlerting());
+    TEST_ASSERT_EQUAL_INT(0, output.cleared);
+
+    // And it expires normally from there
+    int64_t lastAbove = t + 1;
+    for (t = lastAbove + 100; t <= lastAbove + WATCH_HOLD_MS + 100; t += 100) {
+        output.now = t * 1000;
+        list.onSample(0, ch, NOISE_DBM, THRESHOLD_DBM);
+        list.service();
+    }
+    TEST_ASSERT_FALSE(list.isAlerting());
+    TEST_ASSERT_EQUAL_INT(1, output.cleared);
+    TEST_ASSERT_EQUAL_UINT32(1, list.getAlertCount());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_snaps_to_sweep_channels);
+    RUN_TEST(test_pin_within_budget_while_display_busy);
+    RUN_TEST(test_alert_holds_then_clears);
+    RUN_TEST(test_hold_scales_with_revisits);
+    RUN_TEST(test_sample_during_expiry_holds_alert);
+    return UNITY_END();
+}
@@ -0,0 +1,795 @@
+/**
+ * @file spurd.cpp
+ * @brief Host daemon fusing detections from many SPUR units
+ *
+ * Reads the $SWP/$DET telemetry sentences every unit prints on its USB
+ * serial port (see sendTelemetry() in src/main.cpp), one non-blocking
+ * parser per device on a single epoll loop. Unit clocks are aligned to
+ * the host clock, reports of the same emitter from different units are
+ * merged into one fused table, and the table is served on a Unix socket.
+ * Units whose sweep clock is GPS-locked also stamp sweeps and detections
+ * with UTC; those stamps are passed through per unit report, so reports
+ * of one channel sampled at the same instant line up exactly.
+ *
+ * Build:  g++ -O2 -std=c++17 -Wall -o spurd tools/spurd.cpp
+ * Run:    ./spurd [-s /tmp/spurd.sock] [-H hold_ms] /dev/ttyACM0 /dev/ttyACM1 ...
+ * Query:  echo emitters | socat - UNIX-CONNECT:/tmp/spurd.sock
+ *
+ * Query commands, one per line, each answered with one JSON line:
+ *   emitters   fused emitter table
+ *   units      per-unit link and clock state
+ *   stats      daemon counters
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+
+#include "../include/config.h"
+
+#define DEFAULT_SOCKET "/tmp/spurd.sock"
+#define SENTENCE_MAX TELEMETRY_LINE_MAX
+#define MAX_FIELDS 16
+#define MAX_UNITS_PER_EMITTER 16
+#define MAX_FUSED 256
+#define CLIENT_OUT_MAX (1 << 20)       // Drop a dashboard that stops reading
+#define TICK_MS 250                    // Reconnect and expiry period
+#define REOPEN_MS 1000                 // Retry a vanished device this often
+#define OFFSET_DRIFT_SHIFT 8           // Clock offset creeps up by 1/256 per line
+
+static const char* const modNames[] = {
+    "UNKNOWN", "FSK", "GFSK", "LoRa", "FHSS", "DSSS", "OFDM"
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static int64_t nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// One serial-attached unit
+struct Device {
+    std::string path;
+    int fd;
+    int64_t reopenAtUs;
+
+    // Sentence parser: IDLE until '$', BODY until '*', then two hex digits
+    enum { IDLE, BODY, CHECK_HI, CHECK_LO } state;
+    char body[SENTENCE_MAX];
+    int length;
+    uint8_t checksum;
+    uint8_t received;
+
+    // Unit clock alignment: host time = unit ms * 1000 + offset
+    int unit;                          // -1 until the first sentence
+    uint32_t lastUnitMs;
+    int64_t offsetUs;
+    bool offsetValid;
+    bool synced;                       // Last sweep was on the UTC slot grid
+
+    uint64_t sentences;
+    uint64_t badChecksum;
+    uint64_t overflows;
+    uint64_t sweeps;
+    uint64_t detections;
+    int64_t lastSeenUs;
+};
+
+// One unit's view of a fused emitter
+struct UnitReport {
+    int unit;
+    int rssi;
+    int64_t seenUs;
+    int64_t utcUs;                     // Unit's UTC sample time, 0 if not synced
+};
+
+// One transmitter, however many units hear it
+struct FusedEmitter {
+    bool active;
+    uint8_t band;
+    double frequency;
+    double bandwidth;
+    int modType;
+    int bestRssi;
+    int bestUnit;
+    int occupancy;
+    double latitude;
+    double longitude;
+    bool hasPosition;
+    int64_t firstSeenUs;
+    int64_t lastSeenUs;
+    int reportCount;
+    UnitReport reports[MAX_UNITS_PER_EMITTER];
+};
+
+struct Client {
+    int fd;
+    std::string in;
+    std::string out;
+};
+
+class Daemon {
+public:
+    Daemon() {
+        epollFd = -1;
+        listenFd = -1;
+        timerFd = -1;
+        holdUs = (int64_t)SIGNAL_HOLD_TIME_MS * 1000;
+        startUs = nowUs();
+        fusedCount = 0;
+        totalDetections = 0;
+        mergedDetections = 0;
+        memset(fused, 0, sizeof(fused));
+    }
+
+    bool begin(const std::vector<std::string>& paths, const char* socketPath, int holdMs);
+    void run();
+
+private:
+    int epollFd;
+    int listenFd;
+    int timerFd;
+    std::string socketPath;
+    int64_t holdUs;
+    int64_t startUs;
+
+    std::vector<Device*> devices;
+    std::vector<Client*> clients;
+    FusedEmitter fused[MAX_FUSED];
+    int fusedCount;
+    uint64_t totalDetections;
+    uint64_t mergedDetections;
+
+    bool openDevice(Device* dev);
+    void closeDevice(Device* dev);
+    void readDevice(Device* dev);
+    void feed(Device* dev, char c, int64_t rxUs);
+    void handleSentence(Device* dev, int64_t rxUs);
+    int64_t alignClock(Device* dev, uint32_t unitMs, int64_t rxUs);
+    void fuseDetection(int unit, int64_t atUs, uint8_t band, double freq, double bw,
+                       int rssi, int mod, int occupancy, const char* lat, const char* lon,
+                       int64_t utcUs);
+    void expire(int64_t now);
+
+    void acceptClient();
+    void readClient(Client* client);
+    void flushClient(Client* client);
+    void closeClient(Client* client);
+    std::string answer(const std::string& command);
+    std::string emittersJson();
+    std::string unitsJson();
+    std::string statsJson();
+
+    void watch(int fd, uint32_t events, void* ptr);
+};
+
+// Tags that tell epoll events for the listener and timer from device/client pointers
+static char listenTag;
+static char timerTag;
+
+void Daemon::watch(int fd, uint32_t events, void* ptr) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = ptr;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0 && errno == EEXIST) {
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    }
+}
+
+bool Daemon::begin(const std::vector<std::string>& paths, const char* path, int holdMs) {
+    holdUs = (int64_t)holdMs * 1000;
+    socketPath = path;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        perror("[SPURD] epoll_create1");
+        return false;
+    }
+
+    // Query socket; a stale one from a previous run is replaced
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[SPURD] Socket path too long\n");
+        return false;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, 16) < 0) {
+        perror("[SPURD] Query socket");
+        return false;
+    }
+    watch(listenFd, EPOLLIN, &listenTag);
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec tick;
+    memset(&tick, 0, sizeof(tick));
+    tick.it_interval.tv_nsec = TICK_MS * 1000000L;
+    tick.it_value.tv_nsec = TICK_MS * 1000000L;
+    timerfd_settime(timerFd, 0, &tick, nullptr);
+    watch(timerFd, EPOLLIN, &timerTag);
+
+    for (const std::string& p : paths) {
+        Device* dev = new Device();
+        dev->path = p;
+        dev->fd = -1;
+        dev->reopenAtUs = 0;
+        dev->state = Device::IDLE;
+        dev->unit = -1;
+        dev->offsetValid = false;
+        dev->synced = false;
+        devices.push_back(dev);
+
+        // Missing devices are retried from the timer
+        if (!openDevice(dev)) {
+            fprintf(stderr, "[SPURD] %s not available yet: %s\n", p.c_str(), strerror(errno));
+        }
+    }
+
+    printf("[SPURD] %zu devices, query socket %s\n", devices.size(), socketPath.c_str());
+    return true;
+}
+
+bool Daemon::openDevice(Device* dev) {
+    int fd = open(dev->path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        dev->reopenAtUs = nowUs() + (int64_t)REOPEN_MS * 1000;
+        return false;
+    }
+
+    // Raw 115200 8N1; a pseudo-terminal accepts and ignores the speed
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 1;  // Empty reads then fail with EAGAIN
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    dev->fd = fd;
+    dev->state = Device::IDLE;
+    watch(fd, EPOLLIN | EPOLLRDHUP, dev);
+    printf("[SPURD] Opened %s\n", dev->path.c_str());
+    return true;
+}
+
+void Daemon::closeDevice(Device* dev) {
+    if (dev->fd < 0) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, dev->fd, nullptr);
+    close(dev->fd);
+    dev->fd = -1;
+    dev->reopenAtUs = nowUs() + (int64_t)REOPEN_MS * 1000;
+
+    // A replugged unit may have rebooted; relearn its clock
+    dev->offsetValid = false;
+    printf("[SPURD] Lost %s, retrying\n", dev->path.c_str());
+}
+
+void Daemon::readDevice(Device* dev) {
+    char buf[4096];
+    for (;;) {
+        ssize_t n = read(dev->fd, buf, sizeof(buf));
+        if (n > 0) {
+            int64_t rxUs = nowUs();
+            for (ssize_t i = 0; i < n; i++) feed(dev, buf[i], rxUs);
+            continue;
+        }
+        if (n == 0) return;  // A tty reports a hangup through EPOLLHUP, not EOF
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+        if (errno == EINTR) continue;
+        closeDevice(dev);  // EIO: unplugged
+        return;
+    }
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+void Daemon::feed(Device* dev, char c, int64_t rxUs) {
+    // '$' always starts a new sentence, so a torn line costs only itself
+    if (c == '$') {
+        dev->state = Device::BODY;
+        dev->length = 0;
+        dev->checksum = 0;
+        return;
+    }
+
+    switch (dev->state) {
+        case Device::IDLE:
+            break;  // Human-readable log lines
+
+        case Device::BODY:
+            if (c == '*') {
+                dev->body[dev->length] = '\0';
+                dev->state = Device::CHECK_HI;
+            } else if (c == '\r' || c == '\n') {
+                dev->state = Device::IDLE;
+            } else if (dev->length >= SENTENCE_MAX - 1) {
+                dev->overflows++;
+                dev->state = Device::IDLE;
+            } else {
+                dev->body[dev->length++] = c;
+                dev->checksum ^= (uint8_t)c;
+            }
+            break;
+
+        case Device::CHECK_HI: {
+            int v = hexValue(c);
+            if (v < 0) {
+                dev->badChecksum++;
+                dev->state = Device::IDLE;
+            } else {
+                dev->received = (uint8_t)(v << 4);
+                dev->state = Device::CHECK_LO;
+            }
+            break;
+        }
+
+        case Device::CHECK_LO: {
+            int v = hexValue(c);
+            dev->state = Device::IDLE;
+            if (v < 0 || (uint8_t)(dev->received | v) != dev->checksum) {
+                dev->badChecksum++;
+                break;
+            }
+            dev->sentences++;
+            dev->lastSeenUs = rxUs;
+            handleSentence(dev, rxUs);
+            break;
+        }
+    }
+}
+
+// "seconds.micros" UTC field; empty means the unit has no GPS time
+static int64_t parseUtc(const char* field) {
+    if (field[0] == '\0') return 0;
+    char* end;
+    int64_t seconds = strtoll(field, &end, 10);
+    int64_t micros = *end == '.' ? strtoll(end + 1, nullptr, 10) : 0;
+    return seconds * 1000000 + micros;
+}
+
+// Split in place on ','; empty fields are kept
+static int splitFields(char* body, char** fields) {
+    int count = 0;
+    fields[count++] = body;
+    for (char* p = body; *p && count < MAX_FIELDS; p++) {
+        if (*p == ',') {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+    }
+    return count;
+}
+
+void Daemon::handleSentence(Device* dev, int64_t rxUs) {
+    char* f[MAX_FIELDS];
+    int n = splitFields(dev->body, f);
+    if (n < 3) return;
+
+    int unit = (int)(strtoul(f[1], nullptr, 16) & 0xFFFF);
+    uint32_t unitMs = (uint32_t)strtoul(f[2], nullptr, 10);
+    if (dev->unit != unit) {
+        dev->unit = unit;
+        dev->offsetValid = false;
+    }
+
+    if (strcmp(f[0], "SWP") == 0 && n >= 6) {
+        alignClock(dev, unitMs, rxUs);
+        dev->synced = n >= 7 && parseUtc(f[6]) != 0;
+        dev->sweeps++;
+    } else if (strcmp(f[0], "DET") == 0 && n >= 11) {
+        // Detections are stamped when measured, before the sweep ended, so
+        // they place on the timeline but don't train the offset
+        if (!dev->offsetValid) alignClock(dev, unitMs, rxUs);
+        int64_t atUs = (int64_t)unitMs * 1000 + dev->offsetUs;
+        if (atUs > rxUs) atUs = rxUs;
+
+        dev->detections++;
+        fuseDetection(unit, atUs, (uint8_t)atoi(f[3]), atof(f[4]), atof(f[5]),
+                      atoi(f[6]), atoi(f[7]), atoi(f[8]), f[9], f[10],
+                      n >= 12 ? parseUtc(f[11]) : 0);
+    }
+}
+
+int64_t Daemon::alignClock(Device* dev, uint32_t unitMs, int64_t rxUs) {
+    int64_t candidate = rxUs - (int64_t)unitMs * 1000;
+
+    // The unit restarted: its millis() went backwards
+    if (dev->offsetValid && unitMs < dev->lastUnitMs) dev->offsetValid = false;
+    dev->lastUnitMs = unitMs;
+
+    // Transport delay only ever adds, so the smallest offset seen is the
+    // closest to the truth; let it creep up slowly to follow clock drift
+    if (!dev->offsetValid || candidate < dev->offsetUs) {
+        dev->offsetUs = candidate;
+        dev->offsetValid = true;
+    } else {
+        dev->offsetUs += (candidate - dev->offsetUs) >> OFFSET_DRIFT_SHIFT;
+    }
+    return dev->offsetUs;
+}
+
+void Daemon::fuseDetection(int unit, int64_t atUs, uint8_t band, double freq, double bw,
+                           int rssi, int mod, int occupancy, const char* lat, const char* lon,
+                           int64_t utcUs) {
+    totalDetections++;
+
+    // Same matching rule as the firmware tracker: within 1 MHz, or
+    // overlapping occupied bands
+    FusedEmitter* e = nullptr;
+    for (int i = 0; i < fusedCount; i++) {
+        FusedEmitter& c = fused[i];
+        double separation = fabs(c.frequency - freq);
+        if (c.active && c.band == band &&
+            (separation < 1.0 || separation < (c.bandwidth + bw) / 2)) {
+            e = &c;
+            break;
+        }
+    }
+
+    if (e == nullptr) {
+        if (fusedCount < MAX_FUSED) {
+            e = &fused[fusedCount++];
+        } else {
+            // Full: reuse the stalest entry
+            e = &fused[0];
+            for (int i = 1; i < fusedCount; i++) {
+                if (fused[i].lastSeenUs < e->lastSeenUs) e = &fused[i];
+            }
+        }
+        memset(e, 0, sizeof(*e));
+        e->active = true;
+        e->band = band;
+        e->frequency = freq;
+        e->bandwidth = bw;
+        e->modType = mod;
+        e->bestRssi = rssi;
+        e->bestUnit = unit;
+        e->firstSeenUs = atUs;
+    } else {
+        mergedDetections++;
+    }
+
+    // One report per unit; repeats from later sweeps refresh it
+    UnitReport* r = nullptr;
+    for (int i = 0; i < e->reportCount; i++) {
+        if (e->reports[i].unit == unit) r = &e->reports[i];
+    }
+    if (r == nullptr && e->reportCount < MAX_UNITS_PER_EMITTER) {
+        r = &e->reports[e->reportCount++];
+        r->unit = unit;
+    } else if (r == nullptr) {
+        // Full: a louder unit displaces the quietest
+        UnitReport* weakest = &e->reports[0];
+        for (int i = 1; i < e->reportCount; i++) {
+            if (e->reports[i].rssi < weakest->rssi) weakest = &e->reports[i];
+        }
+        if (rssi > weakest->rssi) {
+            r = weakest;
+            r->unit = unit;
+        }
+    }
+    if (r != nullptr) {
+        r->rssi = rssi;
+        r->seenUs = atUs;
+        r->utcUs = utcUs;
+    }
+
+    // The unit hearing it loudest is closest; its view wins
+    bool strongest = unit == e->bestUnit || rssi >= e->bestRssi;
+    if (strongest) {
+        e->bestRssi = rssi;
+        e->bestUnit = unit;
+        e->frequency = freq;
+        e->bandwidth = bw;
+        e->modType = mod;
+        e->occupancy = occupancy;
+        if (lat[0] != '\0' && lon[0] != '\0') {
+            e->latitude = atof(lat);
+            e->longitude = atof(lon);
+            e->hasPosition = true;
+        }
+    }
+    if (atUs > e->lastSeenUs) e->lastSeenUs = atUs;
+    if (atUs < e->firstSeenUs) e->firstSeenUs = atUs;
+}
+
+void Daemon::expire(int64_t now) {
+    int kept = 0;
+    for (int i = 0; i < fusedCount; i++) {
+        FusedEmitter& e = fused[i];
+
+        // Drop units that stopped hearing it, then the emitter itself
+        int reports = 0;
+        int best = -1;
+        for (int k = 0; k < e.reportCount; k++) {
+            if (now - e.reports[k].seenUs > holdUs) continue;
+            e.reports[reports] = e.reports[k];
+            if (best < 0 || e.reports[reports].rssi > e.reports[best].rssi) best = reports;
+            reports++;
+        }
+        e.reportCount = reports;
+        if (reports == 0) continue;
+
+        e.bestUnit = e.reports[best].unit;
+        e.bestRssi = e.reports[best].rssi;
+        if (kept != i) fused[kept] = e;
+        kept++;
+    }
+    fusedCount = kept;
+
+    for (Device* dev : devices) {
+        if (dev->fd < 0 && now >= dev->reopenAtUs) openDevice(dev);
+    }
+}
+
+void Daemon::acceptClient() {
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        Client* client = new Client();
+        client->fd = fd;
+        clients.push_back(client);
+        watch(fd, EPOLLIN | EPOLLRDHUP, client);
+    }
+}
+
+void Daemon::readClient(Client* client) {
+    char buf[1024];
+    for (;;) {
+        ssize_t n = read(client->fd, buf, sizeof(buf));
+        if (n > 0) {
+            client->in.append(buf, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeClient(client);
+            return;
+        }
+        break;
+    }
+
+    size_t eol;
+    while ((eol = client->in.find('\n')) != std::string::npos) {
+        std::string command = client->in.substr(0, eol);
+        client->in.erase(0, eol + 1);
+        if (!command.empty() && command.back() == '\r') command.pop_back();
+        client->out += answer(command);
+    }
+    if (client->in.size() > 4096) client->in.clear();  // Not a line protocol
+    flushClient(client);
+}
+
+void Daemon::flushClient(Client* client) {
+    while (!client->out.empty()) {
+        ssize_t n = write(client->fd, client->out.data(), client->out.size());
+        if (n > 0) {
+            client->out.erase(0, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeClient(client);
+        return;
+    }
+
+    if (client->out.size() > CLIENT_OUT_MAX) {
+        closeClient(client);
+        return;
+    }
+
+    // Only ask for EPOLLOUT while there is something left to send
+    uint32_t events = EPOLLIN | EPOLLRDHUP | (client->out.empty() ? 0u : (uint32_t)EPOLLOUT);
+    watch(client->fd, events, client);
+}
+
+void Daemon::closeClient(Client* client) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client->fd, nullptr);
+    close(client->fd);
+    client->fd = -1;  // Freed at the end of the event batch
+}
+
+std::string Daemon::answer(const std::string& command) {
+    if (command == "emitters") return emittersJson();
+    if (command == "units") return unitsJson();
+    if (command == "stats") return statsJson();
+    return "{\"error\":\"unknown command, try emitters, units or stats\"}\n";
+}
+
+std::string Daemon::emittersJson() {
+    std::string out = "[";
+    char item[2048];
+    int64_t now = nowUs();
+
+    for (int i = 0; i < fusedCount; i++) {
+        const FusedEmitter& e = fused[i];
+        int mod = e.modType >= 0 && e.modType <= MOD_OFDM ? e.modType : MOD_UNKNOWN;
+        int n = snprintf(item, sizeof(item),
+                         "%s{\"band\":%u,\"freq\":%.3f,\"bw\":%.1f,\"mod\":\"%s\",\"rssi\":%d,"
+                         "\"occupancy\":%d,\"best_unit\":\"%04X\",\"age_ms\":%lld,\"seen_ms\":%lld",
+                         i > 0 ? "," : "", e.band, e.frequency, e.bandwidth, modNames[mod],
+                         e.bestRssi, e.occupancy, e.bestUnit,
+                         (long long)((now - e.lastSeenUs) / 1000),
+                         (long long)((e.lastSeenUs - e.firstSeenUs) / 1000));
+        if (e.hasPosition) {
+            n += snprintf(item + n, sizeof(item) - n, ",\"lat\":%.6f,\"lon\":%.6f",
+                          e.latitude, e.longitude);
+        }
+        n += snprintf(item + n, sizeof(item) - n, ",\"units\":[");
+        for (int k = 0; k < e.reportCount && n < (int)sizeof(item) - 64; k++) {
+            const UnitReport& r = e.reports[k];
+            n += snprintf(item + n, sizeof(item) - n, "%s{\"unit\":\"%04X\",\"rssi\":%d",
+                          k > 0 ? "," : "", r.unit, r.rssi);
+            if (r.utcUs != 0) {
+                n += snprintf(item + n, sizeof(item) - n, ",\"utc\":%lld.%06lld",
+                              (long long)(r.utcUs / 1000000), (long long)(r.utcUs % 1000000));
+            }
+            n += snprintf(item + n, sizeof(item) - n, "}");
+        }
+        snprintf(item + n, sizeof(item) - n, "]}");
+        out += item;
+    }
+    out += "]\n";
+    return out;
+}
+
+std::string Daemon::unitsJson() {
+    std::string out = "[";
+    char item[512];
+    int64_t now = nowUs();
+
+    for (size_t i = 0; i < devices.size(); i++) {
+        const Device* d = devices[i];
+        char unit[12] = "";
+        if (d->unit >= 0) snprintf(unit, sizeof(unit), "%04X", d->unit);
+        snprintf(item, sizeof(item),
+                 "%s{\"device\":\"%s\",\"unit\":\"%s\",\"connected\":%s,\"sentences\":%llu,"
+                 "\"sweeps\":%llu,\"detections\":%llu,\"bad_checksum\":%llu,\"overflows\":%llu,"
+                 "\"last_seen_ms\":%lld,\"clock_offset_ms\":%lld,\"synced\":%s}",
+                 i > 0 ? "," : "", d->path.c_str(), unit, d->fd >= 0 ? "true" : "false",
+                 (unsigned long long)d->sentences, (unsigned long long)d->sweeps,
+                 (unsigned long long)d->detections, (unsigned long long)d->badChecksum,
+                 (unsigned long long)d->overflows,
+                 d->lastSeenUs > 0 ? (long long)((now - d->lastSeenUs) / 1000) : -1LL,
+                 d->offsetValid ? (long long)(d->offsetUs / 1000) : 0LL,
+                 d->synced ? "true" : "false");
+        out += item;
+    }
+    out += "]\n";
+    return out;
+}
+
+std::string Daemon::statsJson() {
+    char out[256];
+    int connected = 0;
+    for (const Device* d : devices) connected += d->fd >= 0;
+    snprintf(out, sizeof(out),
+             "{\"uptime_s\":%lld,\"devices\":%zu,\"connected\":%d,\"emitters\":%d,"
+             "\"detections\":%llu,\"merged\":%llu,\"clients\":%zu}\n",
+             (long long)((nowUs() - startUs) / 1000000), devices.size(), connected, fusedCount,
+             (unsigned long long)totalDetections, (unsigned long long)mergedDetections,
+             clients.size());
+    return out;
+}
+
+void Daemon::run() {
+    struct epoll_event events[64];
+
+    while (!stopRequested) {
+        int n = epoll_wait(epollFd, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("[SPURD] epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            void* ptr = events[i].data.ptr;
+            uint32_t ev = events[i].events;
+
+            if (ptr == &listenTag) {
+                acceptClient();
+            } else if (ptr == &timerTag) {
+                uint64_t ticks;
+                if (read(timerFd, &ticks, sizeof(ticks)) < 0) continue;
+                expire(nowUs());
+            } else {
+                bool isDevice = false;
+                for (Device* dev : devices) {
+                    if (dev == ptr) {
+                        isDevice = true;
+                        // Drain what is buffered before acting on a hangup
+                        if (dev->fd >= 0) readDevice(dev);
+                        if (dev->fd >= 0 && (ev & (EPOLLHUP | EPOLLERR))) closeDevice(dev);
+                        break;
+                    }
+                }
+                if (!isDevice) {
+                    Client* client = (Client*)ptr;
+                    if (client->fd >= 0 && (ev & EPOLLOUT)) flushClient(client);
+                    if (client->fd >= 0 && (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) readClient(client);
+                }
+            }
+        }
+
+        // Free clients closed during this batch, now no event refers to them
+        for (size_t i = 0; i < clients.size();) {
+            if (clients[i]->fd < 0) {
+                delete clients[i];
+                clients[i] = clients.back();
+                clients.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+    unlink(socketPath.c_str());
+}
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: spurd [-s socket] [-H hold_ms] device...\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* socketPath = DEFAULT_SOCKET;
+    int holdMs = SIGNAL_HOLD_TIME_MS;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+            holdMs = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            usage();
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) usage();
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    Daemon daemon;
+    if (!daemon.begin(paths, socketPath, holdMs)) return 1;
+    daemon.run();
+    return 0;
+}
@@ -0,0 +1,489 @@
+/**
+ * @file spurd_load.cpp
+ * @brief Load test for spurd over pseudo-terminals
+ *
+ * Starts spurd on N ptys, each driven by a simulated unit sweeping back
+ * to back: a $SWP per sweep and a $DET for every emitter it hears on that
+ * band, formatted as sendTelemetry() prints them, with the human-readable
+ * [SCAN] lines in between. Every unit hears the same transmitters, at its
+ * own level and with its own frequency error.
+ *
+ * The daemon passes if
+ *   it keeps up    the writers never back up beyond PTY_BACKLOG_MAX, and
+ *                  every sentence is parsed within DRAIN_MS of the last
+ *                  one sent, with no checksum errors or overflows
+ *   it dedups      each transmitter is one fused emitter carrying one
+ *                  report per unit, and every other detection merged
+ *
+ * Build:  g++ -O2 -std=c++17 -Wall -o spurd tools/spurd.cpp
+ *         g++ -O2 -std=c++17 -Wall -o spurd_load tools/spurd_load.cpp
+ * Run:    ./spurd_load [-d ./spurd] [-n units] [-t seconds] [-p sweep_ms] [-f] [-v]
+ *
+ * -f feeds the daemon through FIFOs instead of ptys, which separates its
+ * own behaviour from anything the tty layer does to the stream.
+ * Exits 0 on a pass, 1 on a failure.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "../include/config.h"
+
+#define DEFAULT_DAEMON "./spurd"
+#define DEFAULT_UNITS 8
+#define DEFAULT_SECONDS 10
+#define DEFAULT_SWEEP_MS 20            // 141 channels at ~140 us each, back to back
+#define MAX_UNITS 64
+#define MAX_UNITS_PER_EMITTER 16       // As in spurd
+#define PTY_BACKLOG_MAX (64 * 1024)    // Queued in the harness because the pty was full
+#define START_TIMEOUT_MS 5000
+#define DRAIN_MS 500
+#define QUERY_TIMEOUT_MS 2000
+
+static int64_t nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// One transmitter every unit hears
+struct Transmitter {
+    uint8_t band;
+    float frequency;
+    float bandwidth;
+    int modType;
+};
+
+static const Transmitter scene[] = {
+    {0, 868.0f, 0.5f, MOD_LORA},
+    {0, 902.5f, 0.5f, MOD_FHSS},
+    {0, 915.0f, 0.5f, MOD_GFSK},
+    {0, 925.0f, 1.0f, MOD_FSK},
+    {1, 2412.0f, 20.0f, MOD_OFDM},
+    {1, 2437.0f, 22.0f, MOD_DSSS},
+    {1, 2462.0f, 20.0f, MOD_OFDM},
+    {1, 2480.0f, 1.0f, MOD_GFSK},
+};
+
+#define SCENE_SIZE (int)(sizeof(scene) / sizeof(scene[0]))
+
+// One simulated unit on the master side of a pty
+struct Unit {
+    int master;
+    std::string slavePath;
+    uint16_t id;
+    uint32_t bootMs;                   // millis() at the start of the run
+    uint32_t rng;
+    uint8_t band;
+    uint32_t sweeps[2];
+    int64_t nextSweepUs;
+    std::string pending;               // Written once the pty has room
+
+    uint64_t sentences;
+    uint64_t detections;
+    uint64_t bytes;
+    size_t maxBacklog;
+    uint64_t stalls;                   // Writes the pty could not take in full
+};
+
+static uint32_t nextRandom(Unit& u) {
+    u.rng = u.rng * 1664525u + 1013904223u;
+    return u.rng >> 8;
+}
+
+static void appendSentence(Unit& u, const char* body) {
+    uint8_t checksum = 0;
+    for (const char* p = body; *p; p++) checksum ^= (uint8_t)*p;
+
+    char line[TELEMETRY_LINE_MAX];
+    snprintf(line, sizeof(line), "$%s*%02X\r\n", body, checksum);
+    u.pending += line;
+    u.sentences++;
+}
+
+// One sweep's output, as handleSweep() prints it
+static void sweep(Unit& u, int64_t startUs, int64_t now, int64_t periodUs) {
+    uint8_t band = u.band;
+    u.band ^= 1;
+    u.sweeps[band]++;
+
+    uint32_t nowMs = u.bootMs + (uint32_t)((now - startUs) / 1000);
+    uint32_t sweepMs = nowMs - (uint32_t)(periodUs / 1000);
+    char body[TELEMETRY_LINE_MAX - 8];
+
+    int detected = 0;
+    for (int i = 0; i < SCENE_SIZE; i++) detected += scene[i].band == band;
+
+    snprintf(body, sizeof(body), "SWP,%04X,%lu,%u,%lu,%d,", u.id, (unsigned long)nowMs, band,
+             (unsigned long)u.sweeps[band], detected);
+    appendSentence(u, body);
+
+    for (int i = 0; i < SCENE_SIZE; i++) {
+        const Transmitter& t = scene[i];
+        if (t.band != band) continue;
+
+        // Each unit has its own level and up to 0.3 MHz of frequency error
+        float freq = t.frequency + (int)(nextRandom(u) % 61 - 30) * 0.01f;
+        int rssi = -45 - (u.id & 0xFF) % 40 - i - (int)(nextRandom(u) % 4);
+        uint32_t seenMs = sweepMs + nextRandom(u) % (uint32_t)(periodUs / 1000 + 1);
+
+        snprintf(body, sizeof(body), "DET,%04X,%lu,%u,%.3f,%.1f,%d,%d,%u,,,", u.id,
+                 (unsigned long)seenMs, band, freq, t.bandwidth, rssi, t.modType,
+                 40 + nextRandom(u) % 50);
+        appendSentence(u, body);
+        u.detections++;
+    }
+
+    // The readable log the parser has to skip
+    char log[96];
+    snprintf(log, sizeof(log), "[SCAN] %s: %d signals detected\r\n",
+             band == 0 ? "900MHz" : "2.4GHz", detected);
+    u.pending += log;
+}
+
+// Write what the pty takes now
+static void flushUnit(Unit& u) {
+    while (!u.pending.empty()) {
+        ssize_t n = write(u.master, u.pending.data(), u.pending.size());
+        if (n > 0) {
+            u.bytes += n;
+            u.pending.erase(0, n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        u.stalls++;
+        break;
+    }
+    if (u.pending.size() > u.maxBacklog) u.maxBacklog = u.pending.size();
+}
+
+static bool openPty(Unit& u) {
+    u.master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (u.master < 0 || grantpt(u.master) < 0 || unlockpt(u.master) < 0) {
+        perror("[LOAD] posix_openpt");
+        return false;
+    }
+    u.slavePath = ptsname(u.master);
+    fcntl(u.master, F_SETFL, fcntl(u.master, F_GETFL) | O_NONBLOCK);
+
+    // Raw from the start, so nothing written before spurd opens the slave
+    // is echoed or held for a line discipline
+    struct termios tio;
+    if (tcgetattr(u.master, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(u.master, TCSANOW, &tio);
+    }
+    return true;
+}
+
+// The same stream through a named pipe; spurd skips tty setup on it
+static bool openFifo(Unit& u, int index) {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/spurd_load.%d.%d", (int)getpid(), index);
+    unlink(path);
+    if (mkfifo(path, 0600) < 0) {
+        perror("[LOAD] mkfifo");
+        return false;
+    }
+    // Opened read-write so it never blocks waiting for spurd
+    u.master = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    u.slavePath = path;
+    return u.master >= 0;
+}
+
+static void removeFifos(std::vector<Unit>& units) {
+    for (Unit& u : units) {
+        if (u.slavePath.compare(0, 5, "/tmp/") == 0) unlink(u.slavePath.c_str());
+    }
+}
+
+// One command on the query socket, one JSON line back; empty on failure
+static std::string query(const char* socketPath, const char* command) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return "";
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socketPath);
+    struct timeval tv;
+    tv.tv_sec = QUERY_TIMEOUT_MS / 1000;
+    tv.tv_usec = (QUERY_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    std::string reply;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        std::string line = std::string(command) + "\n";
+        if (write(fd, line.data(), line.size()) == (ssize_t)line.size()) {
+            char buf[4096];
+            ssize_t n;
+            while ((n = read(fd, buf, sizeof(buf))) > 0) {
+                reply.append(buf, n);
+                if (reply.back() == '\n') break;
+            }
+        }
+    }
+    close(fd);
+    return reply;
+}
+
+// Every value of "key": in a JSON line, in order
+static std::vector<long long> jsonNumbers(const std::string& json, const char* key) {
+    std::vector<long long> values;
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t at = 0;
+    while ((at = json.find(pattern, at)) != std::string::npos) {
+        at += pattern.size();
+        values.push_back(strtoll(json.c_str() + at, nullptr, 10));
+    }
+    return values;
+}
+
+static long long jsonNumber(const std::string& json, const char* key) {
+    std::vector<long long> values = jsonNumbers(json, key);
+    return values.empty() ? -1 : values[0];
+}
+
+static pid_t startDaemon(const char* daemonPath, const char* socketPath,
+                         const std::vector<Unit>& units, bool verbose) {
+    std::vector<std::string> args = {daemonPath, "-s", socketPath};
+    for (const Unit& u : units) args.push_back(u.slavePath);
+
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    if (!verbose) {
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) dup2(null, STDOUT_FILENO);
+    }
+    std::vector<char*> argv;
+    for (std::string& a : args) argv.push_back(&a[0]);
+    argv.push_back(nullptr);
+    execv(daemonPath, argv.data());
+    perror("[LOAD] exec spurd");
+    _exit(127);
+}
+
+// Until the daemon answers with every device open
+static bool waitForDaemon(const char* socketPath, size_t unitCount) {
+    int64_t deadline = nowUs() + (int64_t)START_TIMEOUT_MS * 1000;
+    while (nowUs() < deadline) {
+        if (jsonNumber(query(socketPath, "stats"), "connected") == (long long)unitCount) return true;
+        usleep(20000);
+    }
+    return false;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: spurd_load [-d spurd] [-n units] [-t seconds] [-p sweep_ms] [-f] [-v]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    const char* daemonPath = DEFAULT_DAEMON;
+    int unitCount = DEFAULT_UNITS;
+    int seconds = DEFAULT_SECONDS;
+    int sweepMs = DEFAULT_SWEEP_MS;
+    bool useFifos = false;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            daemonPath = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            unitCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            sweepMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0) {
+            useFifos = true;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            usage();
+        }
+    }
+    if (unitCount < 1 || unitCount > MAX_UNITS || seconds < 1 || sweepMs < 1) usage();
+
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    std::vector<Unit> units(unitCount);
+    for (int i = 0; i < unitCount; i++) {
+        Unit& u = units[i];
+        if (!(useFifos ? openFifo(u, i) : openPty(u))) return 1;
+        u.id = (uint16_t)(0xA000 + i);
+        u.bootMs = 5000 + (uint32_t)i * 7919;
+        u.rng = 12345u + i;
+        u.band = (uint8_t)(i & 1);
+        u.sweeps[0] = u.sweeps[1] = 0;
+        u.sentences = u.detections = u.bytes = u.stalls = 0;
+        u.maxBacklog = 0;
+    }
+
+    char socketPath[64];
+    snprintf(socketPath, sizeof(socketPath), "/tmp/spurd_load.%d.sock", (int)getpid());
+    pid_t daemon = startDaemon(daemonPath, socketPath, units, verbose);
+    if (daemon < 0 || !waitForDaemon(socketPath, units.size())) {
+        fprintf(stderr, "[LOAD] spurd did not open all %d devices\n", unitCount);
+        if (daemon > 0) kill(daemon, SIGTERM);
+        removeFifos(units);
+        return 1;
+    }
+    printf("[LOAD] %d units, %d ms sweeps, %d s\n", unitCount, sweepMs, seconds);
+
+    // Sweep at full rate; a unit that falls behind catches up at once
+    int64_t periodUs = (int64_t)sweepMs * 1000;
+    int64_t startUs = nowUs();
+    int64_t endUs = startUs + (int64_t)seconds * 1000000;
+    for (int i = 0; i < unitCount; i++) {
+        units[i].nextSweepUs = startUs + periodUs * i / unitCount;
+    }
+
+    std::vector<struct pollfd> fds(unitCount);
+    int64_t now;
+    while ((now = nowUs()) < endUs) {
+        int64_t nextUs = endUs;
+        for (int i = 0; i < unitCount; i++) {
+            Unit& u = units[i];
+            while (u.nextSweepUs <= now) {
+                sweep(u, startUs, now, periodUs);
+                u.nextSweepUs += periodUs;
+            }
+            flushUnit(u);
+            if (u.nextSweepUs < nextUs) nextUs = u.nextSweepUs;
+            fds[i].fd = u.master;
+            fds[i].events = u.pending.empty() ? 0 : POLLOUT;
+        }
+        int waitMs = (int)((nextUs - nowUs() + 999) / 1000);
+        poll(fds.data(), fds.size(), waitMs > 0 ? waitMs : 0);
+    }
+
+    // Let the ptys drain, then give spurd DRAIN_MS to catch up
+    uint64_t sent = 0;
+    uint64_t detections = 0;
+    uint64_t bytes = 0;
+    size_t maxBacklog = 0;
+    uint64_t stalls = 0;
+    int64_t flushDeadline = nowUs() + (int64_t)START_TIMEOUT_MS * 1000;
+    for (Unit& u : units) {
+        while (!u.pending.empty() && nowUs() < flushDeadline) {
+            flushUnit(u);
+            if (!u.pending.empty()) usleep(1000);
+        }
+        sent += u.sentences;
+        detections += u.detections;
+        bytes += u.bytes;
+        stalls += u.stalls;
+        if (u.maxBacklog > maxBacklog) maxBacklog = u.maxBacklog;
+    }
+    int64_t lastWriteUs = nowUs();
+
+    std::string unitsJson;
+    int64_t caughtUpUs = -1;
+    do {
+        unitsJson = query(socketPath, "units");
+        std::vector<long long> parsed = jsonNumbers(unitsJson, "sentences");
+        uint64_t total = 0;
+        for (long long p : parsed) total += p;
+        if (total == sent) {
+            caughtUpUs = nowUs() - lastWriteUs;
+            break;
+        }
+        usleep(5000);
+    } while (nowUs() - lastWriteUs < (int64_t)DRAIN_MS * 1000);
+
+    std::string stats = query(socketPath, "stats");
+    std::string emitters = query(socketPath, "emitters");
+    kill(daemon, SIGTERM);
+    waitpid(daemon, nullptr, 0);
+    removeFifos(units);
+
+    double elapsed = (lastWriteUs - startUs) / 1e6;
+    printf("[LOAD] Sent %llu sentences (%.0f/s, %.1f kB/s), %llu detections\n",
+           (unsigned long long)sent, sent / elapsed, bytes / elapsed / 1000,
+           (unsigned long long)detections);
+    printf("[LOAD] Largest backlog %zu bytes, %llu stalled writes\n", maxBacklog,
+           (unsigned long long)stalls);
+
+    bool pass = true;
+
+    // Kept up: nothing queued for long, everything parsed, nothing corrupted
+    if (maxBacklog > PTY_BACKLOG_MAX) {
+        printf("[LOAD] FAIL: writers backed up by %zu bytes\n", maxBacklog);
+        pass = false;
+    }
+    if (caughtUpUs < 0) {
+        printf("[LOAD] FAIL: spurd had not parsed everything %d ms after the last write\n",
+               DRAIN_MS);
+        pass = false;
+    } else {
+        printf("[LOAD] Caught up %.1f ms after the last write\n", caughtUpUs / 1000.0);
+    }
+
+    std::vector<long long> parsed = jsonNumbers(unitsJson, "sentences");
+    std::vector<long long> badChecksum = jsonNumbers(unitsJson, "bad_checksum");
+    std::vector<long long> overflows = jsonNumbers(unitsJson, "overflows");
+    if (parsed.size() != units.size()) {
+        printf("[LOAD] FAIL: units query gave %zu devices\n", parsed.size());
+        pass = false;
+    }
+    for (size_t i = 0; i < parsed.size() && i < units.size(); i++) {
+        if (parsed[i] != (long long)units[i].sentences || badChecksum[i] != 0 || overflows[i] != 0) {
+            printf("[LOAD] FAIL: %s parsed %lld of %llu, %lld bad, %lld overflows\n",
+                   units[i].slavePath.c_str(), parsed[i], (unsigned long long)units[i].sentences,
+                   badChecksum[i], overflows[i]);
+            pass = false;
+        }
+    }
+
+    // Deduplicated: one emitter per transmitter, one report per unit
+    std::vector<long long> bands = jsonNumbers(emitters, "band");
+    int expectReports = unitCount < MAX_UNITS_PER_EMITTER ? unitCount : MAX_UNITS_PER_EMITTER;
+    if ((int)bands.size() != SCENE_SIZE) {
+        printf("[LOAD] FAIL: %zu fused emitters for %d transmitters\n", bands.size(), SCENE_SIZE);
+        pass = false;
+    }
+    size_t at = 0;
+    while ((at = emitters.find("{\"band\":", at)) != std::string::npos) {
+        size_t end = emitters.find("]}", at);
+        std::string item = emitters.substr(at, end - at);
+        int reports = 0;
+        for (size_t k = 0; (k = item.find("{\"unit\":", k)) != std::string::npos; k++) reports++;
+        if (reports != expectReports) {
+            printf("[LOAD] FAIL: %d unit reports, expected %d: %s\n", reports, expectReports,
+                   item.c_str());
+            pass = false;
+        }
+        at = end;
+    }
+
+    long long fusedDetections = jsonNumber(stats, "detections");
+    long long merged = jsonNumber(stats, "merged");
+    if (fusedDetections != (long long)detections || merged != fusedDetections - SCENE_SIZE) {
+        printf("[LOAD] FAIL: %lld detections fused, %lld merged; expected %llu and %llu\n",
+               fusedDetections, merged, (unsigned long long)detections,
+               (unsigned long long)(detections - SCENE_SIZE));
+        pass = false;
+    }
+
+    printf("[LOAD] %s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
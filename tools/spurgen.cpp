@@ -0,0 +1,308 @@
+/**
+ * @file spurgen.cpp
+ * @brief Synthetic sweep captures for benchmarking spurscan
+ *
+ * Writes one directory per unit of log files in FlashLogger's on-flash
+ * format: CRC-checked blocks of LOG_PAGE_SIZE, each packed with logged
+ * sweep rows of both bands, alternating. Every row is a noise floor
+ * with the unit's emitters drawn over it:
+ *
+ *   narrow   one or two channels, like a LoRa or FSK link
+ *   rolloff  a peak falling off 3 dB a channel, like DSSS
+ *   plateau  a flat block of channels, like OFDM video
+ *
+ * Each emitter keys on and off with its own cadence, so tracks open and
+ * close throughout a session. Units reboot -b times along the way,
+ * restarting their timestamps, so spurscan sees several sessions per
+ * unit. The output depends only on the options and the seed.
+ *
+ * Build:  g++ -O2 -std=c++17 -Wall -o spurgen tools/spurgen.cpp
+ * Run:    ./spurgen [-u units] [-s MB_per_unit] [-f MB_per_file] [-b boots]
+ *                   [-e emitters] [-r seed] out_dir
+ *
+ * Files are larger than a unit would write (LOG_FILE_MAX_BYTES) so that a
+ * multi-GB capture is not hundreds of thousands of files; spurscan does
+ * not care how the blocks are split between files.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "../include/config.h"
+
+#define DEFAULT_UNITS 4
+#define DEFAULT_UNIT_MB 512
+#define DEFAULT_FILE_MB 64
+#define DEFAULT_BOOTS 4
+#define DEFAULT_EMITTERS 6             // Per band
+#define ROW_INTERVAL_MS (LOG_SWEEP_DECIMATION * 100)   // ~100 ms sweeps
+#define NOISE_DBM -105
+#define NOISE_SPREAD_DB 4
+
+// On-flash format, mirrored from flash_logger.h (which needs Arduino)
+#define LOG_BLOCK_MAGIC 0x474C5053
+#define LOG_REC_SWEEP_ROW 2
+#define LOG_RECORD_PREFIX 2
+
+struct __attribute__((packed)) LogBlockHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint16_t payloadLength;
+    uint16_t recordCount;
+    uint32_t crc;
+};
+
+struct __attribute__((packed)) LogSweepRowHeader {
+    uint32_t timestamp;
+    uint8_t band;
+    uint8_t channelCount;
+};
+
+enum Shape { SHAPE_NARROW, SHAPE_ROLLOFF, SHAPE_PLATEAU };
+
+struct Emitter {
+    Shape shape;
+    int channel;                   // Lowest channel occupied
+    int width;
+    int levelDbm;                  // At the peak
+    uint32_t onRows;
+    uint32_t offRows;
+    uint32_t phase;
+};
+
+static uint32_t rngState;
+
+static uint32_t rng() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+static int rngRange(int lo, int hi) {
+    return lo + (int)(rng() % (uint32_t)(hi - lo + 1));
+}
+
+// CRC-32 as FlashLogger::crc32()
+static uint32_t crcTable[256];
+
+static void crcInit() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (c & 1 ? 0xEDB88320 : 0);
+        crcTable[i] = c;
+    }
+}
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void makeEmitters(int channels, int count, std::vector<Emitter>& out) {
+    for (int i = 0; i < count; i++) {
+        Emitter e;
+        e.shape = (Shape)(i % 3);
+        e.width = e.shape == SHAPE_NARROW ? rngRange(1, 2)
+                : e.shape == SHAPE_ROLLOFF ? rngRange(7, 11) : rngRange(10, 20);
+        if (e.width > channels / 4) e.width = channels / 4;
+        e.channel = rngRange(0, channels - e.width);
+        e.levelDbm = rngRange(-80, -40);
+        e.onRows = (uint32_t)rngRange(20, 400);
+        e.offRows = (uint32_t)rngRange(50, 2000);
+        e.phase = rng();
+        out.push_back(e);
+    }
+}
+
+static void drawRow(const std::vector<Emitter>& emitters, uint32_t row, int channels, int8_t* data) {
+    for (int ch = 0; ch < channels; ch++) {
+        data[ch] = (int8_t)(NOISE_DBM + rngRange(-NOISE_SPREAD_DB, NOISE_SPREAD_DB));
+    }
+
+    for (const Emitter& e : emitters) {
+        if ((row + e.phase) % (e.onRows + e.offRows) >= e.onRows) continue;
+        int mid = e.channel + e.width / 2;
+        for (int k = 0; k < e.width; k++) {
+            int ch = e.channel + k;
+            int level = e.levelDbm + rngRange(-1, 1);
+            if (e.shape == SHAPE_ROLLOFF) level -= 3 * abs(ch - mid);
+            if (level > data[ch]) data[ch] = (int8_t)level;
+        }
+    }
+}
+
+struct Writer {
+    std::string dir;
+    size_t fileBytes;
+    FILE* file;
+    int fileIndex;
+    size_t written;                // Into the current file
+    uint64_t total;
+    uint32_t sequence;
+    uint8_t page[LOG_PAGE_SIZE];
+    size_t used;
+    uint16_t records;
+};
+
+static bool openNext(Writer& w) {
+    if (w.file != nullptr) fclose(w.file);
+    char name[32];
+    snprintf(name, sizeof(name), "/log%05d.bin", w.fileIndex++);
+    w.file = fopen((w.dir + name).c_str(), "wb");
+    if (w.file == nullptr) {
+        perror((w.dir + name).c_str());
+        return false;
+    }
+    w.written = 0;
+    return true;
+}
+
+// Seal the page as FlashLogger does: sequence and lengths, then payload
+static bool sealPage(Writer& w) {
+    if (w.records == 0) return true;
+
+    LogBlockHeader hdr;
+    hdr.magic = LOG_BLOCK_MAGIC;
+    hdr.sequence = w.sequence++;
+    hdr.payloadLength = (uint16_t)(w.used - sizeof(hdr));
+    hdr.recordCount = w.records;
+    const uint8_t* fields = (const uint8_t*)&hdr.sequence;
+    hdr.crc = crc32(w.page + sizeof(hdr), hdr.payloadLength,
+                    crc32(fields, offsetof(LogBlockHeader, crc) - offsetof(LogBlockHeader, sequence)));
+    memcpy(w.page, &hdr, sizeof(hdr));
+
+    if (w.written + w.used > w.fileBytes && w.written > 0 && !openNext(w)) return false;
+    if (fwrite(w.page, 1, w.used, w.file) != w.used) {
+        perror(w.dir.c_str());
+        return false;
+    }
+    w.written += w.used;
+    w.total += w.used;
+    w.used = sizeof(LogBlockHeader);
+    w.records = 0;
+    return true;
+}
+
+static bool appendRow(Writer& w, uint32_t timestamp, uint8_t band, const int8_t* data, int channels) {
+    size_t len = sizeof(LogSweepRowHeader) + channels;
+    if (w.used + LOG_RECORD_PREFIX + len > LOG_PAGE_SIZE && !sealPage(w)) return false;
+
+    LogSweepRowHeader row;
+    row.timestamp = timestamp;
+    row.band = band;
+    row.channelCount = (uint8_t)channels;
+
+    uint8_t* p = w.page + w.used;
+    p[0] = LOG_REC_SWEEP_ROW;
+    p[1] = (uint8_t)len;
+    memcpy(p + LOG_RECORD_PREFIX, &row, sizeof(row));
+    memcpy(p + LOG_RECORD_PREFIX + sizeof(row), data, channels);
+    w.used += LOG_RECORD_PREFIX + len;
+    w.records++;
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: spurgen [-u units] [-s MB_per_unit] [-f MB_per_file] [-b boots] "
+                    "[-e emitters] [-r seed] out_dir\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    int units = DEFAULT_UNITS;
+    double unitMB = DEFAULT_UNIT_MB;
+    double fileMB = DEFAULT_FILE_MB;
+    int boots = DEFAULT_BOOTS;
+    int emitterCount = DEFAULT_EMITTERS;
+    uint32_t seed = 1;
+    const char* outDir = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            units = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            unitMB = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            fileMB = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            boots = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            emitterCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-' || outDir != nullptr) {
+            usage();
+        } else {
+            outDir = argv[i];
+        }
+    }
+    if (outDir == nullptr || units < 1 || unitMB <= 0 || fileMB <= 0 || boots < 1) usage();
+
+    if (mkdir(outDir, 0755) != 0 && errno != EEXIST) {
+        perror(outDir);
+        return 1;
+    }
+
+    crcInit();
+    const int channels[2] = { CHANNELS_900, CHANNELS_2400 };
+    int8_t data[256];              // channelCount is a byte
+    uint64_t totalBytes = 0;
+    uint64_t totalRows = 0;
+
+    for (int u = 0; u < units; u++) {
+        rngState = seed * 7919u + u;
+        std::vector<Emitter> emitters[2];
+        makeEmitters(channels[0], emitterCount, emitters[0]);
+        makeEmitters(channels[1], emitterCount, emitters[1]);
+
+        Writer w;
+        char name[32];
+        snprintf(name, sizeof(name), "/unit%02d", u);
+        w.dir = std::string(outDir) + name;
+        if (mkdir(w.dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            perror(w.dir.c_str());
+            return 1;
+        }
+        w.fileBytes = (size_t)(fileMB * 1e6);
+        w.file = nullptr;
+        w.fileIndex = 0;
+        w.sequence = 0;
+        w.total = 0;
+        w.used = sizeof(LogBlockHeader);
+        w.records = 0;
+        if (!openNext(w)) return 1;
+
+        // One row of each band per interval, until the unit's share is written
+        size_t pairBytes = 2 * (LOG_RECORD_PREFIX + sizeof(LogSweepRowHeader)) + channels[0] + channels[1];
+        uint64_t pairs = (uint64_t)(unitMB * 1e6) / pairBytes;
+        uint64_t pairsPerBoot = (pairs + boots - 1) / boots;
+
+        uint32_t timestamp = 0;
+        for (uint64_t p = 0; p < pairs; p++) {
+            if (p % pairsPerBoot == 0) timestamp = (uint32_t)rngRange(3000, 8000);
+            for (int band = 0; band < 2; band++) {
+                drawRow(emitters[band], (uint32_t)p, channels[band], data);
+                if (!appendRow(w, timestamp + band * ROW_INTERVAL_MS / 2, (uint8_t)band,
+                               data, channels[band])) return 1;
+            }
+            timestamp += ROW_INTERVAL_MS;
+        }
+        if (!sealPage(w)) return 1;
+        fclose(w.file);
+
+        totalBytes += w.total;
+        totalRows += pairs * 2;
+    }
+
+    printf("%d units, %.1f MB, %llu rows\n", units, totalBytes / 1e6, (unsigned long long)totalRows);
+    return 0;
+}
@@ -0,0 +1,709 @@
+/**
+ * @file spurscan.cpp
+ * @brief Bulk replay of recorded sweep captures through the firmware detector
+ *
+ * Reads the log files FlashLogger writes (one directory per unit, copied
+ * off LittleFS), memory-maps them and re-runs the firmware's own
+ * detection, clustering and classification (BandAnalyzer) over every
+ * logged sweep row. Work is split three ways:
+ *
+ *   index    each file is validated block by block (magic, length, CRC)
+ *            and its sweep rows are listed, one task per file
+ *   analyze  each boot session is cut into chunks of rows, one task per
+ *            chunk; a chunk first replays the rows just before it so its
+ *            noise floors and variance window match a straight run
+ *   track    each session's sightings, in chunk order, are folded into
+ *            emitter tracks, one task per session
+ *
+ * Tasks are claimed from a shared counter by one worker per core, so a
+ * slow chunk never holds up the others. Detection is nearly all of the
+ * work; tracking is cheap and runs over whole sessions, so the emitter
+ * table does not depend on the chunk size or thread count.
+ *
+ * Rows are logged without their per-channel histogram, so occupancy is
+ * taken as 100% on channels above threshold and 0% elsewhere.
+ *
+ * Build:  g++ -O2 -std=c++17 -Wall -pthread -Iinclude -o spurscan tools/spurscan.cpp \
+ *             src/band_analyzer.cpp src/spur_mask.cpp src/sweep_kernels.cpp \
+ *             src/emitter_cluster.cpp src/classifier.cpp
+ * Run:    ./spurscan [-j threads] [-c chunk_rows] [-w warmup_rows] [-H hold_ms] [-o out.csv] [-B]
+ *                    unit_dir...
+ *
+ * A path may also be a single .bin file. Files within a unit are read in
+ * name order, which is the order FlashLogger numbers them in.
+ *
+ * -B benchmarks the replay: after an untimed pass to map the files, it
+ * runs once on one thread and once on -j threads, prints each stage's
+ * speedup, and exits 1 if the two emitter tables differ. tools/spurgen.cpp
+ * writes synthetic captures of any size to run it on.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/config.h"
+#include "../include/band_analyzer.h"
+
+#define DEFAULT_CHUNK_ROWS 4096
+#define DEFAULT_WARMUP_ROWS 256        // Floors settle well within this
+#define DEFAULT_HOLD_MS 60000          // A few logged rows at the default decimation
+#define MOD_COUNT (MOD_OFDM + 1)
+
+// On-flash format, mirrored from flash_logger.h (which needs Arduino)
+#define LOG_BLOCK_MAGIC 0x474C5053
+#define LOG_REC_SWEEP_ROW 2
+#define LOG_RECORD_PREFIX 2
+
+struct __attribute__((packed)) LogBlockHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint16_t payloadLength;
+    uint16_t recordCount;
+    uint32_t crc;
+};
+
+struct __attribute__((packed)) LogSweepRowHeader {
+    uint32_t timestamp;
+    uint8_t band;
+    uint8_t channelCount;
+};
+
+static const char* const modNames[] = {
+    "UNKNOWN", "FSK", "GFSK", "LoRa", "FHSS", "DSSS", "OFDM"
+};
+
+static int64_t nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// CRC-32 as FlashLogger::crc32(); a byte-wise table, since the firmware's
+// 64-byte nibble table would make indexing CRC-bound on the host
+static uint32_t crcTable[256];
+
+static void crcInit() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (c & 1 ? 0xEDB88320 : 0);
+        crcTable[i] = c;
+    }
+}
+
+static uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Run tasks 0..count-1 on a fixed set of workers
+ *
+ * Workers claim the next unstarted task from a shared counter, so uneven
+ * tasks balance themselves without a scheduler.
+ */
+static void runTasks(int threads, size_t count, const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) task(i);
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads && (size_t)t < count; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& th : pool) th.join();
+}
+
+struct SweepRow {
+    uint32_t timestamp;            // millis() on the unit
+    uint8_t band;
+    const int8_t* data;            // Into the mapped file
+};
+
+struct LogFile {
+    std::string path;
+    int unit;
+    const uint8_t* base;
+    size_t size;
+    std::vector<SweepRow> rows;
+    uint32_t blocks;
+    bool torn;                     // Stopped at a bad block before the end
+};
+
+struct Unit {
+    std::string name;
+    std::vector<int> files;        // Indices into the file list, in name order
+};
+
+// A run of one unit's rows for one band with no reboot in between
+struct Session {
+    int unit;
+    int index;                     // Boot count within the unit
+    uint8_t band;
+    std::vector<SweepRow> rows;
+};
+
+struct Chunk {
+    int session;
+    size_t begin;                  // First row reported
+    size_t end;
+    size_t warmBegin;              // First row replayed
+};
+
+// One emitter in one row
+struct Sighting {
+    uint32_t timestamp;
+    float lowMHz;
+    float highMHz;
+    float centerMHz;
+    int8_t peakDbm;
+    uint8_t modType;
+};
+
+struct Track {
+    int unit;
+    int session;
+    uint8_t band;
+    float lowMHz;                  // Occupied span over all sightings
+    float highMHz;
+    float peakMHz;                 // Centre at the strongest sighting
+    int8_t peakDbm;
+    int64_t sumDbm;
+    uint32_t firstMs;
+    uint32_t lastMs;
+    uint32_t sightings;
+    uint32_t votes[MOD_COUNT];
+};
+
+static ModulationType trackModulation(const Track& t) {
+    int best = MOD_UNKNOWN;
+    for (int m = 1; m < MOD_COUNT; m++) {
+        if (t.votes[m] > t.votes[best]) best = m;
+    }
+    return (ModulationType)best;
+}
+
+static float bandStep(uint8_t band) {
+    return band == 0 ? FREQ_900_STEP : FREQ_2400_STEP;
+}
+
+// Spans overlap, allowing one channel of slack for a wandering centre
+static bool overlaps(const Track& t, float lowMHz, float highMHz) {
+    float slack = bandStep(t.band);
+    return lowMHz <= t.highMHz + slack && highMHz >= t.lowMHz - slack;
+}
+
+static void mergeTrack(Track& into, const Track& from) {
+    into.lowMHz = std::min(into.lowMHz, from.lowMHz);
+    into.highMHz = std::max(into.highMHz, from.highMHz);
+    if (from.peakDbm > into.peakDbm) {
+        into.peakDbm = from.peakDbm;
+        into.peakMHz = from.peakMHz;
+    }
+    into.sumDbm += from.sumDbm;
+    into.firstMs = std::min(into.firstMs, from.firstMs);
+    into.lastMs = std::max(into.lastMs, from.lastMs);
+    into.sightings += from.sightings;
+    for (int m = 0; m < MOD_COUNT; m++) into.votes[m] += from.votes[m];
+}
+
+static bool mapFile(LogFile& file) {
+    int fd = open(file.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror(file.path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror(file.path.c_str());
+        return false;
+    }
+
+    madvise(p, st.st_size, MADV_SEQUENTIAL);
+    file.base = (const uint8_t*)p;
+    file.size = st.st_size;
+    return true;
+}
+
+/**
+ * @brief List a file's sweep rows, stopping at the first bad block
+ *
+ * The same walk FlashLogger::recover() does on the unit: a torn write can
+ * only ever cost the tail of the newest file.
+ */
+static void indexFile(LogFile& file) {
+    size_t pos = 0;
+    file.blocks = 0;
+    file.torn = false;
+
+    while (pos + sizeof(LogBlockHeader) <= file.size) {
+        LogBlockHeader hdr;
+        memcpy(&hdr, file.base + pos, sizeof(hdr));
+        const uint8_t* payload = file.base + pos + sizeof(hdr);
+
+        if (hdr.magic != LOG_BLOCK_MAGIC ||
+            pos + sizeof(hdr) + hdr.payloadLength > file.size ||
+            crc32(payload, hdr.payloadLength,
+                  crc32(file.base + pos + offsetof(LogBlockHeader, sequence),
+                        offsetof(LogBlockHeader, crc) - offsetof(LogBlockHeader, sequence))) != hdr.crc) {
+            file.torn = true;
+            return;
+        }
+
+        size_t off = 0;
+        for (int r = 0; r < hdr.recordCount && off + LOG_RECORD_PREFIX <= hdr.payloadLength; r++) {
+            uint8_t type = payload[off];
+            uint8_t len = payload[off + 1];
+            const uint8_t* rec = payload + off + LOG_RECORD_PREFIX;
+            off += LOG_RECORD_PREFIX + len;
+            if (off > hdr.payloadLength) break;
+            if (type != LOG_REC_SWEEP_ROW || len < sizeof(LogSweepRowHeader)) continue;
+
+            LogSweepRowHeader row;
+            memcpy(&row, rec, sizeof(row));
+            int expected = row.band == 0 ? CHANNELS_900 : CHANNELS_2400;
+            if (row.band > 1 || row.channelCount != expected ||
+                len != sizeof(row) + row.channelCount) continue;
+
+            SweepRow sr;
+            sr.timestamp = row.timestamp;
+            sr.band = row.band;
+            sr.data = (const int8_t*)rec + sizeof(row);
+            file.rows.push_back(sr);
+        }
+
+        file.blocks++;
+        pos += sizeof(hdr) + hdr.payloadLength;
+    }
+
+    file.torn = pos != file.size;
+}
+
+/**
+ * @brief Replay a chunk and list the emitters in each of its rows
+ */
+static void analyzeChunk(const Session& session, const Chunk& chunk, std::vector<Sighting>& out) {
+    uint8_t band = session.band;
+    int channels = band == 0 ? CHANNELS_900 : CHANNELS_2400;
+    float start = band == 0 ? FREQ_900_START : FREQ_2400_START;
+
+    // Too large for a worker's stack once history is included
+    BandAnalyzer* analyzer = new BandAnalyzer();
+    analyzer->begin(band, channels, start, bandStep(band));
+
+    EmitterCluster clusters[CLUSTER_MAX];
+    for (size_t r = chunk.warmBegin; r < chunk.end; r++) {
+        const SweepRow& row = session.rows[r];
+        for (int ch = 0; ch < channels; ch++) {
+            int8_t v = row.data[ch];
+            analyzer->setSample(ch, v, v, v > analyzer->getThreshold(ch) ? 100 : 0);
+        }
+
+        int detected = analyzer->detect(clusters, CLUSTER_MAX);
+        if (r < chunk.begin) continue;
+
+        for (int i = 0; i < detected; i++) {
+            const EmitterCluster& c = clusters[i];
+            Sighting s;
+            s.timestamp = row.timestamp;
+            s.lowMHz = c.centerMHz - c.bandwidthMHz / 2;
+            s.highMHz = c.centerMHz + c.bandwidthMHz / 2;
+            s.centerMHz = c.centerMHz;
+            s.peakDbm = c.peakDbm;
+            s.modType = (uint8_t)analyzer->classify(c);
+            out.push_back(s);
+        }
+    }
+
+    delete analyzer;
+}
+
+/**
+ * @brief Fold a session's sightings into emitter tracks
+ *
+ * A sighting joins the first open track it overlaps. A track closes once
+ * its emitter has been absent for longer than the hold time; a later
+ * sighting opens a new one.
+ */
+static void trackSession(const Session& session, const std::vector<Sighting>* chunks, size_t count,
+                         uint32_t holdMs, std::vector<Track>& out) {
+    std::vector<Track> open;
+
+    for (size_t k = 0; k < count; k++) {
+        for (const Sighting& s : chunks[k]) {
+            for (size_t i = 0; i < open.size();) {
+                if (s.timestamp - open[i].lastMs > holdMs) {
+                    out.push_back(open[i]);
+                    open.erase(open.begin() + i);
+                } else {
+                    i++;
+                }
+            }
+
+            Track t;
+            memset(&t, 0, sizeof(t));
+            t.unit = session.unit;
+            t.session = session.index;
+            t.band = session.band;
+            t.lowMHz = s.lowMHz;
+            t.highMHz = s.highMHz;
+            t.peakMHz = s.centerMHz;
+            t.peakDbm = s.peakDbm;
+            t.sumDbm = s.peakDbm;
+            t.firstMs = s.timestamp;
+            t.lastMs = s.timestamp;
+            t.sightings = 1;
+            t.votes[s.modType] = 1;
+
+            bool merged = false;
+            for (Track& o : open) {
+                if (overlaps(o, s.lowMHz, s.highMHz)) {
+                    mergeTrack(o, t);
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) open.push_back(t);
+        }
+    }
+
+    out.insert(out.end(), open.begin(), open.end());
+}
+
+static bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static std::string baseName(const std::string& path) {
+    std::string p = path;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    size_t slash = p.rfind('/');
+    return slash == std::string::npos ? p : p.substr(slash + 1);
+}
+
+static bool addUnit(const std::string& path, std::vector<Unit>& units, std::vector<LogFile>& files) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        perror(path.c_str());
+        return false;
+    }
+
+    std::vector<std::string> paths;
+    if (S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path.c_str());
+        if (dir == nullptr) {
+            perror(path.c_str());
+            return false;
+        }
+        for (struct dirent* e = readdir(dir); e != nullptr; e = readdir(dir)) {
+            std::string name = e->d_name;
+            if (endsWith(name, ".bin")) paths.push_back(path + "/" + name);
+        }
+        closedir(dir);
+        std::sort(paths.begin(), paths.end());
+    } else {
+        paths.push_back(path);
+    }
+
+    Unit unit;
+    unit.name = baseName(path);
+    if (endsWith(unit.name, ".bin")) unit.name.resize(unit.name.size() - 4);
+    for (const std::string& p : paths) {
+        LogFile f;
+        f.path = p;
+        f.unit = (int)units.size();
+        f.base = nullptr;
+        f.size = 0;
+        f.blocks = 0;
+        f.torn = false;
+        unit.files.push_back((int)files.size());
+        files.push_back(f);
+    }
+    units.push_back(unit);
+    return true;
+}
+
+/**
+ * @brief Split each unit's rows into per-band sessions at reboots
+ *
+ * millis() restarts at boot, so a timestamp going backwards is a new
+ * session.
+ */
+static void buildSessions(const std::vector<Unit>& units, const std::vector<LogFile>& files,
+                          std::vector<Session>& sessions) {
+    for (size_t u = 0; u < units.size(); u++) {
+        int boot = 0;
+        uint32_t last = 0;
+        int current[2] = { -1, -1 };
+
+        for (int fi : units[u].files) {
+            for (const SweepRow& row : files[fi].rows) {
+                if (row.timestamp < last) {
+                    boot++;
+                    current[0] = current[1] = -1;
+                }
+                last = row.timestamp;
+
+                if (current[row.band] < 0) {
+                    Session s;
+                    s.unit = (int)u;
+                    s.index = boot;
+                    s.band = row.band;
+                    current[row.band] = (int)sessions.size();
+                    sessions.push_back(s);
+                }
+                sessions[current[row.band]].rows.push_back(row);
+            }
+        }
+    }
+}
+
+static void writeCsv(FILE* out, const std::vector<Unit>& units, const std::vector<Track>& tracks) {
+    fprintf(out, "unit,session,band,freq_mhz,bw_mhz,mod,first_ms,last_ms,sightings,peak_dbm,mean_dbm\n");
+    for (const Track& t : tracks) {
+        fprintf(out, "%s,%d,%s,%.2f,%.2f,%s,%u,%u,%u,%d,%.1f\n",
+                units[t.unit].name.c_str(), t.session, t.band == 0 ? "900" : "2400",
+                t.peakMHz, t.highMHz - t.lowMHz, modNames[trackModulation(t)],
+                t.firstMs, t.lastMs, t.sightings, t.peakDbm,
+                (double)t.sumDbm / t.sightings);
+    }
+}
+
+// Tracks from two runs, field by field; the structs carry padding
+static bool sameTracks(const std::vector<Track>& a, const std::vector<Track>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        const Track& x = a[i];
+        const Track& y = b[i];
+        if (x.unit != y.unit || x.session != y.session || x.band != y.band ||
+            x.lowMHz != y.lowMHz || x.highMHz != y.highMHz || x.peakMHz != y.peakMHz ||
+            x.peakDbm != y.peakDbm || x.sumDbm != y.sumDbm || x.firstMs != y.firstMs ||
+            x.lastMs != y.lastMs || x.sightings != y.sightings ||
+            memcmp(x.votes, y.votes, sizeof(x.votes)) != 0) return false;
+    }
+    return true;
+}
+
+struct Replay {
+    size_t sessions;
+    size_t chunks;
+    std::vector<Track> tracks;
+    double indexS;
+    double analyzeS;
+    double trackS;
+};
+
+/**
+ * @brief Index, analyze and track every file on a number of threads
+ *
+ * Files are mapped on first use and stay mapped, so a second run only
+ * repeats the work.
+ */
+static void replay(std::vector<LogFile>& files, const std::vector<Unit>& units, int threads,
+                   size_t chunkRows, size_t warmupRows, uint32_t holdMs, Replay& out) {
+    int64_t t0 = nowUs();
+    runTasks(threads, files.size(), [&](size_t i) {
+        files[i].rows.clear();
+        if (files[i].base != nullptr || mapFile(files[i])) indexFile(files[i]);
+    });
+
+    std::vector<Session> sessions;
+    buildSessions(units, files, sessions);
+
+    std::vector<Chunk> chunks;
+    std::vector<size_t> firstChunk;
+    for (size_t s = 0; s < sessions.size(); s++) {
+        firstChunk.push_back(chunks.size());
+        size_t n = sessions[s].rows.size();
+        for (size_t begin = 0; begin < n; begin += chunkRows) {
+            Chunk c;
+            c.session = (int)s;
+            c.begin = begin;
+            c.end = std::min(n, begin + chunkRows);
+            c.warmBegin = begin > warmupRows ? begin - warmupRows : 0;
+            chunks.push_back(c);
+        }
+    }
+    firstChunk.push_back(chunks.size());
+
+    int64_t t1 = nowUs();
+    std::vector<std::vector<Sighting>> sightings(chunks.size());
+    runTasks(threads, chunks.size(), [&](size_t i) {
+        analyzeChunk(sessions[chunks[i].session], chunks[i], sightings[i]);
+    });
+
+    int64_t t2 = nowUs();
+    std::vector<std::vector<Track>> sessionTracks(sessions.size());
+    runTasks(threads, sessions.size(), [&](size_t s) {
+        trackSession(sessions[s], &sightings[firstChunk[s]], firstChunk[s + 1] - firstChunk[s],
+                     holdMs, sessionTracks[s]);
+    });
+
+    out.tracks.clear();
+    for (const std::vector<Track>& st : sessionTracks) {
+        out.tracks.insert(out.tracks.end(), st.begin(), st.end());
+    }
+    std::sort(out.tracks.begin(), out.tracks.end(), [](const Track& a, const Track& b) {
+        if (a.unit != b.unit) return a.unit < b.unit;
+        if (a.session != b.session) return a.session < b.session;
+        if (a.band != b.band) return a.band < b.band;
+        if (a.firstMs != b.firstMs) return a.firstMs < b.firstMs;
+        return a.peakMHz < b.peakMHz;
+    });
+    int64_t t3 = nowUs();
+
+    out.sessions = sessions.size();
+    out.chunks = chunks.size();
+    out.indexS = (t1 - t0) / 1e6;
+    out.analyzeS = (t2 - t1) / 1e6;
+    out.trackS = (t3 - t2) / 1e6;
+}
+
+static void printStage(const char* name, double serialS, double parallelS, int threads) {
+    double speedup = parallelS > 0 ? serialS / parallelS : 0.0;
+    printf("%-8s %9.2fs %9.2fs %8.2fx %9.0f%%\n",
+           name, serialS, parallelS, speedup, 100.0 * speedup / threads);
+}
+
+static void usage() {
+    fprintf(stderr, "usage: spurscan [-j threads] [-c chunk_rows] [-w warmup_rows] "
+                    "[-H hold_ms] [-o out.csv] [-B] unit_dir...\n");
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    int threads = (int)std::thread::hardware_concurrency();
+    size_t chunkRows = DEFAULT_CHUNK_ROWS;
+    size_t warmupRows = DEFAULT_WARMUP_ROWS;
+    uint32_t holdMs = DEFAULT_HOLD_MS;
+    const char* csvPath = nullptr;
+    bool bench = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            chunkRows = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            warmupRows = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+            holdMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "-B") == 0) {
+            bench = true;
+        } else if (argv[i][0] == '-') {
+            usage();
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || chunkRows == 0) usage();
+    if (threads < 1) threads = 1;
+
+    std::vector<Unit> units;
+    std::vector<LogFile> files;
+    for (const std::string& p : paths) {
+        if (!addUnit(p, units, files)) return 1;
+    }
+
+    crcInit();
+    Replay run;
+    Replay serial;
+    if (bench) {
+        // An untimed pass maps the files and pulls them into the page
+        // cache, so neither timed run pays for the disk
+        replay(files, units, threads, chunkRows, warmupRows, holdMs, run);
+        replay(files, units, 1, chunkRows, warmupRows, holdMs, serial);
+    }
+    replay(files, units, threads, chunkRows, warmupRows, holdMs, run);
+    const std::vector<Track>& tracks = run.tracks;
+
+    uint64_t bytes = 0;
+    uint64_t rows = 0;
+    uint32_t blocks = 0;
+    int torn = 0;
+    for (const LogFile& f : files) {
+        bytes += f.size;
+        rows += f.rows.size();
+        blocks += f.blocks;
+        if (f.torn) torn++;
+    }
+
+    uint32_t modCounts[MOD_COUNT] = { 0 };
+    for (const Track& t : tracks) modCounts[trackModulation(t)]++;
+
+    double totalS = run.indexS + run.analyzeS + run.trackS;
+    printf("%zu units, %zu files, %.1f MB, %u blocks (%d files torn)\n",
+           units.size(), files.size(), bytes / 1e6, blocks, torn);
+    printf("%llu rows in %zu sessions, %zu chunks on %d threads\n",
+           (unsigned long long)rows, run.sessions, run.chunks, threads);
+    printf("index %.2fs  analyze %.2fs  track %.2fs  total %.2fs  (%.0f rows/s, %.1f MB/s)\n",
+           run.indexS, run.analyzeS, run.trackS, totalS, totalS > 0 ? rows / totalS : 0.0,
+           totalS > 0 ? bytes / 1e6 / totalS : 0.0);
+    printf("%zu emitters:", tracks.size());
+    for (int m = 0; m < MOD_COUNT; m++) {
+        if (modCounts[m]) printf(" %s %u", modNames[m], modCounts[m]);
+    }
+    printf("\n");
+
+    bool same = true;
+    if (bench) {
+        double serialS = serial.indexS + serial.analyzeS + serial.trackS;
+        printf("\n%-8s %10s %10s %9s %10s\n", "stage", "1 thread",
+               (std::to_string(threads) + " threads").c_str(), "speedup", "per core");
+        printStage("index", serial.indexS, run.indexS, threads);
+        printStage("analyze", serial.analyzeS, run.analyzeS, threads);
+        printStage("track", serial.trackS, run.trackS, threads);
+        printStage("total", serialS, totalS, threads);
+        printf("serial %.1f MB/s, parallel %.1f MB/s on %u cores\n",
+               serialS > 0 ? bytes / 1e6 / serialS : 0.0, totalS > 0 ? bytes / 1e6 / totalS : 0.0,
+               std::thread::hardware_concurrency());
+
+        same = sameTracks(serial.tracks, tracks);
+        printf("emitter tables %s\n", same ? "identical" : "DIFFER");
+    }
+
+    if (csvPath != nullptr) {
+        FILE* out = strcmp(csvPath, "-") == 0 ? stdout : fopen(csvPath, "w");
+        if (out == nullptr) {
+            perror(csvPath);
+            return 1;
+        }
+        writeCsv(out, units, tracks);
+        if (out != stdout) fclose(out);
+    }
+
+    for (const LogFile& f : files) {
+        if (f.base != nullptr) munmap((void*)f.base, f.size);
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""
+Train the SPUR emitter classifier and emit include/classifier_model.h.
+
+Fits a small CART decision tree over the per-channel features the firmware
+computes after each sweep (see include/classifier.h) and writes it out as
+constexpr integer tables. Thresholds are integers and the split test is
+`feature <= threshold`, exactly as the firmware evaluates it, so the
+firmware predicts what this tool predicts. To hold it to that, every
+training and test row goes out with this tool's prediction to
+test/test_classifier/classifier_predictions.h, which the native test
+checks classifyEmitter() against.
+
+Training data, any mix of:
+
+  data.csv         CSV with a header naming the features and a `label` column
+  LORA:scan.log    serial log; every `[FEAT] ...` line in it gets label LORA
+
+Enable CLASSIFIER_LOG_FEATURES in config.h to get `[FEAT]` lines on serial
+while a known emitter is on the air.
+
+Example:
+  tools/train_classifier.py tools/classifier_seed.csv FHSS:elrs.log \\
+      -o include/classifier_model.h
+"""
+
+import argparse
+import csv
+import os
+import sys
+
+# Order must match enum ClassifierFeature in include/classifier.h
+FEATURES = ["band", "freq", "rssi", "margin", "variance", "occupancy", "width", "presence"]
+
+# Order must match enum ModulationType in include/config.h
+CLASSES = ["UNKNOWN", "FSK", "GFSK", "LORA", "FHSS", "DSSS", "OFDM"]
+
+LEAF = 0xFF
+MAX_NODES = 255  # Child links are uint8_t, 0xFF marks a leaf
+INT16_MIN, INT16_MAX = -32768, 32767
+
+
+def parse_label(text):
+    name = text.strip().upper()
+    if name.startswith("MOD_"):
+        name = name[4:]
+    if name.isdigit() and int(name) < len(CLASSES):
+        return int(name)
+    if name not in CLASSES:
+        raise ValueError("unknown label %r (expected one of %s)" % (text, ", ".join(CLASSES)))
+    return CLASSES.index(name)
+
+
+def clamp16(value):
+    return max(INT16_MIN, min(INT16_MAX, int(value)))
+
+
+def load_csv(path):
+    rows = []
+    with open(path, newline="") as f:
+        lines = (line for line in f if not line.lstrip().startswith("#"))
+        reader = csv.DictReader(lines)
+        missing = [name for name in FEATURES + ["label"] if name not in (reader.fieldnames or [])]
+        if missing:
+            raise ValueError("%s: missing columns %s" % (path, ", ".join(missing)))
+        for rec in reader:
+            x = [clamp16(rec[name]) for name in FEATURES]
+            rows.append((x, parse_label(rec["label"])))
+    return rows
+
+
+def load_log(label, path):
+    y = parse_label(label)
+    rows = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("[FEAT]")
+            if pos < 0:
+                continue
+            values = line[pos + len("[FEAT]"):].strip().split(",")
+            if len(values) != len(FEATURES):
+                continue  # Truncated or from another feature layout
+            rows.append(([clamp16(v) for v in values], y))
+    return rows
+
+
+def load(source):
+    label, sep, path = source.partition(":")
+    if sep and not os.path.exists(source):
+        return load_log(label, path)
+    return load_csv(source)
+
+
+def gini(counts, total):
+    if total == 0:
+        return 0.0
+    return 1.0 - sum((c / total) ** 2 for c in counts)
+
+
+def class_counts(rows):
+    counts = [0] * len(CLASSES)
+    for _, y in rows:
+        counts[y] += 1
+    return counts
+
+
+def best_split(rows, min_leaf):
+    """Best (feature, threshold) by weighted Gini, or None."""
+    total = len(rows)
+    parent = gini(class_counts(rows), total)
+    best = None
+    best_score = parent - 1e-9
+
+    for f in range(len(FEATURES)):
+        ordered = sorted(rows, key=lambda r: r[0][f])
+        left = [0] * len(CLASSES)
+        right = class_counts(rows)
+        for i in range(total - 1):
+            y = ordered[i][1]
+            left[y] += 1
+            right[y] -= 1
+            a = ordered[i][0][f]
+            b = ordered[i + 1][0][f]
+            n_left = i + 1
+            if a == b or n_left < min_leaf or total - n_left < min_leaf:
+                continue
+            score = (n_left * gini(left, n_left) + (total - n_left) * gini(right, total - n_left)) / total
+            if score < best_score:
+                best_score = score
+                best = (f, (a + b) // 2)  # a <= t < b for integers
+    return best
+
+
+def majority(rows):
+    counts = class_counts(rows)
+    return max(range(len(CLASSES)), key=lambda c: (counts[c], -c))
+
+
+def build(rows, depth, max_depth, min_leaf, nodes):
+    """Append the subtree in preorder; returns its root index."""
+    index = len(nodes)
+    nodes.append(None)
+
+    split = None
+    if depth < max_depth and len(set(y for _, y in rows)) > 1:
+        split = best_split(rows, min_leaf)
+
+    if split is None:
+        nodes[index] = (LEAF, majority(rows), LEAF, LEAF)
+        return index
+
+    f, t = split
+    left_rows = [r for r in rows if r[0][f] <= t]
+    right_rows = [r for r in rows if r[0][f] > t]
+    left = build(left_rows, depth + 1, max_depth, min_leaf, nodes)
+    right = build(right_rows, depth + 1, max_depth, min_leaf, nodes)
+    nodes[index] = (f, t, left, right)
+    return index
+
+
+def predict(nodes, x):
+    """Same walk as classifyEmitter() in src/classifier.cpp."""
+    node = 0
+    while nodes[node][0] != LEAF:
+        f, t, left, right = nodes[node]
+        node = left if x[f] <= t else right
+    return nodes[node][1]
+
+
+def tree_depth(nodes, node=0):
+    f, _, left, right = nodes[node]
+    if f == LEAF:
+        return 0
+    return 1 + max(tree_depth(nodes, left), tree_depth(nodes, right))
+
+
+def report(nodes, rows, title):
+    if not rows:
+        return
+    confusion = [[0] * len(CLASSES) for _ in CLASSES]
+    correct = 0
+    for x, y in rows:
+        p = predict(nodes, x)
+        confusion[y][p] += 1
+        correct += p == y
+    print("%s accuracy: %.1f%% (%d/%d)" % (title, 100.0 * correct / len(rows), correct, len(rows)))
+    used = [c for c in range(len(CLASSES)) if any(confusion[c]) or any(r[c] for r in confusion)]
+    print("  %-8s" % "true\\pred" + "".join("%8s" % CLASSES[c] for c in used))
+    for c in used:
+        print("  %-8s" % CLASSES[c] + "".join("%8d" % confusion[c][p] for p in used))
+
+
+def format_table(ctype, name, values, comment, size="CLASSIFIER_NODE_COUNT"):
+    body = ", ".join(str(v) for v in values)
+    lines = []
+    line = "    "
+    for item in body.split(" "):
+        if len(line) + len(item) + 1 > 78:
+            lines.append(line.rstrip())
+            line = "    "
+        line += item + " "
+    lines.append(line.rstrip())
+    return "// %s\nstatic constexpr %s %s[%s] = {\n%s\n};\n" % (
+        comment, ctype, name, size, "\n".join(lines))
+
+
+def emit_header(nodes, sources, out):
+    feature = [n[0] for n in nodes]
+    threshold = [n[1] for n in nodes]
+    left = [n[2] for n in nodes]
+    right = [n[3] for n in nodes]
+    names = ", ".join(os.path.basename(s) for s in sources)
+
+    text = """/**
+ * @file classifier_model.h
+ * @brief Emitter classifier decision tree (generated, do not edit)
+ *
+ * Generated by tools/train_classifier.py from: %s
+ * %d nodes, depth %d. Retrain instead of editing by hand.
+ */
+
+#ifndef CLASSIFIER_MODEL_H
+#define CLASSIFIER_MODEL_H
+
+#include <stdint.h>
+
+#define CLASSIFIER_MODEL_FEATURES %d
+#define CLASSIFIER_NODE_COUNT %d
+#define CLASSIFIER_LEAF 0xFF
+
+%s
+%s
+%s
+%s
+#endif // CLASSIFIER_MODEL_H
+""" % (names, len(nodes), tree_depth(nodes), len(FEATURES), len(nodes),
+       format_table("uint8_t", "classifierFeature", feature,
+                    "Feature tested at each node, CLASSIFIER_LEAF at a leaf"),
+       format_table("int16_t", "classifierThreshold", threshold,
+                    "Go left if feature <= threshold; the ModulationType at a leaf"),
+       format_table("uint8_t", "classifierLeft", left, "Child when the test holds"),
+       format_table("uint8_t", "classifierRight", right, "Child when it does not"))
+
+    with open(out, "w") as f:
+        f.write(text)
+
+
+def emit_predictions(nodes, rows, sources, out):
+    names = ", ".join(os.path.basename(s) for s in sources)
+    features = ",\n".join("    {%s}" % ", ".join(str(v) for v in x) for x, _ in rows)
+    predicted = [predict(nodes, x) for x, _ in rows]
+
+    text = """/**
+ * @file classifier_predictions.h
+ * @brief Predictions of tools/train_classifier.py (generated, do not edit)
+ *
+ * Every row the model was trained and tested on, from: %s
+ * with the class the tool predicted for it. classifyEmitter() must agree.
+ */
+
+#ifndef CLASSIFIER_PREDICTIONS_H
+#define CLASSIFIER_PREDICTIONS_H
+
+#include <stdint.h>
+
+#define CLASSIFIER_PREDICTION_COUNT %d
+
+// Feature names in the order the tool used them
+static const char* const predictionFeatureNames[%d] = {
+    %s
+};
+
+// Feature vectors
+static constexpr int16_t predictionFeatures[CLASSIFIER_PREDICTION_COUNT][%d] = {
+%s
+};
+
+%s
+#endif // CLASSIFIER_PREDICTIONS_H
+""" % (names, len(rows), len(FEATURES), ", ".join('"%s"' % f for f in FEATURES), len(FEATURES),
+       features,
+       format_table("uint8_t", "predictionClass", predicted,
+                    "ModulationType the tool predicted for each row",
+                    "CLASSIFIER_PREDICTION_COUNT"))
+
+    with open(out, "w") as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("sources", nargs="+", help="CSV files or LABEL:serial.log")
+    parser.add_argument("-o", "--output", default="include/classifier_model.h")
+    parser.add_argument("--predictions", default="test/test_classifier/classifier_predictions.h",
+                        help="where to write the tool's predictions for the native test")
+    parser.add_argument("--test", action="append", default=[], help="held-out CSV or LABEL:log")
+    parser.add_argument("--max-depth", type=int, default=8)
+    parser.add_argument("--min-leaf", type=int, default=2)
+    args = parser.parse_args()
+
+    try:
+        rows = [r for s in args.sources for r in load(s)]
+        test_rows = [r for s in args.test for r in load(s)]
+    except (OSError, ValueError) as e:
+        sys.exit("train_classifier: %s" % e)
+    if not rows:
+        sys.exit("train_classifier: no training rows")
+
+    nodes = []
+    build(rows, 0, args.max_depth, args.min_leaf, nodes)
+    if len(nodes) > MAX_NODES:
+        sys.exit("train_classifier: %d nodes, limit is %d; lower --max-depth" % (len(nodes), MAX_NODES))
+
+    report(nodes, rows, "Training")
+    report(nodes, test_rows, "Test")
+    emit_header(nodes, args.sources, args.output)
+    print("Wrote %s (%d nodes, depth %d)" % (args.output, len(nodes), tree_depth(nodes)))
+
+    pred_dir = os.path.dirname(args.predictions)
+    if pred_dir:
+        os.makedirs(pred_dir, exist_ok=True)
+    emit_predictions(nodes, rows + test_rows, args.sources + args.test, args.predictions)
+    print("Wrote %s (%d rows)" % (args.predictions, len(rows) + len(test_rows)))
+
+
+if __name__ == "__main__":
+    main()